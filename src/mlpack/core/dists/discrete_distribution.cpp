@@ -9,6 +9,58 @@
 using namespace mlpack;
 using namespace mlpack::distribution;
 
+/**
+ * Return the probability of each of the given observations.
+ */
+void DiscreteDistribution::Probability(const arma::mat& x,
+                                       arma::vec& probs) const
+{
+  probs.set_size(x.n_cols);
+  for (size_t i = 0; i < x.n_cols; ++i)
+  {
+    // Adding 0.5 helps ensure that we cast the floating point to a size_t
+    // correctly.
+    const size_t obs = size_t(x(0, i) + 0.5);
+
+    // Ensure that the observation is within the bounds.
+    if (obs >= probabilities.n_elem)
+    {
+      Log::Debug << "DiscreteDistribution::Probability(): received observation "
+          << obs << "; observation must be in [0, " << probabilities.n_elem
+          << "] for this distribution." << std::endl;
+    }
+
+    probs[i] = probabilities(obs);
+  }
+}
+
+/**
+ * Return the log probability of each of the given observations.
+ */
+void DiscreteDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  // Take the log of each possible observation once, instead of once for each
+  // observation.
+  const arma::vec logProbs = arma::log(probabilities);
+
+  logProbabilities.set_size(x.n_cols);
+  for (size_t i = 0; i < x.n_cols; ++i)
+  {
+    const size_t obs = size_t(x(0, i) + 0.5);
+
+    // Ensure that the observation is within the bounds.
+    if (obs >= probabilities.n_elem)
+    {
+      Log::Debug << "DiscreteDistribution::LogProbability(): received "
+          << "observation " << obs << "; observation must be in [0, "
+          << probabilities.n_elem << "] for this distribution." << std::endl;
+    }
+
+    logProbabilities[i] = logProbs(obs);
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
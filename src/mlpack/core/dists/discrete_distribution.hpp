@@ -118,6 +118,27 @@ class DiscreteDistribution
     return log(Probability(observation));
   }
 
+  /**
+   * Calculate the probability of each observation (column) in the given
+   * matrix.  As with the single-observation version, only the first dimension
+   * of each observation is used, and no bounds checking is performed.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& x, arma::vec& probabilities) const;
+
+  /**
+   * Calculate the log probability of each observation (column) in the given
+   * matrix.  As with the single-observation version, only the first dimension
+   * of each observation is used, and no bounds checking is performed.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation (one-dimensional vector; one
    * observation) according to the probability distribution defined by this
@@ -90,6 +90,14 @@ class GaussianDistribution
     probabilities = arma::exp(logProbabilities);
   }
 
+  /**
+   * Calculates the multivariate Gaussian log probability density function for
+   * each data point (column) in the given matrix.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
   void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
@@ -137,6 +145,17 @@ class GaussianDistribution
 
   void Covariance(arma::mat&& covariance);
 
+  /**
+   * Return the lower triangular Cholesky factor of the covariance (that is,
+   * the matrix L such that covariance = L * L^T).
+   */
+  const arma::mat& CovLower() const { return covLower; }
+
+  /**
+   * Return the log-determinant of the covariance.
+   */
+  double LogDetCov() const { return logDetCov; }
+
   /**
    * Serialize the distribution.
    */
@@ -163,33 +182,41 @@ class GaussianDistribution
 };
 
 /**
-* Calculates the multivariate Gaussian log probability density function for each
-* data point (column) in the given matrix
-*
-* @param x List of observations.
-* @param probabilities Output log probabilities for each input observation.
-*/
+ * Calculates the multivariate Gaussian log probability density function for
+ * each data point (column) in the given matrix.  The Mahalanobis distance of
+ * each point is computed as the squared norm of L^{-1} (x - mu), where L is the
+ * cached Cholesky factor of the covariance, so that the whole batch needs only
+ * one triangular solve.
+ *
+ * @param x List of observations.
+ * @param logProbabilities Output log probabilities for each input observation.
+ */
 inline void GaussianDistribution::LogProbability(const arma::mat& x,
                                                  arma::vec& logProbabilities) const
 {
   // Column i of 'diffs' is the difference between x.col(i) and the mean.
-  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
+  arma::mat diffs = x;
+  diffs.each_col() -= mean;
 
   // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1 *
-  // diffs).  We just don't need any of the other elements.  We can calculate
-  // the right hand part of the equation (instead of the left side) so that
-  // later we are referencing columns, not rows -- that is faster.
-  const arma::mat rhs = -0.5 * invCov * diffs;
-  arma::vec logExponents(diffs.n_cols); // We will now fill this.
-  for (size_t i = 0; i < diffs.n_cols; i++)
-    logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
+  // diffs).  Since cov^-1 = L^-T L^-1, that is the squared norm of each column
+  // of L^-1 diffs.
+  const arma::mat z = arma::solve(arma::trimatl(covLower), diffs);
 
   const size_t k = x.n_rows;
+  const double logConstant = -0.5 * k * log2pi - 0.5 * logDetCov;
 
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  logProbabilities.set_size(x.n_cols);
+  for (size_t i = 0; i < z.n_cols; i++)
+  {
+    const double* zCol = z.colptr(i);
+    double sum = 0.0;
+    for (size_t j = 0; j < k; j++)
+      sum += zCol[j] * zCol[j];
+    logProbabilities[i] = logConstant - 0.5 * sum;
+  }
 }
 
-
 } // namespace distribution
 } // namespace mlpack
 
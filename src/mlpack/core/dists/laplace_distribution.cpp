@@ -20,6 +20,31 @@ double LaplaceDistribution::LogProbability(const arma::vec& observation) const
   return -log(2. * scale) - arma::norm(observation - mean, 2) / scale;
 }
 
+/**
+ * Return the log probability of each of the given observations.
+ */
+void LaplaceDistribution::LogProbability(const arma::mat& x,
+                                         arma::vec& logProbabilities) const
+{
+  const double logConstant = -log(2. * scale);
+
+  // Compute the distance of each point to the mean in one pass, without
+  // allocating a temporary for every point.
+  logProbabilities.set_size(x.n_cols);
+  for (size_t i = 0; i < x.n_cols; ++i)
+  {
+    const double* point = x.colptr(i);
+    double sum = 0.0;
+    for (size_t j = 0; j < x.n_rows; ++j)
+    {
+      const double diff = point[j] - mean[j];
+      sum += diff * diff;
+    }
+
+    logProbabilities[i] = logConstant - std::sqrt(sum) / scale;
+  }
+}
+
 /**
  * Estimate the Laplace distribution directly from the given observations.
  *
@@ -85,6 +85,28 @@ class LaplaceDistribution
    */
   double LogProbability(const arma::vec& observation) const;
 
+  /**
+   * Calculate the probability of each data point (column) in the given matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& x, arma::vec& probabilities) const
+  {
+    LogProbability(x, probabilities);
+    probabilities = arma::exp(probabilities);
+  }
+
+  /**
+   * Calculate the log probability of each data point (column) in the given
+   * matrix.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.  This is inlined for speed.
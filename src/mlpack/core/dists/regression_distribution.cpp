@@ -53,6 +53,31 @@ double RegressionDistribution::Probability(const arma::vec& observation) const
   return err.Probability(observation(0)-fitted);
 }
 
+/**
+ * Evaluate probability density function of each given observation.
+ */
+void RegressionDistribution::Probability(const arma::mat& x,
+                                         arma::vec& probabilities) const
+{
+  LogProbability(x, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Evaluate log probability density function of each given observation.  The
+ * regression function is evaluated on all observations at once, and then the
+ * residuals are evaluated under the error distribution.
+ */
+void RegressionDistribution::LogProbability(const arma::mat& x,
+                                            arma::vec& logProbabilities) const
+{
+  arma::vec fitted;
+  rf.Predict(x.rows(1, x.n_rows - 1), fitted);
+
+  const arma::mat residuals = x.row(0) - fitted.t();
+  err.LogProbability(residuals, logProbabilities);
+}
+
 void RegressionDistribution::Predict(const arma::mat& points,
                                      arma::vec& predictions) const
 {
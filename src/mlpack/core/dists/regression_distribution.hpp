@@ -103,6 +103,25 @@ class RegressionDistribution
     return log(Probability(observation));
   }
 
+  /**
+   * Evaluate the probability density function of each observation (column) in
+   * the given matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& x, arma::vec& probabilities) const;
+
+  /**
+   * Evaluate the log probability density function of each observation
+   * (column) in the given matrix.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -30,7 +30,8 @@ AdaDelta<DecomposableFunctionType>::AdaDelta(DecomposableFunctionType& function,
 
 //! Optimize the function (minimize).
 template<typename DecomposableFunctionType>
-double AdaDelta<DecomposableFunctionType>::Optimize(arma::mat& iterate)
+template<typename eT>
+double AdaDelta<DecomposableFunctionType>::Optimize(arma::Mat<eT>& iterate)
 {
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
@@ -51,15 +52,15 @@ double AdaDelta<DecomposableFunctionType>::Optimize(arma::mat& iterate)
     overallObjective += function.Evaluate(iterate, i);
 
   // Now iterate!
-  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::Mat<eT> gradient(iterate.n_rows, iterate.n_cols);
 
   // Leaky sum of squares of parameter gradient.
-  arma::mat meanSquaredGradient = arma::zeros<arma::mat>(iterate.n_rows,
-      iterate.n_cols);
+  arma::Mat<eT> meanSquaredGradient = arma::zeros<arma::Mat<eT> >(
+      iterate.n_rows, iterate.n_cols);
 
   // Leaky sum of squares of parameter gradient.
-  arma::mat meanSquaredGradientDx = arma::zeros<arma::mat>(iterate.n_rows,
-      iterate.n_cols);
+  arma::Mat<eT> meanSquaredGradientDx = arma::zeros<arma::Mat<eT> >(
+      iterate.n_rows, iterate.n_cols);
 
   for (size_t i = 1; i != maxIterations; ++i, ++currentFunction)
   {
@@ -103,7 +104,7 @@ double AdaDelta<DecomposableFunctionType>::Optimize(arma::mat& iterate)
     // Accumulate gradient.
     meanSquaredGradient *= rho;
     meanSquaredGradient += (1 - rho) * (gradient % gradient);
-    arma::mat dx = arma::sqrt((meanSquaredGradientDx + eps) /
+    arma::Mat<eT> dx = arma::sqrt((meanSquaredGradientDx + eps) /
         (meanSquaredGradient + eps)) % gradient;
 
     // Accumulate updates.
@@ -91,10 +91,14 @@ class Adam
    * modified to store the finishing point of the algorithm, and the final
    * objective value is returned.
    *
+   * The iterate may be given in single or double precision, as long as the
+   * function evaluates the same matrix type.
+   *
    * @param iterate Starting point (will be modified).
    * @return Objective value of the final point.
    */
-  double Optimize(arma::mat& iterate);
+  template<typename eT>
+  double Optimize(arma::Mat<eT>& iterate);
 
   //! Get the instantiated function to be optimized.
   const DecomposableFunctionType& Function() const { return function; }
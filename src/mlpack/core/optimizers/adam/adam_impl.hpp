@@ -36,7 +36,8 @@ Adam<DecomposableFunctionType>::Adam(DecomposableFunctionType& function,
 
 //! Optimize the function (minimize).
 template<typename DecomposableFunctionType>
-double Adam<DecomposableFunctionType>::Optimize(arma::mat& iterate)
+template<typename eT>
+double Adam<DecomposableFunctionType>::Optimize(arma::Mat<eT>& iterate)
 {
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
@@ -57,13 +58,15 @@ double Adam<DecomposableFunctionType>::Optimize(arma::mat& iterate)
     overallObjective += function.Evaluate(iterate, i);
 
   // Now iterate!
-  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::Mat<eT> gradient(iterate.n_rows, iterate.n_cols);
 
   // Exponential moving average of gradient values.
-  arma::mat mean = arma::zeros<arma::mat>(iterate.n_rows, iterate.n_cols);
+  arma::Mat<eT> mean = arma::zeros<arma::Mat<eT> >(iterate.n_rows,
+      iterate.n_cols);
 
   // Exponential moving average of squared gradient values.
-  arma::mat variance = arma::zeros<arma::mat>(iterate.n_rows, iterate.n_cols);
+  arma::Mat<eT> variance = arma::zeros<arma::Mat<eT> >(iterate.n_rows,
+      iterate.n_cols);
 
   for (size_t i = 1; i != maxIterations; ++i, ++currentFunction)
   {
@@ -0,0 +1,163 @@
+/**
+ * @file hogwild.hpp
+ *
+ * Hogwild!, a lock-free parallel variant of stochastic gradient descent.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HOGWILD_HOGWILD_HPP
+#define MLPACK_CORE_OPTIMIZERS_HOGWILD_HOGWILD_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Hogwild! is a parallel version of stochastic gradient descent for functions
+ * which can be expressed as a sum of other functions whose gradients are
+ * sparse.  That is, suppose we have
+ *
+ * \f[
+ * f(A) = \sum_{i = 0}^{n} f_i(A)
+ * \f]
+ *
+ * where each \f$ f_i(A) \f$ only depends on a few coordinates of \f$ A \f$.
+ * Then Hogwild! runs the SGD update
+ *
+ * \f[
+ * A_{j + 1} = A_j + \alpha \nabla f_i(A)
+ * \f]
+ *
+ * on all threads at once, without any locking: each thread reads the shared
+ * iterate, computes the sparse gradient of one function, and atomically updates
+ * only the coordinates in which that gradient is nonzero.  Because the
+ * gradients of different functions rarely touch the same coordinates, the
+ * updates seldom overwrite each other, and the algorithm converges nearly like
+ * serial SGD while scaling almost linearly with the number of threads.  For
+ * more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title={Hogwild!: A lock-free approach to parallelizing stochastic gradient
+ *       descent},
+ *   author={Recht, Benjamin and Re, Christopher and Wright, Stephen and Niu,
+ *       Feng},
+ *   booktitle={Advances in Neural Information Processing Systems 24 (NIPS
+ *       2011)},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The functions are visited in passes over all \f$ n \f$ functions, either
+ * linearly or in a random sequence, and the threads split each pass.  After
+ * each pass the objective is evaluated; the algorithm continues until the
+ * maximum number of iterations is reached, or until a pass produces an
+ * improvement within a certain tolerance \f$ \epsilon \f$.  Without OpenMP,
+ * Hogwild! reduces to serial SGD with sparse updates.
+ *
+ * For Hogwild! to work, a SparseDecomposableFunctionType template parameter is
+ * required.  This class must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::sp_mat& gradient);
+ *
+ * NumFunctions() should return the number of functions (\f$n\f$), Evaluate()
+ * should return the full objective \f$ f(A) \f$, and Gradient() should return
+ * the gradient of the individual function \f$ f_i(A) \f$ as a sparse matrix.
+ * Gradient() is called concurrently by all threads, while other threads are
+ * writing to the coordinates, so it must not modify any state of the function.
+ * LogisticRegressionFunction, for instance, implements this, and it is
+ * efficient when the predictors are given as an arma::sp_mat.
+ *
+ * @tparam SparseDecomposableFunctionType Decomposable objective function type
+ *     with sparse gradients to be minimized.
+ */
+template<typename SparseDecomposableFunctionType>
+class Hogwild
+{
+ public:
+  /**
+   * Construct the Hogwild optimizer with the given function and parameters.
+   * The defaults here are not necessarily good for the given problem, so it is
+   * suggested that the values used be tailored to the task at hand.  The
+   * maximum number of iterations refers to the maximum number of points that
+   * are processed by all threads together (i.e., one iteration equals one
+   * point; one iteration does not equal one pass over the dataset).
+   *
+   * @param function Function to be optimized (minimized).
+   * @param stepSize Step size for each iteration.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled; otherwise, each
+   *     function is visited in linear order.
+   */
+  Hogwild(SparseDecomposableFunctionType& function,
+          const double stepSize = 0.01,
+          const size_t maxIterations = 100000,
+          const double tolerance = 1e-5,
+          const bool shuffle = true);
+
+  /**
+   * Optimize the given function using Hogwild!.  The given starting point will
+   * be modified to store the finishing point of the algorithm, and the final
+   * objective value is returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const SparseDecomposableFunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  SparseDecomposableFunctionType& Function() { return function; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+ private:
+  //! The instantiated function.
+  SparseDecomposableFunctionType& function;
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "hogwild_impl.hpp"
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file hogwild_impl.hpp
+ *
+ * Implementation of the Hogwild! optimizer.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HOGWILD_HOGWILD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_HOGWILD_HOGWILD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hogwild.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename SparseDecomposableFunctionType>
+Hogwild<SparseDecomposableFunctionType>::Hogwild(
+    SparseDecomposableFunctionType& function,
+    const double stepSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle) :
+    function(function),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename SparseDecomposableFunctionType>
+double Hogwild<SparseDecomposableFunctionType>::Optimize(arma::mat& iterate)
+{
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  // The order in which the functions are visited; this is only shuffled if
+  // shuffle is true.
+  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+      (numFunctions - 1), numFunctions);
+
+  // To keep track of where we are and how things are going.
+  double overallObjective = function.Evaluate(iterate);
+  double lastObjective = DBL_MAX;
+
+  // The first iteration is counted as in SGD.
+  size_t iteration = 1;
+  while (iteration != maxIterations)
+  {
+    // Output current objective function.
+    Log::Info << "Hogwild: iteration " << iteration << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Hogwild: converged to " << overallObjective << "; "
+          << "terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "Hogwild: minimized within tolerance " << tolerance << "; "
+          << "terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    if (shuffle) // Determine order of visitation.
+      visitationOrder = arma::shuffle(visitationOrder);
+
+    // The last pass may be cut short by the maximum number of iterations.
+    size_t passSize = numFunctions;
+    if (maxIterations != 0)
+      passSize = std::min(passSize, maxIterations - iteration);
+
+    // Each thread computes the sparse gradient at the current iterate and
+    // applies it without any locks; only the update of each single coordinate
+    // is atomic.
+    #pragma omp parallel for schedule(static)
+    for (intmax_t j = 0; j < (intmax_t) passSize; ++j)
+    {
+      arma::sp_mat gradient;
+      function.Gradient(iterate, visitationOrder[j], gradient);
+
+      for (arma::sp_mat::const_iterator it = gradient.begin();
+          it != gradient.end(); ++it)
+      {
+        double& coordinate = iterate(it.row(), it.col());
+        const double update = stepSize * (*it);
+
+        #pragma omp atomic
+        coordinate -= update;
+      }
+    }
+
+    iteration += passSize;
+    lastObjective = overallObjective;
+    overallObjective = function.Evaluate(iterate);
+  }
+
+  Log::Info << "Hogwild: maximum iterations (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+
+  return overallObjective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
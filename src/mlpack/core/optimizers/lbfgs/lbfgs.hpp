@@ -24,6 +24,22 @@ namespace optimization {
  *  - double Evaluate(const arma::mat& coordinates);
  *  - void Gradient(const arma::mat& coordinates, arma::mat& gradient);
  *  - arma::mat& GetInitialPoint();
+ *
+ * The inverse Hessian approximation is applied in its compact representation
+ * (see "Representations of quasi-Newton matrices and their use in limited
+ * memory methods", Byrd, Nocedal and Schnabel, 1994): the stored differences
+ * are kept as the columns of two matrices, so each search direction only takes
+ * a few matrix-vector products and some operations on small matrices of the
+ * size of the memory, instead of a loop over the stored differences.
+ *
+ * If an L1 penalty is given, the function f(x) + l1Penalty * |x|_1 is
+ * minimized with the orthant-wise limited-memory quasi-Newton method (OWL-QN;
+ * see "Scalable training of L1-regularized log-linear models", Andrew and
+ * Gao, 2007); the given function only has to provide the smooth part f(x).
+ *
+ * For objective functions that are sums of many functions, the evaluation can
+ * be spread over multiple threads by wrapping the function in a
+ * ParallelSeparableFunction.
  */
 template<typename FunctionType>
 class L_BFGS
@@ -48,6 +64,8 @@ class L_BFGS
    *     (before giving up).
    * @param minStep The minimum step of the line search.
    * @param maxStep The maximum step of the line search.
+   * @param l1Penalty Weight of the L1 penalty added to the function (0 means
+   *     no penalty); if it is positive, OWL-QN is used.
    */
   L_BFGS(FunctionType& function,
          const size_t numBasis = 10, /* same default as scipy */
@@ -58,7 +76,8 @@ class L_BFGS
          const double factr = 1e-15,
          const size_t maxLineSearchTrials = 50,
          const double minStep = 1e-20,
-         const double maxStep = 1e20);
+         const double maxStep = 1e20,
+         const double l1Penalty = 0);
 
   /**
    * Return the point where the lowest function value has been found.
@@ -145,16 +164,25 @@ class L_BFGS
   //! Modify the maximum line search step size.
   double& MaxStep() { return maxStep; }
 
+  //! Get the weight of the L1 penalty.
+  double L1Penalty() const { return l1Penalty; }
+  //! Modify the weight of the L1 penalty.
+  double& L1Penalty() { return l1Penalty; }
+
  private:
   //! Internal reference to the function we are optimizing.
   FunctionType& function;
 
   //! Position of the new iterate.
   arma::mat newIterateTmp;
-  //! Stores all the s matrices in memory.
-  arma::cube s;
-  //! Stores all the y matrices in memory.
-  arma::cube y;
+  //! Stores all the s vectors in memory, one per column.
+  arma::mat s;
+  //! Stores all the y vectors in memory, one per column.
+  arma::mat y;
+  //! Inner products of the stored s and y vectors: sTy(i, j) = s_i^T y_j.
+  arma::mat sTy;
+  //! Inner products of the stored y vectors: yTy(i, j) = y_i^T y_j.
+  arma::mat yTy;
 
   //! Size of memory for this L-BFGS optimizer.
   size_t numBasis;
@@ -174,13 +202,15 @@ class L_BFGS
   double minStep;
   //! Maximum step of the line search.
   double maxStep;
+  //! Weight of the L1 penalty.
+  double l1Penalty;
 
   //! Best point found so far.
   std::pair<arma::mat, double> minPointIterate;
 
   /**
-   * Evaluate the function at the given iterate point and store the result if it
-   * is a new minimum.
+   * Evaluate the function (including the L1 penalty) at the given iterate point
+   * and store the result if it is a new minimum.
    *
    * @return The value of the function.
    */
@@ -222,6 +252,38 @@ class L_BFGS
                   arma::mat& gradient,
                   const arma::mat& searchDirection);
 
+  /**
+   * Perform a back-tracking line search for OWL-QN, which keeps the new iterate
+   * in the orthant of the current iterate (as given by the pseudo-gradient for
+   * zero coordinates).  The parameter iterate will be modified if the method
+   * is successful.
+   *
+   * @param functionValue Value of the function at the initial point
+   * @param iterate The initial point to begin the line search from
+   * @param gradient The gradient of the smooth part at the initial point
+   * @param pseudoGradient The pseudo-gradient at the initial point
+   * @param searchDirection A vector specifying the search direction
+   *
+   * @return false if no step size is suitable, true otherwise.
+   */
+  bool OrthantWiseLineSearch(double& functionValue,
+                             arma::mat& iterate,
+                             arma::mat& gradient,
+                             const arma::mat& pseudoGradient,
+                             const arma::mat& searchDirection);
+
+  /**
+   * Calculate the pseudo-gradient of the L1-penalized function, which is the
+   * steepest descent direction of the non-differentiable objective.
+   *
+   * @param iterate The current point
+   * @param gradient The gradient of the smooth part at the current point
+   * @param pseudoGradient Matrix to store the pseudo-gradient in
+   */
+  void PseudoGradient(const arma::mat& iterate,
+                      const arma::mat& gradient,
+                      arma::mat& pseudoGradient);
+
   /**
    * Find the L-BFGS search direction.
    *
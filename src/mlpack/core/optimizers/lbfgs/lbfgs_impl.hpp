@@ -26,6 +26,7 @@ namespace optimization {
  *     (before giving up).
  * @param minStep The minimum step of the line search.
  * @param maxStep The maximum step of the line search.
+ * @param l1Penalty Weight of the L1 penalty added to the function.
  */
 template<typename FunctionType>
 L_BFGS<FunctionType>::L_BFGS(FunctionType& function,
@@ -37,7 +38,8 @@ L_BFGS<FunctionType>::L_BFGS(FunctionType& function,
                              const double factr,
                              const size_t maxLineSearchTrials,
                              const double minStep,
-                             const double maxStep) :
+                             const double maxStep,
+                             const double l1Penalty) :
     function(function),
     numBasis(numBasis),
     maxIterations(maxIterations),
@@ -47,7 +49,8 @@ L_BFGS<FunctionType>::L_BFGS(FunctionType& function,
     factr(factr),
     maxLineSearchTrials(maxLineSearchTrials),
     minStep(minStep),
-    maxStep(maxStep)
+    maxStep(maxStep),
+    l1Penalty(l1Penalty)
 {
   // Get the dimensions of the coordinates of the function; GetInitialPoint()
   // might return an arma::vec, but that's okay because then n_cols will simply
@@ -56,8 +59,10 @@ L_BFGS<FunctionType>::L_BFGS(FunctionType& function,
   const size_t cols = function.GetInitialPoint().n_cols;
 
   newIterateTmp.set_size(rows, cols);
-  s.set_size(rows, cols, numBasis);
-  y.set_size(rows, cols, numBasis);
+  s.zeros(rows * cols, numBasis);
+  y.zeros(rows * cols, numBasis);
+  sTy.zeros(numBasis, numBasis);
+  yTy.zeros(numBasis, numBasis);
 
   // Allocate the pair holding the min iterate information.
   minPointIterate.first.zeros(rows, cols);
@@ -76,6 +81,8 @@ double L_BFGS<FunctionType>::Evaluate(const arma::mat& iterate)
   // Evaluate the function and keep track of the minimum function
   // value encountered during the optimization.
   double functionValue = function.Evaluate(iterate);
+  if (l1Penalty > 0)
+    functionValue += l1Penalty * arma::accu(arma::abs(iterate));
 
   if (functionValue < minPointIterate.second)
   {
@@ -99,11 +106,10 @@ double L_BFGS<FunctionType>::ChooseScalingFactor(const size_t iterationNum,
   double scalingFactor = 1.0;
   if (iterationNum > 0)
   {
-    int previousPos = (iterationNum - 1) % numBasis;
-    // Get s and y matrices once instead of multiple times.
-    arma::mat& sMat = s.slice(previousPos);
-    arma::mat& yMat = y.slice(previousPos);
-    scalingFactor = dot(sMat, yMat) / dot(yMat, yMat);
+    // The inner products of the last s and y vectors are already stored.
+    const size_t previousPos = (iterationNum - 1) % numBasis;
+    scalingFactor = sTy(previousPos, previousPos) /
+        yTy(previousPos, previousPos);
   }
   else
   {
@@ -240,6 +246,102 @@ bool L_BFGS<FunctionType>::LineSearch(double& functionValue,
   return true;
 }
 
+/**
+ * Perform a back-tracking line search for OWL-QN.  Every trial point is
+ * projected onto the orthant of the current iterate, and the step is accepted
+ * once it satisfies the Armijo condition with respect to the pseudo-gradient.
+ *
+ * @param functionValue Value of the function at the initial point
+ * @param iterate The initial point to begin the line search from
+ * @param gradient The gradient of the smooth part at the initial point
+ * @param pseudoGradient The pseudo-gradient at the initial point
+ * @param searchDirection A vector specifying the search direction
+ *
+ * @return false if no step size is suitable, true otherwise.
+ */
+template<typename FunctionType>
+bool L_BFGS<FunctionType>::OrthantWiseLineSearch(
+    double& functionValue,
+    arma::mat& iterate,
+    arma::mat& gradient,
+    const arma::mat& pseudoGradient,
+    const arma::mat& searchDirection)
+{
+  // The orthant of a zero coordinate is the one the steepest descent direction
+  // points into.
+  arma::mat orthant(iterate.n_rows, iterate.n_cols);
+  for (size_t i = 0; i < iterate.n_elem; ++i)
+  {
+    const double x = (iterate[i] != 0.0) ? iterate[i] : -pseudoGradient[i];
+    orthant[i] = (x > 0.0) ? 1.0 : ((x < 0.0) ? -1.0 : 0.0);
+  }
+
+  // Save the initial function value.
+  const double initialFunctionValue = functionValue;
+
+  double stepSize = 1.0;
+  for (size_t numIterations = 0; numIterations < maxLineSearchTrials;
+       ++numIterations)
+  {
+    // Take a step and zero all coordinates that left their orthant.
+    newIterateTmp = iterate + stepSize * searchDirection;
+    for (size_t i = 0; i < newIterateTmp.n_elem; ++i)
+      if (newIterateTmp[i] * orthant[i] <= 0.0)
+        newIterateTmp[i] = 0.0;
+
+    functionValue = Evaluate(newIterateTmp);
+    if (functionValue <= initialFunctionValue + armijoConstant *
+        arma::dot(pseudoGradient, newIterateTmp - iterate))
+    {
+      // Move to the new iterate.
+      function.Gradient(newIterateTmp, gradient);
+      iterate = newIterateTmp;
+      return true;
+    }
+
+    stepSize *= 0.5;
+    if (stepSize < minStep)
+    {
+      Log::Debug << "stepSize < minStep" << std::endl;
+      break;
+    }
+  }
+
+  functionValue = initialFunctionValue;
+  return false;
+}
+
+/**
+ * Calculate the pseudo-gradient of the L1-penalized function.  For nonzero
+ * coordinates it is the gradient of the penalized function; for zero
+ * coordinates it is the one-sided derivative in the descent direction, or zero
+ * if both one-sided derivatives are nonnegative.
+ *
+ * @param iterate The current point
+ * @param gradient The gradient of the smooth part at the current point
+ * @param pseudoGradient Matrix to store the pseudo-gradient in
+ */
+template<typename FunctionType>
+void L_BFGS<FunctionType>::PseudoGradient(const arma::mat& iterate,
+                                          const arma::mat& gradient,
+                                          arma::mat& pseudoGradient)
+{
+  pseudoGradient.set_size(gradient.n_rows, gradient.n_cols);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (iterate[i] > 0.0)
+      pseudoGradient[i] = gradient[i] + l1Penalty;
+    else if (iterate[i] < 0.0)
+      pseudoGradient[i] = gradient[i] - l1Penalty;
+    else if (gradient[i] + l1Penalty < 0.0)
+      pseudoGradient[i] = gradient[i] + l1Penalty;
+    else if (gradient[i] - l1Penalty > 0.0)
+      pseudoGradient[i] = gradient[i] - l1Penalty;
+    else
+      pseudoGradient[i] = 0.0;
+  }
+}
+
 /**
  * Find the L_BFGS search direction.
  *
@@ -254,40 +356,57 @@ void L_BFGS<FunctionType>::SearchDirection(const arma::mat& gradient,
                                            const double scalingFactor,
                                            arma::mat& searchDirection)
 {
-  // Start from this point.
-  searchDirection = gradient;
+  // See "Representations of quasi-Newton matrices and their use in limited
+  // memory methods" (Byrd, Nocedal and Schnabel, 1994).  With the stored
+  // vectors as the columns of S and Y (oldest first), R the upper triangular
+  // part of S^T Y, D its diagonal and gamma the scaling factor, the inverse
+  // Hessian approximation applied to the gradient g is
+  //
+  //   H g = gamma g + S R^-T ((D + gamma Y^T Y) R^-1 S^T g - gamma Y^T g)
+  //         - gamma Y R^-1 S^T g.
+  //
+  // Only S^T g, Y^T g and the two products with S and Y touch vectors of the
+  // full dimensionality; everything else works on numBasis x numBasis
+  // matrices.
+  searchDirection.set_size(gradient.n_rows, gradient.n_cols);
+  const arma::vec g(const_cast<double*>(gradient.memptr()), gradient.n_elem,
+      false, true);
+  arma::vec direction(searchDirection.memptr(), searchDirection.n_elem, false,
+      true);
+
+  const size_t numStored = std::min(iterationNum, numBasis);
+  if (numStored == 0)
+  {
+    direction = -scalingFactor * g;
+    return;
+  }
 
-  // See "A Recursive Formula to Compute H * g" in "Updating quasi-Newton
-  // matrices with limited storage" (Nocedal, 1980).
+  // The columns of the stored vectors, from the oldest to the newest.
+  arma::uvec order(numStored);
+  for (size_t i = 0; i < numStored; ++i)
+    order[i] = (iterationNum - numStored + i) % numBasis;
 
-  // Temporary variables.
-  arma::vec rho(numBasis);
-  arma::vec alpha(numBasis);
+  // The products with the gradient are computed for all columns at once; the
+  // columns that aren't used yet are zero.
+  const arma::vec sTg = s.t() * g;
+  const arma::vec yTg = y.t() * g;
 
-  size_t limit = (numBasis > iterationNum) ? 0 : (iterationNum - numBasis);
-  for (size_t i = iterationNum; i != limit; i--)
-  {
-    int translatedPosition = (i + (numBasis - 1)) % numBasis;
-    rho[iterationNum - i] = 1.0 / arma::dot(y.slice(translatedPosition),
-                                            s.slice(translatedPosition));
-    alpha[iterationNum - i] = rho[iterationNum - i] *
-        arma::dot(s.slice(translatedPosition), searchDirection);
-    searchDirection -= alpha[iterationNum - i] * y.slice(translatedPosition);
-  }
+  const arma::mat sTyOrdered = sTy.submat(order, order);
+  const arma::mat r = arma::trimatu(sTyOrdered);
+  const arma::vec d = sTyOrdered.diag();
 
-  searchDirection *= scalingFactor;
+  const arma::vec u = arma::solve(arma::trimatu(r), sTg.elem(order));
+  const arma::vec v = arma::solve(arma::trimatl(r.t()), d % u +
+      scalingFactor * (yTy.submat(order, order) * u - yTg.elem(order)));
 
-  for (size_t i = limit; i < iterationNum; i++)
-  {
-    int translatedPosition = i % numBasis;
-    double beta = rho[iterationNum - i - 1] *
-        arma::dot(y.slice(translatedPosition), searchDirection);
-    searchDirection += (alpha[iterationNum - i - 1] - beta) *
-        s.slice(translatedPosition);
-  }
+  // Scatter the coefficients back to the columns of s and y.
+  arma::vec sCoefficients(numBasis, arma::fill::zeros);
+  arma::vec yCoefficients(numBasis, arma::fill::zeros);
+  sCoefficients.elem(order) = v;
+  yCoefficients.elem(order) = -scalingFactor * u;
 
   // Negate the search direction so that it is a descent direction.
-  searchDirection *= -1;
+  direction = -(scalingFactor * g + s * sCoefficients + y * yCoefficients);
 }
 
 /**
@@ -310,9 +429,16 @@ void L_BFGS<FunctionType>::UpdateBasisSet(const size_t iterationNum,
 {
   // Overwrite a certain position instead of pushing everything in the vector
   // back one position.
-  int overwritePos = iterationNum % numBasis;
-  s.slice(overwritePos) = iterate - oldIterate;
-  y.slice(overwritePos) = gradient - oldGradient;
+  const size_t overwritePos = iterationNum % numBasis;
+  s.col(overwritePos) = arma::vectorise(iterate - oldIterate);
+  y.col(overwritePos) = arma::vectorise(gradient - oldGradient);
+
+  // Update the inner products with the new vectors; the columns that aren't
+  // used yet are zero.
+  sTy.row(overwritePos) = s.col(overwritePos).t() * y;
+  sTy.col(overwritePos) = s.t() * y.col(overwritePos);
+  yTy.col(overwritePos) = y.t() * y.col(overwritePos);
+  yTy.row(overwritePos) = yTy.col(overwritePos).t();
 }
 
 /**
@@ -347,13 +473,15 @@ template<typename FunctionType>
 double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
                                       const size_t maxIterations)
 {
-  // Ensure that the cubes holding past iterations' information are the right
-  // size.  Also set the current best point value to the maximum.
+  // Ensure that the matrices holding past iterations' information are the
+  // right size.  Also set the current best point value to the maximum.
   const size_t rows = function.GetInitialPoint().n_rows;
   const size_t cols = function.GetInitialPoint().n_cols;
 
-  s.set_size(rows, cols, numBasis);
-  y.set_size(rows, cols, numBasis);
+  s.zeros(rows * cols, numBasis);
+  y.zeros(rows * cols, numBasis);
+  sTy.zeros(numBasis, numBasis);
+  yTy.zeros(numBasis, numBasis);
   minPointIterate.second = std::numeric_limits<double>::max();
 
   // The old iterate to be saved.
@@ -377,6 +505,12 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
   arma::mat searchDirection;
   searchDirection.zeros(iterate.n_rows, iterate.n_cols);
 
+  // With an L1 penalty (OWL-QN), the search direction is computed from the
+  // pseudo-gradient, while the basis set is still built from the gradient of
+  // the smooth part.
+  const bool orthantWise = (l1Penalty > 0);
+  arma::mat pseudoGradient;
+
   // The initial gradient value.
   function.Gradient(iterate, gradient);
 
@@ -384,9 +518,13 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
   for (size_t itNum = 0; optimizeUntilConvergence || (itNum != maxIterations);
        ++itNum)
   {
+    if (orthantWise)
+      PseudoGradient(iterate, gradient, pseudoGradient);
+    const arma::mat& descentGradient = orthantWise ? pseudoGradient : gradient;
+
     Log::Debug << "L-BFGS iteration " << itNum << "; objective " <<
-        function.Evaluate(iterate) << ", gradient norm " <<
-        arma::norm(gradient, 2) << ", " <<
+        functionValue << ", gradient norm " <<
+        arma::norm(descentGradient, 2) << ", " <<
         ((prevFunctionValue - functionValue) /
          std::max(std::max(fabs(prevFunctionValue), fabs(functionValue)), 1.0)) << "." << std::endl;
 
@@ -396,7 +534,7 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
     //
     // But don't do this on the first iteration to ensure we always take at
     // least one descent step.
-    if (itNum > 0 && GradientNormTooSmall(gradient))
+    if (itNum > 0 && GradientNormTooSmall(descentGradient))
     {
       Log::Debug << "L-BFGS gradient norm too small (terminating successfully)."
           << std::endl;
@@ -404,18 +542,31 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
     }
 
     // Choose the scaling factor.
-    double scalingFactor = ChooseScalingFactor(itNum, gradient);
+    double scalingFactor = ChooseScalingFactor(itNum, descentGradient);
 
     // Build an approximation to the Hessian and choose the search
     // direction for the current iteration.
-    SearchDirection(gradient, itNum, scalingFactor, searchDirection);
+    SearchDirection(descentGradient, itNum, scalingFactor, searchDirection);
+
+    // OWL-QN only moves along coordinates in which the search direction agrees
+    // in sign with the steepest descent direction.
+    if (orthantWise)
+    {
+      for (size_t i = 0; i < searchDirection.n_elem; ++i)
+        if (searchDirection[i] * pseudoGradient[i] >= 0.0)
+          searchDirection[i] = 0.0;
+    }
 
     // Save the old iterate and the gradient before stepping.
     oldIterate = iterate;
     oldGradient = gradient;
 
     // Do a line search and take a step.
-    if (!LineSearch(functionValue, iterate, gradient, searchDirection))
+    const bool lineSearchSucceeded = orthantWise ?
+        OrthantWiseLineSearch(functionValue, iterate, gradient, pseudoGradient,
+        searchDirection) :
+        LineSearch(functionValue, iterate, gradient, searchDirection);
+    if (!lineSearchSucceeded)
     {
       Log::Debug << "Line search failed.  Stopping optimization." << std::endl;
       break; // The line search failed; nothing else to try.
@@ -448,6 +599,10 @@ double L_BFGS<FunctionType>::Optimize(arma::mat& iterate,
 
   } // End of the optimization loop.
 
+  if (orthantWise)
+    return function.Evaluate(iterate) + l1Penalty * arma::accu(arma::abs(
+        iterate));
+
   return function.Evaluate(iterate);
 }
 
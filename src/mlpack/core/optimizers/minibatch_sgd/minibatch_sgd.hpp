@@ -8,10 +8,14 @@
 #define MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+#include <mlpack/core/optimizers/parallel_separable_function/parallel_separable_function.hpp>
 
 namespace mlpack {
 namespace optimization {
 
+HAS_MEM_FUNC(GradientBatch, HasGradientBatch);
+
 /**
  * Mini-batch Stochastic Gradient Descent is a technique for minimizing a
  * function which can be expressed as a sum of other functions.  That is,
@@ -62,6 +66,32 @@ namespace optimization {
  * function on the first point in the dataset (presumably, the dataset is held
  * internally in the DecomposableFunctionType).
  *
+ * Optionally, the class may also implement the following two functions, which
+ * evaluate the sum of the objective functions and of the gradients for the
+ * batchSize functions starting at index begin:
+ *
+ *   double EvaluateBatch(const arma::mat& coordinates,
+ *                        const size_t begin,
+ *                        const size_t batchSize);
+ *   void GradientBatch(const arma::mat& coordinates,
+ *                      const size_t begin,
+ *                      arma::mat& gradient,
+ *                      const size_t batchSize);
+ *
+ * If they are available, mini-batch SGD hands each mini-batch to them at once
+ * (the FFN class, for instance, then propagates the whole batch through the
+ * network with matrix-matrix products); otherwise the individual functions are
+ * evaluated one at a time.
+ *
+ * If the parallel option is set and mlpack is compiled with OpenMP, the
+ * individual functions of each mini-batch are split across the threads with a
+ * ParallelSeparableFunction: each thread sums the gradients of its part of the
+ * batch into its own buffer, and the buffers are then added together in a tree
+ * reduction.  This requires that Evaluate() and Gradient() can be called
+ * concurrently for different functions i (LogisticRegressionFunction and NCA's
+ * SoftmaxErrorFunction, for instance, satisfy this).  Functions with
+ * GradientBatch() (like FFN) are always handed the whole batch.
+ *
  * @tparam DecomposableFunctionType Decomposable objective function type to be
  *     minimized.
  */
@@ -84,13 +114,16 @@ class MiniBatchSGD
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param shuffle If true, the mini-batch order is shuffled; otherwise, each
    *     mini-batch is visited in linear order.
+   * @param parallel If true, the functions of each mini-batch are evaluated by
+   *     multiple threads.
    */
   MiniBatchSGD(DecomposableFunctionType& function,
                const size_t batchSize = 1000,
                const double stepSize = 0.01,
                const size_t maxIterations = 100000,
                const double tolerance = 1e-5,
-               const bool shuffle = true);
+               const bool shuffle = true,
+               const bool parallel = false);
 
   /**
    * Optimize the given function using mini-batch SGD.  The given starting point
@@ -132,6 +165,11 @@ class MiniBatchSGD
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  //! Get whether or not the mini-batches are split across threads.
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not the mini-batches are split across threads.
+  bool& Parallel() { return parallel; }
+
  private:
   //! The instantiated function.
   DecomposableFunctionType& function;
@@ -151,6 +189,51 @@ class MiniBatchSGD
   //! Controls whether or not the individual functions are shuffled when
   //! iterating.
   bool shuffle;
+
+  //! Controls whether or not the functions of each mini-batch are evaluated
+  //! by multiple threads.
+  bool parallel;
+
+  //! The function type, without any reference.
+  typedef typename std::remove_reference<DecomposableFunctionType>::type
+      FunctionType;
+
+  //! Evaluates the individual functions of a batch with multiple threads.
+  ParallelSeparableFunction<FunctionType> parallelFunction;
+
+  //! Evaluate the objective of a batch with EvaluateBatch().
+  template<typename F = FunctionType>
+  typename std::enable_if<HasGradientBatch<F, void(F::*)(const arma::mat&,
+      const size_t, arma::mat&, const size_t)>::value, double>::type
+  EvaluateBatch(const arma::mat& iterate,
+                const size_t begin,
+                const size_t batchSize);
+
+  //! Evaluate the objective of a batch one function at a time.
+  template<typename F = FunctionType>
+  typename std::enable_if<!HasGradientBatch<F, void(F::*)(const arma::mat&,
+      const size_t, arma::mat&, const size_t)>::value, double>::type
+  EvaluateBatch(const arma::mat& iterate,
+                const size_t begin,
+                const size_t batchSize);
+
+  //! Compute the gradient of a batch with GradientBatch().
+  template<typename F = FunctionType>
+  typename std::enable_if<HasGradientBatch<F, void(F::*)(const arma::mat&,
+      const size_t, arma::mat&, const size_t)>::value, void>::type
+  GradientBatch(const arma::mat& iterate,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  //! Compute the gradient of a batch one function at a time.
+  template<typename F = FunctionType>
+  typename std::enable_if<!HasGradientBatch<F, void(F::*)(const arma::mat&,
+      const size_t, arma::mat&, const size_t)>::value, void>::type
+  GradientBatch(const arma::mat& iterate,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
 };
 
 } // namespace optimization
@@ -20,13 +20,16 @@ MiniBatchSGD<DecomposableFunctionType>::MiniBatchSGD(
     const double stepSize,
     const size_t maxIterations,
     const double tolerance,
-    const bool shuffle) :
+    const bool shuffle,
+    const bool parallel) :
     function(function),
     batchSize(batchSize),
     stepSize(stepSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
-    shuffle(shuffle)
+    shuffle(shuffle),
+    parallel(parallel),
+    parallelFunction(function)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -39,11 +42,12 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
   if (numFunctions % batchSize != 0)
     ++numBatches; // Capture last few.
 
-  // This is only used if shuffle is true.
-  arma::Col<size_t> visitationOrder;
+  // The order in which the batches are visited; this is only shuffled if
+  // shuffle is true.
+  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+      (numBatches - 1), numBatches);
   if (shuffle)
-    visitationOrder = arma::shuffle(arma::linspace<arma::Col<size_t>>(0,
-        (numBatches - 1), numBatches));
+    visitationOrder = arma::shuffle(visitationOrder);
 
   // To keep track of where we are and how things are going.
   size_t currentBatch = 0;
@@ -51,8 +55,9 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
   double lastObjective = DBL_MAX;
 
   // Calculate the first objective function.
-  for (size_t i = 0; i < numFunctions; ++i)
-    overallObjective += function.Evaluate(iterate, i);
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+    overallObjective += EvaluateBatch(iterate, i,
+        std::min(batchSize, numFunctions - i));
 
   // Now iterate!
   arma::mat gradient(iterate.n_rows, iterate.n_cols);
@@ -89,54 +94,17 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
         visitationOrder = arma::shuffle(visitationOrder);
     }
 
-    // Evaluate the gradient for this mini-batch.
-    const size_t offset = (shuffle) ? batchSize * visitationOrder[currentBatch]
-        : batchSize * currentBatch;
-    function.Gradient(iterate, offset, gradient);
-    if (visitationOrder[currentBatch] != numBatches - 1)
-    {
-      for (size_t j = 1; j < batchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
+    // Evaluate the gradient for this mini-batch; the last batch may not be a
+    // full-size batch.
+    const size_t offset = batchSize * visitationOrder[currentBatch];
+    const size_t currentBatchSize = std::min(batchSize, numFunctions - offset);
+    GradientBatch(iterate, offset, gradient, currentBatchSize);
 
-      // Now update the iterate.
-      iterate -= (stepSize / batchSize) * gradient;
-
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < batchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
-    else
-    {
-      // Handle last batch differently: it's not a full-size batch.
-      const size_t lastBatchSize = numFunctions - offset - 1;
-      for (size_t j = 1; j < lastBatchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
+    // Now update the iterate.
+    iterate -= (stepSize / currentBatchSize) * gradient;
 
-      // Ensure the last batch size isn't zero, to avoid division by zero before
-      // updating.
-      if (lastBatchSize > 0)
-      {
-        // Now update the iterate.
-        iterate -= (stepSize / lastBatchSize) * gradient;
-      }
-      else
-      {
-        // Now update the iterate.
-        iterate -= stepSize * gradient;
-      }
-
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < lastBatchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
+    // Add that to the overall objective function.
+    overallObjective += EvaluateBatch(iterate, offset, currentBatchSize);
   }
 
   Log::Info << "Mini-batch SGD: maximum iterations (" << maxIterations << ") "
@@ -144,12 +112,78 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
 
   // Calculate final objective.
   overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; ++i)
-    overallObjective += function.Evaluate(iterate, i);
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+    overallObjective += EvaluateBatch(iterate, i,
+        std::min(batchSize, numFunctions - i));
 
   return overallObjective;
 }
 
+template<typename DecomposableFunctionType>
+template<typename F>
+typename std::enable_if<HasGradientBatch<F, void(F::*)(const arma::mat&,
+    const size_t, arma::mat&, const size_t)>::value, double>::type
+MiniBatchSGD<DecomposableFunctionType>::EvaluateBatch(const arma::mat& iterate,
+                                                      const size_t begin,
+                                                      const size_t batchSize)
+{
+  return function.EvaluateBatch(iterate, begin, batchSize);
+}
+
+template<typename DecomposableFunctionType>
+template<typename F>
+typename std::enable_if<!HasGradientBatch<F, void(F::*)(const arma::mat&,
+    const size_t, arma::mat&, const size_t)>::value, double>::type
+MiniBatchSGD<DecomposableFunctionType>::EvaluateBatch(const arma::mat& iterate,
+                                                      const size_t begin,
+                                                      const size_t batchSize)
+{
+  if (parallel)
+    return parallelFunction.EvaluateBatch(iterate, begin, batchSize);
+
+  double objective = 0;
+  for (size_t j = 0; j < batchSize; ++j)
+    objective += function.Evaluate(iterate, begin + j);
+
+  return objective;
+}
+
+template<typename DecomposableFunctionType>
+template<typename F>
+typename std::enable_if<HasGradientBatch<F, void(F::*)(const arma::mat&,
+    const size_t, arma::mat&, const size_t)>::value, void>::type
+MiniBatchSGD<DecomposableFunctionType>::GradientBatch(const arma::mat& iterate,
+                                                      const size_t begin,
+                                                      arma::mat& gradient,
+                                                      const size_t batchSize)
+{
+  function.GradientBatch(iterate, begin, gradient, batchSize);
+}
+
+template<typename DecomposableFunctionType>
+template<typename F>
+typename std::enable_if<!HasGradientBatch<F, void(F::*)(const arma::mat&,
+    const size_t, arma::mat&, const size_t)>::value, void>::type
+MiniBatchSGD<DecomposableFunctionType>::GradientBatch(const arma::mat& iterate,
+                                                      const size_t begin,
+                                                      arma::mat& gradient,
+                                                      const size_t batchSize)
+{
+  if (parallel)
+  {
+    parallelFunction.GradientBatch(iterate, begin, gradient, batchSize);
+    return;
+  }
+
+  function.Gradient(iterate, begin, gradient);
+  for (size_t j = 1; j < batchSize; ++j)
+  {
+    arma::mat funcGradient;
+    function.Gradient(iterate, begin + j, funcGradient);
+    gradient += funcGradient;
+  }
+}
+
 } // namespace optimization
 } // namespace mlpack
 
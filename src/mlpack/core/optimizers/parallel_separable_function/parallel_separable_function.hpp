@@ -0,0 +1,134 @@
+/**
+ * @file parallel_separable_function.hpp
+ *
+ * Wrapper that evaluates a separable objective function and its gradient with
+ * multiple threads.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SEPARABLE_FUNCTION_PARALLEL_SEPARABLE_FUNCTION_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SEPARABLE_FUNCTION_PARALLEL_SEPARABLE_FUNCTION_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * A wrapper around a function that can be expressed as a sum of other
+ * functions,
+ *
+ * \f[
+ * f(A) = \sum_{i = 0}^{n} f_i(A),
+ * \f]
+ *
+ * which evaluates the sum of the individual functions and of their gradients
+ * with multiple threads (if mlpack is compiled with OpenMP).  The functions
+ * are split into one contiguous part per thread; each thread sums the
+ * gradients of its part into its own buffer, and the buffers are then added
+ * together in a tree reduction.
+ *
+ * The wrapper provides the full Evaluate() and Gradient() functions that are
+ * required by batch optimizers such as L_BFGS, as well as EvaluateBatch() and
+ * GradientBatch() for ranges of functions, which are used by MiniBatchSGD:
+ *
+ * @code
+ * LogisticRegressionFunction<> lrf(data, responses);
+ * ParallelSeparableFunction<LogisticRegressionFunction<>> f(lrf);
+ * L_BFGS<ParallelSeparableFunction<LogisticRegressionFunction<>>> lbfgs(f);
+ * arma::mat coordinates = f.GetInitialPoint();
+ * lbfgs.Optimize(coordinates);
+ * @endcode
+ *
+ * The wrapped DecomposableFunctionType must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates, const size_t i);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient);
+ *   const arma::mat& GetInitialPoint();
+ *
+ * Evaluate() and Gradient() are called concurrently for different i, so they
+ * must not modify any shared state of the function (LogisticRegressionFunction,
+ * SoftmaxRegressionFunction and NCA's SoftmaxErrorFunction satisfy this).
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type.
+ */
+template<typename DecomposableFunctionType>
+class ParallelSeparableFunction
+{
+ public:
+  /**
+   * Wrap the given function.
+   *
+   * @param function Function to evaluate in parallel.
+   */
+  ParallelSeparableFunction(DecomposableFunctionType& function);
+
+  /**
+   * Evaluate the sum of all individual functions.
+   *
+   * @param coordinates Point to evaluate the function at.
+   */
+  double Evaluate(const arma::mat& coordinates);
+
+  /**
+   * Evaluate the sum of the gradients of all individual functions.
+   *
+   * @param coordinates Point to evaluate the gradient at.
+   * @param gradient Matrix to store the gradient in.
+   */
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient);
+
+  /**
+   * Evaluate the sum of the batchSize individual functions starting at index
+   * begin.
+   *
+   * @param coordinates Point to evaluate the functions at.
+   * @param begin Index of the first function.
+   * @param batchSize Number of functions.
+   */
+  double EvaluateBatch(const arma::mat& coordinates,
+                       const size_t begin,
+                       const size_t batchSize);
+
+  /**
+   * Evaluate the sum of the gradients of the batchSize individual functions
+   * starting at index begin.
+   *
+   * @param coordinates Point to evaluate the gradients at.
+   * @param begin Index of the first function.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of functions.
+   */
+  void GradientBatch(const arma::mat& coordinates,
+                     const size_t begin,
+                     arma::mat& gradient,
+                     const size_t batchSize);
+
+  //! Return the initial point of the wrapped function.
+  const arma::mat GetInitialPoint() const { return function.GetInitialPoint(); }
+
+  //! Return the number of individual functions.
+  size_t NumFunctions() const { return function.NumFunctions(); }
+
+  //! Get the wrapped function.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the wrapped function.
+  DecomposableFunctionType& Function() { return function; }
+
+ private:
+  //! The wrapped function.
+  DecomposableFunctionType& function;
+
+  //! The gradient buffers of all threads but the first, which are kept to avoid
+  //! memory reallocations.
+  std::vector<arma::mat> threadGradients;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_separable_function_impl.hpp"
+
+#endif
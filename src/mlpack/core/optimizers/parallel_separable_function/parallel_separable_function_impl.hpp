@@ -0,0 +1,105 @@
+/**
+ * @file parallel_separable_function_impl.hpp
+ *
+ * Implementation of the ParallelSeparableFunction wrapper.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_PARALLEL_SEPARABLE_FUNCTION_PARALLEL_SEPARABLE_FUNCTION_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_PARALLEL_SEPARABLE_FUNCTION_PARALLEL_SEPARABLE_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_separable_function.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType>
+ParallelSeparableFunction<DecomposableFunctionType>::ParallelSeparableFunction(
+    DecomposableFunctionType& function) :
+    function(function)
+{ /* Nothing to do. */ }
+
+template<typename DecomposableFunctionType>
+double ParallelSeparableFunction<DecomposableFunctionType>::Evaluate(
+    const arma::mat& coordinates)
+{
+  return EvaluateBatch(coordinates, 0, function.NumFunctions());
+}
+
+template<typename DecomposableFunctionType>
+void ParallelSeparableFunction<DecomposableFunctionType>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient)
+{
+  GradientBatch(coordinates, 0, gradient, function.NumFunctions());
+}
+
+template<typename DecomposableFunctionType>
+double ParallelSeparableFunction<DecomposableFunctionType>::EvaluateBatch(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t batchSize)
+{
+  double objective = 0;
+
+  #pragma omp parallel for reduction(+:objective) schedule(static)
+  for (intmax_t j = 0; j < (intmax_t) batchSize; ++j)
+    objective += function.Evaluate(coordinates, begin + j);
+
+  return objective;
+}
+
+template<typename DecomposableFunctionType>
+void ParallelSeparableFunction<DecomposableFunctionType>::GradientBatch(
+    const arma::mat& coordinates,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  #ifdef HAS_OPENMP
+  const size_t numThreads = std::max(std::min(
+      (size_t) omp_get_max_threads(), batchSize), (size_t) 1);
+  #else
+  const size_t numThreads = 1;
+  #endif
+
+  // The first thread sums into the given gradient; all other threads get a
+  // buffer of their own, so no locking is necessary.
+  threadGradients.resize(numThreads - 1);
+  gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+  for (size_t t = 0; t < numThreads - 1; ++t)
+    threadGradients[t].zeros(coordinates.n_rows, coordinates.n_cols);
+
+  // Each thread handles a contiguous part of the batch.
+  #pragma omp parallel for num_threads((int) numThreads) schedule(static, 1)
+  for (intmax_t t = 0; t < (intmax_t) numThreads; ++t)
+  {
+    arma::mat& threadGradient = (t == 0) ? gradient : threadGradients[t - 1];
+    const size_t first = begin + (t * batchSize) / numThreads;
+    const size_t last = begin + ((t + 1) * batchSize) / numThreads;
+
+    arma::mat funcGradient;
+    for (size_t j = first; j < last; ++j)
+    {
+      function.Gradient(coordinates, j, funcGradient);
+      threadGradient += funcGradient;
+    }
+  }
+
+  // Now add the buffers together pairwise, which takes log2(numThreads)
+  // parallel rounds.
+  for (size_t step = 1; step < numThreads; step *= 2)
+  {
+    #pragma omp parallel for num_threads((int) numThreads) schedule(static)
+    for (intmax_t t = 0; t < (intmax_t) (numThreads - step);
+        t += (intmax_t) (2 * step))
+    {
+      arma::mat& target = (t == 0) ? gradient : threadGradients[t - 1];
+      target += threadGradients[t + step - 1];
+    }
+  }
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
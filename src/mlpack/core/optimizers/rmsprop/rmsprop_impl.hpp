@@ -33,7 +33,8 @@ RMSprop<DecomposableFunctionType>::RMSprop(DecomposableFunctionType& function,
 
 //! Optimize the function (minimize).
 template<typename DecomposableFunctionType>
-double RMSprop<DecomposableFunctionType>::Optimize(arma::mat& iterate)
+template<typename eT>
+double RMSprop<DecomposableFunctionType>::Optimize(arma::Mat<eT>& iterate)
 {
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
@@ -54,11 +55,11 @@ double RMSprop<DecomposableFunctionType>::Optimize(arma::mat& iterate)
     overallObjective += function.Evaluate(iterate, i);
 
   // Now iterate!
-  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::Mat<eT> gradient(iterate.n_rows, iterate.n_cols);
 
   // Leaky sum of squares of parameter gradient.
-  arma::mat meanSquaredGradient = arma::zeros<arma::mat>(iterate.n_rows,
-      iterate.n_cols);
+  arma::Mat<eT> meanSquaredGradient = arma::zeros<arma::Mat<eT> >(
+      iterate.n_rows, iterate.n_cols);
 
   for (size_t i = 1; i != maxIterations; ++i, ++currentFunction)
   {
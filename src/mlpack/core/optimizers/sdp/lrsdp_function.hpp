@@ -72,6 +72,60 @@ class LRSDPFunction
                           const arma::mat& coordinates,
                           arma::mat& gradient) const;
 
+  /**
+   * Give the sparse constraints as one list of entries instead of as one sparse
+   * matrix per constraint.  This avoids the O(n) storage overhead of each
+   * arma::sp_mat in SDP().SparseA(), which dominates for problems with many
+   * constraints of only a few entries each, such as matrix completion.  The
+   * entries are only used if SDP().SparseA() is empty; SDP().SparseB() must
+   * still hold the right-hand side of every sparse constraint.  Each entry must
+   * be given explicitly, so for a symmetric constraint both (j, k) and (k, j)
+   * must be present.
+   *
+   * @param locations Matrix of size 3 x (number of entries); each column holds
+   *     the index of the constraint, the row, and the column of one entry.
+   * @param values Values of the entries.
+   */
+  void SparseConstraints(const arma::umat& locations, const arma::vec& values);
+
+  /**
+   * Collect the entries of all matrices in SDP().SparseA() into the batch that
+   * is used to evaluate the sparse constraints.  If SDP().SparseA() is empty,
+   * the entries given to SparseConstraints() are kept.  This is called by
+   * LRSDP::Optimize(); if the AugLagrangian optimizer is used directly, call it
+   * after modifying SDP().SparseA().
+   */
+  void UpdateSparseConstraints();
+
+  /**
+   * Evaluate all sparse constraints, Tr(A_i * (R R^T)) - b_i, at the given
+   * coordinates in one pass over their entries.  R R^T is never formed, and
+   * the constraints are split over multiple threads if OpenMP is available.
+   *
+   * @param coordinates Coordinates R to evaluate the constraints at.
+   * @param constraints Vector to store the value of each constraint in.
+   */
+  void EvaluateSparseConstraints(const arma::mat& coordinates,
+                                 arma::vec& constraints) const;
+
+  /**
+   * Compute sum_i w_i * A_i * R over all sparse constraints, which is needed
+   * for the gradient of the augmented Lagrangian.  The rows of the result are
+   * split over multiple threads if OpenMP is available.
+   *
+   * @param coordinates Coordinates R.
+   * @param weights Weight w_i of each sparse constraint.
+   * @param product Matrix to store the result in.
+   */
+  void MultiplySparseConstraints(const arma::mat& coordinates,
+                                 const arma::vec& weights,
+                                 arma::mat& product) const;
+
+  //! Return whether the batch of sparse constraint entries is up to date with
+  //! the number of sparse constraints.
+  bool SparseConstraintsBatched() const
+  { return sparseOffsets.n_elem == sdp.NumSparseConstraints() + 1; }
+
   //! Get the total number of constraints in the LRSDP.
   size_t NumConstraints() const { return sdp.NumConstraints(); }
 
@@ -91,6 +145,24 @@ class LRSDPFunction
 
   //! Initial point.
   arma::mat initialPoint;
+
+  //! The constraint, row and column of each sparse constraint entry, sorted by
+  //! constraint.
+  arma::umat sparseLocations;
+  //! The value of each sparse constraint entry.
+  arma::vec sparseValues;
+  //! The entries of sparse constraint i are sparseOffsets[i] to
+  //! sparseOffsets[i + 1] - 1.
+  arma::uvec sparseOffsets;
+  //! Indices of the sparse constraint entries, sorted by row.
+  arma::uvec rowOrder;
+  //! The entries in row j are rowOrder[rowOffsets[j]] to
+  //! rowOrder[rowOffsets[j + 1] - 1].
+  arma::uvec rowOffsets;
+
+  //! Sort the given sparse constraint entries into the batch.
+  void BatchSparseConstraints(const arma::umat& locations,
+                              const arma::vec& values);
 };
 
 // Declare specializations in lrsdp_function.cpp.
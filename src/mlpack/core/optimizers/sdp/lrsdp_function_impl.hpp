@@ -42,8 +42,8 @@ LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
 template <typename SDPType>
 double LRSDPFunction<SDPType>::Evaluate(const arma::mat& coordinates) const
 {
-  const arma::mat rrt = coordinates * trans(coordinates);
-  return accu(SDP().C() % rrt);
+  // Tr(C * (R R^T)) is the sum of the entries of (C R) % R.
+  return accu((SDP().C() * coordinates) % coordinates);
 }
 
 template <typename SDPType>
@@ -58,11 +58,31 @@ template <typename SDPType>
 double LRSDPFunction<SDPType>::EvaluateConstraint(const size_t index,
                                                   const arma::mat& coordinates) const
 {
-  const arma::mat rrt = coordinates * trans(coordinates);
   if (index < SDP().NumSparseConstraints())
-    return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+  {
+    // Tr(A_i * (R R^T)) is the sum over the entries a_jk of A_i of
+    // a_jk * <R_j, R_k>, where R_j is row j of R.
+    double trace = 0;
+    if (!SDP().SparseA().empty())
+    {
+      const arma::sp_mat& a = SDP().SparseA()[index];
+      for (arma::sp_mat::const_iterator it = a.begin(); it != a.end(); ++it)
+        trace += (*it) * dot(coordinates.row(it.row()),
+            coordinates.row(it.col()));
+    }
+    else
+    {
+      for (size_t e = sparseOffsets[index]; e < sparseOffsets[index + 1]; ++e)
+        trace += sparseValues[e] * dot(coordinates.row(sparseLocations(1, e)),
+            coordinates.row(sparseLocations(2, e)));
+    }
+
+    return trace - SDP().SparseB()[index];
+  }
+
   const size_t index1 = index - SDP().NumSparseConstraints();
-  return accu(SDP().DenseA()[index1] % rrt) - SDP().DenseB()[index1];
+  return accu((SDP().DenseA()[index1] * coordinates) % coordinates) -
+      SDP().DenseB()[index1];
 }
 
 template <typename SDPType>
@@ -74,50 +94,172 @@ void LRSDPFunction<SDPType>::GradientConstraint(const size_t /* index */,
       << "optimizers!" << std::endl;
 }
 
+template <typename SDPType>
+void LRSDPFunction<SDPType>::SparseConstraints(const arma::umat& locations,
+                                               const arma::vec& values)
+{
+  if (locations.n_rows != 3 || locations.n_cols != values.n_elem)
+    Log::Fatal << "LRSDPFunction::SparseConstraints(): locations must have 3 "
+        << "rows and one column per value!" << std::endl;
+
+  BatchSparseConstraints(locations, values);
+}
+
+template <typename SDPType>
+void LRSDPFunction<SDPType>::UpdateSparseConstraints()
+{
+  const std::vector<arma::sp_mat>& sparseA = SDP().SparseA();
+  if (sparseA.empty())
+  {
+    // Without sparse constraints there is nothing to batch, but the offsets
+    // still have to be set up.
+    if (SDP().NumSparseConstraints() == 0)
+      BatchSparseConstraints(arma::umat(3, 0), arma::vec());
+    else if (!SparseConstraintsBatched())
+      Log::Fatal << "LRSDPFunction::UpdateSparseConstraints(): SDP().SparseA() "
+          << "is empty, and the entries given to SparseConstraints() do not "
+          << "match the " << SDP().NumSparseConstraints() << " sparse "
+          << "constraints!" << std::endl;
+    return;
+  }
+
+  if (sparseA.size() != SDP().NumSparseConstraints())
+    Log::Fatal << "LRSDPFunction::UpdateSparseConstraints(): number of sparse "
+        << "constraint matrices (" << sparseA.size() << ") does not match the "
+        << "number of values in SDP().SparseB() ("
+        << SDP().NumSparseConstraints() << ")!" << std::endl;
+
+  size_t numEntries = 0;
+  for (size_t i = 0; i < sparseA.size(); ++i)
+    numEntries += sparseA[i].n_nonzero;
+
+  arma::umat locations(3, numEntries);
+  arma::vec values(numEntries);
+  size_t e = 0;
+  for (size_t i = 0; i < sparseA.size(); ++i)
+  {
+    for (arma::sp_mat::const_iterator it = sparseA[i].begin();
+        it != sparseA[i].end(); ++it, ++e)
+    {
+      locations(0, e) = i;
+      locations(1, e) = it.row();
+      locations(2, e) = it.col();
+      values[e] = (*it);
+    }
+  }
+
+  BatchSparseConstraints(locations, values);
+}
+
+template <typename SDPType>
+void LRSDPFunction<SDPType>::BatchSparseConstraints(const arma::umat& locations,
+                                                    const arma::vec& values)
+{
+  const size_t numConstraints = SDP().NumSparseConstraints();
+  const size_t n = initialPoint.n_rows;
+
+  // Count the entries of each constraint and of each row.
+  sparseOffsets.zeros(numConstraints + 1);
+  rowOffsets.zeros(n + 1);
+  for (size_t e = 0; e < locations.n_cols; ++e)
+  {
+    if (locations(0, e) >= numConstraints || locations(1, e) >= n ||
+        locations(2, e) >= n)
+      Log::Fatal << "LRSDPFunction::SparseConstraints(): entry (" << locations(1, e)
+          << ", " << locations(2, e) << ") of constraint " << locations(0, e)
+          << " is out of bounds!" << std::endl;
+
+    ++sparseOffsets[locations(0, e) + 1];
+    ++rowOffsets[locations(1, e) + 1];
+  }
+
+  sparseOffsets = arma::cumsum(sparseOffsets);
+  rowOffsets = arma::cumsum(rowOffsets);
+
+  // Now a counting sort puts the entries in order of their constraint.
+  sparseLocations.set_size(3, locations.n_cols);
+  sparseValues.set_size(locations.n_cols);
+  arma::uvec next = sparseOffsets;
+  for (size_t e = 0; e < locations.n_cols; ++e)
+  {
+    const size_t position = next[locations(0, e)]++;
+    sparseLocations.col(position) = locations.col(e);
+    sparseValues[position] = values[e];
+  }
+
+  // And the same again to order the sorted entries by row.
+  rowOrder.set_size(locations.n_cols);
+  next = rowOffsets;
+  for (size_t e = 0; e < sparseLocations.n_cols; ++e)
+    rowOrder[next[sparseLocations(1, e)]++] = e;
+}
+
+template <typename SDPType>
+void LRSDPFunction<SDPType>::EvaluateSparseConstraints(
+    const arma::mat& coordinates,
+    arma::vec& constraints) const
+{
+  // The rows of R are the columns of R^T, which are contiguous in memory.
+  const arma::mat rt = trans(coordinates);
+  constraints.set_size(SDP().NumSparseConstraints());
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) constraints.n_elem; ++i)
+  {
+    double trace = 0;
+    for (size_t e = sparseOffsets[i]; e < sparseOffsets[i + 1]; ++e)
+      trace += sparseValues[e] * dot(rt.unsafe_col(sparseLocations(1, e)),
+          rt.unsafe_col(sparseLocations(2, e)));
+
+    constraints[i] = trace - SDP().SparseB()[i];
+  }
+}
+
+template <typename SDPType>
+void LRSDPFunction<SDPType>::MultiplySparseConstraints(
+    const arma::mat& coordinates,
+    const arma::vec& weights,
+    arma::mat& product) const
+{
+  // Row j of the product is the sum over all entries a_jk in row j of every
+  // A_i of w_i * a_jk * R_k.  We work on the transposed matrices, so that each
+  // thread writes only its own contiguous columns.
+  const arma::mat rt = trans(coordinates);
+  arma::mat productT(rt.n_rows, rt.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t j = 0; j < (intmax_t) rt.n_cols; ++j)
+  {
+    for (size_t k = rowOffsets[j]; k < rowOffsets[j + 1]; ++k)
+    {
+      const size_t e = rowOrder[k];
+      productT.col(j) += (weights[sparseLocations(0, e)] * sparseValues[e]) *
+          rt.unsafe_col(sparseLocations(2, e));
+    }
+  }
+
+  product = trans(productT);
+}
+
 //! Utility function for calculating part of the objective when AugLagrangian is
 //! used with an LRSDPFunction.
-template <typename MatrixType>
 static inline void
 UpdateObjective(double& objective,
-                const arma::mat& rrt,
-                const std::vector<MatrixType>& ais,
-                const arma::vec& bis,
+                const arma::vec& constraints,
                 const arma::vec& lambda,
                 const size_t lambdaOffset,
                 const double sigma)
 {
-  for (size_t i = 0; i < ais.size(); ++i)
-  {
-    // Take the trace subtracted by the b_i.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    objective -= (lambda[lambdaOffset + i] * constraint);
-    objective += (sigma / 2.) * constraint * constraint;
-  }
-}
-
-//! Utility function for calculating part of the gradient when AugLagrangian is
-//! used with an LRSDPFunction.
-template <typename MatrixType>
-static inline void
-UpdateGradient(arma::mat& s,
-               const arma::mat& rrt,
-               const std::vector<MatrixType>& ais,
-               const arma::vec& bis,
-               const arma::vec& lambda,
-               const size_t lambdaOffset,
-               const double sigma)
-{
-  for (size_t i = 0; i < ais.size(); ++i)
+  for (size_t i = 0; i < constraints.n_elem; ++i)
   {
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    const double y = lambda[lambdaOffset + i] - sigma * constraint;
-    s -= y * ais[i];
+    objective -= (lambda[lambdaOffset + i] * constraints[i]);
+    objective += (sigma / 2.) * constraints[i] * constraints[i];
   }
 }
 
 template <typename SDPType>
 static inline double
-EvaluateImpl(const LRSDPFunction<SDPType>& function,
+EvaluateImpl(LRSDPFunction<SDPType>& function,
              const arma::mat& coordinates,
              const arma::vec& lambda,
              const double sigma)
@@ -126,30 +268,31 @@ EvaluateImpl(const LRSDPFunction<SDPType>& function,
   // L(R, y, s) = Tr(C * (R R^T)) -
   //     sum_{i = 1}^{m} (y_i (Tr(A_i * (R R^T)) - b_i)) +
   //     (sigma / 2) * sum_{i = 1}^{m} (Tr(A_i * (R R^T)) - b_i)^2
-
-  // Let's start with the objective: Tr(C * (R R^T)).
-  // Simple, possibly slow solution-- see below for optimization opportunity
   //
-  // TODO: Note that Tr(C^T * (R R^T)) = Tr( (CR)^T * R ), so
-  // multiplying C*R first, and then taking the trace dot should be more memory
-  // efficient
-  //
-  // Similarly for the constraints, taking A*R first should be more efficient
-  const arma::mat rrt = coordinates * trans(coordinates);
-  double objective = accu(function.SDP().C() % rrt);
+  // Tr(A * (R R^T)) = Tr((A R)^T R), so we multiply A * R first and never form
+  // the n x n matrix R R^T.
+  if (!function.SparseConstraintsBatched())
+    function.UpdateSparseConstraints();
+
+  double objective = function.Evaluate(coordinates);
 
-  // Now each constraint.
-  UpdateObjective(objective, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
-      lambda, 0, sigma);
-  UpdateObjective(objective, rrt, function.SDP().DenseA(), function.SDP().DenseB(), lambda,
-      function.SDP().NumSparseConstraints(), sigma);
+  // Now each constraint; the sparse constraints are evaluated in one pass.
+  arma::vec constraints;
+  function.EvaluateSparseConstraints(coordinates, constraints);
+  UpdateObjective(objective, constraints, lambda, 0, sigma);
+
+  const size_t numSparse = function.SDP().NumSparseConstraints();
+  constraints.set_size(function.SDP().NumDenseConstraints());
+  for (size_t i = 0; i < constraints.n_elem; ++i)
+    constraints[i] = function.EvaluateConstraint(numSparse + i, coordinates);
+  UpdateObjective(objective, constraints, lambda, numSparse, sigma);
 
   return objective;
 }
 
 template <typename SDPType>
 static inline void
-GradientImpl(const LRSDPFunction<SDPType>& function,
+GradientImpl(LRSDPFunction<SDPType>& function,
              const arma::mat& coordinates,
              const arma::vec& lambda,
              const double sigma,
@@ -160,17 +303,31 @@ GradientImpl(const LRSDPFunction<SDPType>& function,
   //   with
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
-  const arma::mat rrt = coordinates * trans(coordinates);
-  arma::mat s(function.SDP().C());
+  //
+  // S' is never formed; instead we sum C * R and each y'_i * A_i * R.
+  if (!function.SparseConstraintsBatched())
+    function.UpdateSparseConstraints();
 
-  UpdateGradient(
-      s, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
-      lambda, 0, sigma);
-  UpdateGradient(
-      s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
-      lambda, function.SDP().NumSparseConstraints(), sigma);
+  arma::vec constraints;
+  function.EvaluateSparseConstraints(coordinates, constraints);
+  arma::vec y(constraints.n_elem);
+  for (size_t i = 0; i < constraints.n_elem; ++i)
+    y[i] = lambda[i] - sigma * constraints[i];
+
+  arma::mat sparseProduct;
+  function.MultiplySparseConstraints(coordinates, y, sparseProduct);
+  gradient = function.SDP().C() * coordinates - sparseProduct;
+
+  const size_t numSparse = function.SDP().NumSparseConstraints();
+  for (size_t i = 0; i < function.SDP().NumDenseConstraints(); ++i)
+  {
+    const arma::mat ar = function.SDP().DenseA()[i] * coordinates;
+    const double constraint = accu(ar % coordinates) -
+        function.SDP().DenseB()[i];
+    gradient -= (lambda[numSparse + i] - sigma * constraint) * ar;
+  }
 
-  gradient = 2 * s * coordinates;
+  gradient *= 2;
 }
 
 // Template specializations for function and gradient evaluation.
@@ -24,6 +24,12 @@ LRSDP<SDPType>::LRSDP(const size_t numSparseConstraints,
 template <typename SDPType>
 double LRSDP<SDPType>::Optimize(arma::mat& coordinates)
 {
+  // The constraints may have been modified since the last optimization, and
+  // their number may have changed since construction.
+  function.UpdateSparseConstraints();
+  if (augLag.Lambda().n_elem != function.NumConstraints())
+    augLag.Lambda().zeros(function.NumConstraints());
+
   augLag.Sigma() = 10;
   augLag.Optimize(coordinates, 1000);
 
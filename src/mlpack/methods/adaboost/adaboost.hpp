@@ -26,6 +26,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/perceptron/perceptron.hpp>
 #include <mlpack/methods/decision_stump/decision_stump.hpp>
+#include "weak_learner_traits.hpp"
 
 namespace mlpack {
 namespace adaboost {
@@ -68,6 +69,11 @@ namespace adaboost {
  * For more information on and examples of weak learners, see
  * perceptron::Perceptron<> and decision_stump::DecisionStump<>.
  *
+ * If WeakLearnerTraits<WeakLearnerType>::UsesPresortedData is true (as it is
+ * for decision_stump::DecisionStump<>), the sorted order of the points in each
+ * dimension is computed once before boosting starts, and every weak learner is
+ * trained with it, instead of sorting the data again in every round.
+ *
  * @tparam MatType Data matrix type (i.e. arma::mat or arma::sp_mat).
  * @tparam WeakLearnerType Type of weak learner to use.
  */
@@ -157,6 +163,49 @@ class AdaBoost
   void Serialize(Archive& ar, const unsigned int /* version */);
 
 private:
+  /**
+   * Compute the sorted order of the points in each dimension, if the weak
+   * learner can use it.
+   */
+  template<typename LearnerType = WeakLearnerType>
+  static typename std::enable_if<
+      WeakLearnerTraits<LearnerType>::UsesPresortedData>::type
+  Presort(const MatType& data, arma::umat& sortedIndices);
+
+  /**
+   * Do nothing, since the weak learner can't use the sorted order of the
+   * points.
+   */
+  template<typename LearnerType = WeakLearnerType>
+  static typename std::enable_if<
+      !WeakLearnerTraits<LearnerType>::UsesPresortedData>::type
+  Presort(const MatType& /* data */, arma::umat& /* sortedIndices */) { }
+
+  /**
+   * Train a weak learner with the given weights, using the sorted order of the
+   * points computed by Presort().
+   */
+  template<typename LearnerType = WeakLearnerType>
+  static typename std::enable_if<
+      WeakLearnerTraits<LearnerType>::UsesPresortedData, LearnerType>::type
+  TrainWeakLearner(const LearnerType& other,
+                   const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::rowvec& weights,
+                   const arma::umat& sortedIndices);
+
+  /**
+   * Train a weak learner with the given weights.
+   */
+  template<typename LearnerType = WeakLearnerType>
+  static typename std::enable_if<
+      !WeakLearnerTraits<LearnerType>::UsesPresortedData, LearnerType>::type
+  TrainWeakLearner(const LearnerType& other,
+                   const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::rowvec& weights,
+                   const arma::umat& /* sortedIndices */);
+
   //! The number of classes in the model.
   size_t classes;
   // The tolerance for change in rt and when to stop.
@@ -83,6 +83,11 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // Use tempData to modify input data for incorporating weights.
   MatType tempData(data);
 
+  // If the weak learner can use it, sort each dimension once here; the order
+  // doesn't change between boosting rounds.
+  arma::umat sortedIndices;
+  Presort(tempData, sortedIndices);
+
   // This matrix is a helper matrix used to calculate the final hypothesis.
   arma::mat sumFinalH = arma::zeros<arma::mat>(classes, predictedLabels.n_cols);
 
@@ -112,7 +117,8 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     weights = arma::sum(D);
 
     // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, weights);
+    WeakLearnerType w = TrainWeakLearner(other, tempData, labels, weights,
+        sortedIndices);
     w.Classify(tempData, predictedLabels);
 
     // Now from predictedLabels, build ht, the weak hypothesis
@@ -185,6 +191,47 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   }
 }
 
+// Presort the data for a weak learner that supports it.
+template<typename WeakLearnerType, typename MatType>
+template<typename LearnerType>
+typename std::enable_if<
+    WeakLearnerTraits<LearnerType>::UsesPresortedData>::type
+AdaBoost<WeakLearnerType, MatType>::Presort(const MatType& data,
+                                            arma::umat& sortedIndices)
+{
+  LearnerType::Presort(data, sortedIndices);
+}
+
+// Train a weak learner that supports presorted data.
+template<typename WeakLearnerType, typename MatType>
+template<typename LearnerType>
+typename std::enable_if<
+    WeakLearnerTraits<LearnerType>::UsesPresortedData, LearnerType>::type
+AdaBoost<WeakLearnerType, MatType>::TrainWeakLearner(
+    const LearnerType& other,
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const arma::rowvec& weights,
+    const arma::umat& sortedIndices)
+{
+  return LearnerType(other, data, labels, weights, sortedIndices);
+}
+
+// Train a weak learner that doesn't support presorted data.
+template<typename WeakLearnerType, typename MatType>
+template<typename LearnerType>
+typename std::enable_if<
+    !WeakLearnerTraits<LearnerType>::UsesPresortedData, LearnerType>::type
+AdaBoost<WeakLearnerType, MatType>::TrainWeakLearner(
+    const LearnerType& other,
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const arma::rowvec& weights,
+    const arma::umat& /* sortedIndices */)
+{
+  return LearnerType(other, data, labels, weights);
+}
+
 /**
  * Classify the given test points.
  */
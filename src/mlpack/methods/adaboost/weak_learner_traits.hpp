@@ -0,0 +1,69 @@
+/**
+ * @file weak_learner_traits.hpp
+ *
+ * This file defines the WeakLearnerTraits class, which AdaBoost uses to find
+ * out which optional features a weak learner supports.
+ */
+#ifndef MLPACK_METHODS_ADABOOST_WEAK_LEARNER_TRAITS_HPP
+#define MLPACK_METHODS_ADABOOST_WEAK_LEARNER_TRAITS_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_stump/decision_stump.hpp>
+
+namespace mlpack {
+namespace adaboost {
+
+/**
+ * This is a template class that can provide information about weak learners.
+ * By default, weak learners do not support any optional features; if a weak
+ * learner does, it should specialize this class:
+ *
+ * @code
+ * template<>
+ * class WeakLearnerTraits<MyWeakLearner>
+ * {
+ *  public:
+ *   static const bool UsesPresortedData = true;
+ * };
+ * @endcode
+ */
+template<typename WeakLearnerType>
+class WeakLearnerTraits
+{
+ public:
+  /**
+   * If true, the weak learner can reuse the sorted order of the points in each
+   * dimension across boosting rounds.  Such a weak learner must provide the
+   * following two functions:
+   *
+   * @code
+   * // Compute the sorted order of the points in each dimension.
+   * static void Presort(const MatType& data, arma::umat& sortedIndices);
+   *
+   * // A boosting constructor which uses the sorted order computed by
+   * // Presort().
+   * WeakLearner(WeakLearner& other,
+   *             const MatType& data,
+   *             const arma::Row<size_t>& labels,
+   *             const arma::rowvec& weights,
+   *             const arma::umat& sortedIndices);
+   * @endcode
+   */
+  static const bool UsesPresortedData = false;
+};
+
+/**
+ * Decision stumps choose their splits from the sorted order of each dimension,
+ * which does not change between boosting rounds.
+ */
+template<typename MatType>
+class WeakLearnerTraits<decision_stump::DecisionStump<MatType>>
+{
+ public:
+  static const bool UsesPresortedData = true;
+};
+
+} // namespace adaboost
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file convolution_rule_traits.hpp
+ *
+ * This provides the ConvolutionRuleTraits class, a template class to get
+ * information about various convolution rules.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_CONVOLUTION_RULE_TRAITS_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_CONVOLUTION_RULE_TRAITS_HPP
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * This is a template class that can provide information about various
+ * convolution rules.  By default, this class will provide the weakest possible
+ * assumptions on convolution rules, and each convolution rule should override
+ * values as necessary.  If a convolution rule doesn't need to override a value,
+ * then there's no need to write a ConvolutionRuleTraits specialization for that
+ * class.
+ */
+template<typename ConvolutionRule>
+class ConvolutionRuleTraits
+{
+ public:
+  /**
+   * This is true if the convolution rule can compute the forward pass, the
+   * backward pass and the gradient of a whole convolution layer at once,
+   * through the static functions Forward(), Backward() and Gradient(), instead
+   * of convolving each pair of input and output maps separately.
+   */
+  static const bool ConvolvesAllMaps = false;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
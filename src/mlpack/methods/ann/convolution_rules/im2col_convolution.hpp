@@ -0,0 +1,477 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through im2col and matrix multiplication.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/core.hpp>
+#include "border_modes.hpp"
+#include "convolution_rule_traits.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by unfolding every patch of the
+ * input that the filter is applied to into a row of a matrix (im2col), so that
+ * the convolution becomes a single matrix product that is handled by BLAS.
+ * Like NaiveConvolution, the convolution can be computed with the valid border
+ * type or the full border type (default).
+ *
+ * In addition to the usual convolution interface, Im2ColConvolution can
+ * compute the forward pass, the backward pass and the gradient of a whole
+ * ConvLayer at once (see ConvolutionRuleTraits), with one matrix product for
+ * all of the input and output maps.  These layer-wise functions also respect
+ * the stride and padding of the layer.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output)
+  {
+    PaddedConvolution(input, filter, 0, 0, output);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output)
+  {
+    // The zero padding is never stored; im2col skips it.
+    PaddedConvolution(input, filter, filter.n_rows - 1, filter.n_cols - 1,
+        output);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i));
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i));
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i));
+    }
+  }
+
+  /**
+   * Compute the forward pass of a convolution layer: output map o is the sum
+   * over all input maps i of the (valid) convolution of input map i with the
+   * filter in slice (i * outMaps + o) of the weights.
+   *
+   * @param input The input maps.
+   * @param weights The filters of the layer.
+   * @param outMaps The number of output maps.
+   * @param xStride Stride of filter application in the x direction.
+   * @param yStride Stride of filter application in the y direction.
+   * @param wPad Spatial padding width of the input.
+   * @param hPad Spatial padding height of the input.
+   * @param output The output maps.
+   */
+  template<typename eT>
+  static void Forward(const arma::Cube<eT>& input,
+                      const arma::Cube<eT>& weights,
+                      const size_t outMaps,
+                      const size_t xStride,
+                      const size_t yStride,
+                      const size_t wPad,
+                      const size_t hPad,
+                      arma::Cube<eT>& output)
+  {
+    const size_t outRows = (input.n_rows + 2 * wPad - weights.n_rows) /
+        xStride + 1;
+    const size_t outCols = (input.n_cols + 2 * hPad - weights.n_cols) /
+        yStride + 1;
+
+    arma::Mat<eT> columns;
+    Im2ColMaps(input, weights.n_rows, weights.n_cols, xStride, yStride, wPad,
+        hPad, outRows, outCols, columns);
+
+    arma::Mat<eT> filters;
+    FilterMatrix(weights, input.n_slices, outMaps, filters);
+
+    // Each slice of the output is one column of the product.
+    output.set_size(outRows, outCols, outMaps);
+    arma::Mat<eT> outputMat(output.memptr(), outRows * outCols, outMaps, false,
+        true);
+    outputMat = columns * filters;
+  }
+
+  /**
+   * Compute the backward pass of a convolution layer, that is, the error with
+   * respect to the input maps given the error with respect to the output maps.
+   *
+   * @param error The error with respect to the output maps.
+   * @param weights The filters of the layer.
+   * @param inputRows The number of rows of the input maps.
+   * @param inputCols The number of columns of the input maps.
+   * @param xStride Stride of filter application in the x direction.
+   * @param yStride Stride of filter application in the y direction.
+   * @param wPad Spatial padding width of the input.
+   * @param hPad Spatial padding height of the input.
+   * @param g The error with respect to the input maps.
+   */
+  template<typename eT>
+  static void Backward(const arma::Cube<eT>& error,
+                       const arma::Cube<eT>& weights,
+                       const size_t inputRows,
+                       const size_t inputCols,
+                       const size_t xStride,
+                       const size_t yStride,
+                       const size_t wPad,
+                       const size_t hPad,
+                       arma::Cube<eT>& g)
+  {
+    const size_t outMaps = error.n_slices;
+    const size_t inMaps = weights.n_slices / outMaps;
+    const size_t filterSize = weights.n_rows * weights.n_cols;
+
+    arma::Mat<eT> filters;
+    FilterMatrix(weights, inMaps, outMaps, filters);
+
+    const arma::Mat<eT> errorMat(const_cast<eT*>(error.memptr()),
+        error.n_rows * error.n_cols, outMaps, false, true);
+    const arma::Mat<eT> columns = errorMat * arma::trans(filters);
+
+    // Fold the columns back onto the input maps.
+    g.zeros(inputRows, inputCols, inMaps);
+    for (size_t i = 0; i < inMaps; ++i)
+    {
+      Col2Im(columns.colptr(i * filterSize), weights.n_rows, weights.n_cols,
+          xStride, yStride, wPad, hPad, error.n_rows, error.n_cols, inputRows,
+          inputCols, g.slice_memptr(i));
+    }
+  }
+
+  /**
+   * Compute the gradient of a convolution layer with respect to its filters,
+   * given the input maps and the error with respect to the output maps.
+   *
+   * @param input The input maps.
+   * @param error The error with respect to the output maps.
+   * @param filterRows The number of rows of each filter.
+   * @param filterCols The number of columns of each filter.
+   * @param xStride Stride of filter application in the x direction.
+   * @param yStride Stride of filter application in the y direction.
+   * @param wPad Spatial padding width of the input.
+   * @param hPad Spatial padding height of the input.
+   * @param g The gradient, with the same layout as the weights.
+   */
+  template<typename eT>
+  static void Gradient(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error,
+                       const size_t filterRows,
+                       const size_t filterCols,
+                       const size_t xStride,
+                       const size_t yStride,
+                       const size_t wPad,
+                       const size_t hPad,
+                       arma::Cube<eT>& g)
+  {
+    const size_t inMaps = input.n_slices;
+    const size_t outMaps = error.n_slices;
+    const size_t filterSize = filterRows * filterCols;
+
+    arma::Mat<eT> columns;
+    Im2ColMaps(input, filterRows, filterCols, xStride, yStride, wPad, hPad,
+        error.n_rows, error.n_cols, columns);
+
+    const arma::Mat<eT> errorMat(const_cast<eT*>(error.memptr()),
+        error.n_rows * error.n_cols, outMaps, false, true);
+    const arma::Mat<eT> filters = arma::trans(columns) * errorMat;
+
+    // Rearrange the gradient into the layout of the weights.
+    g.set_size(filterRows, filterCols, inMaps * outMaps);
+    arma::Mat<eT> gMat(g.memptr(), filterSize, inMaps * outMaps, false, true);
+    for (size_t i = 0; i < inMaps; ++i)
+    {
+      gMat.cols(i * outMaps, (i + 1) * outMaps - 1) =
+          filters.rows(i * filterSize, (i + 1) * filterSize - 1);
+    }
+  }
+
+ private:
+  /*
+   * Perform a (valid) convolution of the input, implicitly padded with the
+   * given number of zeros on each side, with the filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the conolution.
+   * @param wPad Number of zero rows to pad the input with on each side.
+   * @param hPad Number of zero columns to pad the input with on each side.
+   * @param output Output data that contains the results of the convolution.
+   */
+  template<typename eT>
+  static void PaddedConvolution(const arma::Mat<eT>& input,
+                                const arma::Mat<eT>& filter,
+                                const size_t wPad,
+                                const size_t hPad,
+                                arma::Mat<eT>& output)
+  {
+    const size_t outRows = input.n_rows + 2 * wPad - filter.n_rows + 1;
+    const size_t outCols = input.n_cols + 2 * hPad - filter.n_cols + 1;
+
+    arma::Mat<eT> columns(outRows * outCols, filter.n_elem);
+    Im2Col(input.memptr(), input.n_rows, input.n_cols, filter.n_rows,
+        filter.n_cols, 1, 1, wPad, hPad, outRows, outCols, columns.memptr());
+
+    // The output may be a slice of a cube, so write into its memory.
+    output.set_size(outRows, outCols);
+    arma::Mat<eT> outputVec(output.memptr(), output.n_elem, 1, false, true);
+    outputVec = columns * arma::vectorise(filter);
+  }
+
+  /*
+   * Unfold all of the input maps into one matrix, such that column
+   * (i * filterSize + k) holds element k of the filter-sized patch at each
+   * output position, in input map i.
+   */
+  template<typename eT>
+  static void Im2ColMaps(const arma::Cube<eT>& input,
+                         const size_t filterRows,
+                         const size_t filterCols,
+                         const size_t xStride,
+                         const size_t yStride,
+                         const size_t wPad,
+                         const size_t hPad,
+                         const size_t outRows,
+                         const size_t outCols,
+                         arma::Mat<eT>& columns)
+  {
+    const size_t filterSize = filterRows * filterCols;
+    columns.set_size(outRows * outCols, input.n_slices * filterSize);
+    for (size_t i = 0; i < input.n_slices; ++i)
+    {
+      Im2Col(input.slice_memptr(i), input.n_rows, input.n_cols, filterRows,
+          filterCols, xStride, yStride, wPad, hPad, outRows, outCols,
+          columns.colptr(i * filterSize));
+    }
+  }
+
+  /*
+   * Unfold a single column-major input map into filterRows * filterCols
+   * consecutive columns of length outRows * outCols.  Positions that fall into
+   * the padding are zero.
+   */
+  template<typename eT>
+  static void Im2Col(const eT* input,
+                     const size_t rows,
+                     const size_t cols,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t xStride,
+                     const size_t yStride,
+                     const size_t wPad,
+                     const size_t hPad,
+                     const size_t outRows,
+                     const size_t outCols,
+                     eT* columns)
+  {
+    for (size_t kj = 0; kj < filterCols; ++kj)
+    {
+      for (size_t ki = 0; ki < filterRows; ++ki)
+      {
+        for (size_t j = 0; j < outCols; ++j)
+        {
+          const size_t col = j * yStride + kj;
+          if (col < hPad || col >= cols + hPad)
+          {
+            std::fill(columns, columns + outRows, eT(0));
+            columns += outRows;
+            continue;
+          }
+
+          const eT* inputCol = input + (col - hPad) * rows;
+          for (size_t i = 0; i < outRows; ++i, ++columns)
+          {
+            const size_t row = i * xStride + ki;
+            *columns = (row < wPad || row >= rows + wPad) ? eT(0) :
+                inputCol[row - wPad];
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * The adjoint of Im2Col(): add the unfolded columns back onto the positions
+   * of the input map they were taken from.
+   */
+  template<typename eT>
+  static void Col2Im(const eT* columns,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t xStride,
+                     const size_t yStride,
+                     const size_t wPad,
+                     const size_t hPad,
+                     const size_t outRows,
+                     const size_t outCols,
+                     const size_t rows,
+                     const size_t cols,
+                     eT* output)
+  {
+    for (size_t kj = 0; kj < filterCols; ++kj)
+    {
+      for (size_t ki = 0; ki < filterRows; ++ki)
+      {
+        for (size_t j = 0; j < outCols; ++j)
+        {
+          const size_t col = j * yStride + kj;
+          if (col < hPad || col >= cols + hPad)
+          {
+            columns += outRows;
+            continue;
+          }
+
+          eT* outputCol = output + (col - hPad) * rows;
+          for (size_t i = 0; i < outRows; ++i, ++columns)
+          {
+            const size_t row = i * xStride + ki;
+            if (row >= wPad && row < rows + wPad)
+              outputCol[row - wPad] += *columns;
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Arrange the filters of a layer into a matrix, such that column o holds the
+   * filters of output map o for all input maps, in the row order of the
+   * columns built by Im2ColMaps().
+   */
+  template<typename eT>
+  static void FilterMatrix(const arma::Cube<eT>& weights,
+                           const size_t inMaps,
+                           const size_t outMaps,
+                           arma::Mat<eT>& filters)
+  {
+    const size_t filterSize = weights.n_rows * weights.n_cols;
+    const arma::Mat<eT> weightsMat(const_cast<eT*>(weights.memptr()),
+        filterSize, inMaps * outMaps, false, true);
+
+    filters.set_size(inMaps * filterSize, outMaps);
+    for (size_t i = 0; i < inMaps; ++i)
+    {
+      filters.rows(i * filterSize, (i + 1) * filterSize - 1) =
+          weightsMat.cols(i * outMaps, (i + 1) * outMaps - 1);
+    }
+  }
+
+};  // class Im2ColConvolution
+
+//! Im2ColConvolution can convolve all maps of a layer at once.
+template<typename BorderMode>
+class ConvolutionRuleTraits<Im2ColConvolution<BorderMode> >
+{
+ public:
+  static const bool ConvolvesAllMaps = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
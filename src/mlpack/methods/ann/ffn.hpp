@@ -10,6 +10,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/ann/network_util.hpp>
+#include <mlpack/methods/ann/inference_network.hpp>
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
 #include <mlpack/methods/ann/performance_functions/cee_function.hpp>
@@ -25,12 +26,15 @@ namespace ann /** Artificial Neural Network. */ {
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  * @tparam PerformanceFunction Performance strategy used to calculate the error.
+ * @tparam MatType Type of the data and the parameters (arma::mat or
+ *         arma::fmat); the layers have to use the same matrix type.
  */
 template <
   typename LayerTypes,
   typename OutputLayerType,
   typename InitializationRuleType = NguyenWidrowInitialization,
-  class PerformanceFunction = CrossEntropyErrorFunction<>
+  class PerformanceFunction = CrossEntropyErrorFunction<>,
+  typename MatType = arma::mat
 >
 class FFN
 {
@@ -39,7 +43,11 @@ class FFN
   using NetworkType = FFN<LayerTypes,
                           OutputLayerType,
                           InitializationRuleType,
-                          PerformanceFunction>;
+                          PerformanceFunction,
+                          MatType>;
+
+  //! The element type of the data and the parameters.
+  typedef typename MatType::elem_type ElemType;
 
   /**
    * Create the FFN object with the given predictors and responses set (this is
@@ -62,8 +70,8 @@ class FFN
            template<typename> class OptimizerType>
   FFN(LayerType &&network,
       OutputType &&outputLayer,
-      const arma::mat& predictors,
-      const arma::mat& responses,
+      const MatType& predictors,
+      const MatType& responses,
       OptimizerType<NetworkType>& optimizer,
       InitializationRuleType initializeRule = InitializationRuleType(),
       PerformanceFunction performanceFunction = PerformanceFunction());
@@ -85,8 +93,8 @@ class FFN
   template<typename LayerType, typename OutputType>
   FFN(LayerType &&network,
       OutputType &&outputLayer,
-      const arma::mat& predictors,
-      const arma::mat& responses,
+      const MatType& predictors,
+      const MatType& responses,
       InitializationRuleType initializeRule = InitializationRuleType(),
       PerformanceFunction performanceFunction = PerformanceFunction());
 
@@ -108,6 +116,12 @@ class FFN
       InitializationRuleType initializeRule = InitializationRuleType(),
       PerformanceFunction performanceFunction = PerformanceFunction());
 
+  /**
+   * Release the layer activations and deltas that point into the memory of the
+   * network, since the layer modules may outlive the network.
+   */
+  ~FFN();
+
   /**
    * Train the feedforward network on the given input data. By default, the
    * RMSprop optimization algorithm is used, but others can be specified
@@ -124,7 +138,7 @@ class FFN
   template<
       template<typename> class OptimizerType = mlpack::optimization::RMSprop
   >
-  void Train(const arma::mat& predictors, const arma::mat& responses);
+  void Train(const MatType& predictors, const MatType& responses);
 
   /**
    * Train the feedforward network with the given instantiated optimizer.
@@ -158,8 +172,8 @@ class FFN
   template<
       template<typename> class OptimizerType = mlpack::optimization::RMSprop
   >
-  void Train(const arma::mat& predictors,
-             const arma::mat& responses,
+  void Train(const MatType& predictors,
+             const MatType& responses,
              OptimizerType<NetworkType>& optimizer);
 
   /**
@@ -170,7 +184,23 @@ class FFN
    * @param predictors Input predictors.
    * @param responses Matrix to put output predictions of responses into.
    */
-  void Predict(arma::mat& predictors, arma::mat& responses);
+  void Predict(MatType& predictors, MatType& responses);
+
+  /**
+   * Compile the trained network into an InferenceNetwork that only supports
+   * prediction. The inference network works on a copy of the current weights,
+   * so further training doesn't affect it.
+   *
+   * @tparam eT Element type of the inference network (double or float).
+   * @param maxBatchSize Maximum number of points that are predicted at once.
+   */
+  template<typename eT = ElemType>
+  InferenceNetwork<OutputLayerType, eT> Freeze(
+      const size_t maxBatchSize = 1) const
+  {
+    return InferenceNetwork<OutputLayerType, eT>(network, outputLayer,
+        maxBatchSize);
+  }
 
   /**
    * Evaluate the feedforward network with the given parameters. This function
@@ -181,7 +211,7 @@ class FFN
    * @param deterministic Whether or not to train or test the model. Note some
    * layer act differently in training or testing mode.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const MatType& parameters,
                   const size_t i,
                   const bool deterministic = true);
 
@@ -194,17 +224,52 @@ class FFN
    * @param i Index of points to use for objective function gradient evaluation.
    * @param gradient Matrix to output gradient into.
    */
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const MatType& parameters,
                 const size_t i,
-                arma::mat& gradient);
+                MatType& gradient);
+
+  /**
+   * Evaluate the feedforward network with the given parameters on a batch of
+   * consecutive points.  The points are propagated through the network
+   * together, so each layer works on a matrix of points instead of a single
+   * vector.  This is used by optimizers that work on mini-batches, such as
+   * mlpack::optimization::MiniBatchSGD.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   * @param deterministic Whether or not to train or test the model. Note some
+   * layer act differently in training or testing mode.
+   * @return The sum of the objective over the points in the batch.
+   */
+  double EvaluateBatch(const MatType& parameters,
+                       const size_t begin,
+                       const size_t batchSize,
+                       const bool deterministic = true);
+
+  /**
+   * Evaluate the gradient of the feedforward network with the given
+   * parameters, with respect to a batch of consecutive points.  The points are
+   * propagated forward and backward through the network together, and the
+   * gradient is the sum of the gradients of the points in the batch.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points in the batch.
+   */
+  void GradientBatch(const MatType& parameters,
+                     const size_t begin,
+                     MatType& gradient,
+                     const size_t batchSize);
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
   //! Return the initial point for the optimization.
-  const arma::mat& Parameters() const { return parameter; }
+  const MatType& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
-  arma::mat& Parameters() { return parameter; }
+  MatType& Parameters() { return parameter; }
 
   //! Serialize the model.
   template<typename Archive>
@@ -268,7 +333,10 @@ private:
   typename std::enable_if<I == sizeof...(Tp), void>::type
   ForwardTail(std::tuple<Tp...>& network)
   {
-    LinkParameter(network);
+    // Once the buffers are planned, the input of each layer already points to
+    // the output of the previous layer.
+    if (outputRows.empty())
+      LinkParameter(network);
   }
 
   template<size_t I = 1, typename... Tp>
@@ -322,7 +390,9 @@ private:
   /**
    * Run a single iteration of the feed backward algorithm, using the given
    * error of the output layer. Note that we iterate backward through the
-   * layer modules.
+   * layer modules. The gradient of each layer is updated as soon as the delta
+   * of the following layer is available, so that the delta isn't needed any
+   * more once the layer has calculated its own delta.
    */
   template<size_t I = 1, typename DataType, typename... Tp>
   typename std::enable_if<I < (sizeof...(Tp) - 1), void>::type
@@ -337,13 +407,20 @@ private:
 
   template<size_t I = 1, typename DataType, typename... Tp>
   typename std::enable_if<I == (sizeof...(Tp)), void>::type
-  BackwardTail(const DataType& /* unused */,
-               std::tuple<Tp...>& /* unused */) { /* Nothing to do here */ }
+  BackwardTail(const DataType& /* unused */, std::tuple<Tp...>& network)
+  {
+    Update(std::get<0>(network), std::get<0>(network).OutputParameter(),
+           std::get<1>(network).Delta());
+  }
 
   template<size_t I = 1, typename DataType, typename... Tp>
   typename std::enable_if<I < (sizeof...(Tp)), void>::type
   BackwardTail(const DataType& error, std::tuple<Tp...>& network)
   {
+    Update(std::get<sizeof...(Tp) - I>(network),
+           std::get<sizeof...(Tp) - I>(network).OutputParameter(),
+           std::get<sizeof...(Tp) - I + 1>(network).Delta());
+
     std::get<sizeof...(Tp) - I>(network).Backward(
         std::get<sizeof...(Tp) - I>(network).OutputParameter(),
         std::get<sizeof...(Tp) - I + 1>(network).Delta(),
@@ -353,31 +430,9 @@ private:
   }
 
   /**
-   * Iterate through all layer modules and update the the gradient using the
-   * layer defined optimizer.
+   * Update the gradient of the given layer using the delta of the following
+   * layer.
    */
-  template<
-      size_t I = 0,
-      size_t Max = std::tuple_size<LayerTypes>::value - 1,
-      typename... Tp
-  >
-  typename std::enable_if<I == Max, void>::type
-  UpdateGradients(std::tuple<Tp...>& /* unused */) { /* Nothing to do here */ }
-
-  template<
-      size_t I = 0,
-      size_t Max = std::tuple_size<LayerTypes>::value - 1,
-      typename... Tp
-  >
-  typename std::enable_if<I < Max, void>::type
-  UpdateGradients(std::tuple<Tp...>& network)
-  {
-    Update(std::get<I>(network), std::get<I>(network).OutputParameter(),
-           std::get<I + 1>(network).Delta());
-
-    UpdateGradients<I + 1, Max, Tp...>(network);
-  }
-
   template<typename T, typename P, typename D>
   typename std::enable_if<
       HasGradientCheck<T, P&(T::*)()>::value, void>::type
@@ -405,6 +460,109 @@ private:
         network).OutputParameter(), output);
   }
 
+  /**
+   * Plan the layer activations and deltas for a pass over the given number of
+   * points, grow the memory arena if it is too small to hold them, and point
+   * the layers into the arena. Training keeps the activations of all layers
+   * for the backward pass, while the deltas alternate between two buffers.
+   * Testing only keeps the activations of two consecutive layers, which
+   * alternate between two buffers as well. Nothing is done before the first
+   * pass, since the layer sizes are only known afterwards.
+   *
+   * @param batchSize Number of points in the pass.
+   * @param training Whether or not the deltas have to be planned as well.
+   */
+  void PlanBuffers(const size_t batchSize, const bool training);
+
+  /**
+   * Record the number of rows of the activation of each layer.
+   */
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  RecordOutputRows(std::tuple<Tp...>& /* unused */) { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  RecordOutputRows(std::tuple<Tp...>& network)
+  {
+    outputRows.push_back(std::get<I>(network).OutputParameter().n_rows);
+    RecordOutputRows<I + 1, Tp...>(network);
+  }
+
+  /**
+   * Point the activation, the input and the delta of each layer to the
+   * planned offset in the memory arena.
+   */
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  LinkBuffers(std::tuple<Tp...>& /* unused */,
+              const size_t /* unused */,
+              const bool /* unused */) { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  LinkBuffers(std::tuple<Tp...>& network,
+              const size_t batchSize,
+              const bool training)
+  {
+    LinkBuffer(std::get<I>(network).OutputParameter(), outputOffsets[I],
+        outputRows[I], batchSize);
+
+    if (training && I > 0)
+    {
+      LinkBuffer(std::get<I>(network).InputParameter(), outputOffsets[I - 1],
+          outputRows[I - 1], batchSize);
+      LinkBuffer(std::get<I>(network).Delta(), deltaOffsets[I % 2],
+          outputRows[I - 1], batchSize);
+    }
+    else if (I > 0)
+    {
+      // The memory arena may have moved, so don't keep stale views around.
+      std::get<I>(network).InputParameter().reset();
+      std::get<I>(network).Delta().reset();
+    }
+
+    LinkBuffers<I + 1, Tp...>(network, batchSize, training);
+  }
+
+  //! Point the given matrix to the given offset in the memory arena.
+  void LinkBuffer(MatType& buffer,
+                  const size_t offset,
+                  const size_t rows,
+                  const size_t cols)
+  {
+    buffer = MatType(buffers.memptr() + offset, rows, cols, false, false);
+  }
+
+  //! Other data types (such as cubes) keep their own memory.
+  template<typename DataType>
+  void LinkBuffer(DataType& /* unused */,
+                  const size_t /* unused */,
+                  const size_t /* unused */,
+                  const size_t /* unused */) { /* Nothing to do here */ }
+
+  /**
+   * Release the layer activations, inputs and deltas that point into the
+   * memory arena.
+   */
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  ReleaseBuffers(std::tuple<Tp...>& /* unused */) { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  ReleaseBuffers(std::tuple<Tp...>& network)
+  {
+    std::get<I>(network).OutputParameter().reset();
+    if (I > 0)
+    {
+      std::get<I>(network).InputParameter().reset();
+      std::get<I>(network).Delta().reset();
+    }
+
+    ReleaseBuffers<I + 1, Tp...>(network);
+  }
+
   //! Instantiated feedforward network.
   LayerTypes network;
 
@@ -418,19 +576,31 @@ private:
   bool deterministic;
 
   //! Matrix of (trained) parameters.
-  arma::mat parameter;
+  MatType parameter;
 
   //! The matrix of data points (predictors).
-  arma::mat predictors;
+  MatType predictors;
 
   //! The matrix of responses to the input data points.
-  arma::mat responses;
+  MatType responses;
 
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
   //! Locally stored backward error.
-  arma::mat error;
+  MatType error;
+
+  //! Memory arena that holds the layer activations and deltas.
+  MatType buffers;
+
+  //! The number of rows of the activation of each layer.
+  std::vector<size_t> outputRows;
+
+  //! The offset of the activation of each layer in the memory arena.
+  std::vector<size_t> outputOffsets;
+
+  //! The offsets of the two alternating delta buffers in the memory arena.
+  size_t deltaOffsets[2];
 }; // class FFN
 
 } // namespace ann
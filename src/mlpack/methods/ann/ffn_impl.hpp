@@ -17,20 +17,21 @@ namespace ann /** Artificial Neural Network. */ {
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 template<typename LayerType,
          typename OutputType,
          template<typename> class OptimizerType
 >
-FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::FFN(LayerType &&network,
-       OutputType &&outputLayer,
-       const arma::mat& predictors,
-       const arma::mat& responses,
-       OptimizerType<NetworkType>& optimizer,
-       InitializationRuleType initializeRule,
-       PerformanceFunction performanceFunction) :
+FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+    MatType>::FFN(LayerType &&network,
+                  OutputType &&outputLayer,
+                  const MatType& predictors,
+                  const MatType& responses,
+                  OptimizerType<NetworkType>& optimizer,
+                  InitializationRuleType initializeRule,
+                  PerformanceFunction performanceFunction) :
     network(std::forward<LayerType>(network)),
     outputLayer(std::forward<OutputType>(outputLayer)),
     performanceFunc(std::move(performanceFunction)),
@@ -61,16 +62,17 @@ FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 template<typename LayerType, typename OutputType>
-FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::FFN(LayerType &&network,
-       OutputType &&outputLayer,
-       const arma::mat& predictors,
-       const arma::mat& responses,
-       InitializationRuleType initializeRule,
-       PerformanceFunction performanceFunction) :
+FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+    MatType>::FFN(LayerType &&network,
+                  OutputType &&outputLayer,
+                  const MatType& predictors,
+                  const MatType& responses,
+                  InitializationRuleType initializeRule,
+                  PerformanceFunction performanceFunction) :
     network(std::forward<LayerType>(network)),
     outputLayer(std::forward<OutputType>(outputLayer)),
     performanceFunc(std::move(performanceFunction))
@@ -92,14 +94,15 @@ FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 template<typename LayerType, typename OutputType>
-FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::FFN(LayerType &&network,
-       OutputType &&outputLayer,
-       InitializationRuleType initializeRule,
-       PerformanceFunction performanceFunction) :
+FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+    MatType>::FFN(LayerType &&network,
+                  OutputType &&outputLayer,
+                  InitializationRuleType initializeRule,
+                  PerformanceFunction performanceFunction) :
     network(std::forward<LayerType>(network)),
     outputLayer(std::forward<OutputType>(outputLayer)),
     performanceFunc(std::move(performanceFunction))
@@ -119,12 +122,25 @@ FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
+>
+FFN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+    MatType>::~FFN()
+{
+  ReleaseBuffers(network);
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction,
+         typename MatType
 >
 template<template<typename> class OptimizerType>
 void FFN<
-LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Train(const arma::mat& predictors, const arma::mat& responses)
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::Train(const MatType& predictors, const MatType& responses)
 {
   numFunctions = predictors.n_cols;
   this->predictors = predictors;
@@ -144,14 +160,15 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 template<template<typename> class OptimizerType>
 void FFN<
-LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Train(const arma::mat& predictors,
-         const arma::mat& responses,
-         OptimizerType<NetworkType>& optimizer)
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::Train(const MatType& predictors,
+                const MatType& responses,
+                OptimizerType<NetworkType>& optimizer)
 {
   numFunctions = predictors.n_cols;
   this->predictors = predictors;
@@ -169,14 +186,15 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 template<
     template<typename> class OptimizerType
 >
 void FFN<
-LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Train(OptimizerType<NetworkType>& optimizer)
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::Train(OptimizerType<NetworkType>& optimizer)
 {
   // Train the model.
   Timer::Start("ffn_optimization");
@@ -190,91 +208,168 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 void FFN<
-LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Predict(arma::mat& predictors, arma::mat& responses)
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::Predict(MatType& predictors, MatType& responses)
 {
   deterministic = true;
 
-  arma::mat responsesTemp;
+  // All points are propagated through the network at once.
   ResetParameter(network);
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true),
-      network);
-  OutputPrediction(responsesTemp, network);
+  PlanBuffers(predictors.n_cols, false);
+  Forward(predictors, network);
+  if (outputRows.empty())
+    RecordOutputRows(network);
 
-  responses = arma::mat(responsesTemp.n_elem, predictors.n_cols);
-  responses.col(0) = responsesTemp.col(0);
+  OutputPrediction(responses, network);
+}
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
-  {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true),
-        network);
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction,
+         typename MatType
+>
+double FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::Evaluate(const MatType& parameters,
+                   const size_t i,
+                   const bool deterministic)
+{
+  return EvaluateBatch(parameters, i, 1, deterministic);
+}
 
-    responsesTemp = arma::mat(responses.colptr(i), responses.n_rows, 1, false,
-        true);
-    OutputPrediction(responsesTemp, network);
-    responses.col(i) = responsesTemp.col(0);
-  }
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction,
+         typename MatType
+>
+void FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::Gradient(const MatType& parameters,
+                   const size_t i,
+                   MatType& gradient)
+{
+  GradientBatch(parameters, i, gradient, 1);
 }
 
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 double FFN<
-LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Evaluate(const arma::mat& /* unused */,
-            const size_t i,
-            const bool deterministic)
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::EvaluateBatch(const MatType& /* unused */,
+                        const size_t begin,
+                        const size_t batchSize,
+                        const bool deterministic)
 {
   this->deterministic = deterministic;
 
   ResetParameter(network);
+  PlanBuffers(batchSize, !deterministic);
 
-  Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true),
-      network);
+  // The columns of the batch are used in place.
+  Forward(MatType(const_cast<ElemType*>(predictors.colptr(begin)),
+      predictors.n_rows, batchSize, false, true), network);
+  if (outputRows.empty())
+    RecordOutputRows(network);
 
-  return OutputError(arma::mat(responses.colptr(i), responses.n_rows, 1, false,
-      true), error, network);
+  return OutputError(MatType(const_cast<ElemType*>(responses.colptr(begin)),
+      responses.n_rows, batchSize, false, true), error, network);
 }
 
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
 >
 void FFN<
-LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Gradient(const arma::mat& /* unused */,
-            const size_t i,
-            arma::mat& gradient)
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::GradientBatch(const MatType& /* unused */,
+                        const size_t begin,
+                        MatType& gradient,
+                        const size_t batchSize)
 {
   if (gradient.is_empty())
   {
-    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
   }
 
-
-  Evaluate(parameter, i, false);
+  EvaluateBatch(parameter, begin, batchSize, false);
 
   NetworkGradients(gradient, network);
 
   Backward<>(error, network);
-  UpdateGradients<>(network);
 }
 
 template<typename LayerTypes,
          typename OutputLayerType,
          typename InitializationRuleType,
-         typename PerformanceFunction
+         typename PerformanceFunction,
+         typename MatType
+>
+void FFN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::PlanBuffers(const size_t batchSize, const bool training)
+{
+  // The layer sizes are only known after the first pass.
+  if (outputRows.empty())
+    return;
+
+  size_t maxRows = 0;
+  for (size_t i = 0; i < outputRows.size(); ++i)
+    maxRows = std::max(maxRows, outputRows[i]);
+
+  // The delta of a layer has the size of its input, so the largest activation
+  // bounds the size of both alternating delta buffers.
+  outputOffsets.resize(outputRows.size());
+  size_t size = 0;
+  if (training)
+  {
+    for (size_t i = 0; i < outputRows.size(); ++i)
+    {
+      outputOffsets[i] = size;
+      size += outputRows[i] * batchSize;
+    }
+
+    deltaOffsets[0] = size;
+    deltaOffsets[1] = size + maxRows * batchSize;
+    size += 2 * maxRows * batchSize;
+  }
+  else
+  {
+    for (size_t i = 0; i < outputRows.size(); ++i)
+      outputOffsets[i] = (i % 2) * maxRows * batchSize;
+
+    size = 2 * maxRows * batchSize;
+  }
+
+  // The arena only grows, so after the first batch of each size no memory is
+  // allocated for the layers any more.
+  if (buffers.n_elem < size)
+    buffers.set_size(size, 1);
+
+  LinkBuffers(network, batchSize, training);
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction,
+         typename MatType
 >
 template<typename Archive>
 void FFN<
-LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Serialize(Archive& ar, const unsigned int /* version */)
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction,
+MatType>::Serialize(Archive& ar, const unsigned int /* version */)
 {
   ar & data::CreateNVP(parameter, "parameter");
 
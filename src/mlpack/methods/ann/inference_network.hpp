@@ -0,0 +1,232 @@
+/**
+ * @file inference_network.hpp
+ *
+ * Definition of the InferenceNetwork class, which freezes a trained feed
+ * forward network into a form that only supports prediction.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_NETWORK_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_NETWORK_HPP
+
+#include <mlpack/core.hpp>
+
+#include <mlpack/methods/ann/activation_functions/identity_function.hpp>
+#include <mlpack/methods/ann/layer/linear_layer.hpp>
+#include <mlpack/methods/ann/layer/bias_layer.hpp>
+#include <mlpack/methods/ann/layer/base_layer.hpp>
+#include <mlpack/methods/ann/layer/dropout_layer.hpp>
+#include <mlpack/methods/ann/layer/dropconnect_layer.hpp>
+#include <mlpack/methods/ann/layer/softmax_layer.hpp>
+#include <mlpack/methods/ann/layer/log_softmax_layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An inference-only version of a trained feed forward network. The layers of
+ * the network are compiled into a short list of stages:
+ *
+ *  - a LinearLayer or DropConnectLayer becomes a matrix multiplication,
+ *  - a following BiasLayer is folded into the bias of that stage,
+ *  - a following BaseLayer is fused with the bias, so that both are applied
+ *    in a single pass over the output of the matrix multiplication,
+ *  - a DropoutLayer only scales its input in testing mode, so it is folded
+ *    into the weights of the next stage,
+ *  - SoftmaxLayer and LogSoftmaxLayer are kept as separate stages.
+ *
+ * A network that contains any other layer doesn't compile.
+ *
+ * The buffers are allocated once for a maximum batch size, so predicting up
+ * to that many points doesn't allocate any memory. The weights can be stored
+ * in single precision (eT = float), in which case the predictors have to be
+ * given in single precision as well.
+ *
+ * The network is compiled from a copy of the weights, so it is not affected
+ * by any further training of the original network.
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam eT Element type of the weights and the data (double or float).
+ */
+template<typename OutputLayerType, typename eT = double>
+class InferenceNetwork
+{
+ public:
+  /**
+   * Compile the given trained network modules.
+   *
+   * @param network Trained network modules.
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param maxBatchSize Maximum number of points that are predicted at once.
+   */
+  template<typename... Tp>
+  InferenceNetwork(const std::tuple<Tp...>& network,
+                   const OutputLayerType& outputLayer,
+                   const size_t maxBatchSize = 1);
+
+  /**
+   * Predict the responses to the given predictors. The responses will reflect
+   * the output of the given output layer as returned by the OutputClass()
+   * function. More than MaxBatchSize() predictors are predicted in batches of
+   * MaxBatchSize() points.
+   *
+   * @param predictors Input predictors.
+   * @param responses Matrix to put output predictions of responses into.
+   */
+  void Predict(const arma::Mat<eT>& predictors, arma::Mat<eT>& responses);
+
+  //! Get the maximum number of points that are predicted at once.
+  size_t MaxBatchSize() const { return maxBatchSize; }
+
+  //! Get the number of stages of the compiled network.
+  size_t NumStages() const { return stages.size(); }
+
+ private:
+  //! The operation of a stage.
+  enum StageType
+  {
+    DENSE,
+    ELEMENTWISE,
+    SOFTMAX,
+    LOG_SOFTMAX
+  };
+
+  //! Function that adds the bias and applies the activation function in place.
+  typedef void (*ActivationType)(arma::Mat<eT>& x, const arma::Col<eT>& bias);
+
+  //! A single stage of the compiled network.
+  struct Stage
+  {
+    //! The operation of the stage.
+    StageType type;
+    //! The weights of a dense stage.
+    arma::Mat<eT> weights;
+    //! The scale of an elementwise stage.
+    eT scale;
+    //! The bias (empty if there is none).
+    arma::Col<eT> bias;
+    //! The activation function (NULL for the identity function).
+    ActivationType activation;
+    //! The number of output rows.
+    size_t rows;
+  };
+
+  /**
+   * Compile the layers of the network, one after another.
+   */
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  AddLayers(const std::tuple<Tp...>& /* unused */) { /* Nothing to do here */ }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  AddLayers(const std::tuple<Tp...>& network)
+  {
+    AddLayer(std::get<I>(network));
+    AddLayers<I + 1, Tp...>(network);
+  }
+
+  //! Add a matrix multiplication stage.
+  template<typename InputDataType, typename OutputDataType>
+  void AddLayer(const LinearLayer<InputDataType, OutputDataType>& layer)
+  {
+    AddDense(layer.Weights());
+  }
+
+  //! Add a matrix multiplication stage; the connections are only dropped
+  //! during training.
+  template<typename InputLayer, typename InputDataType, typename OutputDataType>
+  void AddLayer(
+      const DropConnectLayer<InputLayer, InputDataType, OutputDataType>& layer)
+  {
+    AddDense(layer.Weights());
+  }
+
+  //! Fold the bias into the previous stage.
+  template<typename InputDataType, typename OutputDataType>
+  void AddLayer(const BiasLayer<InputDataType, OutputDataType>& layer);
+
+  //! Fuse the activation function with the previous stage.
+  template<
+      class ActivationFunction,
+      typename InputDataType,
+      typename OutputDataType
+  >
+  void AddLayer(
+      const BaseLayer<ActivationFunction, InputDataType, OutputDataType>& layer);
+
+  //! Fold the scale of the testing mode into the next stage.
+  template<typename InputDataType, typename OutputDataType>
+  void AddLayer(const DropoutLayer<InputDataType, OutputDataType>& layer);
+
+  //! Add a softmax stage.
+  template<typename InputDataType, typename OutputDataType>
+  void AddLayer(const SoftmaxLayer<InputDataType, OutputDataType>& /* layer */)
+  {
+    AddStage(SOFTMAX);
+  }
+
+  //! Add a log softmax stage.
+  template<typename InputDataType, typename OutputDataType>
+  void AddLayer(
+      const LogSoftmaxLayer<InputDataType, OutputDataType>& /* layer */)
+  {
+    AddStage(LOG_SOFTMAX);
+  }
+
+  //! Any other layer (such as the convolutional layers) can't be compiled.
+  template<typename LayerType>
+  void AddLayer(const LayerType& /* layer */)
+  {
+    static_assert(sizeof(LayerType) == 0, "Only LinearLayer, DropConnectLayer, "
+        "BiasLayer, BaseLayer, DropoutLayer, SoftmaxLayer and LogSoftmaxLayer "
+        "can be compiled into an InferenceNetwork.");
+  }
+
+  //! Add a matrix multiplication stage with the given weights.
+  template<typename MatType>
+  void AddDense(const MatType& weights);
+
+  //! Add a stage of the given type, after applying any pending scale.
+  void AddStage(const StageType type);
+
+  //! Return true if the last stage can take a bias or an activation function.
+  bool LastStageIsOpen() const
+  {
+    return !stages.empty() && (stages.back().type == DENSE ||
+        stages.back().type == ELEMENTWISE) && !stages.back().activation;
+  }
+
+  //! Run the given stage on the given input.
+  void Forward(const Stage& stage,
+               const arma::Mat<eT>& input,
+               arma::Mat<eT>& output);
+
+  //! Add the bias and apply the activation function in a single pass.
+  template<typename ActivationFunction>
+  static void Activate(arma::Mat<eT>& x, const arma::Col<eT>& bias);
+
+  //! The compiled stages.
+  std::vector<Stage> stages;
+
+  //! The output layer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! The maximum number of points that are predicted at once.
+  size_t maxBatchSize;
+
+  //! The number of rows of the predictors.
+  size_t inputSize;
+
+  //! The scale of a dropout layer that still has to be applied.
+  eT pendingScale;
+
+  //! The two buffers that the stages alternately write their output into.
+  arma::Mat<eT> buffers[2];
+}; // class InferenceNetwork
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "inference_network_impl.hpp"
+
+#endif
@@ -0,0 +1,299 @@
+/**
+ * @file inference_network_impl.hpp
+ *
+ * Implementation of the InferenceNetwork class, which freezes a trained feed
+ * forward network into a form that only supports prediction.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_NETWORK_IMPL_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_NETWORK_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "inference_network.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename eT>
+template<typename... Tp>
+InferenceNetwork<OutputLayerType, eT>::InferenceNetwork(
+    const std::tuple<Tp...>& network,
+    const OutputLayerType& outputLayer,
+    const size_t maxBatchSize) :
+    outputLayer(outputLayer),
+    maxBatchSize(std::max(maxBatchSize, (size_t) 1)),
+    inputSize(0),
+    pendingScale(1)
+{
+  AddLayers(network);
+
+  // A dropout layer at the end of the network still has to scale the output.
+  if (pendingScale != 1)
+    AddStage(ELEMENTWISE);
+
+  if (stages.empty())
+  {
+    Log::Fatal << "InferenceNetwork::InferenceNetwork(): the network doesn't "
+        << "contain a LinearLayer or DropConnectLayer!" << std::endl;
+  }
+
+  // The stages alternately read from one buffer and write into the other, so
+  // two buffers of the largest stage are enough for the whole network.
+  size_t maxRows = 0;
+  for (size_t i = 0; i < stages.size(); ++i)
+    maxRows = std::max(maxRows, stages[i].rows);
+
+  buffers[0].set_size(maxRows, this->maxBatchSize);
+  buffers[1].set_size(maxRows, this->maxBatchSize);
+}
+
+template<typename OutputLayerType, typename eT>
+void InferenceNetwork<OutputLayerType, eT>::Predict(
+    const arma::Mat<eT>& predictors,
+    arma::Mat<eT>& responses)
+{
+  if (predictors.n_rows != inputSize)
+  {
+    Log::Fatal << "InferenceNetwork::Predict(): the predictors have "
+        << predictors.n_rows << " dimensions, but the network expects "
+        << inputSize << "!" << std::endl;
+  }
+
+  responses.set_size(stages.back().rows, predictors.n_cols);
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += maxBatchSize)
+  {
+    const size_t n = std::min(maxBatchSize, predictors.n_cols - begin);
+
+    // The first stage reads the predictors directly; all other stages read
+    // from and write into the preallocated buffers.
+    const arma::Mat<eT> input(const_cast<eT*>(predictors.colptr(begin)),
+        predictors.n_rows, n, false, true);
+
+    size_t current = 0;
+    for (size_t i = 0; i < stages.size(); ++i, current = 1 - current)
+    {
+      arma::Mat<eT> output(buffers[current].memptr(), stages[i].rows, n, false,
+          true);
+
+      if (i == 0)
+      {
+        Forward(stages[i], input, output);
+      }
+      else
+      {
+        const arma::Mat<eT> previous(buffers[1 - current].memptr(),
+            stages[i - 1].rows, n, false, true);
+        Forward(stages[i], previous, output);
+      }
+    }
+
+    const arma::Mat<eT> last(buffers[1 - current].memptr(), stages.back().rows,
+        n, false, true);
+    arma::Mat<eT> prediction(responses.colptr(begin), responses.n_rows, n,
+        false, true);
+    outputLayer.OutputClass(last, prediction);
+  }
+}
+
+template<typename OutputLayerType, typename eT>
+template<typename InputDataType, typename OutputDataType>
+void InferenceNetwork<OutputLayerType, eT>::AddLayer(
+    const BiasLayer<InputDataType, OutputDataType>& layer)
+{
+  const arma::Col<eT> bias = arma::conv_to<arma::Col<eT> >::from(
+      arma::vectorise(layer.Weights()) * layer.Bias());
+
+  AddStage(ELEMENTWISE);
+  Stage& stage = stages.back();
+  if (stage.bias.is_empty())
+    stage.bias = bias;
+  else
+    stage.bias += bias;
+}
+
+template<typename OutputLayerType, typename eT>
+template<
+    class ActivationFunction,
+    typename InputDataType,
+    typename OutputDataType
+>
+void InferenceNetwork<OutputLayerType, eT>::AddLayer(
+    const BaseLayer<ActivationFunction, InputDataType, OutputDataType>&
+        /* layer */)
+{
+  AddStage(ELEMENTWISE);
+
+  // The identity function leaves the stage open for a following bias.
+  if (!std::is_same<ActivationFunction, IdentityFunction>::value)
+    stages.back().activation = &Activate<ActivationFunction>;
+}
+
+template<typename OutputLayerType, typename eT>
+template<typename InputDataType, typename OutputDataType>
+void InferenceNetwork<OutputLayerType, eT>::AddLayer(
+    const DropoutLayer<InputDataType, OutputDataType>& layer)
+{
+  // In testing mode the dropout layer only scales its input.
+  if (!layer.Rescale())
+    return;
+
+  const eT scale = eT(1.0 / (1.0 - layer.Ratio()));
+  if (pendingScale == 1 && LastStageIsOpen())
+  {
+    // The output of the last stage is linear in its parameters, so the scale
+    // can be folded into them.
+    Stage& stage = stages.back();
+    if (stage.type == DENSE)
+      stage.weights *= scale;
+    else
+      stage.scale *= scale;
+
+    stage.bias *= scale;
+  }
+  else
+  {
+    pendingScale *= scale;
+  }
+}
+
+template<typename OutputLayerType, typename eT>
+template<typename MatType>
+void InferenceNetwork<OutputLayerType, eT>::AddDense(const MatType& weights)
+{
+  if (stages.empty())
+    inputSize = weights.n_cols;
+
+  Stage stage;
+  stage.type = DENSE;
+  stage.weights = arma::conv_to<arma::Mat<eT> >::from(weights);
+  stage.scale = 1;
+  stage.activation = NULL;
+  stage.rows = weights.n_rows;
+
+  // W * (s * x) = (s * W) * x, so the scale of a previous dropout layer is
+  // folded into the weights.
+  if (pendingScale != 1)
+  {
+    stage.weights *= pendingScale;
+    pendingScale = 1;
+  }
+
+  stages.push_back(stage);
+}
+
+template<typename OutputLayerType, typename eT>
+void InferenceNetwork<OutputLayerType, eT>::AddStage(const StageType type)
+{
+  if (stages.empty())
+  {
+    Log::Fatal << "InferenceNetwork::InferenceNetwork(): the first layer of "
+        << "the network has to be a LinearLayer or DropConnectLayer!"
+        << std::endl;
+  }
+
+  // An elementwise operation is merged into the last stage if that stage
+  // didn't apply an activation function yet.
+  if (type == ELEMENTWISE && pendingScale == 1 && LastStageIsOpen())
+    return;
+
+  Stage stage;
+  stage.type = (pendingScale != 1) ? ELEMENTWISE : type;
+  stage.scale = pendingScale;
+  stage.activation = NULL;
+  stage.rows = stages.back().rows;
+  stages.push_back(stage);
+  pendingScale = 1;
+
+  // Apply the pending scale first and then the requested operation.
+  if (type != ELEMENTWISE && stage.type == ELEMENTWISE)
+    AddStage(type);
+}
+
+template<typename OutputLayerType, typename eT>
+void InferenceNetwork<OutputLayerType, eT>::Forward(
+    const Stage& stage,
+    const arma::Mat<eT>& input,
+    arma::Mat<eT>& output)
+{
+  switch (stage.type)
+  {
+    case DENSE:
+      output = stage.weights * input;
+      break;
+
+    case ELEMENTWISE:
+      output = input * stage.scale;
+      break;
+
+    case SOFTMAX:
+      for (size_t j = 0; j < input.n_cols; ++j)
+      {
+        const eT* x = input.colptr(j);
+        eT* y = output.colptr(j);
+
+        const eT maxInput = *std::max_element(x, x + input.n_rows);
+        eT sum = 0;
+        for (size_t i = 0; i < input.n_rows; ++i)
+        {
+          y[i] = std::exp(x[i] - maxInput);
+          sum += y[i];
+        }
+
+        for (size_t i = 0; i < input.n_rows; ++i)
+          y[i] /= sum;
+      }
+      return;
+
+    case LOG_SOFTMAX:
+      for (size_t j = 0; j < input.n_cols; ++j)
+      {
+        const eT* x = input.colptr(j);
+        eT* y = output.colptr(j);
+
+        const eT maxInput = *std::max_element(x, x + input.n_rows);
+        eT sum = 0;
+        for (size_t i = 0; i < input.n_rows; ++i)
+          sum += std::exp(x[i] - maxInput);
+
+        const eT logSum = maxInput + std::log(sum);
+        for (size_t i = 0; i < input.n_rows; ++i)
+          y[i] = x[i] - logSum;
+      }
+      return;
+  }
+
+  // Add the bias and apply the activation function in the same pass over the
+  // output.
+  if (stage.activation)
+    stage.activation(output, stage.bias);
+  else if (!stage.bias.is_empty())
+    output.each_col() += stage.bias;
+}
+
+template<typename OutputLayerType, typename eT>
+template<typename ActivationFunction>
+void InferenceNetwork<OutputLayerType, eT>::Activate(
+    arma::Mat<eT>& x,
+    const arma::Col<eT>& bias)
+{
+  for (size_t j = 0; j < x.n_cols; ++j)
+  {
+    eT* column = x.colptr(j);
+
+    if (bias.is_empty())
+    {
+      for (size_t i = 0; i < x.n_rows; ++i)
+        column[i] = eT(ActivationFunction::fn(double(column[i])));
+    }
+    else
+    {
+      for (size_t i = 0; i < x.n_rows; ++i)
+        column[i] = eT(ActivationFunction::fn(double(column[i] + bias[i])));
+    }
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -57,7 +57,9 @@ class BiasLayer
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   {
-    output = input + (weights * bias);
+    // Each column of the input is one sample of the batch.
+    output = input;
+    output.each_col() += weights * bias;
   }
 
   /**
@@ -106,7 +108,7 @@ class BiasLayer
                 const ErrorType& error,
                 GradientType& gradient)
   {
-    gradient = error * bias;
+    gradient = arma::sum(error, 1) * bias;
   }
 
   //! Get the weights.
@@ -114,6 +116,11 @@ class BiasLayer
   //! Modify the weights.
   InputDataType& Weights() { return weights; }
 
+  //! Get the bias value.
+  double Bias() const { return bias; }
+  //! Modify the bias value.
+  double& Bias() { return bias; }
+
   //! Get the input parameter.
   InputDataType const& InputParameter() const { return inputParameter; }
   //! Modify the input parameter.
@@ -11,6 +11,7 @@
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -19,6 +20,11 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the ConvLayer class. The ConvLayer class represents a
  * single layer of a neural network.
  *
+ * If a convolution rule can convolve all maps of the layer at once (see
+ * ConvolutionRuleTraits), like Im2ColConvolution, the layer hands the whole
+ * pass to the rule; otherwise each pair of input and output maps is convolved
+ * separately.  Only the former respect the stride and padding of the layer.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -80,21 +86,7 @@ class ConvLayer
   template<typename eT>
   void Forward(const arma::Cube<eT>& input, arma::Cube<eT>& output)
   {
-    const size_t wConv = ConvOutSize(input.n_rows, wfilter, xStride, wPad);
-    const size_t hConv = ConvOutSize(input.n_cols, hfilter, yStride, hPad);
-
-    output = arma::zeros<arma::Cube<eT> >(wConv, hConv, outMaps);
-    for (size_t outMap = 0, outMapIdx = 0; outMap < outMaps; outMap++)
-    {
-      for (size_t inMap = 0; inMap < inMaps; inMap++, outMapIdx++)
-      {
-        arma::Mat<eT> convOutput;
-        ForwardConvolutionRule::Convolution(input.slice(inMap),
-            weights.slice(outMap), convOutput);
-
-        output.slice(outMap) += convOutput;
-      }
-    }
+    ForwardMaps<ForwardConvolutionRule>(input, output);
   }
 
   /**
@@ -111,24 +103,7 @@ class ConvLayer
                 const arma::Cube<eT>& gy,
                 arma::Cube<eT>& g)
   {
-    g = arma::zeros<arma::Cube<eT> >(inputParameter.n_rows,
-                                     inputParameter.n_cols,
-                                     inputParameter.n_slices);
-
-    for (size_t outMap = 0, outMapIdx = 0; outMap < inMaps; outMap++)
-    {
-      for (size_t inMap = 0; inMap < outMaps; inMap++, outMapIdx++)
-      {
-        arma::Mat<eT> rotatedFilter;
-        Rotate180(weights.slice(outMap * outMaps + inMap), rotatedFilter);
-
-        arma::Mat<eT> output;
-        BackwardConvolutionRule::Convolution(gy.slice(inMap), rotatedFilter,
-            output);
-
-        g.slice(outMap) += output;
-      }
-    }
+    BackwardMaps<BackwardConvolutionRule>(gy, g);
   }
 
   /*
@@ -143,23 +118,7 @@ class ConvLayer
                 const arma::Cube<eT>& d,
                 arma::Cube<eT>& g)
   {
-    g = arma::zeros<arma::Cube<eT> >(weights.n_rows, weights.n_cols,
-        weights.n_slices);
-
-    for (size_t outMap = 0; outMap < outMaps; outMap++)
-    {
-      for (size_t inMap = 0, s = outMap; inMap < inMaps; inMap++, s += outMaps)
-      {
-        arma::Cube<eT> inputSlices = input.slices(inMap, inMap);
-        arma::Cube<eT> deltaSlices = d.slices(outMap, outMap);
-
-        arma::Cube<eT> output;
-        GradientConvolutionRule::Convolution(inputSlices, deltaSlices, output);
-
-        for (size_t i = 0; i < output.n_slices; i++)
-          g.slice(s) += output.slice(i);
-      }
-    }
+    GradientMaps<GradientConvolutionRule>(input, d, g);
   }
 
   //! Get the weights.
@@ -205,6 +164,145 @@ class ConvLayer
   }
 
  private:
+  /*
+   * Forward pass of a rule that convolves all maps at once.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<
+      ConvolutionRuleTraits<Rule>::ConvolvesAllMaps, void>::type
+  ForwardMaps(const arma::Cube<eT>& input, arma::Cube<eT>& output)
+  {
+    Rule::Forward(input, weights, outMaps, xStride, yStride, wPad, hPad,
+        output);
+  }
+
+  /*
+   * Forward pass of a rule that convolves one pair of maps at a time.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<
+      !ConvolutionRuleTraits<Rule>::ConvolvesAllMaps, void>::type
+  ForwardMaps(const arma::Cube<eT>& input, arma::Cube<eT>& output)
+  {
+    const size_t wConv = ConvOutSize(input.n_rows, wfilter, xStride, wPad);
+    const size_t hConv = ConvOutSize(input.n_cols, hfilter, yStride, hPad);
+
+    output = arma::zeros<arma::Cube<eT> >(wConv, hConv, outMaps);
+    for (size_t outMap = 0; outMap < outMaps; outMap++)
+    {
+      for (size_t inMap = 0; inMap < inMaps; inMap++)
+      {
+        arma::Mat<eT> convOutput;
+        Rule::Convolution(input.slice(inMap),
+            weights.slice(inMap * outMaps + outMap), convOutput);
+
+        output.slice(outMap) += convOutput;
+      }
+    }
+  }
+
+  /*
+   * Backward pass of a rule that convolves all maps at once.
+   *
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<
+      ConvolutionRuleTraits<Rule>::ConvolvesAllMaps, void>::type
+  BackwardMaps(const arma::Cube<eT>& gy, arma::Cube<eT>& g)
+  {
+    Rule::Backward(gy, weights, inputParameter.n_rows, inputParameter.n_cols,
+        xStride, yStride, wPad, hPad, g);
+  }
+
+  /*
+   * Backward pass of a rule that convolves one pair of maps at a time.
+   *
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<
+      !ConvolutionRuleTraits<Rule>::ConvolvesAllMaps, void>::type
+  BackwardMaps(const arma::Cube<eT>& gy, arma::Cube<eT>& g)
+  {
+    g = arma::zeros<arma::Cube<eT> >(inputParameter.n_rows,
+                                     inputParameter.n_cols,
+                                     inputParameter.n_slices);
+
+    for (size_t outMap = 0, outMapIdx = 0; outMap < inMaps; outMap++)
+    {
+      for (size_t inMap = 0; inMap < outMaps; inMap++, outMapIdx++)
+      {
+        arma::Mat<eT> rotatedFilter;
+        Rotate180(weights.slice(outMap * outMaps + inMap), rotatedFilter);
+
+        arma::Mat<eT> output;
+        Rule::Convolution(gy.slice(inMap), rotatedFilter, output);
+
+        g.slice(outMap) += output;
+      }
+    }
+  }
+
+  /*
+   * Gradient of a rule that convolves all maps at once.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param d The calculated error.
+   * @param g The calculated gradient.
+   */
+  template<typename Rule, typename eT>
+  typename std::enable_if<
+      ConvolutionRuleTraits<Rule>::ConvolvesAllMaps, void>::type
+  GradientMaps(const arma::Cube<eT>& input,
+               const arma::Cube<eT>& d,
+               arma::Cube<eT>& g)
+  {
+    Rule::Gradient(input, d, wfilter, hfilter, xStride, yStride, wPad, hPad,
+        g);
+  }
+
+  /*
+   * Gradient of a rule that convolves one pair of maps at a time.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param d The calculated error.
+   * @param g The calculated gradient.
+   */
+  template<typename Rule, typename InputType, typename eT>
+  typename std::enable_if<
+      !ConvolutionRuleTraits<Rule>::ConvolvesAllMaps, void>::type
+  GradientMaps(const InputType& input,
+               const arma::Cube<eT>& d,
+               arma::Cube<eT>& g)
+  {
+    g = arma::zeros<arma::Cube<eT> >(weights.n_rows, weights.n_cols,
+        weights.n_slices);
+
+    for (size_t outMap = 0; outMap < outMaps; outMap++)
+    {
+      for (size_t inMap = 0, s = outMap; inMap < inMaps; inMap++, s += outMaps)
+      {
+        arma::Cube<eT> inputSlices = input.slices(inMap, inMap);
+        arma::Cube<eT> deltaSlices = d.slices(outMap, outMap);
+
+        arma::Cube<eT> output;
+        Rule::Convolution(inputSlices, deltaSlices, output);
+
+        for (size_t i = 0; i < output.n_slices; i++)
+          g.slice(s) += output.slice(i);
+      }
+    }
+  }
+
   /*
    * Rotates a 3rd-order tesor counterclockwise by 180 degrees.
    *
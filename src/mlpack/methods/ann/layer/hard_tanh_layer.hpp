@@ -105,7 +105,7 @@ class HardTanHLayer
                 arma::Cube<eT>& g)
   {
     // Generate a cube using the backpropagated error matrix.
-    arma::Cube<eT> mappedError = arma::zeros<arma::cube>(input.n_rows,
+    arma::Cube<eT> mappedError = arma::zeros<arma::Cube<eT> >(input.n_rows,
         input.n_cols, input.n_slices);
 
     for (size_t s = 0, j = 0; s < mappedError.n_slices; s+= gy.n_cols, j++)
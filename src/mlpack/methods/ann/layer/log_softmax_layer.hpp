@@ -46,7 +46,7 @@ class LogSoftmaxLayer
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   {
-    arma::mat maxInput = arma::repmat(arma::max(input), input.n_rows, 1);
+    arma::Mat<eT> maxInput = arma::repmat(arma::max(input), input.n_rows, 1);
     output = (maxInput - input);
 
     // Approximation of the hyperbolic tangent. The acuracy however is
@@ -74,7 +74,9 @@ class LogSoftmaxLayer
       return 0.0;
     } );
 
-    output = input - (maxInput + std::log(arma::accu(output)));
+    // Each column of the input is one sample of the batch.
+    output = input - (maxInput + arma::repmat(arma::log(arma::sum(output)),
+        input.n_rows, 1));
   }
 
   /**
@@ -91,7 +93,9 @@ class LogSoftmaxLayer
                 const arma::Mat<eT>& gy,
                 arma::Mat<eT>& g)
   {
-    g = gy - arma::exp(input) * arma::accu(gy);
+    g = arma::exp(input);
+    g.each_row() %= arma::sum(gy);
+    g = gy - g;
   }
 
   //! Get the input parameter.
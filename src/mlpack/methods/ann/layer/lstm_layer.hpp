@@ -52,7 +52,9 @@ class LSTMLayer
       outSize(outSize),
       peepholes(peepholes),
       seqLen(1),
-      offset(0)
+      offset(0),
+      queryOffset(0),
+      batchSize(1)
   {
     if (peepholes)
     {
@@ -67,7 +69,9 @@ class LSTMLayer
 
   /**
    * Ordinary feed forward pass of a neural network, evaluating the function
-   * f(x) by propagating the activity forward through f.
+   * f(x) by propagating the activity forward through f. Each column of the
+   * input belongs to a different sequence, so several sequences of the same
+   * length can be propagated at once.
    *
    * @param input Input data used for evaluating the specified function.
    * @param output Resulting output activation.
@@ -75,60 +79,80 @@ class LSTMLayer
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   {
-    if (inGate.n_cols < seqLen)
+    // The first step of a window continues from the last state of the
+    // previous window, if there is one.
+    if (offset == 0)
     {
-      inGate = arma::zeros<InputDataType>(outSize, seqLen);
-      inGateAct = arma::zeros<InputDataType>(outSize, seqLen);
-      inGateError = arma::zeros<InputDataType>(outSize, seqLen);
-      outGate = arma::zeros<InputDataType>(outSize, seqLen);
-      outGateAct = arma::zeros<InputDataType>(outSize, seqLen);
-      outGateError = arma::zeros<InputDataType>(outSize, seqLen);
-      forgetGate = arma::zeros<InputDataType>(outSize, seqLen);
-      forgetGateAct = arma::zeros<InputDataType>(outSize, seqLen);
-      forgetGateError = arma::zeros<InputDataType>(outSize, seqLen);
-      state = arma::zeros<InputDataType>(outSize, seqLen);
-      stateError = arma::zeros<InputDataType>(outSize, seqLen);
-      cellAct = arma::zeros<InputDataType>(outSize, seqLen);
+      batchSize = input.n_cols;
+      prevState = lastState;
     }
 
+    if (inGate.n_cols < seqLen * batchSize)
+    {
+      inGate = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      inGateAct = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      inGateError = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      outGate = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      outGateAct = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      outGateError = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      forgetGate = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      forgetGateAct = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      forgetGateError = arma::zeros<InputDataType>(outSize,
+          seqLen * batchSize);
+      state = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      stateError = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+      cellAct = arma::zeros<InputDataType>(outSize, seqLen * batchSize);
+    }
+
+    const size_t begin = offset * batchSize;
+    const size_t end = begin + batchSize - 1;
+
     // Split up the inputactivation into the 3 parts (inGate, forgetGate,
     // outGate).
-    inGate.col(offset) = input.submat(0, 0, outSize - 1, 0);
+    inGate.cols(begin, end) = input.rows(0, outSize - 1);
+    forgetGate.cols(begin, end) = input.rows(outSize, (outSize * 2) - 1);
+    outGate.cols(begin, end) = input.rows(outSize * 3, (outSize * 4) - 1);
 
-    forgetGate.col(offset) = input.submat(outSize, 0, (outSize * 2) - 1, 0);
-    outGate.col(offset) = input.submat(outSize * 3, 0, (outSize * 4) - 1, 0);
-
-    if (peepholes && offset > 0)
+    const InputDataType previousState = PreviousState(offset);
+    if (peepholes && !previousState.is_empty())
     {
-      inGate.col(offset) += peepholeWeights.col(0) % state.col(offset - 1);
-      forgetGate.col(offset) += peepholeWeights.col(1) %
-          state.col(offset - 1);
+      inGate.cols(begin, end) += arma::diagmat(peepholeWeights.col(0)) *
+          previousState;
+      forgetGate.cols(begin, end) += arma::diagmat(peepholeWeights.col(1)) *
+          previousState;
     }
 
-    arma::Col<eT> inGateActivation = inGateAct.unsafe_col(offset);
-    GateActivationFunction::fn(inGate.unsafe_col(offset), inGateActivation);
+    arma::Mat<eT> inGateActivation = StepCols(inGateAct, offset);
+    GateActivationFunction::fn(StepCols(inGate, offset), inGateActivation);
 
-    arma::Col<eT> forgetGateActivation = forgetGateAct.unsafe_col(offset);
-    GateActivationFunction::fn(forgetGate.unsafe_col(offset),
+    arma::Mat<eT> forgetGateActivation = StepCols(forgetGateAct, offset);
+    GateActivationFunction::fn(StepCols(forgetGate, offset),
         forgetGateActivation);
 
-    arma::Col<eT> cellActivation = cellAct.unsafe_col(offset);
-    StateActivationFunction::fn(input.submat(outSize * 2, 0,
-        (outSize * 3) - 1, 0), cellActivation);
+    arma::Mat<eT> cellActivation = StepCols(cellAct, offset);
+    StateActivationFunction::fn(input.rows(outSize * 2, (outSize * 3) - 1),
+        cellActivation);
 
-    state.col(offset) = inGateAct.col(offset) % cellActivation;
+    state.cols(begin, end) = inGateActivation % cellActivation;
 
-    if (offset > 0)
-      state.col(offset) += forgetGateAct.col(offset) % state.col(offset - 1);
+    if (!previousState.is_empty())
+      state.cols(begin, end) += forgetGateActivation % previousState;
 
     if (peepholes)
-      outGate.col(offset) += peepholeWeights.col(2) % state.col(offset);
+    {
+      outGate.cols(begin, end) += arma::diagmat(peepholeWeights.col(2)) *
+          state.cols(begin, end);
+    }
 
-    arma::Col<eT> outGateActivation = outGateAct.unsafe_col(offset);
-    GateActivationFunction::fn(outGate.unsafe_col(offset), outGateActivation);
+    arma::Mat<eT> outGateActivation = StepCols(outGateAct, offset);
+    GateActivationFunction::fn(StepCols(outGate, offset), outGateActivation);
 
-    OutputActivationFunction::fn(state.unsafe_col(offset), output);
-    output = outGateAct.col(offset) % output;
+    OutputActivationFunction::fn(state.cols(begin, end), output);
+    output = outGateActivation % output;
+
+    // Keep the state of the last step of the window for the next window.
+    if (offset == seqLen - 1)
+      lastState = state.cols(begin, end);
 
     offset = (offset + 1) % seqLen;
   }
@@ -136,7 +160,8 @@ class LSTMLayer
   /**
    * Ordinary feed backward pass of a neural network, calculating the function
    * f(x) by propagating x backwards trough f. Using the results from the feed
-   * forward pass.
+   * forward pass. The error isn't propagated back beyond the first step of the
+   * window.
    *
    * @param input The propagated input activation.
    * @param gy The backpropagated error.
@@ -149,84 +174,92 @@ class LSTMLayer
   {
     queryOffset = seqLen - offset - 1;
 
-    arma::Col<eT> outGateDerivative;
-    GateActivationFunction::deriv(outGateAct.unsafe_col(queryOffset),
+    const size_t begin = queryOffset * batchSize;
+    const size_t end = begin + batchSize - 1;
+
+    arma::Mat<eT> outGateDerivative;
+    GateActivationFunction::deriv(StepCols(outGateAct, queryOffset),
         outGateDerivative);
 
-    arma::Col<eT> stateActivation;
-    StateActivationFunction::fn(state.unsafe_col(queryOffset), stateActivation);
+    arma::Mat<eT> stateActivation;
+    StateActivationFunction::fn(StepCols(state, queryOffset), stateActivation);
 
-    outGateError.col(queryOffset) = outGateDerivative % gy % stateActivation;
+    outGateError.cols(begin, end) = outGateDerivative % gy % stateActivation;
 
-    arma::Col<eT> stateDerivative;
+    arma::Mat<eT> stateDerivative;
     StateActivationFunction::deriv(stateActivation, stateDerivative);
 
-    stateError.col(queryOffset) = gy % outGateAct.col(queryOffset) %
+    stateError.cols(begin, end) = gy % outGateAct.cols(begin, end) %
         stateDerivative;
 
     if (queryOffset < (seqLen - 1))
     {
-      stateError.col(queryOffset) += stateError.col(queryOffset + 1) %
-          forgetGateAct.col(queryOffset + 1);
+      stateError.cols(begin, end) += stateError.cols(end + 1,
+          end + batchSize) % forgetGateAct.cols(end + 1, end + batchSize);
 
       if (peepholes)
       {
-        stateError.col(queryOffset) += inGateError.col(queryOffset + 1) %
-            peepholeWeights.col(0);
-        stateError.col(queryOffset) += forgetGateError.col(queryOffset + 1) %
-            peepholeWeights.col(1);
+        stateError.cols(begin, end) += arma::diagmat(peepholeWeights.col(0)) *
+            inGateError.cols(end + 1, end + batchSize);
+        stateError.cols(begin, end) += arma::diagmat(peepholeWeights.col(1)) *
+            forgetGateError.cols(end + 1, end + batchSize);
       }
     }
 
     if (peepholes)
     {
-      stateError.col(queryOffset) += outGateError.col(queryOffset) %
-          peepholeWeights.col(2);
+      stateError.cols(begin, end) += arma::diagmat(peepholeWeights.col(2)) *
+          outGateError.cols(begin, end);
     }
 
-    arma::Col<eT> cellDerivative;
-    StateActivationFunction::deriv(cellAct.col(queryOffset), cellDerivative);
+    arma::Mat<eT> cellDerivative;
+    StateActivationFunction::deriv(StepCols(cellAct, queryOffset),
+        cellDerivative);
 
-    arma::Col<eT> cellError = inGateAct.col(queryOffset) % cellDerivative %
-        stateError.col(queryOffset);
+    arma::Mat<eT> cellError = inGateAct.cols(begin, end) % cellDerivative %
+        stateError.cols(begin, end);
 
-    if (queryOffset > 0)
+    const InputDataType previousState = PreviousState(queryOffset);
+    if (!previousState.is_empty())
     {
-      arma::Col<eT> forgetGateDerivative;
-      GateActivationFunction::deriv(forgetGateAct.col(queryOffset),
+      arma::Mat<eT> forgetGateDerivative;
+      GateActivationFunction::deriv(StepCols(forgetGateAct, queryOffset),
           forgetGateDerivative);
 
-      forgetGateError.col(queryOffset) = forgetGateDerivative %
-          stateError.col(queryOffset) % state.col(queryOffset - 1);
+      forgetGateError.cols(begin, end) = forgetGateDerivative %
+          stateError.cols(begin, end) % previousState;
+    }
+    else
+    {
+      forgetGateError.cols(begin, end).zeros();
     }
 
-    arma::Col<eT> inGateDerivative;
-    GateActivationFunction::deriv(inGateAct.col(queryOffset), inGateDerivative);
+    arma::Mat<eT> inGateDerivative;
+    GateActivationFunction::deriv(StepCols(inGateAct, queryOffset),
+        inGateDerivative);
 
-    inGateError.col(queryOffset) = inGateDerivative %
-        stateError.col(queryOffset) % cellAct.col(queryOffset);
+    inGateError.cols(begin, end) = inGateDerivative %
+        stateError.cols(begin, end) % cellAct.cols(begin, end);
 
     if (peepholes)
     {
-      peepholeDerivatives.col(2) += outGateError.col(queryOffset) %
-          state.col(queryOffset);
+      peepholeDerivatives.col(2) += arma::sum(outGateError.cols(begin, end) %
+          state.cols(begin, end), 1);
 
-      if (queryOffset > 0)
+      if (!previousState.is_empty())
       {
-        peepholeDerivatives.col(0) += inGateError.col(queryOffset) %
-            state.col(queryOffset - 1);
-        peepholeDerivatives.col(1) += forgetGateError.col(queryOffset) %
-            state.col(queryOffset - 1);
+        peepholeDerivatives.col(0) += arma::sum(inGateError.cols(begin, end) %
+            previousState, 1);
+        peepholeDerivatives.col(1) += arma::sum(
+            forgetGateError.cols(begin, end) % previousState, 1);
       }
     }
 
-    g = arma::zeros<arma::Mat<eT> >(outSize * 4, 1);
-    g.submat(0, 0, outSize - 1, 0) = inGateError.col(queryOffset);
-    g.submat(outSize, 0, (outSize * 2) - 1, 0) =
-        forgetGateError.col(queryOffset);
-    g.submat(outSize * 2, 0, (outSize * 3) - 1, 0) = cellError;
-    g.submat(outSize * 3, 0, (outSize * 4) - 1, 0) =
-        outGateError.col(queryOffset);
+    g = arma::zeros<arma::Mat<eT> >(outSize * 4, batchSize);
+    g.rows(0, outSize - 1) = inGateError.cols(begin, end);
+    g.rows(outSize, (outSize * 2) - 1) = forgetGateError.cols(begin, end);
+    g.rows(outSize * 2, (outSize * 3) - 1) = cellError;
+    g.rows(outSize * 3, (outSize * 4) - 1) = outGateError.cols(begin, end);
 
     offset = (offset + 1) % seqLen;
   }
@@ -245,22 +278,36 @@ class LSTMLayer
   {
     if (peepholes && offset == 0)
     {
+      const size_t begin = queryOffset * batchSize;
+      const size_t end = begin + batchSize - 1;
+
       peepholeGradient.col(0) = arma::trans((peepholeWeights.col(0).t() *
-          (inGateError.col(queryOffset) % peepholeDerivatives.col(0))) *
-          inGate.col(queryOffset).t());
+          (arma::diagmat(peepholeDerivatives.col(0)) *
+          inGateError.cols(begin, end))) * inGate.cols(begin, end).t());
 
       peepholeGradient.col(1) = arma::trans((peepholeWeights.col(1).t() *
-          (forgetGateError.col(queryOffset) % peepholeDerivatives.col(1))) *
-          forgetGate.col(queryOffset).t());
+          (arma::diagmat(peepholeDerivatives.col(1)) *
+          forgetGateError.cols(begin, end))) *
+          forgetGate.cols(begin, end).t());
 
       peepholeGradient.col(2) = arma::trans((peepholeWeights.col(2).t() *
-          (outGateError.col(queryOffset) % peepholeDerivatives.col(2))) *
-          outGate.col(queryOffset).t());
+          (arma::diagmat(peepholeDerivatives.col(2)) *
+          outGateError.cols(begin, end))) * outGate.cols(begin, end).t());
 
       peepholeDerivatives.zeros();
     }
   }
 
+  /**
+   * Forget the state carried over from the previous window, so that the next
+   * step starts a new sequence.
+   */
+  void ResetCell()
+  {
+    lastState.reset();
+    offset = 0;
+  }
+
   //! Get the peephole weights.
   OutputDataType const& Weights() const { return peepholeWeights; }
   //! Modify the peephole weights.
@@ -312,6 +359,24 @@ class LSTMLayer
   }
 
  private:
+  //! Get the columns of the given matrix that belong to the given step.
+  InputDataType StepCols(InputDataType& m, const size_t step)
+  {
+    return InputDataType(m.colptr(step * batchSize), m.n_rows, batchSize,
+        false, true);
+  }
+
+  //! Get the state before the given step, or an empty matrix at the start of
+  //! a sequence.
+  InputDataType PreviousState(const size_t step)
+  {
+    if (step > 0)
+      return StepCols(state, step - 1);
+
+    return InputDataType(prevState.memptr(), prevState.n_rows,
+        prevState.n_cols, false, true);
+  }
+
   //! Locally-stored number of output units.
   size_t outSize;
 
@@ -327,6 +392,9 @@ class LSTMLayer
   //! Locally-stored query offset.
   size_t queryOffset;
 
+  //! Locally-stored number of sequences that are propagated at once.
+  size_t batchSize;
+
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -375,6 +443,12 @@ class LSTMLayer
   //! Locally-stored cell activation object.
   InputDataType cellAct;
 
+  //! Locally-stored state before the first step of the current window.
+  InputDataType prevState;
+
+  //! Locally-stored state of the last step of the last window.
+  InputDataType lastState;
+
   //! Locally-stored peephole weight object.
   OutputDataType peepholeWeights;
 
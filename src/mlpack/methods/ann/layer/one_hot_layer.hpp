@@ -58,9 +58,13 @@ class OneHotLayer
     output = inputActivations;
     output.zeros();
 
-    arma::uword maxIndex = 0;
-    inputActivations.max(maxIndex);
-    output(maxIndex) = 1;
+    // Each column of the input is one sample of the batch.
+    for (size_t i = 0; i < inputActivations.n_cols; ++i)
+    {
+      arma::uword maxIndex = 0;
+      inputActivations.col(i).max(maxIndex);
+      output(maxIndex, i) = 1;
+    }
   }
 
   /**
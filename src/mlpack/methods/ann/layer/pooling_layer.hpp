@@ -113,8 +113,9 @@ class PoolingLayer
                 arma::Cube<eT>& g)
   {
     // Generate a cube from the error matrix.
-    arma::Cube<eT> mappedError = arma::zeros<arma::cube>(outputParameter.n_rows,
-        outputParameter.n_cols, outputParameter.n_slices);
+    arma::Cube<eT> mappedError = arma::zeros<arma::Cube<eT> >(
+        outputParameter.n_rows, outputParameter.n_cols,
+        outputParameter.n_slices);
 
     for (size_t s = 0, j = 0; s < mappedError.n_slices; s+= gy.n_cols, j++)
     {
@@ -82,7 +82,7 @@ class RecurrentLayer
   template<typename InputType, typename eT>
   void Backward(const InputType& /* unused */,
                 const arma::Mat<eT>& gy,
-                arma::mat& g)
+                arma::Mat<eT>& g)
   {
     g = (weights).t() * gy;
   }
@@ -46,9 +46,10 @@ class SoftmaxLayer
   template<typename eT>
   void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
   {
+    // Each column of the input is one sample of the batch.
     output = arma::trunc_exp(input -
         arma::repmat(arma::max(input), input.n_rows, 1));
-    output /= arma::accu(output);
+    output.each_row() /= arma::sum(output);
   }
 
   /**
@@ -78,7 +78,7 @@ class SparseOutputLayer
                 const arma::Mat<eT>& gy,
                 arma::Mat<eT>& g)
   {
-    const arma::mat klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+    const arma::Mat<eT> klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
           (1 - rhoCap));
 
     // NOTE: if the armadillo version high enough, find_nonfinite can prevents
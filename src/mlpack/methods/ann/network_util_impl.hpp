@@ -45,121 +45,121 @@ LayerSize(T& /* unused */, P& /* unused */)
   return 0;
 }
 
-template<size_t I, typename... Tp>
+template<size_t I, typename eT, typename... Tp>
 typename std::enable_if<I < sizeof...(Tp), void>::type
-NetworkWeights(arma::mat& weights,
+NetworkWeights(arma::Mat<eT>& weights,
                std::tuple<Tp...>& network,
                size_t offset)
 {
-  NetworkWeights<I + 1, Tp...>(weights, network,
+  NetworkWeights<I + 1, eT, Tp...>(weights, network,
       offset + LayerWeights(std::get<I>(network), weights,
       offset, std::get<I>(network).OutputParameter()));
 
 }
 
-template<size_t I, typename... Tp>
+template<size_t I, typename eT, typename... Tp>
 typename std::enable_if<I == sizeof...(Tp), void>::type
-NetworkWeights(arma::mat& /* unused */,
+NetworkWeights(arma::Mat<eT>& /* unused */,
                std::tuple<Tp...>& /* unused */,
                size_t /* unused */)
 {
   /* Nothing to do here */
 }
 
-template<typename T>
+template<typename T, typename eT>
 typename std::enable_if<
-    HasWeightsCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+    HasWeightsCheck<T, arma::Mat<eT>&(T::*)()>::value, size_t>::type
 LayerWeights(T& layer,
-             arma::mat& weights,
+             arma::Mat<eT>& weights,
              size_t offset,
-             arma::mat& /* unused */)
+             arma::Mat<eT>& /* unused */)
 {
-  layer.Weights() = arma::mat(weights.memptr() + offset,
+  layer.Weights() = arma::Mat<eT>(weights.memptr() + offset,
       layer.Weights().n_rows, layer.Weights().n_cols, false, false);
 
   return layer.Weights().n_elem;
 }
 
-template<typename T>
+template<typename T, typename eT>
 typename std::enable_if<
-    HasWeightsCheck<T, arma::cube&(T::*)()>::value, size_t>::type
+    HasWeightsCheck<T, arma::Cube<eT>&(T::*)()>::value, size_t>::type
 LayerWeights(T& layer,
-             arma::mat& weights,
+             arma::Mat<eT>& weights,
              size_t offset,
-             arma::cube& /* unused */)
+             arma::Cube<eT>& /* unused */)
 {
-  layer.Weights() = arma::cube(weights.memptr() + offset,
+  layer.Weights() = arma::Cube<eT>(weights.memptr() + offset,
       layer.Weights().n_rows, layer.Weights().n_cols,
       layer.Weights().n_slices, false, false);
 
   return layer.Weights().n_elem;
 }
 
-template<typename T, typename P>
+template<typename T, typename eT, typename P>
 typename std::enable_if<
     !HasWeightsCheck<T, P&(T::*)()>::value, size_t>::type
 LayerWeights(T& /* unused */,
-             arma::mat& /* unused */,
+             arma::Mat<eT>& /* unused */,
              size_t /* unused */,
              P& /* unused */)
 {
   return 0;
 }
 
-template<size_t I, typename... Tp>
+template<size_t I, typename eT, typename... Tp>
 typename std::enable_if<I < sizeof...(Tp), void>::type
-NetworkGradients(arma::mat& gradients,
+NetworkGradients(arma::Mat<eT>& gradients,
                  std::tuple<Tp...>& network,
                  size_t offset)
 {
-  NetworkGradients<I + 1, Tp...>(gradients, network,
+  NetworkGradients<I + 1, eT, Tp...>(gradients, network,
       offset + LayerGradients(std::get<I>(network), gradients,
       offset, std::get<I>(network).OutputParameter()));
 }
 
-template<size_t I, typename... Tp>
+template<size_t I, typename eT, typename... Tp>
 typename std::enable_if<I == sizeof...(Tp), void>::type
-NetworkGradients(arma::mat& /* unused */,
+NetworkGradients(arma::Mat<eT>& /* unused */,
                std::tuple<Tp...>& /* unused */,
                size_t /* unused */)
 {
   /* Nothing to do here */
 }
 
-template<typename T>
+template<typename T, typename eT>
 typename std::enable_if<
-    HasGradientCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+    HasGradientCheck<T, arma::Mat<eT>&(T::*)()>::value, size_t>::type
 LayerGradients(T& layer,
-               arma::mat& gradients,
+               arma::Mat<eT>& gradients,
                size_t offset,
-               arma::mat& /* unused */)
+               arma::Mat<eT>& /* unused */)
 {
-  layer.Gradient() = arma::mat(gradients.memptr() + offset,
+  layer.Gradient() = arma::Mat<eT>(gradients.memptr() + offset,
       layer.Weights().n_rows, layer.Weights().n_cols, false, false);
 
   return layer.Weights().n_elem;
 }
 
-template<typename T>
+template<typename T, typename eT>
 typename std::enable_if<
-    HasGradientCheck<T, arma::cube&(T::*)()>::value, size_t>::type
+    HasGradientCheck<T, arma::Cube<eT>&(T::*)()>::value, size_t>::type
 LayerGradients(T& layer,
-               arma::mat& gradients,
+               arma::Mat<eT>& gradients,
                size_t offset,
-               arma::cube& /* unused */)
+               arma::Cube<eT>& /* unused */)
 {
-  layer.Gradient() = arma::cube(gradients.memptr() + offset,
+  layer.Gradient() = arma::Cube<eT>(gradients.memptr() + offset,
       layer.Weights().n_rows, layer.Weights().n_cols,
       layer.Weights().n_slices, false, false);
 
   return layer.Weights().n_elem;
 }
 
-template<typename T, typename P>
+template<typename T, typename eT, typename P>
 typename std::enable_if<
     !HasGradientCheck<T, P&(T::*)()>::value, size_t>::type
 LayerGradients(T& /* unused */,
-               arma::mat& /* unused */,
+               arma::Mat<eT>& /* unused */,
                size_t /* unused */,
                P& /* unused */)
 {
@@ -204,38 +204,41 @@ LayerInputSize(T& /* unused */, P& /* unused */)
   return 0;
 }
 
-template<size_t I, typename InitializationRuleType, typename... Tp>
+template<size_t I, typename InitializationRuleType, typename eT,
+         typename... Tp>
 typename std::enable_if<I < sizeof...(Tp), void>::type
 NetworkWeights(InitializationRuleType& initializeRule,
-               arma::mat& weights,
+               arma::Mat<eT>& weights,
                std::tuple<Tp...>& network,
                size_t offset)
 {
-  NetworkWeights<I + 1, InitializationRuleType, Tp...>(initializeRule, weights,
-      network, offset + LayerWeights(initializeRule, std::get<I>(network),
-      weights, offset, std::get<I>(network).OutputParameter()));
+  NetworkWeights<I + 1, InitializationRuleType, eT, Tp...>(initializeRule,
+      weights, network, offset + LayerWeights(initializeRule,
+      std::get<I>(network), weights, offset,
+      std::get<I>(network).OutputParameter()));
 }
 
-template<size_t I, typename InitializationRuleType, typename... Tp>
+template<size_t I, typename InitializationRuleType, typename eT,
+         typename... Tp>
 typename std::enable_if<I == sizeof...(Tp), void>::type
 NetworkWeights(InitializationRuleType& /* initializeRule */,
-               arma::mat& /* weights */,
+               arma::Mat<eT>& /* weights */,
                std::tuple<Tp...>& /* network */,
                size_t /* offset */)
 {
   /* Nothing to do here */
 }
 
-template<typename InitializationRuleType, typename T>
+template<typename InitializationRuleType, typename T, typename eT>
 typename std::enable_if<
-    HasWeightsCheck<T, arma::mat&(T::*)()>::value, size_t>::type
+    HasWeightsCheck<T, arma::Mat<eT>&(T::*)()>::value, size_t>::type
 LayerWeights(InitializationRuleType& initializeRule,
              T& layer,
-             arma::mat& weights,
+             arma::Mat<eT>& weights,
              size_t offset,
-             arma::mat& /* output */)
+             arma::Mat<eT>& /* output */)
 {
-  layer.Weights() = arma::mat(weights.memptr() + offset,
+  layer.Weights() = arma::Mat<eT>(weights.memptr() + offset,
       layer.Weights().n_rows, layer.Weights().n_cols, false, false);
 
   initializeRule.Initialize(layer.Weights(), layer.Weights().n_rows,
@@ -244,16 +247,16 @@ LayerWeights(InitializationRuleType& initializeRule,
   return layer.Weights().n_elem;
 }
 
-template<typename InitializationRuleType, typename T>
+template<typename InitializationRuleType, typename T, typename eT>
 typename std::enable_if<
-    HasWeightsCheck<T, arma::cube&(T::*)()>::value, size_t>::type
+    HasWeightsCheck<T, arma::Cube<eT>&(T::*)()>::value, size_t>::type
 LayerWeights(InitializationRuleType& initializeRule,
              T& layer,
-             arma::mat& weights,
+             arma::Mat<eT>& weights,
              size_t offset,
-             arma::cube& /* output */)
+             arma::Cube<eT>& /* output */)
 {
-  layer.Weights() = arma::cube(weights.memptr() + offset,
+  layer.Weights() = arma::Cube<eT>(weights.memptr() + offset,
       layer.Weights().n_rows, layer.Weights().n_cols,
       layer.Weights().n_slices, false, false);
 
@@ -263,12 +266,13 @@ LayerWeights(InitializationRuleType& initializeRule,
   return layer.Weights().n_elem;
 }
 
-template<typename InitializationRuleType, typename T, typename P>
+template<typename InitializationRuleType, typename T, typename eT,
+         typename P>
 typename std::enable_if<
     !HasWeightsCheck<T, P&(T::*)()>::value, size_t>::type
 LayerWeights(InitializationRuleType& /* initializeRule */,
              T& /* layer */,
-             arma::mat& /* weights */,
+             arma::Mat<eT>& /* weights */,
              size_t /* offset */,
              P& /* output */)
 {
@@ -45,7 +45,8 @@ class MeanSquaredErrorFunction
   template<typename DataType>
   static double Error(const DataType& input, const DataType& target, const DataType&)
   {
-    return arma::mean(arma::mean(arma::square(target - input)));
+    // The error of a batch is the sum of the errors of its samples (columns).
+    return arma::accu(arma::square(target - input)) / target.n_rows;
   }
 
 }; // class MeanSquaredErrorFunction
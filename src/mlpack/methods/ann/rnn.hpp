@@ -201,9 +201,50 @@ class RNN
                 const size_t i,
                 arma::mat& gradient);
 
+  /**
+   * Evaluate the recurrent neural network with the given parameters on a batch
+   * of consecutive sequences. All sequences have the same length, so every
+   * step of the sequences is propagated through the network at once.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param deterministic Whether or not to train or test the model. Note some
+   * layer act differently in training or testing mode.
+   * @return The sum of the objective over the sequences in the batch.
+   */
+  double EvaluateBatch(const arma::mat& parameters,
+                       const size_t begin,
+                       const size_t batchSize,
+                       const bool deterministic = true);
+
+  /**
+   * Evaluate the gradient of the recurrent neural network with the given
+   * parameters, with respect to a batch of consecutive sequences. The
+   * sequences are split into windows of Rho() steps; the error is propagated
+   * back through each window only, while the recurrent state is carried over
+   * into the next window (truncated backpropagation through time).
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the first sequence of the batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of sequences in the batch.
+   */
+  void GradientBatch(const arma::mat& parameters,
+                     const size_t begin,
+                     arma::mat& gradient,
+                     const size_t batchSize);
+
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  //! Get the number of steps the error is propagated back through time (0
+  //! means the whole sequence).
+  size_t Rho() const { return rho; }
+  //! Modify the number of steps the error is propagated back through time (0
+  //! means the whole sequence).
+  size_t& Rho() { return rho; }
+
   //! Return the initial point for the optimization.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
@@ -215,29 +256,41 @@ class RNN
 
  private:
   /*
-   * Predict the response of the given input matrix.
+   * Predict the response of the given input sequences, one per column.
    */
   template <typename DataType>
   void SinglePredict(const DataType& input, DataType& output)
   {
     deterministic = true;
     seqLen = input.n_rows / inputSize;
+    batchSize = input.n_cols;
     ResetParameter(network);
 
-    // Iterate through the input sequence and perform the feed forward pass.
-    for (seqNum = 0; seqNum < seqLen; seqNum++)
+    if (seqOutput)
+      output.set_size(seqLen * outputSize, batchSize);
+
+    // Iterate through the input sequences window by window and perform the
+    // feed forward pass.
+    const size_t windowSize = WindowSize();
+    for (size_t begin = 0; begin < seqLen; begin += windowSize)
     {
-      // Perform the forward pass and save the activations.
-      Forward(input.rows(seqNum * inputSize, (seqNum + 1) * inputSize - 1),
-          network);
-      SaveActivations(network);
+      const size_t length = std::min(windowSize, seqLen - begin);
+      ResetWindow(network, length);
 
-      // Retrieve output of the subsequence.
-      if (seqOutput)
+      for (size_t step = begin; step < begin + length; step++)
       {
-        DataType seqOutput;
-        OutputPrediction(seqOutput, network);
-        output = arma::join_cols(output, seqOutput);
+        Forward(input.rows(step * inputSize, (step + 1) * inputSize - 1),
+            network);
+        LinkRecurrent(network);
+
+        // Retrieve output of the subsequence.
+        if (seqOutput)
+        {
+          DataType stepOutput;
+          OutputPrediction(stepOutput, network);
+          output.rows(step * outputSize, (step + 1) * outputSize - 1) =
+              stepOutput;
+        }
       }
     }
 
@@ -246,9 +299,33 @@ class RNN
       OutputPrediction(output, network);
   }
 
+  /**
+   * Run the feed forward pass over a window of the given input sequences, and
+   * calculate the output error of the steps in the window.
+   *
+   * @param input Input sequences, one per column.
+   * @param target Target sequences or outputs, one per column.
+   * @param begin First step of the window.
+   * @param length Number of steps in the window.
+   * @param save Whether or not to save the activations for the feed backward
+   *        pass.
+   * @return The error of the steps in the window.
+   */
+  double ForwardWindow(const arma::mat& input,
+                       const arma::mat& target,
+                       const size_t begin,
+                       const size_t length,
+                       const bool save);
+
+  //! Return the number of steps in a window of the current sequences.
+  size_t WindowSize() const
+  {
+    return (rho == 0 || rho > seqLen) ? seqLen : rho;
+  }
+
   /**
    * Reset the network by clearing the layer activations and by setting the
-   * layer status.
+   * layer status. This is done at the start of each batch of sequences.
    */
   template<size_t I = 0, typename... Tp>
   typename std::enable_if<I == sizeof...(Tp), void>::type
@@ -262,13 +339,34 @@ class RNN
   ResetParameter(std::tuple<Tp...>& network)
   {
     ResetDeterministic(std::get<I>(network));
-    ResetSeqLen(std::get<I>(network));
     ResetRecurrent(std::get<I>(network), std::get<I>(network).InputParameter());
-    std::get<I>(network).Delta().zeros();
+    ResetCell(std::get<I>(network));
 
     ResetParameter<I + 1, Tp...>(network);
   }
 
+  /**
+   * Prepare the network for a new window of the sequences by setting the
+   * window length and by clearing the deltas, so that no error is propagated
+   * back from the previous window.
+   */
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I == sizeof...(Tp), void>::type
+  ResetWindow(std::tuple<Tp...>& /* unused */, const size_t /* unused */)
+  {
+    /* Nothing to do here */
+  }
+
+  template<size_t I = 0, typename... Tp>
+  typename std::enable_if<I < sizeof...(Tp), void>::type
+  ResetWindow(std::tuple<Tp...>& network, const size_t length)
+  {
+    ResetSeqLen(std::get<I>(network), length);
+    std::get<I>(network).Delta().reset();
+
+    ResetWindow<I + 1, Tp...>(network, length);
+  }
+
   /**
    * Reset the layer status by setting the current deterministic parameter
    * for all layer that implement the Deterministic function.
@@ -287,21 +385,41 @@ class RNN
   ResetDeterministic(T& /* unused */) { /* Nothing to do here */ }
 
   /**
-   * Reset the layer sequence length by setting the current seqLen parameter
+   * Reset the layer sequence length by setting the current window length
    * for all layer that implement the SeqLen function.
    */
   template<typename T>
   typename std::enable_if<
       HasSeqLenCheck<T, size_t&(T::*)(void)>::value, void>::type
-  ResetSeqLen(T& layer)
+  ResetSeqLen(T& layer, const size_t length)
   {
-    layer.SeqLen() = seqLen;
+    layer.SeqLen() = length;
   }
 
   template<typename T>
   typename std::enable_if<
       !HasSeqLenCheck<T, size_t&(T::*)(void)>::value, void>::type
-  ResetSeqLen(T& /* unused */) { /* Nothing to do here */ }
+  ResetSeqLen(T& /* unused */, const size_t /* unused */)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Reset the carried cell state for all layer that implement the ResetCell
+   * function.
+   */
+  template<typename T>
+  typename std::enable_if<
+      HasResetCellCheck<T, void(T::*)(void)>::value, void>::type
+  ResetCell(T& layer)
+  {
+    layer.ResetCell();
+  }
+
+  template<typename T>
+  typename std::enable_if<
+      !HasResetCellCheck<T, void(T::*)(void)>::value, void>::type
+  ResetCell(T& /* unused */) { /* Nothing to do here */ }
 
   /**
    * Distinguish between recurrent layer and non-recurrent layer when resetting
@@ -312,7 +430,8 @@ class RNN
       HasRecurrentParameterCheck<T, P&(T::*)()>::value, void>::type
   ResetRecurrent(T& layer, P& /* unused */)
   {
-    layer.RecurrentParameter().zeros();
+    layer.RecurrentParameter().zeros(layer.RecurrentParameter().n_rows,
+        batchSize);
   }
 
   template<typename T, typename P>
@@ -333,7 +452,7 @@ class RNN
             const TargetDataType& target,
             std::tuple<Tp...>& /* unused */)
   {
-    seqOutput = outputSize < target.n_elem ? true : false;
+    seqOutput = outputSize < target.n_rows ? true : false;
   }
 
   template<size_t I = 0, typename InputDataType, typename TargetDataType,
@@ -413,10 +532,11 @@ class RNN
     if (activations.size() == layerNumber)
     {
       activations.push_back(new arma::mat(layer.RecurrentParameter().n_rows,
-          seqLen));
+          WindowSize() * batchSize));
     }
 
-    activations[layerNumber].unsafe_col(seqNum) = layer.RecurrentParameter();
+    activations[layerNumber].cols(seqNum * batchSize,
+        (seqNum + 1) * batchSize - 1) = layer.RecurrentParameter();
   }
 
   template<typename T, typename P>
@@ -427,10 +547,11 @@ class RNN
     if (activations.size() == layerNumber)
     {
       activations.push_back(new arma::mat(layer.OutputParameter().n_rows,
-          seqLen));
+          WindowSize() * batchSize));
     }
 
-    activations[layerNumber].unsafe_col(seqNum) = layer.OutputParameter();
+    activations[layerNumber].cols(seqNum * batchSize,
+        (seqNum + 1) * batchSize - 1) = layer.OutputParameter();
   }
 
   /**
@@ -469,7 +590,8 @@ class RNN
       HasRecurrentParameterCheck<T, P&(T::*)()>::value, void>::type
   Load(const size_t layerNumber, T& layer, P& /* unused */)
   {
-    layer.RecurrentParameter() = activations[layerNumber].unsafe_col(seqNum);
+    layer.RecurrentParameter() = activations[layerNumber].cols(
+        seqNum * batchSize, (seqNum + 1) * batchSize - 1);
   }
 
   template<typename T, typename P>
@@ -477,7 +599,8 @@ class RNN
       !HasRecurrentParameterCheck<T, P&(T::*)()>::value, void>::type
   Load(const size_t layerNumber, T& layer, P& /* unused */)
   {
-    layer.OutputParameter() = activations[layerNumber].unsafe_col(seqNum);
+    layer.OutputParameter() = activations[layerNumber].cols(
+        seqNum * batchSize, (seqNum + 1) * batchSize - 1);
   }
 
   /**
@@ -766,7 +889,7 @@ class RNN
   //! Locally stored network output size.
   size_t outputSize;
 
-  //! The index of the current sequence number.
+  //! The index of the current step in the window.
   size_t seqNum;
 
   //! Locally stored number of samples in one input sequence.
@@ -783,6 +906,12 @@ class RNN
 
   //! Locally stored backward error.
   arma::mat error;
+
+  //! The number of steps the error is propagated back through time.
+  size_t rho;
+
+  //! The number of sequences that are propagated at once.
+  size_t batchSize;
 }; // class RNN
 
 } // namespace ann
@@ -38,7 +38,9 @@ RNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     responses(responses),
     numFunctions(predictors.n_cols),
     inputSize(0),
-    outputSize(0)
+    outputSize(0),
+    rho(0),
+    batchSize(1)
 {
   static_assert(std::is_same<typename std::decay<LayerType>::type,
                   LayerTypes>::value,
@@ -77,7 +79,9 @@ RNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     outputLayer(std::forward<OutputType>(outputLayer)),
     performanceFunc(std::move(performanceFunction)),
     inputSize(0),
-    outputSize(0)
+    outputSize(0),
+    rho(0),
+    batchSize(1)
 {
   static_assert(std::is_same<typename std::decay<LayerType>::type,
                   LayerTypes>::value,
@@ -108,7 +112,9 @@ RNN<LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     outputLayer(std::forward<OutputType>(outputLayer)),
     performanceFunc(std::move(performanceFunction)),
     inputSize(0),
-    outputSize(0)
+    outputSize(0),
+    rho(0),
+    batchSize(1)
 {
   static_assert(std::is_same<typename std::decay<LayerType>::type,
                   LayerTypes>::value,
@@ -202,19 +208,8 @@ void RNN<
 LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
 >::Predict(arma::mat& predictors, arma::mat& responses)
 {
-  arma::mat responsesTemp;
-  SinglePredict(arma::mat(predictors.colptr(0), predictors.n_rows,
-      1, false, true), responsesTemp);
-
-  responses = arma::mat(responsesTemp.n_elem, predictors.n_cols);
-  responses.col(0) = responsesTemp.col(0);
-
-  for (size_t i = 1; i < predictors.n_cols; i++)
-  {
-    SinglePredict(arma::mat(predictors.colptr(i), predictors.n_rows,
-      1, false, true), responsesTemp);
-    responses.col(i) = responsesTemp.col(0);
-  }
+  // All sequences are propagated through the network at once.
+  SinglePredict(predictors, responses);
 }
 
 template<typename LayerTypes,
@@ -224,49 +219,62 @@ template<typename LayerTypes,
 >
 double RNN<
 LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Evaluate(const arma::mat& /* unused */,
+>::Evaluate(const arma::mat& parameters,
             const size_t i,
             const bool deterministic)
+{
+  return EvaluateBatch(parameters, i, 1, deterministic);
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+void RNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::Gradient(const arma::mat& parameters,
+            const size_t i,
+            arma::mat& gradient)
+{
+  GradientBatch(parameters, i, gradient, 1);
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+double RNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::EvaluateBatch(const arma::mat& /* unused */,
+                 const size_t begin,
+                 const size_t batchSize,
+                 const bool deterministic)
 {
   this->deterministic = deterministic;
+  this->batchSize = batchSize;
 
-  arma::mat input = arma::mat(predictors.colptr(i), predictors.n_rows,
-      1, false, true);
-  arma::mat target = arma::mat(responses.colptr(i), responses.n_rows,
-      1, false, true);
+  // The columns of the batch are used in place.
+  const arma::mat input = arma::mat(const_cast<double*>(
+      predictors.colptr(begin)), predictors.n_rows, batchSize, false, true);
+  const arma::mat target = arma::mat(const_cast<double*>(
+      responses.colptr(begin)), responses.n_rows, batchSize, false, true);
 
-  // Initialize the activation storage only once.
-  if (activations.empty())
-    InitLayer(input, target, network);
+  InitLayer(input, target, network);
 
-  double networkError = 0;
   seqLen = input.n_rows / inputSize;
   ResetParameter(network);
 
-  error = arma::mat(outputSize, outputSize < target.n_elem ? seqLen : 1);
-
-  // Iterate through the input sequence and perform the feed forward pass.
-  for (seqNum = 0; seqNum < seqLen; seqNum++)
+  // The window only bounds the memory here, since nothing is propagated back.
+  double networkError = 0;
+  const size_t windowSize = WindowSize();
+  for (size_t step = 0; step < seqLen; step += windowSize)
   {
-    // Perform the forward pass and save the activations.
-    Forward(input.rows(seqNum * inputSize, (seqNum + 1) * inputSize - 1),
-        network);
-    SaveActivations(network);
-
-    // Retrieve output error of the subsequence.
-    if (seqOutput)
-    {
-      arma::mat seqError = error.unsafe_col(seqNum);
-      arma::mat seqTarget = target.submat(seqNum * outputSize, 0,
-          (seqNum + 1) * outputSize - 1, 0);
-      networkError += OutputError(seqTarget, seqError, network);
-    }
+    networkError += ForwardWindow(input, target, step,
+        std::min(windowSize, seqLen - step), false);
   }
 
-  // Retrieve output error of the complete sequence.
-  if (!seqOutput)
-    return OutputError(target, error, network);
-
   return networkError;
 }
 
@@ -277,9 +285,10 @@ template<typename LayerTypes,
 >
 void RNN<
 LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
->::Gradient(const arma::mat& /* unused */,
-            const size_t i,
-            arma::mat& gradient)
+>::GradientBatch(const arma::mat& /* unused */,
+                 const size_t begin,
+                 arma::mat& gradient,
+                 const size_t batchSize)
 {
   if (gradient.is_empty())
   {
@@ -290,41 +299,122 @@ LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
     gradient.zeros();
   }
 
-  Evaluate(parameter, i, false);
+  deterministic = false;
+  this->batchSize = batchSize;
+
+  // The columns of the batch are used in place.
+  const arma::mat input = arma::mat(const_cast<double*>(
+      predictors.colptr(begin)), predictors.n_rows, batchSize, false, true);
+  const arma::mat target = arma::mat(const_cast<double*>(
+      responses.colptr(begin)), responses.n_rows, batchSize, false, true);
+
+  InitLayer(input, target, network);
+
+  seqLen = input.n_rows / inputSize;
+  ResetParameter(network);
 
   arma::mat currentGradient = arma::mat(gradient.n_rows, gradient.n_cols);
   NetworkGradients(currentGradient, network);
 
-  const arma::mat input = arma::mat(predictors.colptr(i), predictors.n_rows,
-      1, false, true);
-
-  // Iterate through the input sequence and perform the feed backward pass.
-  for (seqNum = seqLen - 1; seqNum >= 0; seqNum--)
+  const size_t windowSize = WindowSize();
+  for (size_t step = 0; step < seqLen; step += windowSize)
   {
-    // Load the network activation for the upcoming backward pass.
-    LoadActivations(input.rows(seqNum * inputSize, (seqNum + 1) *
-        inputSize - 1), network);
+    const size_t length = std::min(windowSize, seqLen - step);
+    ForwardWindow(input, target, step, length, true);
 
-    // Perform the backward pass.
-    if (seqOutput)
+    // If only the complete sequence has an output, there is no error to
+    // propagate back until the last window.
+    if (!seqOutput && (step + length) < seqLen)
+      continue;
+
+    // Iterate through the window and perform the feed backward pass.
+    for (seqNum = length - 1; seqNum >= 0; seqNum--)
     {
-      arma::mat seqError = error.unsafe_col(seqNum);
-      Backward(seqError, network);
+      // Load the network activation for the upcoming backward pass.
+      LoadActivations(input.rows((step + seqNum) * inputSize,
+          (step + seqNum + 1) * inputSize - 1), network);
+
+      // Perform the backward pass.
+      if (seqOutput)
+      {
+        arma::mat seqError = arma::mat(error.colptr(seqNum * batchSize),
+            outputSize, batchSize, false, true);
+        Backward(seqError, network);
+      }
+      else
+      {
+        Backward(error, network);
+      }
+
+      // Link the parameters and update the gradients.
+      LinkParameter(network);
+      UpdateGradients<>(network);
+
+      // Update the overall gradient.
+      gradient += currentGradient;
+
+      if (seqNum == 0) break;
     }
+
+    // Restore the recurrent state of the last step of the window, which is
+    // carried over into the next window.
+    seqNum = length - 1;
+    LoadActivations(input.rows((step + seqNum) * inputSize,
+        (step + seqNum + 1) * inputSize - 1), network);
+    LinkRecurrent(network);
+  }
+}
+
+template<typename LayerTypes,
+         typename OutputLayerType,
+         typename InitializationRuleType,
+         typename PerformanceFunction
+>
+double RNN<
+LayerTypes, OutputLayerType, InitializationRuleType, PerformanceFunction
+>::ForwardWindow(const arma::mat& input,
+                 const arma::mat& target,
+                 const size_t begin,
+                 const size_t length,
+                 const bool save)
+{
+  ResetWindow(network, length);
+
+  if (seqOutput)
+    error.set_size(outputSize, length * batchSize);
+  else
+    error.set_size(outputSize, batchSize);
+
+  double networkError = 0;
+  for (seqNum = 0; seqNum < length; seqNum++)
+  {
+    const size_t step = begin + seqNum;
+
+    // Perform the forward pass and save the activations.
+    Forward(input.rows(step * inputSize, (step + 1) * inputSize - 1),
+        network);
+
+    if (save)
+      SaveActivations(network);
     else
+      LinkRecurrent(network);
+
+    // Retrieve output error of the subsequence.
+    if (seqOutput)
     {
-      Backward(error, network);
+      arma::mat seqError = arma::mat(error.colptr(seqNum * batchSize),
+          outputSize, batchSize, false, true);
+      arma::mat seqTarget = target.rows(step * outputSize,
+          (step + 1) * outputSize - 1);
+      networkError += OutputError(seqTarget, seqError, network);
     }
+  }
 
-    // Link the parameters and update the gradients.
-    LinkParameter(network);
-    UpdateGradients<>(network);
-
-    // Update the overall gradient.
-    gradient += currentGradient;
+  // Retrieve output error of the complete sequence.
+  if (!seqOutput && (begin + length) == seqLen)
+    networkError = OutputError(target, error, network);
 
-    if (seqNum == 0) break;
-  }
+  return networkError;
 }
 
 template<typename LayerTypes,
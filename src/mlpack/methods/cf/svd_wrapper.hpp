@@ -8,6 +8,7 @@
 #define MLPACK_METHODS_SVDWRAPPER_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/methods/randomized_svd/randomized_svd.hpp>
 
 namespace mlpack
 {
@@ -30,6 +31,9 @@ class DummyClass {};
  * of factorization. Q matrix is transposed and trimmed to support the rank
  * of factorization. The Factroizer class should implement Apply which takes
  * matrices P, sigma, Q and V as their parameter respectively.
+ *
+ * SVDWrapper<svd::RandomizedSVD> is handled specially: only the requested rank
+ * is computed, the data is not centered, and sparse data is never densified.
  */
 template<class Factorizer = DummyClass>
 class SVDWrapper
@@ -69,6 +73,22 @@ class SVDWrapper
                arma::mat& W,
                arma::mat& H) const;
 
+  /**
+   * Factorizer function which computes SVD of the given sparse matrix and
+   * returns matrices as required by CF module.  Unless the factorizer supports
+   * sparse matrices, the matrix is converted to a dense matrix first.
+   *
+   * @param V input matrix
+   * @param W first unitary matrix
+   * @param H second unitary matrix
+   *
+   * @note V = W * H
+   */
+  double Apply(const arma::sp_mat& V,
+               size_t r,
+               arma::mat& W,
+               arma::mat& H) const;
+
  private:
   //! svd factorizer
   Factorizer factorizer;
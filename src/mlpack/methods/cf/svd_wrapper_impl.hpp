@@ -27,7 +27,7 @@ double mlpack::cf::SVDWrapper<Factorizer>::Apply(const arma::mat& V,
 }
 
 template<>
-double mlpack::cf::SVDWrapper<DummyClass>::Apply(const arma::mat& V,
+inline double mlpack::cf::SVDWrapper<DummyClass>::Apply(const arma::mat& V,
                                      arma::mat& W,
                                      arma::mat& sigma,
                                      arma::mat& H) const
@@ -88,7 +88,7 @@ double mlpack::cf::SVDWrapper<Factorizer>::Apply(const arma::mat& V,
 }
 
 template<>
-double mlpack::cf::SVDWrapper<DummyClass>::Apply(const arma::mat& V,
+inline double mlpack::cf::SVDWrapper<DummyClass>::Apply(const arma::mat& V,
                                      size_t r,
                                      arma::mat& W,
                                      arma::mat& H) const
@@ -125,3 +125,105 @@ double mlpack::cf::SVDWrapper<DummyClass>::Apply(const arma::mat& V,
   // return the normalized frobenius norm
   return arma::norm(V - V_rec, "fro") / arma::norm(V, "fro");
 }
+
+template<class Factorizer>
+double mlpack::cf::SVDWrapper<Factorizer>::Apply(const arma::sp_mat& V,
+                         size_t r,
+                         arma::mat& W,
+                         arma::mat& H) const
+{
+  return Apply(arma::mat(V), r, W, H);
+}
+
+//! Return the normalized frobenius norm of V - W * H.
+inline double ReconstructionError(const arma::mat& V,
+                                  const arma::mat& W,
+                                  const arma::mat& H)
+{
+  return arma::norm(V - W * H, "fro") / arma::norm(V, "fro");
+}
+
+//! Return the normalized frobenius norm of V - W * H for sparse V, without
+//! forming W * H.
+inline double ReconstructionError(const arma::sp_mat& V,
+                                  const arma::mat& W,
+                                  const arma::mat& H)
+{
+  // ||V - W H||^2 = ||V||^2 - 2 <V, W H> + ||W H||^2, where only the nonzero
+  // entries of V contribute to the inner product.
+  const arma::mat Wt = arma::trans(W);
+  double vNorm = 0;
+  double product = 0;
+
+  #pragma omp parallel for reduction(+:vNorm, product) schedule(static)
+  for (intmax_t j = 0; j < (intmax_t) V.n_cols; ++j)
+  {
+    for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+    {
+      const double value = V.values[k];
+      vNorm += value * value;
+      product += value * arma::dot(Wt.unsafe_col(V.row_indices[k]),
+          H.unsafe_col(j));
+    }
+  }
+
+  const double whNorm = arma::accu((Wt * W) % (H * arma::trans(H)));
+  return std::sqrt(std::max(vNorm - 2 * product + whNorm, 0.0)) /
+      std::sqrt(vNorm);
+}
+
+//! Compute a rank r factorization with the randomized SVD, for dense or sparse
+//! V.
+template<typename MatType>
+inline double RandomizedSVDApply(const mlpack::svd::RandomizedSVD& factorizer,
+                                 const MatType& V,
+                                 size_t r,
+                                 arma::mat& W,
+                                 arma::mat& H)
+{
+  // check if the given rank is valid
+  if(r > V.n_rows || r > V.n_cols)
+  {
+    Log::Info << "Rank " << r << ", given for decomposition is invalid." << std::endl;
+    r = (V.n_rows > V.n_cols) ? V.n_cols : V.n_rows;
+    Log::Info << "Setting decomposition rank to " << r << std::endl;
+  }
+
+  // V = W * H has to hold for V itself, so V must not be centered.
+  mlpack::svd::RandomizedSVD rsvd(factorizer);
+  rsvd.Center() = false;
+
+  // get the rank r svd factorization
+  arma::vec sigma;
+  rsvd.Apply(V, W, sigma, H, r);
+  r = std::min(r, (size_t) sigma.n_elem);
+
+  // eigenvalue matrix is multiplied to W
+  W = W.cols(0, r - 1) * arma::diagmat(sigma.subvec(0, r - 1));
+
+  // take transpose of the matrix H as required by CF module
+  H = arma::trans(H.cols(0, r - 1));
+
+  // return the normalized frobenius norm
+  return ReconstructionError(V, W, H);
+}
+
+template<>
+inline double mlpack::cf::SVDWrapper<mlpack::svd::RandomizedSVD>::Apply(
+    const arma::mat& V,
+    size_t r,
+    arma::mat& W,
+    arma::mat& H) const
+{
+  return RandomizedSVDApply(factorizer, V, r, W, H);
+}
+
+template<>
+inline double mlpack::cf::SVDWrapper<mlpack::svd::RandomizedSVD>::Apply(
+    const arma::sp_mat& V,
+    size_t r,
+    arma::mat& W,
+    arma::mat& H) const
+{
+  return RandomizedSVDApply(factorizer, V, r, W, H);
+}
@@ -59,6 +59,29 @@ class DecisionStump
                 const arma::Row<size_t>& labels,
                 const arma::rowvec& weights);
 
+  /**
+   * Alternate constructor which copies the parameters bucketSize and classes
+   * from an already initiated decision stump, other, and trains with the given
+   * weights, using the sorted order of the points in each dimension that was
+   * computed beforehand with Presort().  This gives the same stump as the
+   * constructor without sortedIndices, but avoids sorting the data again, so
+   * it should be used when many stumps are trained on the same data (like in
+   * boosting).
+   *
+   * @param other The other initiated Decision Stump object from
+   *      which we copy the values.
+   * @param data The data on which to train this object on.
+   * @param labels The labels of data.
+   * @param weights Weight vector to use while training. For boosting purposes.
+   * @param sortedIndices Sorted order of the points in each dimension, as
+   *      computed by Presort().
+   */
+  DecisionStump(const DecisionStump<>& other,
+                const MatType& data,
+                const arma::Row<size_t>& labels,
+                const arma::rowvec& weights,
+                const arma::umat& sortedIndices);
+
   /**
    * Create a decision stump without training.  This stump will not be useful
    * and will always return a class of 0 for anything that is to be classified,
@@ -91,6 +114,19 @@ class DecisionStump
    */
   void Classify(const MatType& test, arma::Row<size_t>& predictedLabels);
 
+  /**
+   * Compute the sorted order of the points in each dimension of the given
+   * data, for use with the presorted boosting constructor.  Column d of
+   * sortedIndices will hold the indices of the points, sorted (stably) by
+   * their value in dimension d.  Note that this takes as much memory as the
+   * data itself.  If OpenMP is available, the dimensions are sorted in
+   * parallel.
+   *
+   * @param data Dataset to sort.
+   * @param sortedIndices Matrix to store the sorted order of each dimension in.
+   */
+  static void Presort(const MatType& data, arma::umat& sortedIndices);
+
   //! Access the splitting dimension.
   size_t SplitDimension() const { return splitDimension; }
   //! Modify the splitting dimension (be careful!).
@@ -127,14 +163,16 @@ class DecisionStump
    * Sets up dimension as if it were splitting on it and finds entropy when
    * splitting on dimension.
    *
-   * @param dimension A row from the training data, which might be a
-   *     candidate for the splitting dimension.
+   * @param labels Labels of the training data.
+   * @param weightD Weights of the training data.
+   * @param sortedIndex Indices of the points, sorted by their value in the
+   *     candidate splitting dimension.
    * @tparam UseWeights Whether we need to run a weighted Decision Stump.
    */
   template<bool UseWeights>
-  double SetupSplitDimension(const arma::rowvec& dimension,
-                             const arma::Row<size_t>& labels,
-                             const arma::rowvec& weightD);
+  double SetupSplitDimension(const arma::Row<size_t>& labels,
+                             const arma::rowvec& weightD,
+                             const arma::uvec& sortedIndex);
 
   /**
    * After having decided the dimension on which to split, train on that
@@ -142,10 +180,14 @@ class DecisionStump
    *
    * @tparam dimension dimension is the dimension decided by the constructor
    *      on which we now train the decision stump.
+   * @param labels Labels of the training data.
+   * @param sortedIndex Indices of the points, sorted by their value in the
+   *      dimension.
    */
   template<typename VecType>
   void TrainOnDim(const VecType& dimension,
-                  const arma::Row<size_t>& labels);
+                  const arma::Row<size_t>& labels,
+                  const arma::uvec& sortedIndex);
 
   /**
    * After the "split" matrix has been set up, merge ranges with identical class
@@ -189,13 +231,16 @@ class DecisionStump
    * @param data Dataset to train on.
    * @param labels Labels for dataset.
    * @param weights Weights for this set of labels.
+   * @param sortedIndices Sorted order of the points in each dimension, or NULL
+   *      if the data has not been presorted.
    * @tparam UseWeights If true, the weights in the weight vector will be used
    *      (otherwise they are ignored).
    */
   template<bool UseWeights>
   void Train(const MatType& data,
              const arma::Row<size_t>& labels,
-             const arma::rowvec& weights);
+             const arma::rowvec& weights,
+             const arma::umat* sortedIndices = NULL);
 };
 
 } // namespace decision_stump
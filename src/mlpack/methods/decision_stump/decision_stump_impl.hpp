@@ -77,40 +77,75 @@ template<typename MatType>
 template<bool UseWeights>
 void DecisionStump<MatType>::Train(const MatType& data,
                                    const arma::Row<size_t>& labels,
-                                   const arma::rowvec& weights)
+                                   const arma::rowvec& weights,
+                                   const arma::umat* sortedIndices)
 {
   // If classLabels are not all identical, proceed with training.
   size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
-  double gain, bestGain = 0.0;
-  for (size_t i = 0; i < data.n_rows; i++)
+  // Calculate the entropy of each candidate dimension.  The dimensions are
+  // independent, so they can be evaluated in parallel; the best one is chosen
+  // afterwards, in order, so the result does not depend on the number of
+  // threads.
+  arma::vec entropies(data.n_rows);
+  std::vector<char> distinct(data.n_rows, 0);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t d = 0; d < (intmax_t) data.n_rows; d++)
   {
     // Go through each dimension of the data.
+    const size_t i = (size_t) d;
     if (IsDistinct(data.row(i)))
     {
       // For each dimension with non-identical values, treat it as a potential
       // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
-
-      gain = rootEntropy - entropy;
-      // Find the dimension with the best entropy so that the gain is
-      // maximized.
-
-      // We are maximizing gain, which is what is returned from
-      // SetupSplitDimension().
-      if (gain < bestGain)
+      distinct[i] = 1;
+      if (sortedIndices)
+      {
+        entropies[i] = SetupSplitDimension<UseWeights>(labels, weights,
+            sortedIndices->unsafe_col(i));
+      }
+      else
       {
-        bestDim = i;
-        bestGain = gain;
+        const arma::rowvec dimension = data.row(i);
+        entropies[i] = SetupSplitDimension<UseWeights>(labels, weights,
+            arma::stable_sort_index(dimension.t()));
       }
     }
   }
+
+  double gain, bestGain = 0.0;
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    if (!distinct[i])
+      continue;
+
+    gain = rootEntropy - entropies[i];
+    // Find the dimension with the best entropy so that the gain is
+    // maximized.
+
+    // We are maximizing gain, which is what is returned from
+    // SetupSplitDimension().
+    if (gain < bestGain)
+    {
+      bestDim = i;
+      bestGain = gain;
+    }
+  }
   splitDimension = bestDim;
 
   // Once the splitting column/dimension has been decided, train on it.
-  TrainOnDim(data.row(splitDimension), labels);
+  if (sortedIndices)
+  {
+    TrainOnDim(data.row(splitDimension), labels,
+        sortedIndices->unsafe_col(splitDimension));
+  }
+  else
+  {
+    const arma::rowvec dimension = data.row(splitDimension);
+    TrainOnDim(dimension, labels, arma::stable_sort_index(dimension.t()));
+  }
 }
 
 /**
@@ -126,21 +161,20 @@ void DecisionStump<MatType>::Classify(const MatType& test,
                                       arma::Row<size_t>& predictedLabels)
 {
   predictedLabels.set_size(test.n_cols);
-  for (size_t i = 0; i < test.n_cols; i++)
-  {
-    // Determine which bin the test point falls into.
-    // Assume first that it falls into the first bin, then proceed through the
-    // bins until it is known which bin it falls into.
-    size_t bin = 0;
-    const double val = test(splitDimension, i);
 
-    while (bin < split.n_elem - 1)
-    {
-      if (val < split(bin + 1))
-        break;
+  // The split values are sorted, so the bin that a test point falls into is the
+  // number of split values (after the first) that are not greater than it.
+  // Finding that with a binary search is much faster than a linear scan when
+  // there are many bins.
+  const double* splitBegin = split.memptr() + 1;
+  const double* splitEnd = split.memptr() + split.n_elem;
 
-      ++bin;
-    }
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) test.n_cols; i++)
+  {
+    const double val = test(splitDimension, i);
+    const size_t bin = std::upper_bound(splitBegin, splitEnd, val) -
+        splitBegin;
 
     predictedLabels(i) = binLabels(bin);
   }
@@ -169,6 +203,56 @@ DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
   Train<true>(data, labels, weights);
 }
 
+/**
+ * Alternate constructor which copies parameters bucketSize and numClasses
+ * from an already initiated decision stump, other, and uses the given sorted
+ * order of each dimension instead of sorting the data.
+ *
+ * @param other The other initiated Decision Stump object from
+ *      which we copy the values from.
+ * @param data The data on which to train this object on.
+ * @param D Weight vector to use while training. For boosting purposes.
+ * @param labels The labels of data.
+ * @param sortedIndices Sorted order of each dimension, from Presort().
+ */
+template<typename MatType>
+DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
+                                      const MatType& data,
+                                      const arma::Row<size_t>& labels,
+                                      const arma::rowvec& weights,
+                                      const arma::umat& sortedIndices) :
+    classes(other.classes),
+    bucketSize(other.bucketSize)
+{
+  if (sortedIndices.n_rows != data.n_cols ||
+      sortedIndices.n_cols != data.n_rows)
+    Log::Fatal << "DecisionStump::DecisionStump(): sortedIndices has size "
+        << sortedIndices.n_rows << "x" << sortedIndices.n_cols << " but should "
+        << "have size " << data.n_cols << "x" << data.n_rows << "!"
+        << std::endl;
+
+  Train<true>(data, labels, weights, &sortedIndices);
+}
+
+/**
+ * Compute the sorted order of the points in each dimension.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::Presort(const MatType& data,
+                                     arma::umat& sortedIndices)
+{
+  sortedIndices.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t d = 0; d < (intmax_t) data.n_rows; d++)
+  {
+    // This must be the same sort that Train() uses when the data is not
+    // presorted, so that both give the same stump.
+    const arma::rowvec dimension = data.row(d);
+    sortedIndices.col(d) = arma::stable_sort_index(dimension.t());
+  }
+}
+
 /**
  * Serialize the decision stump.
  */
@@ -192,31 +276,28 @@ void DecisionStump<MatType>::Serialize(Archive& ar,
  * Sets up dimension as if it were splitting on it and finds entropy when
  * splitting on dimension.
  *
- * @param dimension A row from the training data, which might be a candidate for
- *      the splitting dimension.
- * @param UseWeights Whether we need to run a weighted Decision Stump.
+ * @param labels Labels of the training data.
+ * @param weights Weights of the training data.
+ * @param sortedIndexDim Indices of the points, sorted by their value in the
+ *      candidate splitting dimension.
+ * @tparam UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
 template<bool UseWeights>
 double DecisionStump<MatType>::SetupSplitDimension(
-    const arma::rowvec& dimension,
     const arma::Row<size_t>& labels,
-    const arma::rowvec& weights)
+    const arma::rowvec& weights,
+    const arma::uvec& sortedIndexDim)
 {
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Sort the dimension in order to calculate splitting ranges.
-  arma::rowvec sortedDim = arma::sort(dimension);
-
-  // Store the indices of the sorted dimension to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexDim = arma::stable_sort_index(dimension.t());
-
-  arma::Row<size_t> sortedLabels(dimension.n_elem);
-  arma::rowvec sortedWeights(dimension.n_elem);
+  // Use the (stably) sorted indices of the dimension to build a vector of
+  // sorted labels.
+  arma::Row<size_t> sortedLabels(sortedIndexDim.n_elem);
+  arma::rowvec sortedWeights(sortedIndexDim.n_elem);
 
-  for (i = 0; i < dimension.n_elem; i++)
+  for (i = 0; i < sortedIndexDim.n_elem; i++)
   {
     sortedLabels(i) = labels(sortedIndexDim(i));
 
@@ -292,17 +373,19 @@ double DecisionStump<MatType>::SetupSplitDimension(
 template<typename MatType>
 template<typename VecType>
 void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
-                                        const arma::Row<size_t>& labels)
+                                        const arma::Row<size_t>& labels,
+                                        const arma::uvec& sortedSplitIndexDim)
 {
   size_t i, count, begin, end;
 
-  arma::rowvec sortedSplitDim = arma::sort(dimension);
-  arma::uvec sortedSplitIndexDim = arma::stable_sort_index(dimension.t());
+  arma::rowvec sortedSplitDim(dimension.n_elem);
   arma::Row<size_t> sortedLabels(dimension.n_elem);
-  sortedLabels.fill(0);
 
   for (i = 0; i < dimension.n_elem; i++)
+  {
+    sortedSplitDim(i) = dimension(sortedSplitIndexDim(i));
     sortedLabels(i) = labels(sortedSplitIndexDim(i));
+  }
 
   arma::rowvec subCols;
   double mostFreq;
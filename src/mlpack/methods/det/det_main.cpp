@@ -135,10 +135,9 @@ int main(int argc, char *argv[])
     if (CLI::HasParam("training_set_estimates_file"))
     {
       // Compute density estimates for each point in the training set.
-      arma::rowvec trainingDensities(trainingData.n_cols);
+      arma::rowvec trainingDensities;
       Timer::Start("det_estimation_time");
-      for (size_t i = 0; i < trainingData.n_cols; i++)
-        trainingDensities[i] = tree->ComputeValue(trainingData.unsafe_col(i));
+      tree->ComputeValue(trainingData, trainingDensities);
       Timer::Stop("det_estimation_time");
 
       data::Save(CLI::GetParam<string>("training_set_estimates_file"),
@@ -161,9 +160,8 @@ int main(int argc, char *argv[])
 
     // Compute test set densities.
     Timer::Start("det_test_set_estimation");
-    arma::rowvec testDensities(testData.n_cols);
-    for (size_t i = 0; i < testData.n_cols; i++)
-      testDensities[i] = tree->ComputeValue(testData.unsafe_col(i));
+    arma::rowvec testDensities;
+    tree->ComputeValue(testData, testDensities);
     Timer::Stop("det_test_set_estimation");
 
     if (CLI::GetParam<string>("test_set_estimates_file") != "")
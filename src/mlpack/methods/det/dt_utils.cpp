@@ -116,8 +116,8 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
 
   // Growing the tree
   double oldAlpha = 0.0;
-  double alpha = dtree.Grow(newDataset, oldFromNew, useVolumeReg, maxLeafSize,
-      minLeafSize);
+  double alpha = dtree.GrowPresorted(newDataset, oldFromNew, useVolumeReg,
+      maxLeafSize, minLeafSize);
 
   Log::Info << dtree.SubtreeLeaves() << " leaf nodes in the tree using full "
       << "dataset; minimum alpha: " << alpha << "." << std::endl;
@@ -129,11 +129,10 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
     std::ofstream outfile(unprunedTreeOutput.c_str());
     if (outfile.good())
     {
-      for (size_t i = 0; i < dataset.n_cols; ++i)
-      {
-        arma::vec testPoint = dataset.unsafe_col(i);
-        outfile << dtree.ComputeValue(testPoint) << std::endl;
-      }
+      arma::rowvec densities;
+      dtree.ComputeValue(dataset, densities);
+      for (size_t i = 0; i < densities.n_elem; ++i)
+        outfile << densities[i] << std::endl;
     }
     else
     {
@@ -220,7 +219,7 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
       cvOldFromNew[i] = i;
 
     // Grow the tree.
-    cvDTree.Grow(train, cvOldFromNew, useVolumeReg, maxLeafSize,
+    cvDTree.GrowPresorted(train, cvOldFromNew, useVolumeReg, maxLeafSize,
         minLeafSize);
 
     // Sequentially prune with all the values of available alphas and adding
@@ -228,16 +227,13 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
     // trees in the pruned sequence.
     arma::vec cvRegularizationConstants(prunedSequence.size());
     cvRegularizationConstants.fill(0.0);
+    arma::rowvec testDensities;
     for (size_t i = 0;
          i < ((prunedSequence.size() < 2) ? 0 : prunedSequence.size() - 2); ++i)
     {
       // Compute test values for this state of the tree.
-      double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; j++)
-      {
-        arma::vec testPoint = test.unsafe_col(j);
-        cvVal += cvDTree.ComputeValue(testPoint);
-      }
+      cvDTree.ComputeValue(test, testDensities);
+      const double cvVal = arma::accu(testDensities);
 
       // Update the cv regularization constant.
       cvRegularizationConstants[i] += 2.0 * cvVal / (double) dataset.n_cols;
@@ -249,12 +245,8 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
     }
 
     // Compute test values for this state of the tree.
-    double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
-    {
-      arma::vec testPoint = test.unsafe_col(i);
-      cvVal += cvDTree.ComputeValue(testPoint);
-    }
+    cvDTree.ComputeValue(test, testDensities);
+    const double cvVal = arma::accu(testDensities);
 
     if (prunedSequence.size() > 2)
       cvRegularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal /
@@ -296,8 +288,8 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
 
   // Grow the tree.
   oldAlpha = -DBL_MAX;
-  alpha = dtreeOpt->Grow(newDataset, oldFromNew, useVolumeReg, maxLeafSize,
-      minLeafSize);
+  alpha = dtreeOpt->GrowPresorted(newDataset, oldFromNew, useVolumeReg,
+      maxLeafSize, minLeafSize);
 
   // Prune with optimal alpha.
   while ((oldAlpha < optimalAlpha) && (dtreeOpt->SubtreeLeaves() > 1))
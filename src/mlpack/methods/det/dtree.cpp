@@ -8,6 +8,7 @@
  */
 #include "dtree.hpp"
 #include <stack>
+#include <map>
 
 using namespace mlpack;
 using namespace det;
@@ -167,7 +168,8 @@ bool DTree::FindSplit(const arma::mat& data,
                       double& splitValue,
                       double& leftError,
                       double& rightError,
-                      const size_t minLeafSize) const
+                      const size_t minLeafSize,
+                      const arma::Mat<size_t>* sortedIndices) const
 {
   // Ensure the dimensionality of the data is the same as the dimensionality of
   // the bounding rectangle.
@@ -179,8 +181,19 @@ bool DTree::FindSplit(const arma::mat& data,
   double minError = logNegError;
   bool splitFound = false;
 
+  // The best split of each dimension is found independently (in parallel, if
+  // the node is large enough to be worth it); the best dimension is chosen
+  // afterwards, in order.
+  arma::vec minDimErrors(maxVals.n_elem);
+  arma::vec dimLeftErrors(maxVals.n_elem);
+  arma::vec dimRightErrors(maxVals.n_elem);
+  arma::vec dimSplitValues(maxVals.n_elem);
+  std::vector<unsigned char> dimSplitsFound(maxVals.n_elem, 0);
+
   // Loop through each dimension.
-  for (size_t dim = 0; dim < maxVals.n_elem; dim++)
+  #pragma omp parallel for schedule(dynamic) \
+      if (points * maxVals.n_elem >= 65536)
+  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; dim++)
   {
     // Have to deal with REAL, INTEGER, NOMINAL data differently, so we have to
     // think of how to do that...
@@ -199,14 +212,20 @@ bool DTree::FindSplit(const arma::mat& data,
     double dimRightError = 0.0; // always be set to something else before use.
     double dimSplitValue = 0.0;
 
-    // Find the log volume of all the other dimensions.
-    double volumeWithoutDim = logVolume - std::log(max - min);
-
-    // Get the values for the dimension.
-    arma::rowvec dimVec = data.row(dim).subvec(start, end - 1);
-
-    // Sort the values in ascending order.
-    dimVec = arma::sort(dimVec);
+    // Get the values for the dimension, in ascending order.
+    arma::rowvec dimVec;
+    if (sortedIndices)
+    {
+      dimVec.set_size(points);
+      const size_t* indices = sortedIndices->colptr(dim) + start;
+      for (size_t i = 0; i < points; ++i)
+        dimVec[i] = data(dim, indices[i]);
+    }
+    else
+    {
+      dimVec = data.row(dim).subvec(start, end - 1);
+      dimVec = arma::sort(dimVec);
+    }
 
     // Find the best split for this dimension.  We need to figure out why
     // there are spikes if this minLeafSize is enforced here...
@@ -248,20 +267,36 @@ bool DTree::FindSplit(const arma::mat& data,
       }
     }
 
-    double actualMinDimError = std::log(minDimError)
+    minDimErrors[dim] = minDimError;
+    dimLeftErrors[dim] = dimLeftError;
+    dimRightErrors[dim] = dimRightError;
+    dimSplitValues[dim] = dimSplitValue;
+    dimSplitsFound[dim] = dimSplitFound;
+  }
+
+  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+  {
+    if (!dimSplitsFound[dim])
+      continue;
+
+    // Find the log volume of all the other dimensions.
+    const double volumeWithoutDim = logVolume -
+        std::log(maxVals[dim] - minVals[dim]);
+
+    double actualMinDimError = std::log(minDimErrors[dim])
         - 2 * std::log((double) data.n_cols) - volumeWithoutDim;
 
-    if ((actualMinDimError > minError) && dimSplitFound)
+    if (actualMinDimError > minError)
     {
       // Calculate actual error (in logspace) by adding terms back to our
       // estimate.
       minError = actualMinDimError;
       splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
-          - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
-          - volumeWithoutDim;
+      splitValue = dimSplitValues[dim];
+      leftError = std::log(dimLeftErrors[dim]) - 2 * std::log((double)
+          data.n_cols) - volumeWithoutDim;
+      rightError = std::log(dimRightErrors[dim]) - 2 * std::log((double)
+          data.n_cols) - volumeWithoutDim;
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -312,8 +347,6 @@ double DTree::Grow(arma::mat& data,
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
-  double leftG, rightG;
-
   // Compute points ratio.
   ratio = (double) (end - start) / (double) oldFromNew.n_elem;
 
@@ -353,26 +386,12 @@ double DTree::Grow(arma::mat& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-          minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+      const double leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
           minLeafSize);
+      const double rightG = right->Grow(data, oldFromNew, useVolReg,
+          maxLeafSize, minLeafSize);
 
-      // Store values of R(T~) and |T~|.
-      subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
-
-      // Find the log negative error of the subtree leaves.  This is kind of an
-      // odd one because we don't want to represent the error in non-log-space,
-      // but we have to calculate log(E_l + E_r).  So we multiply E_l and E_r by
-      // V_t (remember E_l has an inverse relationship to the volume of the
-      // nodes) and then subtract log(V_t) at the end of the whole expression.
-      // As a result we do leave log-space, but the largest quantity we
-      // represent is on the order of (V_t / V_i) where V_i is the smallest leaf
-      // node below this node, which depends heavily on the depth of the tree.
-      subtreeLeavesLogNegError = std::log(
-          std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
-          std::exp(logVolume + right->SubtreeLeavesLogNegError()))
-          - logVolume;
+      return UpdateSubtree(leftG, rightG, data.n_cols, useVolReg);
     }
     else
     {
@@ -389,64 +408,287 @@ double DTree::Grow(arma::mat& data,
     subtreeLeavesLogNegError = logNegError;
   }
 
-  // If this is a leaf, do not compute g_k(t); otherwise compute, store, and
-  // propagate min(g_k(t_L), g_k(t_R), g_k(t)), unless t_L and/or t_R are
-  // leaves.
-  if (subtreeLeaves == 1)
+  // If this is a leaf, do not compute g_k(t).
+  return std::numeric_limits<double>::max();
+}
+
+// Compute, store, and propagate min(g_k(t_L), g_k(t_R), g_k(t)) for a node
+// whose children have been grown.
+double DTree::UpdateSubtree(const double leftG,
+                            const double rightG,
+                            const size_t totalPoints,
+                            const bool useVolReg)
+{
+  // Store values of R(T~) and |T~|.
+  subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
+
+  // Find the log negative error of the subtree leaves.  This is kind of an odd
+  // one because we don't want to represent the error in non-log-space, but we
+  // have to calculate log(E_l + E_r).  So we multiply E_l and E_r by V_t
+  // (remember E_l has an inverse relationship to the volume of the nodes) and
+  // then subtract log(V_t) at the end of the whole expression.  As a result we
+  // do leave log-space, but the largest quantity we represent is on the order
+  // of (V_t / V_i) where V_i is the smallest leaf node below this node, which
+  // depends heavily on the depth of the tree.
+  subtreeLeavesLogNegError = std::log(
+      std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
+      std::exp(logVolume + right->SubtreeLeavesLogNegError()))
+      - logVolume;
+
+  const double range = maxVals[splitDim] - minVals[splitDim];
+  const double leftRatio = (splitValue - minVals[splitDim]) / range;
+  const double rightRatio = (maxVals[splitDim] - splitValue) / range;
+
+  const size_t leftPow = std::pow((double) (left->End() - left->Start()), 2);
+  const size_t rightPow = std::pow((double) (right->End() - right->Start()), 2);
+  const size_t thisPow = std::pow((double) (end - start), 2);
+
+  double tmpAlphaSum = leftPow / leftRatio + rightPow / rightRatio - thisPow;
+
+  if (left->SubtreeLeaves() > 1)
   {
-    return std::numeric_limits<double>::max();
+    const double exponent = 2 * std::log((double) totalPoints) + logVolume +
+        left->AlphaUpper();
+
+    // Whether or not this will overflow is highly dependent on the depth of
+    // the tree.
+    tmpAlphaSum += std::exp(exponent);
+  }
+
+  if (right->SubtreeLeaves() > 1)
+  {
+    const double exponent = 2 * std::log((double) totalPoints) + logVolume +
+        right->AlphaUpper();
+
+    tmpAlphaSum += std::exp(exponent);
+  }
+
+  alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) totalPoints)
+      - logVolume;
+
+  double gT;
+  if (useVolReg)
+  {
+    // This is wrong for now!
+    gT = alphaUpper;// / (subtreeLeavesVTInv - vTInv);
   }
   else
   {
-    const double range = maxVals[splitDim] - minVals[splitDim];
-    const double leftRatio = (splitValue - minVals[splitDim]) / range;
-    const double rightRatio = (maxVals[splitDim] - splitValue) / range;
+    gT = alphaUpper - std::log((double) (subtreeLeaves - 1));
+  }
 
-    const size_t leftPow = std::pow((double) (left->End() - left->Start()), 2);
-    const size_t rightPow = std::pow((double) (right->End() - right->Start()),
-        2);
-    const size_t thisPow = std::pow((double) (end - start), 2);
+  return std::min(gT, std::min(leftG, rightG));
+}
 
-    double tmpAlphaSum = leftPow / leftRatio + rightPow / rightRatio - thisPow;
+// Greedily expand the tree, using indices of the points sorted in each
+// dimension.
+double DTree::GrowPresorted(arma::mat& data,
+                            arma::Col<size_t>& oldFromNew,
+                            const bool useVolReg,
+                            const size_t maxLeafSize,
+                            const size_t minLeafSize)
+{
+  Log::Assert(data.n_rows == maxVals.n_elem);
+  Log::Assert(data.n_rows == minVals.n_elem);
 
-    if (left->SubtreeLeaves() > 1)
-    {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
-          left->AlphaUpper();
+  const size_t totalPoints = oldFromNew.n_elem;
+
+  // Sort the points of this node in each dimension.  Rows [start, end) of
+  // column d hold the indices of the points of a node, sorted by dimension d;
+  // splitting a node partitions those rows (stably) between its children.  The
+  // data itself is not moved until the tree is grown.
+  arma::Mat<size_t> sortedIndices(data.n_cols, data.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t dim = 0; dim < (intmax_t) data.n_rows; ++dim)
+  {
+    size_t* indices = sortedIndices.colptr(dim);
+    for (size_t i = start; i < end; ++i)
+      indices[i] = i;
+
+    std::stable_sort(indices + start, indices + end,
+        [&](const size_t a, const size_t b)
+        { return data(dim, a) < data(dim, b); });
+  }
 
-      // Whether or not this will overflow is highly dependent on the depth of
-      // the tree.
-      tmpAlphaSum += std::exp(exponent);
+  // Whether each point goes to the left child of the node being split.
+  std::vector<unsigned char> goesLeft(data.n_cols);
+
+  // Split the top of the tree breadth-first until there are enough subtrees to
+  // keep every thread busy.
+#ifdef HAS_OPENMP
+  const size_t targetSubtrees = 4 * omp_get_max_threads();
+#else
+  const size_t targetSubtrees = 1;
+#endif
+  std::vector<DTree*> splitNodes; // In breadth-first order.
+  std::vector<DTree*> subtrees(1, this);
+  while (subtrees.size() < targetSubtrees)
+  {
+    std::vector<DTree*> nextSubtrees;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->SplitPresorted(data, sortedIndices, goesLeft,
+          totalPoints, maxLeafSize, minLeafSize))
+      {
+        splitNodes.push_back(subtrees[i]);
+        nextSubtrees.push_back(subtrees[i]->left);
+        nextSubtrees.push_back(subtrees[i]->right);
+      }
     }
 
-    if (right->SubtreeLeaves() > 1)
+    subtrees.swap(nextSubtrees);
+    if (subtrees.empty())
+      break;
+  }
+
+  // The subtrees hold disjoint sets of points, so they can be grown
+  // independently.
+  std::map<const DTree*, double> g;
+  std::vector<double> subtreeG(subtrees.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t i = 0; i < (intmax_t) subtrees.size(); ++i)
+  {
+    subtreeG[i] = subtrees[i]->GrowPresortedSubtree(data, sortedIndices,
+        goesLeft, totalPoints, useVolReg, maxLeafSize, minLeafSize);
+  }
+  for (size_t i = 0; i < subtrees.size(); ++i)
+    g[subtrees[i]] = subtreeG[i];
+
+  // Now finish the nodes that were split above, from the bottom up.  Children
+  // that are not in g are leaves.
+  for (size_t i = splitNodes.size(); i > 0; --i)
+  {
+    DTree* node = splitNodes[i - 1];
+    const double leftG = g.count(node->left) ? g[node->left] :
+        std::numeric_limits<double>::max();
+    const double rightG = g.count(node->right) ? g[node->right] :
+        std::numeric_limits<double>::max();
+    g[node] = node->UpdateSubtree(leftG, rightG, totalPoints, useVolReg);
+  }
+
+  // Reorder the points so that the points of each node are contiguous, like
+  // Grow() does; the rows of any dimension of sortedIndices give that order.
+  // The permutation is applied in place, one cycle at a time.
+  if (data.n_rows > 0)
+  {
+    const size_t* order = sortedIndices.colptr(0);
+    std::vector<unsigned char> placed(data.n_cols, 0);
+    arma::vec tmpCol(data.n_rows);
+    for (size_t i = start; i < end; ++i)
     {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
-          right->AlphaUpper();
+      if (placed[i])
+        continue;
 
-      tmpAlphaSum += std::exp(exponent);
+      tmpCol = data.col(i);
+      const size_t tmpIndex = oldFromNew[i];
+      size_t j = i;
+      while (order[j] != i)
+      {
+        data.col(j) = data.col(order[j]);
+        oldFromNew[j] = oldFromNew[order[j]];
+        placed[j] = 1;
+        j = order[j];
+      }
+      data.col(j) = tmpCol;
+      oldFromNew[j] = tmpIndex;
+      placed[j] = 1;
     }
+  }
 
-    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) data.n_cols)
-        - logVolume;
+  return g.count(this) ? g[this] : std::numeric_limits<double>::max();
+}
 
-    double gT;
-    if (useVolReg)
+bool DTree::SplitPresorted(const arma::mat& data,
+                           arma::Mat<size_t>& sortedIndices,
+                           std::vector<unsigned char>& goesLeft,
+                           const size_t totalPoints,
+                           const size_t maxLeafSize,
+                           const size_t minLeafSize)
+{
+  // Compute points ratio.
+  ratio = (double) (end - start) / (double) totalPoints;
+
+  // Compute the log of the volume of the node.
+  logVolume = 0;
+  for (size_t i = 0; i < maxVals.n_elem; ++i)
+    if (maxVals[i] - minVals[i] > 0.0)
+      logVolume += std::log(maxVals[i] - minVals[i]);
+
+  // Check if node is large enough to split.
+  size_t dim;
+  double splitValueTmp;
+  double leftError, rightError;
+  if ((size_t) (end - start) > maxLeafSize &&
+      FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+          &sortedIndices))
+  {
+    // The points that go left are a prefix of the points sorted in the split
+    // dimension.
+    const size_t* dimIndices = sortedIndices.colptr(dim);
+    size_t splitIndex = start;
+    for (size_t i = start; i < end; ++i)
     {
-      // This is wrong for now!
-      gT = alphaUpper;// / (subtreeLeavesVTInv - vTInv);
+      goesLeft[dimIndices[i]] = (data(dim, dimIndices[i]) <= splitValueTmp);
+      if (goesLeft[dimIndices[i]])
+        ++splitIndex;
     }
-    else
+
+    // Partition the sorted indices of every dimension between the children,
+    // keeping them sorted.
+    #pragma omp parallel for schedule(dynamic) \
+        if ((end - start) * data.n_rows >= 65536)
+    for (intmax_t d = 0; d < (intmax_t) data.n_rows; ++d)
     {
-      gT = alphaUpper - std::log((double) (subtreeLeaves - 1));
+      size_t* indices = sortedIndices.colptr(d);
+      std::stable_partition(indices + start, indices + end,
+          [&](const size_t i) { return goesLeft[i] != 0; });
     }
 
-    return std::min(gT, std::min(leftG, rightG));
+    // Make max and min vals for the children.
+    arma::vec maxValsL(maxVals);
+    arma::vec maxValsR(maxVals);
+    arma::vec minValsL(minVals);
+    arma::vec minValsR(minVals);
+
+    maxValsL[dim] = splitValueTmp;
+    minValsR[dim] = splitValueTmp;
+
+    // Store split dim and split val in the node.
+    splitValue = splitValueTmp;
+    splitDim = dim;
+
+    left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
+    right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
+
+    return true;
   }
 
-  // We need to compute (c_t^2) * r_t for all subtree leaves; this is equal to
-  // n_t ^ 2 / r_t * n ^ 2 = -error.  Therefore the value we need is actually
-  // -1.0 * subtreeLeavesError.
+  // Make a leaf out of this node.
+  assert(((size_t) (end - start) > maxLeafSize) ||
+      ((size_t) (end - start) >= minLeafSize));
+  subtreeLeaves = 1;
+  subtreeLeavesLogNegError = logNegError;
+  return false;
+}
+
+double DTree::GrowPresortedSubtree(const arma::mat& data,
+                                   arma::Mat<size_t>& sortedIndices,
+                                   std::vector<unsigned char>& goesLeft,
+                                   const size_t totalPoints,
+                                   const bool useVolReg,
+                                   const size_t maxLeafSize,
+                                   const size_t minLeafSize)
+{
+  if (!SplitPresorted(data, sortedIndices, goesLeft, totalPoints, maxLeafSize,
+      minLeafSize))
+    return std::numeric_limits<double>::max();
+
+  const double leftG = left->GrowPresortedSubtree(data, sortedIndices,
+      goesLeft, totalPoints, useVolReg, maxLeafSize, minLeafSize);
+  const double rightG = right->GrowPresortedSubtree(data, sortedIndices,
+      goesLeft, totalPoints, useVolReg, maxLeafSize, minLeafSize);
+
+  return UpdateSubtree(leftG, rightG, totalPoints, useVolReg);
 }
 
 
@@ -606,6 +848,101 @@ double DTree::ComputeValue(const arma::vec& query) const
   return 0.0;
 }
 
+void DTree::ComputeValue(const arma::mat& queries, arma::rowvec& densities)
+    const
+{
+  Log::Assert(queries.n_rows == maxVals.n_elem);
+
+  std::vector<FlatNode> nodes;
+  Flatten(nodes);
+
+  densities.set_size(queries.n_cols);
+
+  // Queries are handled in blocks, so that each thread walks the (now compact)
+  // tree for many points in a row.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (queries.n_cols + blockSize - 1) / blockSize;
+  const FlatNode* flat = &nodes[0];
+
+  #pragma omp parallel for schedule(static) if (numBlocks > 1)
+  for (intmax_t block = 0; block < (intmax_t) numBlocks; ++block)
+  {
+    const size_t begin = block * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) queries.n_cols);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double* query = queries.colptr(i);
+
+      // Like ComputeValue(), only the root checks whether the query is within
+      // the range of the data.
+      bool withinRange = true;
+      if (root == 1)
+      {
+        for (size_t d = 0; d < queries.n_rows; ++d)
+        {
+          if ((query[d] < minVals[d]) || (query[d] > maxVals[d]))
+          {
+            withinRange = false;
+            break;
+          }
+        }
+      }
+
+      if (!withinRange)
+      {
+        densities[i] = 0.0;
+        continue;
+      }
+
+      size_t node = 0;
+      while (flat[node].firstChild != 0)
+      {
+        node = flat[node].firstChild +
+            ((query[flat[node].splitDim] <= flat[node].value) ? 0 : 1);
+      }
+
+      densities[i] = flat[node].value;
+    }
+  }
+}
+
+void DTree::Flatten(std::vector<FlatNode>& nodes) const
+{
+  nodes.clear();
+  nodes.reserve(2 * subtreeLeaves - 1);
+  nodes.resize(1);
+
+  // Each entry on the stack is a node of the tree and the index it was given in
+  // the flattened array; children are given adjacent indices.
+  std::stack<std::pair<const DTree*, size_t> > stack;
+  stack.push(std::make_pair(this, 0));
+  while (!stack.empty())
+  {
+    const DTree* node = stack.top().first;
+    const size_t index = stack.top().second;
+    stack.pop();
+
+    if (node->subtreeLeaves == 1)
+    {
+      nodes[index].splitDim = 0;
+      nodes[index].value = std::exp(std::log(node->ratio) - node->logVolume);
+      nodes[index].firstChild = 0;
+    }
+    else
+    {
+      const size_t firstChild = nodes.size();
+      // Set the fields through the index, since resize() may reallocate.
+      nodes.resize(firstChild + 2);
+      nodes[index].splitDim = node->splitDim;
+      nodes[index].value = node->splitValue;
+      nodes[index].firstChild = firstChild;
+
+      stack.push(std::make_pair(node->right, firstChild + 1));
+      stack.push(std::make_pair(node->left, firstChild));
+    }
+  }
+}
+
 
 void DTree::WriteTree(FILE *fp, const size_t level) const
 {
@@ -120,6 +120,29 @@ class DTree
               const size_t maxLeafSize = 10,
               const size_t minLeafSize = 5);
 
+  /**
+   * Greedily expand the tree, like Grow(), but sort each dimension of the data
+   * once before growing and partition the sorted indices down the tree instead
+   * of sorting the points of every node again.  The tree is the same as the
+   * tree built by Grow(), but the points in each leaf may be in a different
+   * order.  An extra (points x dimensions) matrix of indices is used.
+   *
+   * If OpenMP is available, the best split of large nodes is searched for in
+   * parallel over the dimensions, and independent subtrees are grown in
+   * parallel.
+   *
+   * @param data Dataset to build tree on.
+   * @param oldFromNew Mappings from old points to new points.
+   * @param useVolReg If true, volume regularization is used.
+   * @param maxLeafSize Maximum size of a leaf.
+   * @param minLeafSize Minimum size of a leaf.
+   */
+  double GrowPresorted(arma::mat& data,
+                       arma::Col<size_t>& oldFromNew,
+                       const bool useVolReg = false,
+                       const size_t maxLeafSize = 10,
+                       const size_t minLeafSize = 5);
+
   /**
    * Perform alpha pruning on a tree.  Returns the new value of alpha.
    *
@@ -139,6 +162,18 @@ class DTree
    */
   double ComputeValue(const arma::vec& query) const;
 
+  /**
+   * Compute the density estimates of all of the given query points.  The tree
+   * is first flattened into a contiguous array of nodes, which is then
+   * traversed iteratively for each query; if OpenMP is available, blocks of
+   * queries are handled in parallel.  The results are the same as calling
+   * ComputeValue() on each query.
+   *
+   * @param queries Points to estimate the density of (one per column).
+   * @param densities Vector to store the density estimates in.
+   */
+  void ComputeValue(const arma::mat& queries, arma::rowvec& densities) const;
+
   /**
    * Print the tree in a depth-first manner (this function is called
    * recursively).
@@ -239,6 +274,23 @@ class DTree
   //! The right child.
   DTree* right;
 
+  /**
+   * A node of a flattened tree, used for batch queries.  A node is a leaf if
+   * firstChild is 0; otherwise its children are firstChild and firstChild + 1.
+   */
+  struct FlatNode
+  {
+    //! The splitting dimension of the node.
+    size_t splitDim;
+    //! The split value of the node, or the density estimate of a leaf.
+    double value;
+    //! The index of the left child, or 0 for a leaf.
+    size_t firstChild;
+  };
+
+  //! Flatten the tree into the given array of nodes, with the root first.
+  void Flatten(std::vector<FlatNode>& nodes) const;
+
  public:
   //! Return the starting index of points contained in this node.
   size_t Start() const { return start; }
@@ -318,14 +370,17 @@ class DTree
   // Utility methods.
 
   /**
-   * Find the dimension to split on.
+   * Find the dimension to split on.  If sortedIndices is given, the points of
+   * this node in each dimension are taken from it in sorted order (see
+   * GrowPresorted()) instead of being sorted here.
    */
   bool FindSplit(const arma::mat& data,
                  size_t& splitDim,
                  double& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const arma::Mat<size_t>* sortedIndices = NULL) const;
 
   /**
    * Split the data, returning the number of points left of the split.
@@ -335,6 +390,41 @@ class DTree
                    const double splitValue,
                    arma::Col<size_t>& oldFromNew) const;
 
+  /**
+   * Compute the number of leaves, the error of the leaves, and the upper part
+   * of alpha of this node after its children have been grown, and return the
+   * smallest value of g_k(t) in the subtree, given the smallest values leftG
+   * and rightG of the children.
+   */
+  double UpdateSubtree(const double leftG,
+                       const double rightG,
+                       const size_t totalPoints,
+                       const bool useVolReg);
+
+  /**
+   * Split this node using the presorted indices of its points, creating (but
+   * not growing) its children, and partition the indices between the
+   * children.  If the node is not split, it is made a leaf.  Returns whether
+   * the node was split.
+   */
+  bool SplitPresorted(const arma::mat& data,
+                      arma::Mat<size_t>& sortedIndices,
+                      std::vector<unsigned char>& goesLeft,
+                      const size_t totalPoints,
+                      const size_t maxLeafSize,
+                      const size_t minLeafSize);
+
+  /**
+   * Grow the subtree rooted at this node using the presorted indices of its
+   * points, and return the smallest value of g_k(t) in the subtree.
+   */
+  double GrowPresortedSubtree(const arma::mat& data,
+                              arma::Mat<size_t>& sortedIndices,
+                              std::vector<unsigned char>& goesLeft,
+                              const size_t totalPoints,
+                              const bool useVolReg,
+                              const size_t maxLeafSize,
+                              const size_t minLeafSize);
 };
 
 } // namespace det
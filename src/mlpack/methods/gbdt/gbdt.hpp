@@ -0,0 +1,306 @@
+/**
+ * @file gbdt.hpp
+ *
+ * Definition of the GBDT class, which implements gradient boosted decision
+ * trees with histogram-based split finding.
+ */
+#ifndef MLPACK_METHODS_GBDT_GBDT_HPP
+#define MLPACK_METHODS_GBDT_GBDT_HPP
+
+#include <mlpack/core.hpp>
+
+#include "quantile_binner.hpp"
+#include "squared_error_loss.hpp"
+#include "logistic_loss.hpp"
+
+namespace mlpack {
+namespace gbdt /** Gradient boosted decision trees. */ {
+
+/**
+ * An implementation of gradient boosted decision trees (GBDT).  The model is a
+ * sum of regression trees; each tree is fit to the gradient of the loss of the
+ * trees before it, using the second-order (Newton) approximation of the loss
+ * to choose splits and leaf values, with L2 regularization on the leaf values.
+ * For more information, see the following papers:
+ *
+ * @code
+ * @article{friedman2001greedy,
+ *   title={Greedy function approximation: a gradient boosting machine},
+ *   author={Friedman, Jerome H.},
+ *   journal={Annals of Statistics},
+ *   volume={29},
+ *   number={5},
+ *   pages={1189--1232},
+ *   year={2001}
+ * }
+ *
+ * @inproceedings{chen2016xgboost,
+ *   title={XGBoost: A scalable tree boosting system},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining (KDD '16)},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * Before training, each feature is binned with a QuantileBinner, and splits
+ * are found from histograms of the gradients and hessians over the bins.  The
+ * histograms are built in parallel across features (if OpenMP is available),
+ * and only the histogram of the smaller child of each split is built from the
+ * data; the histogram of the larger child is the histogram of its parent minus
+ * the histogram of its sibling.
+ *
+ * Categorical features (as given by the DatasetInfo) are split by sorting the
+ * categories of a node by the ratio of their gradient and hessian sums and
+ * choosing the best prefix of that order, so a categorical split can send any
+ * subset of the categories to the left child.
+ *
+ * The trained trees are stored in a single flat array of nodes, so prediction
+ * does not need to follow any pointers; batch prediction is parallelized over
+ * the points.
+ *
+ * @tparam LossFunction Loss function to minimize; SquaredErrorLoss for
+ *     regression or LogisticLoss for binary classification.  The loss function
+ *     must implement the static functions InitialScore(), Gradients(),
+ *     Evaluate(), and Prediction() (see SquaredErrorLoss for details).
+ */
+template<typename LossFunction = SquaredErrorLoss>
+class GBDT
+{
+ public:
+  /**
+   * Train the model on the given data.
+   *
+   * @param data Training data (one point per column).
+   * @param datasetInfo Types of the features of the training data.
+   * @param responses Responses of the training points.
+   * @param numTrees Number of trees to train.
+   * @param learningRate Factor that each tree's predictions are scaled by.
+   * @param maxDepth Maximum depth of each tree.
+   * @param minLeafSize Minimum number of training points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param maxBins Maximum number of histogram bins for each feature (at most
+   *     256).
+   */
+  GBDT(const arma::mat& data,
+       const data::DatasetInfo& datasetInfo,
+       const arma::rowvec& responses,
+       const size_t numTrees = 100,
+       const double learningRate = 0.1,
+       const size_t maxDepth = 6,
+       const size_t minLeafSize = 20,
+       const double lambda = 1.0,
+       const size_t maxBins = 255);
+
+  /**
+   * Create the model with the given parameters, but without training.  The
+   * model will predict 0 for every point until Train() is called.
+   *
+   * @param numTrees Number of trees to train.
+   * @param learningRate Factor that each tree's predictions are scaled by.
+   * @param maxDepth Maximum depth of each tree.
+   * @param minLeafSize Minimum number of training points in each leaf.
+   * @param lambda L2 regularization of the leaf values.
+   * @param maxBins Maximum number of histogram bins for each feature (at most
+   *     256).
+   */
+  GBDT(const size_t numTrees = 100,
+       const double learningRate = 0.1,
+       const size_t maxDepth = 6,
+       const size_t minLeafSize = 20,
+       const double lambda = 1.0,
+       const size_t maxBins = 255);
+
+  /**
+   * Train the model on the given data, using the parameters of the model.  Any
+   * previously trained trees are discarded.
+   *
+   * @param data Training data (one point per column).
+   * @param datasetInfo Types of the features of the training data.
+   * @param responses Responses of the training points.
+   */
+  void Train(const arma::mat& data,
+             const data::DatasetInfo& datasetInfo,
+             const arma::rowvec& responses);
+
+  /**
+   * Predict the response of the given point.  For LogisticLoss, this is the
+   * probability of class 1.
+   *
+   * @param point Point to predict the response of.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const
+  {
+    return LossFunction::Prediction(Score(point));
+  }
+
+  /**
+   * Predict the responses of the given points.  If OpenMP is available, the
+   * points are handled in parallel.
+   *
+   * @param data Points to predict the responses of.
+   * @param predictions Vector to store the predictions in.
+   */
+  void Predict(const arma::mat& data, arma::rowvec& predictions) const;
+
+  /**
+   * Calculate the raw score of the given point: the sum of the initial score
+   * and the values of the leaves the point falls into.
+   *
+   * @param point Point to calculate the score of.
+   */
+  template<typename VecType>
+  double Score(const VecType& point) const;
+
+  //! Get the number of trained trees.
+  size_t NumTrainedTrees() const { return roots.size(); }
+  //! Get the total number of nodes in all trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the dimensionality of the model.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the number of trees to train.
+  size_t NumTrees() const { return numTrees; }
+  //! Modify the number of trees to train.
+  size_t& NumTrees() { return numTrees; }
+
+  //! Get the learning rate.
+  double LearningRate() const { return learningRate; }
+  //! Modify the learning rate.
+  double& LearningRate() { return learningRate; }
+
+  //! Get the maximum depth of each tree.
+  size_t MaxDepth() const { return maxDepth; }
+  //! Modify the maximum depth of each tree.
+  size_t& MaxDepth() { return maxDepth; }
+
+  //! Get the minimum number of training points in each leaf.
+  size_t MinLeafSize() const { return minLeafSize; }
+  //! Modify the minimum number of training points in each leaf.
+  size_t& MinLeafSize() { return minLeafSize; }
+
+  //! Get the L2 regularization of the leaf values.
+  double Lambda() const { return lambda; }
+  //! Modify the L2 regularization of the leaf values.
+  double& Lambda() { return lambda; }
+
+  //! Get the maximum number of histogram bins for each feature.
+  size_t MaxBins() const { return maxBins; }
+  //! Modify the maximum number of histogram bins for each feature.
+  size_t& MaxBins() { return maxBins; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * A node of a tree.  A node is a leaf if firstChild is 0 (the root of a tree
+   * is never a child).  The children of a node are adjacent: points go to
+   * firstChild or firstChild + 1.
+   */
+  struct Node
+  {
+    Node() :
+        splitDimension(0),
+        firstChild(0),
+        numCategories(0),
+        categoryOffset(0),
+        value(0.0)
+    { }
+
+    //! The dimension that this node splits on.
+    size_t splitDimension;
+    //! The index of the left child, or 0 if this node is a leaf.
+    size_t firstChild;
+    //! The number of categories of the split dimension, or 0 if it is numeric.
+    size_t numCategories;
+    //! For a categorical split, the index of the first direction of this node
+    //! in categoryTable.
+    size_t categoryOffset;
+    //! For a numeric split, points with values less than this go left; for a
+    //! leaf, this is the value of the leaf.
+    double value;
+  };
+
+  /**
+   * Build the histogram of the gradients, hessians, and counts of the given
+   * points over the bins of every feature.  Column binOffsets[d] + b of the
+   * histogram holds the sums for bin b of feature d.
+   */
+  void BuildHistogram(const arma::Mat<unsigned char>& bins,
+                      const arma::Col<size_t>& binOffsets,
+                      const arma::rowvec& gradients,
+                      const arma::rowvec& hessians,
+                      const std::vector<size_t>& indices,
+                      const size_t begin,
+                      const size_t end,
+                      arma::mat& histogram) const;
+
+  /**
+   * Find the best split of a node from its histogram.  The direction of each
+   * bin of the best dimension (0 for left, 1 for right) is stored in
+   * directions.  The gain of the split is returned; if no valid split is
+   * found, 0 is returned.
+   */
+  double FindSplit(const arma::mat& histogram,
+                   const QuantileBinner& binner,
+                   const arma::Col<size_t>& binOffsets,
+                   const double gradientSum,
+                   const double hessianSum,
+                   const size_t count,
+                   size_t& bestDimension,
+                   std::vector<unsigned char>& directions) const;
+
+  /**
+   * Split the given node (holding the points indices[begin, end)) if it is
+   * worth it, and recurse into its children; otherwise, make it a leaf and add
+   * its value to the scores of its points.
+   */
+  void Grow(const size_t node,
+            const size_t begin,
+            const size_t end,
+            const size_t depth,
+            const arma::mat& histogram,
+            const QuantileBinner& binner,
+            const arma::Col<size_t>& binOffsets,
+            const arma::Mat<unsigned char>& bins,
+            const arma::rowvec& gradients,
+            const arma::rowvec& hessians,
+            std::vector<size_t>& indices,
+            arma::rowvec& scores);
+
+  //! The number of trees to train.
+  size_t numTrees;
+  //! The factor that each tree's predictions are scaled by.
+  double learningRate;
+  //! The maximum depth of each tree.
+  size_t maxDepth;
+  //! The minimum number of training points in each leaf.
+  size_t minLeafSize;
+  //! The L2 regularization of the leaf values.
+  double lambda;
+  //! The maximum number of histogram bins for each feature.
+  size_t maxBins;
+
+  //! The dimensionality of the training data.
+  size_t dimensionality;
+  //! The score of a point before any trees are added.
+  double initialScore;
+  //! The nodes of all trees.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree in nodes.
+  std::vector<size_t> roots;
+  //! The direction of each category for each categorical split.
+  std::vector<unsigned char> categoryTable;
+};
+
+} // namespace gbdt
+} // namespace mlpack
+
+// Include implementation.
+#include "gbdt_impl.hpp"
+
+#endif
@@ -0,0 +1,458 @@
+/**
+ * @file gbdt_impl.hpp
+ *
+ * Implementation of the GBDT class.
+ */
+#ifndef MLPACK_METHODS_GBDT_GBDT_IMPL_HPP
+#define MLPACK_METHODS_GBDT_GBDT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gbdt.hpp"
+
+namespace mlpack {
+namespace gbdt {
+
+template<typename LossFunction>
+GBDT<LossFunction>::GBDT(const arma::mat& data,
+                         const data::DatasetInfo& datasetInfo,
+                         const arma::rowvec& responses,
+                         const size_t numTrees,
+                         const double learningRate,
+                         const size_t maxDepth,
+                         const size_t minLeafSize,
+                         const double lambda,
+                         const size_t maxBins) :
+    numTrees(numTrees),
+    learningRate(learningRate),
+    maxDepth(maxDepth),
+    minLeafSize(minLeafSize),
+    lambda(lambda),
+    maxBins(maxBins),
+    dimensionality(0),
+    initialScore(0.0)
+{
+  Train(data, datasetInfo, responses);
+}
+
+template<typename LossFunction>
+GBDT<LossFunction>::GBDT(const size_t numTrees,
+                         const double learningRate,
+                         const size_t maxDepth,
+                         const size_t minLeafSize,
+                         const double lambda,
+                         const size_t maxBins) :
+    numTrees(numTrees),
+    learningRate(learningRate),
+    maxDepth(maxDepth),
+    minLeafSize(minLeafSize),
+    lambda(lambda),
+    maxBins(maxBins),
+    dimensionality(0),
+    initialScore(0.0)
+{
+  // Nothing to do.
+}
+
+template<typename LossFunction>
+void GBDT<LossFunction>::Train(const arma::mat& data,
+                               const data::DatasetInfo& datasetInfo,
+                               const arma::rowvec& responses)
+{
+  if (responses.n_elem != data.n_cols)
+    Log::Fatal << "GBDT::Train(): number of responses (" << responses.n_elem
+        << ") does not match number of points (" << data.n_cols << ")!"
+        << std::endl;
+
+  if (data.n_cols == 0)
+    Log::Fatal << "GBDT::Train(): cannot train on an empty dataset!"
+        << std::endl;
+
+  nodes.clear();
+  roots.clear();
+  categoryTable.clear();
+  dimensionality = data.n_rows;
+
+  // Bin every feature once; the trees are built from the bins only.
+  QuantileBinner binner(maxBins);
+  binner.Fit(data, datasetInfo);
+  arma::Mat<unsigned char> bins;
+  binner.Transform(data, bins);
+
+  // Each feature gets a contiguous range of columns in the histograms.
+  arma::Col<size_t> binOffsets(data.n_rows + 1);
+  binOffsets[0] = 0;
+  for (size_t d = 0; d < data.n_rows; ++d)
+    binOffsets[d + 1] = binOffsets[d] + binner.NumBins(d);
+
+  initialScore = LossFunction::InitialScore(responses);
+  arma::rowvec scores(data.n_cols);
+  scores.fill(initialScore);
+
+  arma::rowvec gradients, hessians;
+  std::vector<size_t> indices(data.n_cols);
+  arma::mat histogram;
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    LossFunction::Gradients(responses, scores, gradients, hessians);
+
+    // Start every tree from the same order of points, so that training is
+    // deterministic.
+    for (size_t i = 0; i < indices.size(); ++i)
+      indices[i] = i;
+
+    BuildHistogram(bins, binOffsets, gradients, hessians, indices, 0,
+        data.n_cols, histogram);
+
+    roots.push_back(nodes.size());
+    nodes.push_back(Node());
+    Grow(roots.back(), 0, data.n_cols, 0, histogram, binner, binOffsets, bins,
+        gradients, hessians, indices, scores);
+
+    Log::Debug << "GBDT::Train(): loss after " << (t + 1) << " trees: "
+        << LossFunction::Evaluate(responses, scores) << "." << std::endl;
+  }
+
+  Log::Info << "GBDT::Train(): trained " << numTrees << " trees with "
+      << nodes.size() << " nodes; training loss "
+      << LossFunction::Evaluate(responses, scores) << "." << std::endl;
+}
+
+template<typename LossFunction>
+void GBDT<LossFunction>::Predict(const arma::mat& data,
+                                 arma::rowvec& predictions) const
+{
+  if (data.n_rows != dimensionality && !roots.empty())
+    Log::Fatal << "GBDT::Predict(): dataset has " << data.n_rows
+        << " dimensions, but the model has " << dimensionality << " dimensions!"
+        << std::endl;
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+    predictions[i] = LossFunction::Prediction(Score(data.unsafe_col(i)));
+}
+
+template<typename LossFunction>
+template<typename VecType>
+double GBDT<LossFunction>::Score(const VecType& point) const
+{
+  double score = initialScore;
+  for (size_t t = 0; t < roots.size(); ++t)
+  {
+    size_t index = roots[t];
+    while (nodes[index].firstChild != 0)
+    {
+      const Node& node = nodes[index];
+      const double value = point[node.splitDimension];
+
+      size_t direction;
+      if (node.numCategories == 0)
+      {
+        direction = !(value < node.value);
+      }
+      else
+      {
+        // Unknown categories are treated like the last category, as in
+        // QuantileBinner::Transform().
+        const size_t category = std::min((size_t) value,
+            node.numCategories - 1);
+        direction = categoryTable[node.categoryOffset + category];
+      }
+
+      index = node.firstChild + direction;
+    }
+
+    score += nodes[index].value;
+  }
+
+  return score;
+}
+
+template<typename LossFunction>
+void GBDT<LossFunction>::BuildHistogram(const arma::Mat<unsigned char>& bins,
+                                        const arma::Col<size_t>& binOffsets,
+                                        const arma::rowvec& gradients,
+                                        const arma::rowvec& hessians,
+                                        const std::vector<size_t>& indices,
+                                        const size_t begin,
+                                        const size_t end,
+                                        arma::mat& histogram) const
+{
+  histogram.zeros(3, binOffsets[binOffsets.n_elem - 1]);
+
+  // Every feature has its own columns of the histogram, so the features can be
+  // handled in parallel without any synchronization.  Small nodes aren't worth
+  // the overhead.
+  #pragma omp parallel for schedule(dynamic) \
+      if ((end - begin) * bins.n_cols >= 65536)
+  for (intmax_t d = 0; d < (intmax_t) bins.n_cols; ++d)
+  {
+    const unsigned char* dimensionBins = bins.colptr(d);
+    double* dimensionHistogram = histogram.colptr(binOffsets[d]);
+    for (size_t k = begin; k < end; ++k)
+    {
+      const size_t i = indices[k];
+      double* bin = dimensionHistogram + 3 * dimensionBins[i];
+      bin[0] += gradients[i];
+      bin[1] += hessians[i];
+      bin[2] += 1.0;
+    }
+  }
+}
+
+template<typename LossFunction>
+double GBDT<LossFunction>::FindSplit(const arma::mat& histogram,
+                                     const QuantileBinner& binner,
+                                     const arma::Col<size_t>& binOffsets,
+                                     const double gradientSum,
+                                     const double hessianSum,
+                                     const size_t count,
+                                     size_t& bestDimension,
+                                     std::vector<unsigned char>& directions)
+    const
+{
+  const double parentScore = gradientSum * gradientSum / (hessianSum + lambda);
+
+  // Find the best split of each dimension in parallel, then choose the best
+  // dimension in order, so that the result doesn't depend on the number of
+  // threads.
+  arma::vec gains(binner.Dimensionality());
+  gains.zeros();
+  std::vector<std::vector<unsigned char>> dimensionDirections(
+      binner.Dimensionality());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t d = 0; d < (intmax_t) binner.Dimensionality(); ++d)
+  {
+    const size_t numBins = binner.NumBins(d);
+    const double* dimensionHistogram = histogram.colptr(binOffsets[d]);
+
+    // Numeric bins are considered in order.  Categories are ordered by the
+    // optimal value of a leaf holding only that category, with empty
+    // categories at the end; the best split is then a prefix of that order.
+    std::vector<size_t> order(numBins);
+    for (size_t b = 0; b < numBins; ++b)
+      order[b] = b;
+
+    if (binner.IsCategorical(d))
+    {
+      std::vector<std::pair<double, size_t>> keys(numBins);
+      for (size_t b = 0; b < numBins; ++b)
+      {
+        const double* bin = dimensionHistogram + 3 * b;
+        keys[b].first = (bin[2] == 0.0) ? DBL_MAX : bin[0] / (bin[1] + lambda);
+        keys[b].second = b;
+      }
+      std::sort(keys.begin(), keys.end());
+      for (size_t b = 0; b < numBins; ++b)
+        order[b] = keys[b].second;
+    }
+
+    double leftGradient = 0.0, leftHessian = 0.0, leftCount = 0.0;
+    double bestGain = 0.0;
+    size_t bestPrefix = numBins;
+    for (size_t k = 0; k + 1 < numBins; ++k)
+    {
+      const double* bin = dimensionHistogram + 3 * order[k];
+      leftGradient += bin[0];
+      leftHessian += bin[1];
+      leftCount += bin[2];
+
+      if (leftCount < minLeafSize)
+        continue;
+      if (count - leftCount < minLeafSize)
+        break; // The right side only gets smaller from here.
+
+      const double rightGradient = gradientSum - leftGradient;
+      const double rightHessian = hessianSum - leftHessian;
+      const double gain = 0.5 * (
+          leftGradient * leftGradient / (leftHessian + lambda) +
+          rightGradient * rightGradient / (rightHessian + lambda) -
+          parentScore);
+
+      if (gain > bestGain)
+      {
+        bestGain = gain;
+        bestPrefix = k;
+      }
+    }
+
+    if (bestPrefix < numBins)
+    {
+      gains[d] = bestGain;
+      dimensionDirections[d].assign(numBins, 1);
+      for (size_t k = 0; k <= bestPrefix; ++k)
+        dimensionDirections[d][order[k]] = 0;
+    }
+  }
+
+  double bestGain = 0.0;
+  for (size_t d = 0; d < gains.n_elem; ++d)
+  {
+    if (gains[d] > bestGain)
+    {
+      bestGain = gains[d];
+      bestDimension = d;
+    }
+  }
+
+  if (bestGain > 0.0)
+    directions.swap(dimensionDirections[bestDimension]);
+
+  return bestGain;
+}
+
+template<typename LossFunction>
+void GBDT<LossFunction>::Grow(const size_t node,
+                              const size_t begin,
+                              const size_t end,
+                              const size_t depth,
+                              const arma::mat& histogram,
+                              const QuantileBinner& binner,
+                              const arma::Col<size_t>& binOffsets,
+                              const arma::Mat<unsigned char>& bins,
+                              const arma::rowvec& gradients,
+                              const arma::rowvec& hessians,
+                              std::vector<size_t>& indices,
+                              arma::rowvec& scores)
+{
+  // Every point is in exactly one bin of each feature, so the totals of the
+  // node can be taken from the bins of the first feature.
+  double gradientSum = 0.0, hessianSum = 0.0;
+  for (size_t b = binOffsets[0]; b < binOffsets[1]; ++b)
+  {
+    gradientSum += histogram(0, b);
+    hessianSum += histogram(1, b);
+  }
+  const size_t count = end - begin;
+
+  size_t dimension = 0;
+  std::vector<unsigned char> directions;
+  double gain = 0.0;
+  if (depth < maxDepth && count >= 2 * minLeafSize)
+  {
+    gain = FindSplit(histogram, binner, binOffsets, gradientSum, hessianSum,
+        count, dimension, directions);
+  }
+
+  if (gain <= 0.0)
+  {
+    // Make this node a leaf, with the Newton step as its value.
+    const double value = -learningRate * gradientSum / (hessianSum + lambda);
+    nodes[node].value = value;
+    for (size_t k = begin; k < end; ++k)
+      scores[indices[k]] += value;
+
+    return;
+  }
+
+  // Move the points that go left to the front of the node's range.
+  const unsigned char* dimensionBins = bins.colptr(dimension);
+  const size_t middle = std::partition(indices.begin() + begin,
+      indices.begin() + end, [&](const size_t i)
+      { return directions[dimensionBins[i]] == 0; }) - indices.begin();
+
+  // Set up the split.  The children must be adjacent, so they are created
+  // together.  (Note that nodes may be reallocated here.)
+  const size_t firstChild = nodes.size();
+  nodes.resize(nodes.size() + 2);
+  nodes[node].splitDimension = dimension;
+  nodes[node].firstChild = firstChild;
+  if (binner.IsCategorical(dimension))
+  {
+    nodes[node].numCategories = directions.size();
+    nodes[node].categoryOffset = categoryTable.size();
+    categoryTable.insert(categoryTable.end(), directions.begin(),
+        directions.end());
+  }
+  else
+  {
+    // The bins that go left are a prefix, and everything below the first
+    // threshold after that prefix falls into them.
+    size_t leftBins = 0;
+    while (directions[leftBins] == 0)
+      ++leftBins;
+    nodes[node].value = binner.Thresholds(dimension)[leftBins - 1];
+  }
+
+  // Only build the histogram of the smaller child; the histogram of the larger
+  // child is the difference.
+  arma::mat leftHistogram, rightHistogram;
+  if (middle - begin <= end - middle)
+  {
+    BuildHistogram(bins, binOffsets, gradients, hessians, indices, begin,
+        middle, leftHistogram);
+    rightHistogram = histogram - leftHistogram;
+  }
+  else
+  {
+    BuildHistogram(bins, binOffsets, gradients, hessians, indices, middle, end,
+        rightHistogram);
+    leftHistogram = histogram - rightHistogram;
+  }
+
+  Grow(firstChild, begin, middle, depth + 1, leftHistogram, binner, binOffsets,
+      bins, gradients, hessians, indices, scores);
+  // The histogram of the left subtree isn't needed anymore.
+  leftHistogram.reset();
+  Grow(firstChild + 1, middle, end, depth + 1, rightHistogram, binner,
+      binOffsets, bins, gradients, hessians, indices, scores);
+}
+
+template<typename LossFunction>
+template<typename Archive>
+void GBDT<LossFunction>::Serialize(Archive& ar,
+                                   const unsigned int /* version */)
+{
+  using data::CreateNVP;
+
+  ar & CreateNVP(numTrees, "numTrees");
+  ar & CreateNVP(learningRate, "learningRate");
+  ar & CreateNVP(maxDepth, "maxDepth");
+  ar & CreateNVP(minLeafSize, "minLeafSize");
+  ar & CreateNVP(lambda, "lambda");
+  ar & CreateNVP(maxBins, "maxBins");
+  ar & CreateNVP(dimensionality, "dimensionality");
+  ar & CreateNVP(initialScore, "initialScore");
+  ar & CreateNVP(roots, "roots");
+  ar & CreateNVP(categoryTable, "categoryTable");
+
+  // The nodes are saved as one matrix of indices and one vector of values.
+  arma::Mat<size_t> nodeIndices;
+  arma::vec nodeValues;
+  if (!Archive::is_loading::value)
+  {
+    nodeIndices.set_size(4, nodes.size());
+    nodeValues.set_size(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodeIndices(0, i) = nodes[i].splitDimension;
+      nodeIndices(1, i) = nodes[i].firstChild;
+      nodeIndices(2, i) = nodes[i].numCategories;
+      nodeIndices(3, i) = nodes[i].categoryOffset;
+      nodeValues[i] = nodes[i].value;
+    }
+  }
+
+  ar & CreateNVP(nodeIndices, "nodeIndices");
+  ar & CreateNVP(nodeValues, "nodeValues");
+
+  if (Archive::is_loading::value)
+  {
+    nodes.resize(nodeValues.n_elem);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodes[i].splitDimension = nodeIndices(0, i);
+      nodes[i].firstChild = nodeIndices(1, i);
+      nodes[i].numCategories = nodeIndices(2, i);
+      nodes[i].categoryOffset = nodeIndices(3, i);
+      nodes[i].value = nodeValues[i];
+    }
+  }
+}
+
+} // namespace gbdt
+} // namespace mlpack
+
+#endif
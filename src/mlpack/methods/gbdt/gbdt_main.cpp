@@ -0,0 +1,295 @@
+/**
+ * @file gbdt_main.cpp
+ *
+ * A command-line program to train and apply gradient boosted decision trees.
+ */
+#include <mlpack/core.hpp>
+#include "gbdt.hpp"
+
+using namespace mlpack;
+using namespace mlpack::gbdt;
+using namespace mlpack::data;
+using namespace std;
+using namespace arma;
+
+PROGRAM_INFO("Gradient Boosted Decision Trees", "This program implements "
+    "gradient boosted decision trees (GBDT) for regression (with the squared "
+    "error loss) and binary classification (with the logistic loss).  Each tree"
+    " is fit to the gradient of the loss of the trees before it, and splits are "
+    "found from histograms of quantile-binned features.  Categorical features "
+    "in ARFF files are supported directly."
+    "\n\n"
+    "To train a model, a dataset must be passed with the --training_file (-t) "
+    "option, and its responses with the --training_responses (-r) option.  The "
+    "loss function is chosen with --loss (-L): 'squared' for regression, or "
+    "'logistic' for binary classification, in which case the responses must "
+    "be 0 or 1.  Alternately, a model may be loaded with the --input_model_file"
+    " (-m) option, and a trained model may be saved with the "
+    "--output_model_file (-M) option."
+    "\n\n"
+    "A trained or loaded model can predict the responses of a test dataset "
+    "given with --test_file (-T); the predictions are saved to the file given "
+    "with --predictions_file (-p).  For the logistic loss, the predictions are "
+    "probabilities of class 1.");
+
+// Input for training.
+PARAM_STRING_IN("training_file", "A file containing the training set.", "t",
+    "");
+PARAM_STRING_IN("training_responses", "A file containing the responses for the"
+    " training set.", "r", "");
+
+// Loading/saving of a model.
+PARAM_STRING_IN("input_model_file", "File containing input GBDT model.", "m",
+    "");
+PARAM_STRING_OUT("output_model_file", "File to save trained GBDT model to.",
+    "M");
+
+// Prediction options.
+PARAM_STRING_IN("test_file", "A file containing the test set.", "T", "");
+PARAM_STRING_OUT("predictions_file", "The file in which the predictions for "
+    "the test set will be written.", "p");
+
+// Training options.
+PARAM_STRING_IN("loss", "The loss function to use: 'squared' or 'logistic'.",
+    "L", "squared");
+PARAM_INT_IN("num_trees", "Number of trees to train.", "n", 100);
+PARAM_DOUBLE_IN("learning_rate", "Factor that the predictions of each tree are "
+    "scaled by.", "a", 0.1);
+PARAM_INT_IN("max_depth", "Maximum depth of each tree.", "D", 6);
+PARAM_INT_IN("min_leaf_size", "Minimum number of training points in each "
+    "leaf.", "l", 20);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the leaf values.", "R", 1.0);
+PARAM_INT_IN("max_bins", "Maximum number of histogram bins for each feature "
+    "(at most 256).", "b", 255);
+
+/**
+ * The model to save to disk.
+ */
+class GBDTModel
+{
+ public:
+  enum LossTypes
+  {
+    SQUARED_ERROR,
+    LOGISTIC
+  };
+
+ private:
+  //! The type of loss.
+  size_t lossType;
+  //! Information on the features (including categorical mappings).
+  DatasetInfo info;
+  //! Non-NULL if using the squared error loss.
+  GBDT<SquaredErrorLoss>* squaredGBDT;
+  //! Non-NULL if using the logistic loss.
+  GBDT<LogisticLoss>* logisticGBDT;
+
+ public:
+  //! Create an empty GBDT model.
+  GBDTModel() :
+      lossType(SQUARED_ERROR),
+      squaredGBDT(NULL),
+      logisticGBDT(NULL)
+  {
+    // Nothing to do.
+  }
+
+  ~GBDTModel()
+  {
+    if (squaredGBDT)
+      delete squaredGBDT;
+    if (logisticGBDT)
+      delete logisticGBDT;
+  }
+
+  //! Get the loss type.
+  size_t LossType() const { return lossType; }
+  //! Modify the loss type.
+  size_t& LossType() { return lossType; }
+
+  //! Get the dataset information.
+  const DatasetInfo& Info() const { return info; }
+  //! Modify the dataset information.
+  DatasetInfo& Info() { return info; }
+
+  //! Train the model.
+  void Train(const mat& data,
+             const rowvec& responses,
+             const size_t numTrees,
+             const double learningRate,
+             const size_t maxDepth,
+             const size_t minLeafSize,
+             const double lambda,
+             const size_t maxBins)
+  {
+    if (lossType == LossTypes::SQUARED_ERROR)
+    {
+      if (squaredGBDT)
+        delete squaredGBDT;
+
+      squaredGBDT = new GBDT<SquaredErrorLoss>(data, info, responses, numTrees,
+          learningRate, maxDepth, minLeafSize, lambda, maxBins);
+    }
+    else if (lossType == LossTypes::LOGISTIC)
+    {
+      if (logisticGBDT)
+        delete logisticGBDT;
+
+      logisticGBDT = new GBDT<LogisticLoss>(data, info, responses, numTrees,
+          learningRate, maxDepth, minLeafSize, lambda, maxBins);
+    }
+  }
+
+  //! Predict the responses of test points.
+  void Predict(const mat& testData, rowvec& predictions)
+  {
+    if (lossType == LossTypes::SQUARED_ERROR)
+      squaredGBDT->Predict(testData, predictions);
+    else if (lossType == LossTypes::LOGISTIC)
+      logisticGBDT->Predict(testData, predictions);
+  }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */)
+  {
+    if (Archive::is_loading::value)
+    {
+      if (squaredGBDT)
+        delete squaredGBDT;
+      if (logisticGBDT)
+        delete logisticGBDT;
+
+      squaredGBDT = NULL;
+      logisticGBDT = NULL;
+    }
+
+    ar & CreateNVP(lossType, "lossType");
+    ar & CreateNVP(info, "info");
+    if (lossType == LossTypes::SQUARED_ERROR)
+      ar & CreateNVP(squaredGBDT, "squaredGBDT");
+    else if (lossType == LossTypes::LOGISTIC)
+      ar & CreateNVP(logisticGBDT, "logisticGBDT");
+  }
+};
+
+int main(int argc, char** argv)
+{
+  CLI::ParseCommandLine(argc, argv);
+
+  // Check input parameters and issue warnings/errors as necessary.
+  if (CLI::HasParam("training_file") && CLI::HasParam("input_model_file"))
+    Log::Fatal << "Only one of --training_file or --input_model_file may be "
+        << "specified!" << endl;
+
+  if (!CLI::HasParam("training_file") && !CLI::HasParam("input_model_file"))
+    Log::Fatal << "Either --training_file or --input_model_file must be "
+        << "specified!" << endl;
+
+  if (CLI::HasParam("training_file") && !CLI::HasParam("training_responses"))
+    Log::Fatal << "--training_responses must be specified with "
+        << "--training_file!" << endl;
+
+  const string lossName = CLI::GetParam<string>("loss");
+  if (lossName != "squared" && lossName != "logistic")
+    Log::Fatal << "Unknown loss '" << lossName << "'; must be 'squared' or "
+        << "'logistic'." << endl;
+
+  if (CLI::GetParam<int>("num_trees") < 0)
+    Log::Fatal << "Invalid number of trees (" << CLI::GetParam<int>("num_trees")
+        << ")!  Must be 0 or greater." << endl;
+
+  if (CLI::GetParam<int>("max_depth") < 0)
+    Log::Fatal << "Invalid maximum depth (" << CLI::GetParam<int>("max_depth")
+        << ")!  Must be 0 or greater." << endl;
+
+  if (CLI::GetParam<int>("min_leaf_size") < 0)
+    Log::Fatal << "Invalid minimum leaf size ("
+        << CLI::GetParam<int>("min_leaf_size") << ")!  Must be 0 or greater."
+        << endl;
+
+  if (CLI::GetParam<int>("max_bins") < 2 || CLI::GetParam<int>("max_bins") > 256)
+    Log::Fatal << "Invalid maximum number of bins ("
+        << CLI::GetParam<int>("max_bins") << ")!  Must be between 2 and 256."
+        << endl;
+
+  if (CLI::HasParam("input_model_file") && CLI::HasParam("loss"))
+    Log::Warn << "--loss ignored because --input_model_file is specified."
+        << endl;
+
+  if (!CLI::HasParam("output_model_file") &&
+      !CLI::HasParam("predictions_file"))
+    Log::Warn << "Neither --output_model_file nor --predictions_file are "
+        << "specified; no results will be saved." << endl;
+
+  if (CLI::HasParam("predictions_file") && !CLI::HasParam("test_file"))
+    Log::Warn << "--predictions_file ignored because --test_file is not "
+        << "specified." << endl;
+
+  GBDTModel m;
+  if (CLI::HasParam("training_file"))
+  {
+    mat trainingData;
+    data::Load(CLI::GetParam<string>("training_file"), trainingData, m.Info(),
+        true);
+
+    mat responsesIn;
+    data::Load(CLI::GetParam<string>("training_responses"), responsesIn, true);
+
+    // Do the responses need to be transposed?
+    if (responsesIn.n_cols == 1)
+      responsesIn = responsesIn.t();
+
+    if (responsesIn.n_cols != trainingData.n_cols)
+      Log::Fatal << "The number of responses (" << responsesIn.n_cols << ") "
+          << "must match the number of training points (" << trainingData.n_cols
+          << ")!" << endl;
+    const rowvec responses = responsesIn.row(0);
+
+    if (lossName == "logistic")
+    {
+      m.LossType() = GBDTModel::LossTypes::LOGISTIC;
+      for (size_t i = 0; i < responses.n_elem; ++i)
+        if (responses[i] != 0.0 && responses[i] != 1.0)
+          Log::Fatal << "Responses must be 0 or 1 for the logistic loss!"
+              << endl;
+    }
+    else
+    {
+      m.LossType() = GBDTModel::LossTypes::SQUARED_ERROR;
+    }
+
+    Timer::Start("gbdt_training");
+    m.Train(trainingData, responses, (size_t) CLI::GetParam<int>("num_trees"),
+        CLI::GetParam<double>("learning_rate"),
+        (size_t) CLI::GetParam<int>("max_depth"),
+        (size_t) CLI::GetParam<int>("min_leaf_size"),
+        CLI::GetParam<double>("lambda"),
+        (size_t) CLI::GetParam<int>("max_bins"));
+    Timer::Stop("gbdt_training");
+  }
+  else
+  {
+    data::Load(CLI::GetParam<string>("input_model_file"), "gbdt_model", m,
+        true); // Fatal on failure.
+  }
+
+  if (CLI::HasParam("test_file"))
+  {
+    // Load the test set with the mappings of the training set, so that
+    // categorical features are mapped the same way.
+    mat testData;
+    data::Load(CLI::GetParam<string>("test_file"), testData, m.Info(), true);
+
+    rowvec predictions;
+    Timer::Start("gbdt_prediction");
+    m.Predict(testData, predictions);
+    Timer::Stop("gbdt_prediction");
+
+    if (CLI::HasParam("predictions_file"))
+      data::Save(CLI::GetParam<string>("predictions_file"), predictions, true);
+  }
+
+  if (CLI::HasParam("output_model_file"))
+    data::Save(CLI::GetParam<string>("output_model_file"), "gbdt_model", m);
+}
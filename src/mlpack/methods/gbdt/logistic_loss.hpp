@@ -0,0 +1,90 @@
+/**
+ * @file logistic_loss.hpp
+ *
+ * The logistic loss function, for binary classification with GBDT.
+ */
+#ifndef MLPACK_METHODS_GBDT_LOGISTIC_LOSS_HPP
+#define MLPACK_METHODS_GBDT_LOGISTIC_LOSS_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace gbdt {
+
+/**
+ * The logistic loss (negative log-likelihood of the Bernoulli distribution),
+ * L(y, f) = log(1 + exp(f)) - y f, for binary classification.  The responses
+ * must be 0 or 1, and the raw score of the model is the log-odds of class 1, so
+ * predictions are probabilities of class 1.
+ */
+class LogisticLoss
+{
+ public:
+  /**
+   * Return the constant score that minimizes the loss on the given responses
+   * (the log-odds of the fraction of points in class 1).
+   */
+  static double InitialScore(const arma::rowvec& responses)
+  {
+    // Keep the score finite even if all the points are in one class.
+    const double p = std::min(std::max(arma::mean(responses), 1e-10),
+        1.0 - 1e-10);
+    return std::log(p / (1.0 - p));
+  }
+
+  /**
+   * Calculate the gradient and the second derivative (hessian) of the loss for
+   * each point, with respect to the current scores.
+   *
+   * @param responses Responses of the points.
+   * @param scores Current scores of the points.
+   * @param gradients Vector to store the gradients in.
+   * @param hessians Vector to store the hessians in.
+   */
+  static void Gradients(const arma::rowvec& responses,
+                        const arma::rowvec& scores,
+                        arma::rowvec& gradients,
+                        arma::rowvec& hessians)
+  {
+    gradients.set_size(responses.n_elem);
+    hessians.set_size(responses.n_elem);
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      const double p = Prediction(scores[i]);
+      gradients[i] = p - responses[i];
+      // Don't let the hessian become exactly zero, so that leaf values stay
+      // finite even without regularization.
+      hessians[i] = std::max(p * (1.0 - p), 1e-16);
+    }
+  }
+
+  /**
+   * Return the mean loss of the given scores.
+   */
+  static double Evaluate(const arma::rowvec& responses,
+                         const arma::rowvec& scores)
+  {
+    double loss = 0.0;
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      // log(1 + exp(f)), computed without overflow.
+      const double f = scores[i];
+      const double softplus = (f > 0.0) ? f + std::log1p(std::exp(-f)) :
+          std::log1p(std::exp(f));
+      loss += softplus - responses[i] * f;
+    }
+
+    return loss / responses.n_elem;
+  }
+
+  //! Convert a raw score to the probability of class 1.
+  static double Prediction(const double score)
+  {
+    return 1.0 / (1.0 + std::exp(-score));
+  }
+};
+
+} // namespace gbdt
+} // namespace mlpack
+
+#endif
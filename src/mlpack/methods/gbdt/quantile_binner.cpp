@@ -0,0 +1,115 @@
+/**
+ * @file quantile_binner.cpp
+ *
+ * Implementation of the QuantileBinner class.
+ */
+#include "quantile_binner.hpp"
+
+using namespace mlpack;
+using namespace mlpack::gbdt;
+
+QuantileBinner::QuantileBinner(const size_t maxBins) :
+    maxBins(maxBins)
+{
+  if (maxBins < 2 || maxBins > 256)
+    Log::Fatal << "QuantileBinner::QuantileBinner(): maxBins must be between 2 "
+        << "and 256 (" << maxBins << " given)!" << std::endl;
+}
+
+void QuantileBinner::Fit(const arma::mat& data,
+                         const data::DatasetInfo& datasetInfo)
+{
+  if (datasetInfo.Dimensionality() != data.n_rows)
+    Log::Fatal << "QuantileBinner::Fit(): dataset has " << data.n_rows
+        << " dimensions, but DatasetInfo has " << datasetInfo.Dimensionality()
+        << " dimensions!" << std::endl;
+
+  numBins.set_size(data.n_rows);
+  categorical.assign(data.n_rows, 0);
+  thresholds.assign(data.n_rows, arma::vec());
+
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    if (datasetInfo.Type(d) == data::Datatype::categorical)
+    {
+      categorical[d] = 1;
+      numBins[d] = std::max(datasetInfo.NumMappings(d), size_t(1));
+      if (numBins[d] > maxBins)
+        Log::Fatal << "QuantileBinner::Fit(): dimension " << d << " has "
+            << numBins[d] << " categories, but at most " << maxBins << " bins "
+            << "are allowed!" << std::endl;
+    }
+  }
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t d = 0; d < (intmax_t) data.n_rows; ++d)
+  {
+    if (categorical[d])
+      continue;
+
+    const arma::vec sorted = arma::sort(arma::trans(data.row(d)));
+    const arma::vec unique = arma::unique(sorted);
+
+    std::vector<double> cuts;
+    if (unique.n_elem <= maxBins)
+    {
+      // Give each distinct value its own bin.
+      for (size_t i = 1; i < unique.n_elem; ++i)
+        cuts.push_back(unique[i - 1] + (unique[i] - unique[i - 1]) / 2.0);
+    }
+    else
+    {
+      // Place the thresholds at the quantiles.  Values that appear very often
+      // would give the same threshold several times, so duplicates are
+      // skipped, as are thresholds that would leave the first bin empty.
+      for (size_t b = 1; b < maxBins; ++b)
+      {
+        const double value = sorted[(b * sorted.n_elem) / maxBins];
+        if (value > sorted[0] && (cuts.empty() || value > cuts.back()))
+          cuts.push_back(value);
+      }
+    }
+
+    thresholds[d] = arma::conv_to<arma::vec>::from(cuts);
+    numBins[d] = cuts.size() + 1;
+  }
+}
+
+void QuantileBinner::Transform(const arma::mat& data,
+                               arma::Mat<unsigned char>& bins) const
+{
+  if (data.n_rows != numBins.n_elem)
+    Log::Fatal << "QuantileBinner::Transform(): dataset has " << data.n_rows
+        << " dimensions, but the binner was fit on " << numBins.n_elem
+        << " dimensions!" << std::endl;
+
+  bins.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t d = 0; d < (intmax_t) data.n_rows; ++d)
+  {
+    unsigned char* dimensionBins = bins.colptr(d);
+    if (categorical[d])
+    {
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        // Unknown categories go into the last bin.
+        const size_t category = (size_t) data(d, i);
+        dimensionBins[i] = (unsigned char) std::min(category,
+            (size_t) numBins[d] - 1);
+      }
+    }
+    else
+    {
+      // The bin of a value is the number of thresholds that are not greater
+      // than it.
+      const double* begin = thresholds[d].memptr();
+      const double* end = begin + thresholds[d].n_elem;
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        dimensionBins[i] = (unsigned char) (std::upper_bound(begin, end,
+            data(d, i)) - begin);
+      }
+    }
+  }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file quantile_binner.hpp
+ *
+ * Definition of the QuantileBinner class, which maps each feature of a dataset
+ * to a small number of bins for histogram-based tree building.
+ */
+#ifndef MLPACK_METHODS_GBDT_QUANTILE_BINNER_HPP
+#define MLPACK_METHODS_GBDT_QUANTILE_BINNER_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace gbdt {
+
+/**
+ * This class maps each feature of a dataset to at most maxBins bins, so that
+ * the best split of a node can be found from a histogram over the bins instead
+ * of from the sorted values of the feature.
+ *
+ * For a numeric feature, the bins are separated by thresholds placed at the
+ * quantiles of the training data, so each bin holds roughly the same number of
+ * points.  (If the feature has no more than maxBins distinct values, each
+ * distinct value gets its own bin, and the thresholds lie halfway between
+ * them.)  A value x falls into bin b if thresholds[b - 1] <= x < thresholds[b].
+ *
+ * For a categorical feature (as given by the DatasetInfo), each category is its
+ * own bin, so the number of categories may not be larger than maxBins.
+ *
+ * Bins are stored as unsigned chars, so maxBins may be at most 256.
+ */
+class QuantileBinner
+{
+ public:
+  /**
+   * Create the binner with the given maximum number of bins per feature.  Fit()
+   * must be called before Transform().
+   *
+   * @param maxBins Maximum number of bins for each feature (at most 256).
+   */
+  QuantileBinner(const size_t maxBins = 255);
+
+  /**
+   * Compute the bins of each feature from the given data.  If OpenMP is
+   * available, the features are handled in parallel.
+   *
+   * @param data Dataset to compute the bins from.
+   * @param datasetInfo Types of the features of the dataset.
+   */
+  void Fit(const arma::mat& data, const data::DatasetInfo& datasetInfo);
+
+  /**
+   * Map each value of the given data to its bin.  The result is stored
+   * transposed (one column per feature), so that the bins of each feature are
+   * contiguous.  If OpenMP is available, the features are handled in parallel.
+   *
+   * @param data Dataset to transform.
+   * @param bins Matrix to store the bins in (points x features).
+   */
+  void Transform(const arma::mat& data, arma::Mat<unsigned char>& bins) const;
+
+  //! Get the maximum number of bins for each feature.
+  size_t MaxBins() const { return maxBins; }
+
+  //! Get the number of features the binner was fit on.
+  size_t Dimensionality() const { return numBins.n_elem; }
+
+  //! Get the number of bins of the given feature.
+  size_t NumBins(const size_t dimension) const { return numBins[dimension]; }
+
+  //! Return whether or not the given feature is categorical.
+  bool IsCategorical(const size_t dimension) const
+  { return categorical[dimension]; }
+
+  //! Get the thresholds between the bins of the given numeric feature.
+  const arma::vec& Thresholds(const size_t dimension) const
+  { return thresholds[dimension]; }
+
+ private:
+  //! The maximum number of bins for each feature.
+  size_t maxBins;
+  //! The number of bins of each feature.
+  arma::Col<size_t> numBins;
+  //! Whether or not each feature is categorical.
+  std::vector<char> categorical;
+  //! The thresholds between the bins of each numeric feature.
+  std::vector<arma::vec> thresholds;
+};
+
+} // namespace gbdt
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file squared_error_loss.hpp
+ *
+ * The squared error loss function, for regression with GBDT.
+ */
+#ifndef MLPACK_METHODS_GBDT_SQUARED_ERROR_LOSS_HPP
+#define MLPACK_METHODS_GBDT_SQUARED_ERROR_LOSS_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace gbdt {
+
+/**
+ * The squared error loss, L(y, f) = (1 / 2) (f - y)^2, for regression.  The raw
+ * score of the model is used as the prediction directly.
+ */
+class SquaredErrorLoss
+{
+ public:
+  /**
+   * Return the constant prediction that minimizes the loss on the given
+   * responses (their mean).
+   */
+  static double InitialScore(const arma::rowvec& responses)
+  {
+    return arma::mean(responses);
+  }
+
+  /**
+   * Calculate the gradient and the second derivative (hessian) of the loss for
+   * each point, with respect to the current scores.
+   *
+   * @param responses Responses of the points.
+   * @param scores Current scores of the points.
+   * @param gradients Vector to store the gradients in.
+   * @param hessians Vector to store the hessians in.
+   */
+  static void Gradients(const arma::rowvec& responses,
+                        const arma::rowvec& scores,
+                        arma::rowvec& gradients,
+                        arma::rowvec& hessians)
+  {
+    gradients = scores - responses;
+    hessians.ones(responses.n_elem);
+  }
+
+  /**
+   * Return the mean loss of the given scores.
+   */
+  static double Evaluate(const arma::rowvec& responses,
+                         const arma::rowvec& scores)
+  {
+    return 0.5 * arma::accu(arma::square(scores - responses)) /
+        responses.n_elem;
+  }
+
+  //! Convert a raw score to a prediction (this does nothing).
+  static double Prediction(const double score) { return score; }
+};
+
+} // namespace gbdt
+} // namespace mlpack
+
+#endif
@@ -142,19 +142,60 @@ class EMFit
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Run the E-step of the EM algorithm, and accumulate the sufficient
+   * statistics that the M-step needs, in a single pass over the data.  The
+   * observations are processed in blocks; for each block and component, the
+   * log-probabilities are computed with the batch
+   * GaussianDistribution::LogProbability(), which needs a single triangular
+   * solve with the cached Cholesky factor of the covariance.
+   * Blocks are processed in parallel with OpenMP, and each thread accumulates
+   * its statistics locally before they are merged.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
-   * @param weights Vector of a priori weights.
+   * The statistics are computed on the observations shifted by the given
+   * vector (this should be something close to the mean of the data), to keep
+   * the covariance computation numerically stable.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each observation being from this model;
+   *     if empty, every observation is given probability 1.
+   * @param dists Current Gaussian distributions.
+   * @param weights Current a priori weights.
+   * @param shift Vector subtracted from each observation for the statistics.
+   * @param probSums Output sum of responsibilities of each component.
+   * @param weightedSums Output responsibility-weighted sum of shifted
+   *     observations of each component (one column per component).
+   * @param weightedOuterSums Output responsibility-weighted sum of outer
+   *     products of shifted observations of each component.
+   * @return Log-likelihood of the observations under the current model.
+   */
+  double EStep(const arma::mat& observations,
+               const arma::vec& probabilities,
+               const std::vector<distribution::GaussianDistribution>& dists,
+               const arma::vec& weights,
+               const arma::vec& shift,
+               arma::vec& probSums,
+               arma::mat& weightedSums,
+               std::vector<arma::mat>& weightedOuterSums) const;
+
+  /**
+   * Run the M-step of the EM algorithm using the statistics computed by
+   * EStep(), updating the distributions and the weights.
+   *
+   * @param shift Vector that was passed to EStep().
+   * @param probSums Sum of responsibilities of each component.
+   * @param weightedSums Responsibility-weighted sums of shifted observations.
+   * @param weightedOuterSums Responsibility-weighted sums of outer products.
+   * @param totalProbability Sum of the probabilities of all observations.
+   * @param dists Gaussian distributions to update.
+   * @param weights A priori weights to update.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  void MStep(const arma::vec& shift,
+             const arma::vec& probSums,
+             const arma::mat& weightedSums,
+             const std::vector<arma::mat>& weightedOuterSums,
+             const double totalProbability,
+             std::vector<distribution::GaussianDistribution>& dists,
+             arma::vec& weights);
 
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
@@ -38,13 +38,26 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The sufficient statistics are computed relative to the mean of the data,
+  // for numerical stability.
+  const arma::vec shift = arma::mean(observations, 1);
+
+  // An empty vector of probabilities means every point has probability 1.
+  const arma::vec probabilities;
+
+  arma::vec probSums;
+  arma::mat weightedSums;
+  std::vector<arma::mat> weightedOuterSums;
+
+  // Each E-step also gives us the log-likelihood of the model it used, so we
+  // don't need a separate pass to calculate it.
+  double l = EStep(observations, probabilities, dists, weights, shift,
+      probSums, weightedSums, weightedOuterSums);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -53,62 +66,16 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = probRowSums / observations.n_cols;
+    // Calculate the new parameters using the statistics of the conditional
+    // probabilities of each Gaussian given the observations.
+    MStep(shift, probSums, weightedSums, weightedOuterSums,
+        (double) observations.n_cols, dists, weights);
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the statistics for
+    // the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = EStep(observations, probabilities, dists, weights, shift, probSums,
+        weightedSums, weightedOuterSums);
 
     iteration++;
   }
@@ -125,78 +92,33 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  const arma::vec shift = arma::mean(observations, 1);
+
+  arma::vec probSums;
+  arma::mat weightedSums;
+  std::vector<arma::mat> weightedOuterSums;
+
+  double l = EStep(observations, probabilities, dists, weights, shift,
+      probSums, weightedSums, weightedOuterSums);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
-
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(cov);
-
-      dists[i].Covariance(std::move(cov));
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = probRowSums / accu(probabilities);
+    // The statistics are weighted by the probability of each point being from
+    // this mixture model.
+    MStep(shift, probSums, weightedSums, weightedOuterSums,
+        arma::accu(probabilities), dists, weights);
 
     // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = EStep(observations, probabilities, dists, weights, shift, probSums,
+        weightedSums, weightedOuterSums);
 
     iteration++;
   }
@@ -270,31 +192,161 @@ InitialClustering(const arma::mat& observations,
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EStep(
     const arma::mat& observations,
+    const arma::vec& probabilities,
     const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+    const arma::vec& weights,
+    const arma::vec& shift,
+    arma::vec& probSums,
+    arma::mat& weightedSums,
+    std::vector<arma::mat>& weightedOuterSums) const
 {
-  double logLikelihood = 0;
+  // Number of points processed at once.  This is large enough that the
+  // products below are efficient matrix-matrix operations, but small enough
+  // that the temporaries stay in cache.
+  const size_t blockSize = 1024;
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
+  const size_t dimensionality = observations.n_rows;
+  const size_t components = dists.size();
+  const size_t blocks = (observations.n_cols + blockSize - 1) / blockSize;
+  const arma::vec logWeights = arma::log(weights);
 
-  for (size_t i = 0; i < dists.size(); ++i)
+  probSums.zeros(components);
+  weightedSums.zeros(dimensionality, components);
+  weightedOuterSums.resize(components);
+  for (size_t k = 0; k < components; ++k)
+    weightedOuterSums[k].zeros(dimensionality, dimensionality);
+
+  double logLikelihood = 0.0;
+
+  #pragma omp parallel
   {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+    // Statistics local to this thread.
+    double localLogLikelihood = 0.0;
+    arma::vec localProbSums(components, arma::fill::zeros);
+    arma::mat localWeightedSums(dimensionality, components, arma::fill::zeros);
+    std::vector<arma::mat> localWeightedOuterSums(components,
+        arma::zeros<arma::mat>(dimensionality, dimensionality));
+
+    // Buffers for each block, which are reused to avoid allocations.
+    arma::mat logProbs, shifted, weightedShifted;
+    arma::vec componentLogProbs;
+
+    #pragma omp for schedule(static)
+    for (intmax_t block = 0; block < (intmax_t) blocks; ++block)
+    {
+      const size_t begin = block * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols) - 1;
+      const size_t points = end - begin + 1;
+      const arma::mat blockObs(const_cast<double*>(
+          observations.colptr(begin)), dimensionality, points, false, true);
+
+      // Compute the weighted log-probability of each point under each
+      // component, evaluating each component on the whole block at once.
+      logProbs.set_size(components, points);
+      for (size_t k = 0; k < components; ++k)
+      {
+        dists[k].LogProbability(blockObs, componentLogProbs);
+        logProbs.row(k) = logWeights[k] + arma::trans(componentLogProbs);
+      }
+
+      // Normalize each column with the log-sum-exp trick to get the
+      // conditional probability of each Gaussian given each point.
+      for (size_t i = 0; i < points; ++i)
+      {
+        double* col = logProbs.colptr(i);
+        double maxLogProb = col[0];
+        for (size_t k = 1; k < components; ++k)
+          maxLogProb = std::max(maxLogProb, col[k]);
+
+        // Avoid dividing by zero; if the probability for everything is 0, we
+        // don't want to make it NaN.
+        if (maxLogProb == -std::numeric_limits<double>::infinity())
+        {
+          for (size_t k = 0; k < components; ++k)
+            col[k] = 0.0;
+          localLogLikelihood += maxLogProb;
+          continue;
+        }
+
+        double sum = 0.0;
+        for (size_t k = 0; k < components; ++k)
+        {
+          col[k] = std::exp(col[k] - maxLogProb);
+          sum += col[k];
+        }
+
+        localLogLikelihood += maxLogProb + std::log(sum);
+
+        // Weight by the probability of the point being from this model.
+        const double scale = (probabilities.n_elem == 0) ? 1.0 / sum :
+            probabilities[begin + i] / sum;
+        for (size_t k = 0; k < components; ++k)
+          col[k] *= scale;
+      }
+
+      // Accumulate the statistics for the M-step.
+      shifted = blockObs;
+      shifted.each_col() -= shift;
+      localProbSums += arma::sum(logProbs, 1);
+      localWeightedSums += shifted * logProbs.t();
+      for (size_t k = 0; k < components; ++k)
+      {
+        weightedShifted = shifted;
+        weightedShifted.each_row() %= logProbs.row(k);
+        localWeightedOuterSums[k] += weightedShifted * shifted.t();
+      }
+    }
+
+    // Merge the statistics of this thread.
+    #pragma omp critical
+    {
+      logLikelihood += localLogLikelihood;
+      probSums += localProbSums;
+      weightedSums += localWeightedSums;
+      for (size_t k = 0; k < components; ++k)
+        weightedOuterSums[k] += localWeightedOuterSums[k];
+    }
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::MStep(
+    const arma::vec& shift,
+    const arma::vec& probSums,
+    const arma::mat& weightedSums,
+    const std::vector<arma::mat>& weightedOuterSums,
+    const double totalProbability,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  for (size_t i = 0; i < dists.size(); i++)
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probSums[i] == 0.0)
+      continue;
+
+    // The new mean (relative to the shift).
+    const arma::vec mean = weightedSums.col(i) / probSums[i];
+    dists[i].Mean() = mean + shift;
+
+    // The new covariance is E[(x - mu)(x - mu)^T] = E[x x^T] - mu mu^T; the
+    // shift cancels out.
+    arma::mat covariance = weightedOuterSums[i] / probSums[i] -
+        mean * mean.t();
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
   }
 
-  return logLikelihood;
+  // Calculate the new values for omega using the updated conditional
+  // probabilities.
+  weights = probSums / totalProbability;
 }
 
 template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
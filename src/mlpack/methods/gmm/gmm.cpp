@@ -71,6 +71,58 @@ double GMM::Probability(const arma::vec& observation,
   return weights[component] * dists[component].Probability(observation);
 }
 
+/**
+ * Return the log-probability of the given observation being from this GMM.
+ */
+double GMM::LogProbability(const arma::vec& observation) const
+{
+  arma::vec logProbability;
+  LogProbability(observation, logProbability);
+  return logProbability[0];
+}
+
+/**
+ * Return the probability of each of the given observations being from this GMM.
+ */
+void GMM::Probability(const arma::mat& observations,
+                      arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Return the log-probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, dists, weights, logProbs);
+
+  // Sum over the components with the log-sum-exp trick.
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    const double* col = logProbs.colptr(i);
+    double maxLogProb = -std::numeric_limits<double>::infinity();
+    for (size_t j = 0; j < gaussians; ++j)
+      maxLogProb = std::max(maxLogProb, col[j]);
+
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      logProbabilities[i] = maxLogProb;
+      continue;
+    }
+
+    double sum = 0.0;
+    for (size_t j = 0; j < gaussians; ++j)
+      sum += std::exp(col[j] - maxLogProb);
+    logProbabilities[i] = maxLogProb + std::log(sum);
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -103,7 +155,9 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Evaluate every component on all of the observations at once.
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, dists, weights, logProbs);
 
   // We should not have to fill this with values, because each one should be
   // overwritten.
@@ -111,13 +165,14 @@ void GMM::Classify(const arma::mat& observations,
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     // Find maximum probability component.
-    double probability = 0;
+    const double* col = logProbs.colptr(i);
+    double logProbability = -std::numeric_limits<double>::infinity();
+    labels[i] = 0;
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (col[j] >= logProbability)
       {
-        probability = newProb;
+        logProbability = col[j];
         labels[i] = j;
       }
     }
@@ -132,21 +187,45 @@ double GMM::LogLikelihood(
     const std::vector<distribution::GaussianDistribution>& distsL,
     const arma::vec& weightsL) const
 {
-  double loglikelihood = 0;
-  arma::vec phis;
-  arma::mat likelihoods(gaussians, data.n_cols);
+  arma::mat logProbs;
+  ComponentLogProbabilities(data, distsL, weightsL, logProbs);
 
-  for (size_t i = 0; i < gaussians; i++)
+  // Now sum over every point, using the log-sum-exp trick for each point.
+  double loglikelihood = 0;
+  for (size_t j = 0; j < data.n_cols; j++)
   {
-    distsL[i].Probability(data, phis);
-    likelihoods.row(i) = weightsL(i) * trans(phis);
+    const double maxLogProb = logProbs.col(j).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      loglikelihood += maxLogProb;
+      continue;
+    }
+
+    loglikelihood += maxLogProb +
+        std::log(arma::accu(arma::exp(logProbs.col(j) - maxLogProb)));
   }
 
-  // Now sum over every point.
-  for (size_t j = 0; j < data.n_cols; j++)
-    loglikelihood += log(accu(likelihoods.col(j)));
   return loglikelihood;
 }
 
+/**
+ * Compute the log-probability of each observation under each weighted
+ * component.
+ */
+void GMM::ComponentLogProbabilities(
+    const arma::mat& observations,
+    const std::vector<distribution::GaussianDistribution>& distsL,
+    const arma::vec& weightsL,
+    arma::mat& logProbabilities) const
+{
+  logProbabilities.set_size(distsL.size(), observations.n_cols);
+  arma::vec logProbs;
+  for (size_t i = 0; i < distsL.size(); i++)
+  {
+    distsL[i].LogProbability(observations, logProbs);
+    logProbabilities.row(i) = std::log(weightsL[i]) + logProbs.t();
+  }
+}
+
 } // namespace gmm
 } // namespace mlpack
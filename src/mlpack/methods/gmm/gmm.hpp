@@ -170,6 +170,36 @@ class GMM
   double Probability(const arma::vec& observation,
                      const size_t component) const;
 
+  /**
+   * Return the log-probability that the given observation came from this
+   * distribution.
+   *
+   * @param observation Observation to evaluate the log-probability of.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
+  /**
+   * Calculate the probability that each observation (column) in the given
+   * matrix came from this distribution.
+   *
+   * @param observations List of observations.
+   * @param probabilities Output probabilities for each observation.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
+  /**
+   * Calculate the log-probability that each observation (column) in the given
+   * matrix came from this distribution.  The components are evaluated on all
+   * of the observations at once, and are combined with the log-sum-exp trick,
+   * so points far from every component do not underflow.
+   *
+   * @param observations List of observations.
+   * @param logProbabilities Output log-probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -276,6 +306,17 @@ class GMM
       const arma::mat& dataPoints,
       const std::vector<distribution::GaussianDistribution>& distsL,
       const arma::vec& weights) const;
+
+  /**
+   * Compute the log-probability of each observation under each component of
+   * the given model, including the prior weight of the component.  Column i of
+   * the result corresponds to observation i.
+   */
+  void ComponentLogProbabilities(
+      const arma::mat& observations,
+      const std::vector<distribution::GaussianDistribution>& distsL,
+      const arma::vec& weightsL,
+      arma::mat& logProbabilities) const;
 };
 
 } // namespace gmm
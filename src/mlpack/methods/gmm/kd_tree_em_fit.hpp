@@ -0,0 +1,270 @@
+/**
+ * @file kd_tree_em_fit.hpp
+ *
+ * Utility class to fit a GMM using an approximate EM algorithm accelerated with
+ * a kd-tree.  Can be used with GMM::Train<>() as an alternative to EMFit.
+ */
+#ifndef MLPACK_METHODS_GMM_KD_TREE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_KD_TREE_EM_FIT_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+#include "em_fit.hpp"
+#include "kd_tree_em_statistic.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations using an approximate version of the EM
+ * algorithm which uses a kd-tree to avoid evaluating every point against every
+ * component.  The idea is from the following paper:
+ *
+ * @code
+ * @inproceedings{moore1999very,
+ *   title={Very fast EM-based mixture model clustering using multiresolution
+ *       kd-trees},
+ *   author={Moore, Andrew W.},
+ *   booktitle={Advances in Neural Information Processing Systems 11
+ *       (NIPS 1998)},
+ *   pages={543--549},
+ *   year={1999}
+ * }
+ * @endcode
+ *
+ * A kd-tree is built on the observations once, and each node caches the sum of
+ * its points and the sum of their outer products (see KDTreeEMStatistic).  In
+ * each iteration, the tree is traversed; for each node, the hyperrectangle
+ * bound of the node is used to bound the responsibility of each component for
+ * every point in the node.  Components whose responsibility is bounded above
+ * by the approximation tolerance are ignored in the whole subtree, and if the
+ * responsibility of every remaining component varies by less than the
+ * approximation tolerance over the node, the whole node is accounted for at
+ * once using the responsibilities of its centroid and its cached statistics.
+ * With an approximation tolerance of 0, the results are the same as EMFit
+ * (but much slower).
+ *
+ * The bounds on the responsibilities use the extreme eigenvalues of each
+ * covariance, so they are tightest when the covariances are not too elongated.
+ * Like all kd-tree based algorithms, this works best on low-dimensional data
+ * with many points and well-separated components.  Note that every node stores
+ * a (dimensionality x dimensionality) matrix, so for high-dimensional data,
+ * maxLeafSize should be increased to limit the memory used by the tree.
+ *
+ * The log-likelihood used to check convergence is also approximated for pruned
+ * nodes, using the log-likelihood of the centroid of the node.
+ *
+ * The initial clustering is done by EMFit with the same clusterer and
+ * covariance constraint.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+class KDTreeEMFit
+{
+ public:
+  /**
+   * Construct the KDTreeEMFit object, optionally passing an
+   * InitialClusteringType object (just in case it needs to store state).
+   * Setting the maximum number of iterations to 0 means that the EM algorithm
+   * will iterate until convergence (with the given tolerance).
+   *
+   * @param maxIterations Maximum number of iterations for EM.
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param approximationTolerance Maximum allowed error in the
+   *     responsibilities of each component for the points in a node.
+   * @param maxLeafSize Maximum number of points in each leaf of the kd-tree.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Object which applies constraints to the covariances.
+   */
+  KDTreeEMFit(const size_t maxIterations = 300,
+              const double tolerance = 1e-10,
+              const double approximationTolerance = 1e-3,
+              const size_t maxLeafSize = 100,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using the
+   * approximate EM algorithm.  The size of the vectors (indicating the number
+   * of components) must already be set.  Optionally, if useInitialModel is set
+   * to true, then the model given in the means, covariances, and weights
+   * parameters is used as the initial model, instead of using the
+   * InitialClusteringType::Cluster() option.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Vector to store trained distributions in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using the
+   * approximate EM algorithm, taking into account the probabilities of each
+   * point being from this mixture.  The size of the vectors (indicating the
+   * number of components) must already be set.  Optionally, if useInitialModel
+   * is set to true, then the model given in the means, covariances, and weights
+   * parameters is used as the initial model, instead of using the
+   * InitialClusteringType::Cluster() option.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Vector to store trained distributions in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the approximation tolerance for the responsibilities.
+  double ApproximationTolerance() const { return approximationTolerance; }
+  //! Modify the approximation tolerance for the responsibilities.
+  double& ApproximationTolerance() { return approximationTolerance; }
+
+  //! Get the maximum leaf size of the kd-tree.
+  size_t MaxLeafSize() const { return maxLeafSize; }
+  //! Modify the maximum leaf size of the kd-tree.
+  size_t& MaxLeafSize() { return maxLeafSize; }
+
+  //! Get the number of points evaluated exactly during the last call to
+  //! Estimate().
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of nodes pruned during the last call to Estimate().
+  size_t NumPrunes() const { return numPrunes; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int version);
+
+  //! Convenience typedef for the tree.
+  typedef tree::KDTree<metric::EuclideanDistance, KDTreeEMStatistic,
+      arma::mat> TreeType;
+
+ private:
+  /**
+   * Fit the model; this is the implementation of both overloads of
+   * Estimate().  If probabilities is empty, every point has probability 1.
+   */
+  void EstimateInternal(const arma::mat& observations,
+                        const arma::vec& probabilities,
+                        std::vector<distribution::GaussianDistribution>& dists,
+                        arma::vec& weights,
+                        const bool useInitialModel);
+
+  /**
+   * Fill the statistics of the given node and its descendants, using the given
+   * weights for each point (in the order of the tree's dataset).
+   */
+  void ComputeStatistics(TreeType& node, const arma::vec& pointWeights);
+
+  /**
+   * Cache the quantities of the current model that are needed during the
+   * traversal, and reset the accumulated statistics.
+   */
+  void Prepare(const std::vector<distribution::GaussianDistribution>& dists,
+               const arma::vec& weights,
+               const arma::vec& shift);
+
+  /**
+   * Traverse the given node, accumulating the statistics for the M-step, with
+   * only the given components considered.
+   */
+  void Traverse(TreeType& node,
+                const arma::vec& pointWeights,
+                const std::vector<size_t>& active);
+
+  /**
+   * Calculate the log-probability of the given point (relative to the shift)
+   * under each of the active components, storing them in logProbs, and return
+   * the log-probability of the point under the mixture of those components.
+   * logProbs is overwritten with the responsibilities of each active
+   * component.
+   */
+  double Responsibilities(const arma::vec& point,
+                          const std::vector<size_t>& active,
+                          arma::vec& logProbs) const;
+
+  /**
+   * Update the model from the statistics accumulated during the traversal.
+   */
+  void MStep(const arma::vec& shift,
+             const double totalProbability,
+             std::vector<distribution::GaussianDistribution>& dists,
+             arma::vec& weights);
+
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Maximum error of the responsibilities in pruned nodes.
+  double approximationTolerance;
+  //! Maximum leaf size of the kd-tree.
+  size_t maxLeafSize;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! Means of the current components, relative to the shift.
+  arma::mat means;
+  //! Inverses of the Cholesky factors of the current covariances.
+  std::vector<arma::mat> invLowers;
+  //! Log of weight and normalizing constant of each current component.
+  arma::vec logConstants;
+  //! Smallest eigenvalue of each current covariance.
+  arma::vec minEigenvalues;
+  //! Largest eigenvalue of each current covariance.
+  arma::vec maxEigenvalues;
+
+  //! Accumulated sum of responsibilities of each component.
+  arma::vec probSums;
+  //! Accumulated responsibility-weighted sum of points of each component.
+  arma::mat weightedSums;
+  //! Accumulated responsibility-weighted sum of outer products.
+  std::vector<arma::mat> weightedOuterSums;
+  //! Accumulated (approximate) log-likelihood.
+  double logLikelihood;
+
+  //! Number of points evaluated exactly.
+  size_t baseCases;
+  //! Number of nodes pruned.
+  size_t numPrunes;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "kd_tree_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,412 @@
+/**
+ * @file kd_tree_em_fit_impl.hpp
+ *
+ * Implementation of the kd-tree accelerated EM algorithm for fitting GMMs.
+ */
+#ifndef MLPACK_METHODS_GMM_KD_TREE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_KD_TREE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kd_tree_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::KDTreeEMFit(
+    const size_t maxIterations,
+    const double tolerance,
+    const double approximationTolerance,
+    const size_t maxLeafSize,
+    InitialClusteringType clusterer,
+    CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    approximationTolerance(approximationTolerance),
+    maxLeafSize(maxLeafSize),
+    clusterer(clusterer),
+    constraint(constraint),
+    logLikelihood(0.0),
+    baseCases(0),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  // An empty vector of probabilities means every point has probability 1.
+  EstimateInternal(observations, arma::vec(), dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+    const arma::mat& observations,
+    const arma::vec& probabilities,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights,
+    const bool useInitialModel)
+{
+  EstimateInternal(observations, probabilities, dists, weights,
+      useInitialModel);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+EstimateInternal(const arma::mat& observations,
+                 const arma::vec& probabilities,
+                 std::vector<distribution::GaussianDistribution>& dists,
+                 arma::vec& weights,
+                 const bool useInitialModel)
+{
+  // Only perform initial clustering if the user wanted it.  EMFit with a
+  // single iteration does exactly the initial clustering (and no M-step).
+  if (!useInitialModel)
+  {
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy> initialFit(1,
+        tolerance, clusterer, constraint);
+    initialFit.Estimate(observations, dists, weights, false);
+  }
+
+  // Build the tree on the observations, shifted by their mean so that the
+  // cached outer products are numerically well-behaved.
+  const arma::vec shift = arma::mean(observations, 1);
+  arma::mat shifted(observations);
+  shifted.each_col() -= shift;
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(std::move(shifted), oldFromNew, maxLeafSize);
+
+  // The tree reorders the points, so we must reorder the weights too.
+  arma::vec pointWeights(observations.n_cols);
+  for (size_t i = 0; i < pointWeights.n_elem; ++i)
+  {
+    pointWeights[i] = (probabilities.n_elem == 0) ? 1.0 :
+        probabilities[oldFromNew[i]];
+  }
+
+  ComputeStatistics(tree, pointWeights);
+
+  const double totalProbability = (probabilities.n_elem == 0) ?
+      (double) observations.n_cols : arma::accu(probabilities);
+
+  std::vector<size_t> allComponents(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+    allComponents[i] = i;
+
+  baseCases = 0;
+  numPrunes = 0;
+
+  // Each traversal also gives us the (approximate) log-likelihood of the model
+  // it used.
+  Prepare(dists, weights, shift);
+  Traverse(tree, pointWeights, allComponents);
+  double l = logLikelihood;
+
+  Log::Debug << "KDTreeEMFit::Estimate(): initial clustering log-likelihood: "
+      << l << std::endl;
+
+  double lOld = -DBL_MAX;
+
+  // Iterate to update the model until no more improvement is found.
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  {
+    Log::Info << "KDTreeEMFit::Estimate(): iteration " << iteration << ", "
+        << "log-likelihood " << l << "." << std::endl;
+
+    MStep(shift, totalProbability, dists, weights);
+
+    lOld = l;
+    Prepare(dists, weights, shift);
+    Traverse(tree, pointWeights, allComponents);
+    l = logLikelihood;
+
+    iteration++;
+  }
+
+  Log::Info << "KDTreeEMFit::Estimate(): " << numPrunes << " nodes pruned, "
+      << baseCases << " base cases." << std::endl;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+ComputeStatistics(TreeType& node, const arma::vec& pointWeights)
+{
+  const size_t dimensionality = node.Dataset().n_rows;
+  KDTreeEMStatistic& stat = node.Stat();
+
+  if (node.IsLeaf())
+  {
+    if (node.Count() == 0)
+    {
+      stat.Weight() = 0.0;
+      stat.WeightedSum().zeros(dimensionality);
+      stat.WeightedOuterSum().zeros(dimensionality, dimensionality);
+      return;
+    }
+
+    const size_t end = node.Begin() + node.Count() - 1;
+    const arma::mat points = node.Dataset().cols(node.Begin(), end);
+    const arma::vec w = pointWeights.subvec(node.Begin(), end);
+
+    arma::mat weightedPoints = points;
+    weightedPoints.each_row() %= w.t();
+
+    stat.Weight() = arma::accu(w);
+    stat.WeightedSum() = points * w;
+    stat.WeightedOuterSum() = weightedPoints * points.t();
+  }
+  else
+  {
+    ComputeStatistics(*node.Left(), pointWeights);
+    ComputeStatistics(*node.Right(), pointWeights);
+
+    const KDTreeEMStatistic& left = node.Left()->Stat();
+    const KDTreeEMStatistic& right = node.Right()->Stat();
+    stat.Weight() = left.Weight() + right.Weight();
+    stat.WeightedSum() = left.WeightedSum() + right.WeightedSum();
+    stat.WeightedOuterSum() = left.WeightedOuterSum() +
+        right.WeightedOuterSum();
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Prepare(
+    const std::vector<distribution::GaussianDistribution>& dists,
+    const arma::vec& weights,
+    const arma::vec& shift)
+{
+  const double log2pi = 1.83787706640934533908193770912475883;
+  const size_t dimensionality = shift.n_elem;
+  const size_t components = dists.size();
+
+  means.set_size(dimensionality, components);
+  invLowers.resize(components);
+  logConstants.set_size(components);
+  minEigenvalues.set_size(components);
+  maxEigenvalues.set_size(components);
+  for (size_t k = 0; k < components; ++k)
+  {
+    means.col(k) = dists[k].Mean() - shift;
+    invLowers[k] = arma::inv(arma::trimatl(dists[k].CovLower()));
+    logConstants[k] = std::log(weights[k]) - 0.5 * dimensionality * log2pi -
+        0.5 * dists[k].LogDetCov();
+
+    // The Mahalanobis distance of a point to the mean is bounded by its
+    // Euclidean distance scaled by the extreme eigenvalues of the covariance.
+    const arma::vec eigenvalues = arma::eig_sym(dists[k].Covariance());
+    minEigenvalues[k] = eigenvalues.min();
+    maxEigenvalues[k] = eigenvalues.max();
+  }
+
+  probSums.zeros(components);
+  weightedSums.zeros(dimensionality, components);
+  weightedOuterSums.resize(components);
+  for (size_t k = 0; k < components; ++k)
+    weightedOuterSums[k].zeros(dimensionality, dimensionality);
+  logLikelihood = 0.0;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Traverse(
+    TreeType& node,
+    const arma::vec& pointWeights,
+    const std::vector<size_t>& active)
+{
+  const KDTreeEMStatistic& stat = node.Stat();
+
+  // Points with no weight don't affect the model.
+  if (stat.Weight() == 0.0)
+    return;
+
+  // Bound the log-probability of every point in the node under each active
+  // component.
+  arma::vec logMax(active.size());
+  arma::vec logMin(active.size());
+  for (size_t a = 0; a < active.size(); ++a)
+  {
+    const size_t k = active[a];
+    const double minDistance = node.MinDistance(means.col(k));
+    const double maxDistance = node.MaxDistance(means.col(k));
+
+    logMax[a] = logConstants[k] - 0.5 * minDistance * minDistance /
+        maxEigenvalues[k];
+    logMin[a] = (minEigenvalues[k] > 0.0) ? logConstants[k] - 0.5 *
+        maxDistance * maxDistance / minEigenvalues[k] :
+        -std::numeric_limits<double>::infinity();
+  }
+
+  // Now turn those into bounds on the responsibilities.  The responsibility of
+  // a component is largest when it has its largest probability and every
+  // other component has its smallest probability (and vice versa).
+  std::vector<size_t> childActive;
+  bool canPrune = true;
+  const double maxLogMax = logMax.max();
+  if (maxLogMax == -std::numeric_limits<double>::infinity())
+  {
+    // We can't say anything about this node.
+    childActive = active;
+    canPrune = false;
+  }
+  else
+  {
+    const arma::vec upper = arma::exp(logMax - maxLogMax);
+    const arma::vec lower = arma::exp(logMin - maxLogMax);
+    const double upperSum = arma::accu(upper);
+    const double lowerSum = arma::accu(lower);
+
+    for (size_t a = 0; a < active.size(); ++a)
+    {
+      const double maxResp = (upper[a] == 0.0) ? 0.0 : upper[a] /
+          (upper[a] + std::max(lowerSum - lower[a], 0.0));
+      const double minResp = (lower[a] == 0.0) ? 0.0 : lower[a] /
+          (lower[a] + std::max(upperSum - upper[a], 0.0));
+
+      // Components that can't have any significant responsibility are ignored
+      // in this whole subtree.
+      if (maxResp < approximationTolerance)
+        continue;
+
+      childActive.push_back(active[a]);
+      if (maxResp - minResp >= approximationTolerance)
+        canPrune = false;
+    }
+
+    // This could only happen if the tolerance is very large.
+    if (childActive.empty())
+    {
+      arma::uword best;
+      logMax.max(best);
+      childActive.push_back(active[best]);
+    }
+  }
+
+  arma::vec responsibilities;
+  if (canPrune)
+  {
+    // Every point in the node has (approximately) the same responsibilities,
+    // so we can use the responsibilities of the centroid for all of them.
+    const arma::vec centroid = stat.WeightedSum() / stat.Weight();
+    const double logProb = Responsibilities(centroid, childActive,
+        responsibilities);
+
+    for (size_t a = 0; a < childActive.size(); ++a)
+    {
+      const size_t k = childActive[a];
+      probSums[k] += responsibilities[a] * stat.Weight();
+      weightedSums.col(k) += responsibilities[a] * stat.WeightedSum();
+      weightedOuterSums[k] += responsibilities[a] * stat.WeightedOuterSum();
+    }
+
+    logLikelihood += node.NumDescendants() * logProb;
+    ++numPrunes;
+  }
+  else if (node.IsLeaf())
+  {
+    // Evaluate each point exactly (with respect to the active components).
+    for (size_t i = node.Begin(); i < node.Begin() + node.Count(); ++i)
+    {
+      const arma::vec point = node.Dataset().unsafe_col(i);
+      logLikelihood += Responsibilities(point, childActive, responsibilities);
+
+      for (size_t a = 0; a < childActive.size(); ++a)
+      {
+        const size_t k = childActive[a];
+        const double r = pointWeights[i] * responsibilities[a];
+        probSums[k] += r;
+        weightedSums.col(k) += r * point;
+        weightedOuterSums[k] += r * (point * point.t());
+      }
+
+      ++baseCases;
+    }
+  }
+  else
+  {
+    Traverse(*node.Left(), pointWeights, childActive);
+    Traverse(*node.Right(), pointWeights, childActive);
+  }
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+double KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+Responsibilities(const arma::vec& point,
+                 const std::vector<size_t>& active,
+                 arma::vec& logProbs) const
+{
+  logProbs.set_size(active.size());
+  for (size_t a = 0; a < active.size(); ++a)
+  {
+    const size_t k = active[a];
+    const arma::vec z = invLowers[k] * (point - means.col(k));
+    logProbs[a] = logConstants[k] - 0.5 * arma::dot(z, z);
+  }
+
+  // Avoid dividing by zero; if the probability for everything is 0, we don't
+  // want to make it NaN.
+  const double maxLogProb = logProbs.max();
+  if (maxLogProb == -std::numeric_limits<double>::infinity())
+  {
+    logProbs.zeros();
+    return maxLogProb;
+  }
+
+  logProbs = arma::exp(logProbs - maxLogProb);
+  const double sum = arma::accu(logProbs);
+  logProbs /= sum;
+
+  return maxLogProb + std::log(sum);
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::MStep(
+    const arma::vec& shift,
+    const double totalProbability,
+    std::vector<distribution::GaussianDistribution>& dists,
+    arma::vec& weights)
+{
+  for (size_t i = 0; i < dists.size(); i++)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probSums[i] == 0.0)
+      continue;
+
+    const arma::vec mean = weightedSums.col(i) / probSums[i];
+    dists[i].Mean() = mean + shift;
+
+    arma::mat covariance = weightedOuterSums[i] / probSums[i] -
+        mean * mean.t();
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = probSums / totalProbability;
+}
+
+template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename Archive>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy>::Serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  using data::CreateNVP;
+
+  ar & CreateNVP(maxIterations, "maxIterations");
+  ar & CreateNVP(tolerance, "tolerance");
+  ar & CreateNVP(approximationTolerance, "approximationTolerance");
+  ar & CreateNVP(maxLeafSize, "maxLeafSize");
+  ar & CreateNVP(clusterer, "clusterer");
+  ar & CreateNVP(constraint, "constraint");
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file kd_tree_em_statistic.hpp
+ *
+ * A StatisticType for trees which holds the sufficient statistics of the points
+ * in a node, for use by KDTreeEMFit.
+ */
+#ifndef MLPACK_METHODS_GMM_KD_TREE_EM_STATISTIC_HPP
+#define MLPACK_METHODS_GMM_KD_TREE_EM_STATISTIC_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * A statistic for trees which holds the (weighted) number of points in a node,
+ * their (weighted) sum, and the (weighted) sum of their outer products.  These
+ * are exactly the quantities that the M-step of the EM algorithm needs, so if
+ * every point in a node has (approximately) the same responsibilities, the
+ * whole node can be accounted for at once.
+ *
+ * The statistics are not calculated when the tree is built, because the
+ * weights of the points are not known then; KDTreeEMFit fills them in.
+ */
+class KDTreeEMStatistic
+{
+ public:
+  //! Initialize the statistic without a node (this does nothing).
+  KDTreeEMStatistic() : weight(0.0) { }
+
+  //! Initialize the statistic for a node (this does nothing; the statistics
+  //! are filled in later).
+  template<typename TreeType>
+  KDTreeEMStatistic(TreeType& /* node */) : weight(0.0) { }
+
+  //! Get the total weight of the points in the node.
+  double Weight() const { return weight; }
+  //! Modify the total weight of the points in the node.
+  double& Weight() { return weight; }
+
+  //! Get the weighted sum of the points in the node.
+  const arma::vec& WeightedSum() const { return weightedSum; }
+  //! Modify the weighted sum of the points in the node.
+  arma::vec& WeightedSum() { return weightedSum; }
+
+  //! Get the weighted sum of the outer products of the points in the node.
+  const arma::mat& WeightedOuterSum() const { return weightedOuterSum; }
+  //! Modify the weighted sum of the outer products of the points in the node.
+  arma::mat& WeightedOuterSum() { return weightedOuterSum; }
+
+ private:
+  //! The total weight of the points in the node.
+  double weight;
+  //! The weighted sum of the points in the node.
+  arma::vec weightedSum;
+  //! The weighted sum of the outer products of the points in the node.
+  arma::mat weightedOuterSum;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -34,6 +34,10 @@ namespace hmm /** Hidden Markov Models. */ {
  *   // Return the probability of the given observation.
  *   double Probability(const DataType& observation) const;
  *
+ *   // Calculate the log-probability of each of the given observations.
+ *   void LogProbability(const arma::mat& observations,
+ *                       arma::vec& logProbabilities) const;
+ *
  *   // Estimate the distribution based on the given observations.
  *   void Train(const std::vector<DataType>& observations);
  *
@@ -353,6 +357,45 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each state.  The returned matrix has
+   * rows equal to the number of hidden states and columns equal to the number
+   * of observations.  Each emission distribution is evaluated on the whole
+   * sequence at once.
+   *
+   * @param dataSeq Data sequence to compute emission probabilities for.
+   * @param logProb Matrix in which emission log-probabilities will be saved.
+   */
+  void EmissionLogProbability(const arma::mat& dataSeq,
+                              arma::mat& logProb) const;
+
+  /**
+   * The Forward algorithm, given the emission probabilities (not
+   * log-probabilities) of each observation, as returned by
+   * EmissionLogProbability() after exponentiation.
+   *
+   * @param emissionProb Emission probabilities for each state and observation.
+   * @param scales Vector in which scaling factors will be saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   */
+  void ForwardFromEmission(const arma::mat& emissionProb,
+                           arma::vec& scales,
+                           arma::mat& forwardProb) const;
+
+  /**
+   * The Backward algorithm, given the emission probabilities (not
+   * log-probabilities) of each observation and the scaling factors found by
+   * ForwardFromEmission().
+   *
+   * @param emissionProb Emission probabilities for each state and observation.
+   * @param scales Vector of scaling factors.
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  void BackwardFromEmission(const arma::mat& emissionProb,
+                            const arma::vec& scales,
+                            arma::mat& backwardProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
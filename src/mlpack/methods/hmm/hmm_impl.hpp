@@ -124,8 +124,18 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
       arma::mat backward;
       arma::vec scales;
 
+      // Evaluate the emission distributions on the whole sequence once; we
+      // need the emission probabilities for the forward and backward
+      // procedures and for the transition estimate below.
+      arma::mat seqEmission;
+      EmissionLogProbability(dataSeq[seq], seqEmission);
+      seqEmission = arma::exp(seqEmission);
+
       // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
+      ForwardFromEmission(seqEmission, scales, forward);
+      BackwardFromEmission(seqEmission, scales, backward);
+      stateProb = forward % backward;
+      loglik += accu(log(scales));
 
       // Add to estimate of initial probability for state j.
       for (size_t j = 0; j < transition.n_cols; ++j)
@@ -139,22 +149,18 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
       // We store the new estimates in a different matrix.
       for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
       {
-        for (size_t j = 0; j < transition.n_cols; ++j)
+        if (t < dataSeq[seq].n_cols - 1)
         {
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+          // Estimate of T_ij (probability of transition from state j to state
+          // i).  We postpone multiplication of the old T_ij until later.
+          newTransition += (backward.col(t + 1) % seqEmission.col(t + 1) /
+              scales[t + 1]) * trans(forward.col(t));
         }
+
+        // Add to list of emission observations, for Distribution::Train().
+        emissionList.col(sumTime) = dataSeq[seq].col(t);
+        for (size_t j = 0; j < transition.n_cols; ++j)
+          emissionProb[j][sumTime] = stateProb(j, t);
         sumTime++;
       }
     }
@@ -304,9 +310,14 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& backwardProb,
                                    arma::vec& scales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  // Evaluate the emission distributions on the whole sequence once, and then
+  // run the forward-backward algorithm.
+  arma::mat emissionProb;
+  EmissionLogProbability(dataSeq, emissionProb);
+  emissionProb = arma::exp(emissionProb);
+
+  ForwardFromEmission(emissionProb, scales, forwardProb);
+  BackwardFromEmission(emissionProb, scales, backwardProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -401,14 +412,17 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   // will be using the rows of the transition matrix.
   arma::mat logTrans(log(trans(transition)));
 
+  // Evaluate the emission distributions on the whole sequence at once.
+  arma::mat logEmission;
+  EmissionLogProbability(dataSeq, logEmission);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
   logStateProb.col(0).zeros();
   for (size_t state = 0; state < transition.n_rows; state++)
   {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
+    logStateProb(state, 0) = log(initial[state]) + logEmission(state, 0);
     stateSeqBack(state, 0) = state;
   }
 
@@ -422,8 +436,7 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     for (size_t j = 0; j < transition.n_rows; j++)
     {
       arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
+      logStateProb(j, t) = prob.max(index) + logEmission(j, t);
         stateSeqBack(j, t) = index;
     }
   }
@@ -502,20 +515,62 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat emissionProb;
+  EmissionLogProbability(dataSeq, emissionProb);
+  emissionProb = arma::exp(emissionProb);
+
+  ForwardFromEmission(emissionProb, scales, forwardProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  arma::mat emissionProb;
+  EmissionLogProbability(dataSeq, emissionProb);
+  emissionProb = arma::exp(emissionProb);
+
+  BackwardFromEmission(emissionProb, scales, backwardProb);
+}
+
+/**
+ * Evaluate each emission distribution on the whole data sequence.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbability(const arma::mat& dataSeq,
+                                               arma::mat& logProb) const
+{
+  logProb.set_size(transition.n_rows, dataSeq.n_cols);
+
+  arma::vec stateLogProb;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    emission[state].LogProbability(dataSeq, stateLogProb);
+    logProb.row(state) = trans(stateLogProb);
+  }
+}
+
+/**
+ * The Forward procedure, given the emission probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ForwardFromEmission(const arma::mat& emissionProb,
+                                            arma::vec& scales,
+                                            arma::mat& forwardProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  forwardProb.zeros(transition.n_rows, emissionProb.n_cols);
+  scales.zeros(emissionProb.n_cols);
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  forwardProb.col(0) = initial % emissionProb.col(0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
@@ -523,17 +578,13 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
     forwardProb.col(0) /= scales[0];
 
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < emissionProb.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation.
+    forwardProb.col(t) = (transition * forwardProb.col(t - 1)) %
+        emissionProb.col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
@@ -542,35 +593,34 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * The Backward procedure, given the emission probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+void HMM<Distribution>::BackwardFromEmission(const arma::mat& emissionProb,
+                                             const arma::vec& scales,
+                                             arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.zeros(transition.n_rows, emissionProb.n_cols);
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardProb.col(emissionProb.n_cols - 1).fill(1);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = emissionProb.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      if (scales[t + 1] > 0.0)
-        backwardProb(j, t) /= scales[t + 1];
-    }
+    // The backward probability of state j at time t is the sum over all state
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.
+    backwardProb.col(t) = trans(transition) * (backwardProb.col(t + 1) %
+        emissionProb.col(t + 1));
+
+    // Normalize by the weights from the forward algorithm.
+    if (scales[t + 1] > 0.0)
+      backwardProb.col(t) /= scales[t + 1];
   }
 }
 
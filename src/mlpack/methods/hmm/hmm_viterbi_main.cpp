@@ -9,6 +9,7 @@
 
 #include "hmm.hpp"
 #include "hmm_util.hpp"
+#include "online_viterbi.hpp"
 
 #include <mlpack/methods/gmm/gmm.hpp>
 
@@ -16,13 +17,31 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction", "This "
     "utility takes an already-trained HMM (--model_file) and evaluates the "
     "most probably hidden state sequence of a given sequence of observations "
     "(--input_file), using the Viterbi algorithm.  The computed state sequence "
-    "is saved to the specified output file (--output_file).");
+    "is saved to the specified output file (--output_file)."
+    "\n\n"
+    "If --stream is specified, observations are instead read from standard "
+    "input, one observation per line (with dimensions separated by spaces or "
+    "commas), and decoded with an online variant of the Viterbi algorithm that "
+    "uses memory independent of the length of the sequence.  Decoded states "
+    "are written, one per line, to the output file (or to standard output if "
+    "--output_file is not given) as soon as they are decided.  Observations "
+    "are processed in chunks of --chunk_size observations, and at most "
+    "--max_lag observations may be undecided at once; if the most probable "
+    "paths have not converged by then, a decision is forced, and the result "
+    "may differ from the exact Viterbi path.");
 
-PARAM_STRING_IN_REQ("input_file", "File containing observations,", "i");
+PARAM_STRING_IN("input_file", "File containing observations,", "i", "");
 PARAM_STRING_IN_REQ("model_file", "File containing HMM.", "m");
 PARAM_STRING_OUT("output_file", "File to save predicted state sequence to.",
     "o");
 
+PARAM_FLAG("stream", "If set, read observations from standard input and decode "
+    "them online.", "s");
+PARAM_INT_IN("chunk_size", "Number of observations to read at once in "
+    "streaming mode.", "c", 1000);
+PARAM_INT_IN("max_lag", "Maximum number of undecided observations in streaming "
+    "mode.", "l", 10000);
+
 using namespace mlpack;
 using namespace mlpack::hmm;
 using namespace mlpack::distribution;
@@ -31,6 +50,105 @@ using namespace mlpack::gmm;
 using namespace arma;
 using namespace std;
 
+// Read up to the given number of observations from the given stream into the
+// columns of the given matrix, one observation per line.  The matrix is resized
+// to the number of observations that were read.
+void ReadChunk(istream& input, mat& chunk, const size_t chunkSize)
+{
+  chunk.set_size(chunk.n_rows, chunkSize);
+
+  size_t col = 0;
+  string line;
+  while (col < chunkSize && getline(input, line))
+  {
+    // Allow comma-separated values too.
+    replace(line.begin(), line.end(), ',', ' ');
+    istringstream lineStream(line);
+
+    size_t row = 0;
+    double value;
+    while (lineStream >> value)
+    {
+      if (row < chunk.n_rows)
+        chunk(row, col) = value;
+      ++row;
+    }
+
+    // Skip blank lines.
+    if (row == 0)
+      continue;
+
+    if (row != chunk.n_rows)
+      Log::Fatal << "Observation " << col << " of chunk has dimensionality "
+          << row << ", but HMM dimensionality is " << chunk.n_rows << "!"
+          << endl;
+
+    ++col;
+  }
+
+  chunk.resize(chunk.n_rows, col);
+}
+
+// Decode observations from stdin online, writing states as soon as they are
+// decided.
+struct StreamingViterbi
+{
+  template<typename HMMType>
+  static void Apply(HMMType& hmm, void* /* extraInfo */)
+  {
+    const int chunkSize = CLI::GetParam<int>("chunk_size");
+    const int maxLag = CLI::GetParam<int>("max_lag");
+
+    if (chunkSize <= 0)
+      Log::Fatal << "Invalid chunk size (" << chunkSize << "); must be greater "
+          << "than 0!" << endl;
+    if (maxLag <= 0)
+      Log::Fatal << "Invalid maximum lag (" << maxLag << "); must be greater "
+          << "than 0!" << endl;
+
+    ofstream outputFile;
+    if (CLI::HasParam("output_file"))
+    {
+      outputFile.open(CLI::GetParam<string>("output_file"));
+      if (!outputFile.is_open())
+        Log::Fatal << "Cannot open output file '"
+            << CLI::GetParam<string>("output_file") << "' for writing!"
+            << endl;
+    }
+    ostream& output = outputFile.is_open() ? outputFile : cout;
+
+    OnlineViterbi<HMMType> viterbi(hmm, (size_t) maxLag);
+
+    mat chunk(hmm.Emission()[0].Dimensionality(), (size_t) chunkSize);
+    arma::Row<size_t> decoded;
+    while (cin)
+    {
+      ReadChunk(cin, chunk, (size_t) chunkSize);
+      if (chunk.n_cols == 0)
+        break;
+
+      viterbi.Process(chunk, decoded);
+      for (size_t i = 0; i < decoded.n_elem; ++i)
+        output << decoded[i] << "\n";
+      output.flush();
+    }
+
+    const size_t forcedDecisions = viterbi.ForcedDecisions();
+    const size_t processed = viterbi.Processed();
+    const double logLikelihood = viterbi.Finish(decoded);
+    for (size_t i = 0; i < decoded.n_elem; ++i)
+      output << decoded[i] << "\n";
+    output.flush();
+
+    Log::Info << "Decoded " << processed << " observations; log-likelihood of "
+        << "most probable state sequence is " << logLikelihood << "." << endl;
+    if (forcedDecisions > 0)
+      Log::Warn << forcedDecisions << " decisions were forced because the "
+          << "window of undecided observations was full; consider increasing "
+          << "--max_lag (-l)." << endl;
+  }
+};
+
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
 struct Viterbi
@@ -73,10 +191,24 @@ int main(int argc, char** argv)
   // Parse command line options.
   CLI::ParseCommandLine(argc, argv);
 
+  const string modelFile = CLI::GetParam<string>("model_file");
+  if (CLI::HasParam("stream"))
+  {
+    if (CLI::HasParam("input_file"))
+      Log::Warn << "--input_file (-i) is ignored because --stream (-s) is "
+          << "specified." << endl;
+
+    LoadHMMAndPerformAction<StreamingViterbi>(modelFile);
+    return 0;
+  }
+
+  if (!CLI::HasParam("input_file"))
+    Log::Fatal << "--input_file (-i) must be specified unless --stream (-s) is "
+        << "given!" << endl;
+
   if (!CLI::HasParam("output_file"))
     Log::Warn << "--output_file (-o) is not specified; no results will be "
         << "saved!" << endl;
 
-  const string modelFile = CLI::GetParam<string>("model_file");
   LoadHMMAndPerformAction<Viterbi>(modelFile);
 }
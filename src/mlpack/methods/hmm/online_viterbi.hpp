@@ -0,0 +1,198 @@
+/**
+ * @file online_viterbi.hpp
+ *
+ * Definition of the OnlineViterbi class, which decodes the most probable hidden
+ * state sequence of an HMM from a stream of observations using bounded memory.
+ */
+#ifndef MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+#define MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * An online variant of the Viterbi algorithm.  HMM::Predict() needs the entire
+ * observation sequence in memory and stores a (states x T) matrix of
+ * backpointers; for very long sequences (or sequences that never end), that is
+ * not feasible.  This class instead takes observations in chunks via Process()
+ * and keeps only the backpointers of time steps whose state has not been
+ * decided yet.
+ *
+ * After each observation, the survivor paths of every state are checked for
+ * convergence: once all of the survivor paths pass through the same state at
+ * some time t, the most probable state sequence up to and including time t can
+ * no longer change, so it is emitted and the corresponding backpointers are
+ * discarded.  Checking for convergence costs O(states) per observation, plus an
+ * amortized backtracking cost whenever the paths have merged.
+ *
+ * The number of undecided time steps is bounded by maxLag, so the memory used
+ * is O(states * maxLag) and independent of the length of the sequence.  If the
+ * survivor paths have not converged after maxLag observations, the first half
+ * of the window is decided using the path of the currently most probable
+ * state.  In that case the decoded sequence is not guaranteed to be identical
+ * to the output of HMM::Predict(), so maxLag should be chosen large enough
+ * that this rarely happens.  If no forced decisions were made, the decoded
+ * sequence is exactly the Viterbi path.
+ *
+ * Example usage:
+ *
+ * @code
+ * extern HMM<GaussianDistribution> hmm;
+ * OnlineViterbi<HMM<GaussianDistribution>> viterbi(hmm, 5000);
+ *
+ * arma::mat chunk;
+ * arma::Row<size_t> decoded;
+ * while (GetNextChunk(chunk))
+ * {
+ *   viterbi.Process(chunk, decoded);
+ *   // ... do something with the newly decoded states ...
+ * }
+ *
+ * // Decode the states that have not been decided yet.
+ * const double logLikelihood = viterbi.Finish(decoded);
+ * @endcode
+ *
+ * @tparam HMMType Type of HMM to decode observations with.
+ */
+template<typename HMMType>
+class OnlineViterbi
+{
+ public:
+  /**
+   * Create the online decoder for the given HMM.  The HMM is not copied, so it
+   * must not be modified or destroyed while this object is in use.
+   *
+   * @param hmm Trained HMM to use for decoding.
+   * @param maxLag Maximum number of time steps that may be undecided before a
+   *     decision is forced.
+   */
+  OnlineViterbi(const HMMType& hmm, const size_t maxLag = 10000);
+
+  /**
+   * Process the given chunk of observations (each column is one observation).
+   * The states that have been decided while processing the chunk are stored in
+   * decoded; these continue the sequence of states emitted by previous calls.
+   * Any number of states (including zero) may be emitted.
+   *
+   * @param observations Chunk of observations to process.
+   * @param decoded Vector in which the newly decoded states will be stored.
+   * @return Number of newly decoded states.
+   */
+  size_t Process(const arma::mat& observations, arma::Row<size_t>& decoded);
+
+  /**
+   * Signal the end of the observation sequence: decode all of the states that
+   * are still undecided, and store them in decoded.  Afterwards, the object is
+   * reset and can be used to decode a new sequence.
+   *
+   * @param decoded Vector in which the remaining decoded states will be stored.
+   * @return Log-likelihood of the most probable state sequence.
+   */
+  double Finish(arma::Row<size_t>& decoded);
+
+  //! Forget all observations seen so far and start a new sequence.
+  void Reset();
+
+  //! Get the log-likelihood of the most probable state sequence so far.
+  double LogLikelihood() const;
+
+  //! Get the number of observations processed since the last reset.
+  size_t Processed() const { return processed; }
+  //! Get the number of observations whose state has not been decided yet.
+  size_t Pending() const { return pending; }
+  //! Get the number of decisions that had to be forced since the last reset.
+  size_t ForcedDecisions() const { return forcedDecisions; }
+
+  //! Get the maximum number of undecided time steps.
+  size_t MaxLag() const { return maxLag; }
+
+ private:
+  //! Perform one step of the Viterbi recursion, given the log-probability of
+  //! the observation under the emission distribution of each state.
+  void Step(const arma::vec& logEmission);
+
+  /**
+   * Trace the survivor path ending at the given state in the given pending
+   * column back to the oldest pending column, storing it in the path buffer.
+   */
+  void Backtrack(const size_t column, const size_t state);
+
+  /**
+   * Emit the first count states of the path buffer, and drop the corresponding
+   * columns from the backpointer window.
+   */
+  void Emit(const size_t count, arma::Row<size_t>& decoded);
+
+  //! Return true if all survivor paths pass through the same state at the
+  //! oldest pending time step.
+  bool Converged() const;
+
+  //! Recompute the root of every survivor path after columns were dropped.
+  void UpdateRoots();
+
+  /**
+   * Search backwards for the most recent time step at which all survivor paths
+   * pass through the same state, and emit the path up to that time step.  This
+   * should only be called when all roots are equal.
+   */
+  void EmitConverged(arma::Row<size_t>& decoded);
+
+  //! Return the index in the circular buffer of the given pending column.
+  size_t Index(const size_t column) const
+  { return (start + column) % maxLag; }
+
+  //! The HMM used for decoding.
+  const HMMType& hmm;
+  //! The maximum number of undecided time steps.
+  size_t maxLag;
+
+  //! Logarithm of the transposed transition matrix.
+  arma::mat logTrans;
+  //! Logarithm of the initial state probabilities.
+  arma::vec logInitial;
+  //! Emission log-probabilities of each state for the current chunk.
+  arma::mat chunkLogEmission;
+  //! Buffer for the emission log-probabilities of a single state.
+  arma::vec stateLogEmission;
+  //! Log-probabilities of the best path ending in each state, minus logOffset.
+  arma::vec logStateProb;
+  //! Buffer for the log-probabilities of the next time step.
+  arma::vec newLogStateProb;
+  //! Offset that was subtracted from logStateProb to avoid loss of precision.
+  double logOffset;
+
+  //! Circular buffer of backpointers for the undecided time steps.
+  arma::Mat<size_t> backPointers;
+  //! Index in the circular buffer of the oldest undecided time step.
+  size_t start;
+  //! Number of undecided time steps.
+  size_t pending;
+
+  //! The state at the oldest undecided time step of each survivor path.
+  arma::Col<size_t> roots;
+  //! Buffer for the roots of the next time step.
+  arma::Col<size_t> newRoots;
+  //! Buffer for the result of backtracking.
+  arma::Col<size_t> path;
+  //! Buffer to mark states during the convergence search.
+  std::vector<char> marked;
+  //! Set of states on the survivor paths during the convergence search.
+  std::vector<size_t> frontier;
+  //! Buffer for the next set of states during the convergence search.
+  std::vector<size_t> nextFrontier;
+
+  //! Number of observations processed since the last reset.
+  size_t processed;
+  //! Number of times a decision had to be forced.
+  size_t forcedDecisions;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_viterbi_impl.hpp"
+
+#endif
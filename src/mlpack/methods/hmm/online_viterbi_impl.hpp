@@ -0,0 +1,309 @@
+/**
+ * @file online_viterbi_impl.hpp
+ *
+ * Implementation of the OnlineViterbi class.
+ */
+#ifndef MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+#define MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_viterbi.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+template<typename HMMType>
+OnlineViterbi<HMMType>::OnlineViterbi(const HMMType& hmm,
+                                      const size_t maxLag) :
+    hmm(hmm),
+    maxLag(maxLag)
+{
+  if (maxLag == 0)
+    Log::Fatal << "OnlineViterbi::OnlineViterbi(): maxLag must be greater "
+        << "than 0!" << std::endl;
+
+  const size_t states = hmm.Transition().n_rows;
+
+  // Store the logs of the transposed transition matrix, like HMM::Predict().
+  logTrans = arma::log(arma::trans(hmm.Transition()));
+  logInitial = arma::log(hmm.Initial());
+
+  // Allocate everything now, so that no allocations are necessary while
+  // processing observations.
+  logStateProb.set_size(states);
+  newLogStateProb.set_size(states);
+  backPointers.set_size(states, maxLag);
+  roots.set_size(states);
+  newRoots.set_size(states);
+  path.set_size(maxLag);
+  marked.resize(states);
+  frontier.reserve(states);
+  nextFrontier.reserve(states);
+
+  Reset();
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Reset()
+{
+  logStateProb.zeros();
+  logOffset = 0.0;
+  start = 0;
+  pending = 0;
+  processed = 0;
+  forcedDecisions = 0;
+}
+
+template<typename HMMType>
+size_t OnlineViterbi<HMMType>::Process(const arma::mat& observations,
+                                       arma::Row<size_t>& decoded)
+{
+  if (observations.n_rows != hmm.Dimensionality())
+    Log::Fatal << "OnlineViterbi::Process(): observations have dimensionality "
+        << observations.n_rows << " (expected " << hmm.Dimensionality()
+        << " dimensions)." << std::endl;
+
+  // Evaluate each emission distribution on the whole chunk at once.
+  const size_t states = logStateProb.n_elem;
+  chunkLogEmission.set_size(states, observations.n_cols);
+  for (size_t j = 0; j < states; ++j)
+  {
+    hmm.Emission()[j].LogProbability(observations, stateLogEmission);
+    chunkLogEmission.row(j) = arma::trans(stateLogEmission);
+  }
+
+  decoded.set_size(0);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    Step(chunkLogEmission.unsafe_col(i));
+
+    // If every survivor path has the same root, then at least the state at the
+    // oldest pending time step is decided.
+    if (Converged())
+    {
+      EmitConverged(decoded);
+    }
+    else if (pending == maxLag)
+    {
+      // The window is full, so we have to force a decision.  Use the path of
+      // the most probable state, and decide half of the window at once so that
+      // we don't have to backtrack through the whole window at every step.
+      arma::uword best;
+      logStateProb.max(best);
+      Backtrack(pending - 1, best);
+      Emit(std::max(maxLag / 2, (size_t) 1), decoded);
+      UpdateRoots();
+      ++forcedDecisions;
+    }
+  }
+
+  return decoded.n_elem;
+}
+
+template<typename HMMType>
+double OnlineViterbi<HMMType>::Finish(arma::Row<size_t>& decoded)
+{
+  decoded.set_size(0);
+  if (pending > 0)
+  {
+    // Now we can simply backtrack from the most probable state, like in the
+    // last step of HMM::Predict().
+    arma::uword best;
+    logStateProb.max(best);
+    Backtrack(pending - 1, best);
+    Emit(pending, decoded);
+  }
+
+  const double logLikelihood = LogLikelihood();
+  Reset();
+  return logLikelihood;
+}
+
+template<typename HMMType>
+double OnlineViterbi<HMMType>::LogLikelihood() const
+{
+  // An empty sequence has probability 1.
+  if (processed == 0)
+    return 0.0;
+
+  return logOffset + logStateProb.max();
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Step(const arma::vec& logEmission)
+{
+  const size_t states = logStateProb.n_elem;
+  const size_t column = Index(pending);
+
+  if (processed == 0)
+  {
+    // The first state is handled just like in HMM::Predict().
+    for (size_t j = 0; j < states; ++j)
+    {
+      newLogStateProb[j] = logInitial[j] + logEmission[j];
+      backPointers(j, column) = j;
+      newRoots[j] = j;
+    }
+  }
+  else
+  {
+    for (size_t j = 0; j < states; ++j)
+    {
+      // Given that we are in state j, find the state with the highest
+      // probability of being the previous state.
+      size_t index = 0;
+      double maxProb = logStateProb[0] + logTrans(0, j);
+      for (size_t i = 1; i < states; ++i)
+      {
+        const double prob = logStateProb[i] + logTrans(i, j);
+        if (prob > maxProb)
+        {
+          maxProb = prob;
+          index = i;
+        }
+      }
+
+      newLogStateProb[j] = maxProb + logEmission[j];
+      backPointers(j, column) = index;
+
+      // If nothing is pending, this time step is the oldest pending time step,
+      // so each path is its own root.
+      newRoots[j] = (pending == 0) ? j : roots[index];
+    }
+  }
+
+  // The log-probabilities only ever decrease, so to keep them in a range where
+  // doubles are precise, we keep track of an offset separately.
+  const double maxLogProb = newLogStateProb.max();
+  if (std::isfinite(maxLogProb))
+  {
+    newLogStateProb -= maxLogProb;
+    logOffset += maxLogProb;
+  }
+
+  logStateProb.swap(newLogStateProb);
+  roots.swap(newRoots);
+  ++pending;
+  ++processed;
+}
+
+template<typename HMMType>
+bool OnlineViterbi<HMMType>::Converged() const
+{
+  // Paths that end in a state with zero probability can never become part of
+  // the most probable path, so they are ignored unless all paths have zero
+  // probability.
+  bool anyPossible = false;
+  size_t root = 0;
+  for (size_t j = 0; j < roots.n_elem; ++j)
+  {
+    if (logStateProb[j] == -std::numeric_limits<double>::infinity())
+      continue;
+
+    if (!anyPossible)
+    {
+      anyPossible = true;
+      root = roots[j];
+    }
+    else if (roots[j] != root)
+    {
+      return false;
+    }
+  }
+
+  if (anyPossible)
+    return true;
+
+  for (size_t j = 1; j < roots.n_elem; ++j)
+    if (roots[j] != roots[0])
+      return false;
+
+  return true;
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Backtrack(const size_t column, const size_t state)
+{
+  path[column] = state;
+  for (size_t k = column; k > 0; --k)
+    path[k - 1] = backPointers(path[k], Index(k));
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Emit(const size_t count,
+                                  arma::Row<size_t>& decoded)
+{
+  const size_t oldSize = decoded.n_elem;
+  decoded.resize(oldSize + count);
+  for (size_t k = 0; k < count; ++k)
+    decoded[oldSize + k] = path[k];
+
+  start = Index(count);
+  pending -= count;
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::UpdateRoots()
+{
+  if (pending == 0)
+    return;
+
+  for (size_t j = 0; j < roots.n_elem; ++j)
+  {
+    size_t state = j;
+    for (size_t k = pending - 1; k > 0; --k)
+      state = backPointers(state, Index(k));
+    roots[j] = state;
+  }
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::EmitConverged(arma::Row<size_t>& decoded)
+{
+  // Walk backwards from the newest time step, keeping the set of states that
+  // lie on some survivor path.  The first time step where that set contains
+  // only one state is the most recent point of convergence.
+  // Just like in Converged(), paths with zero probability are ignored.
+  frontier.clear();
+  for (size_t j = 0; j < logStateProb.n_elem; ++j)
+    if (logStateProb[j] != -std::numeric_limits<double>::infinity())
+      frontier.push_back(j);
+
+  if (frontier.empty())
+  {
+    for (size_t j = 0; j < logStateProb.n_elem; ++j)
+      frontier.push_back(j);
+  }
+
+  size_t column = pending - 1;
+  while (frontier.size() > 1)
+  {
+    // The roots are all equal, so this loop terminates at column 0 at the
+    // latest.
+    nextFrontier.clear();
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      const size_t previous = backPointers(frontier[i], Index(column));
+      if (!marked[previous])
+      {
+        marked[previous] = 1;
+        nextFrontier.push_back(previous);
+      }
+    }
+
+    for (size_t i = 0; i < nextFrontier.size(); ++i)
+      marked[nextFrontier[i]] = 0;
+
+    frontier.swap(nextFrontier);
+    --column;
+  }
+
+  Backtrack(column, frontier[0]);
+  Emit(column + 1, decoded);
+  UpdateRoots();
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
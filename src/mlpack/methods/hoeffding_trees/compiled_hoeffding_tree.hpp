@@ -0,0 +1,191 @@
+/**
+ * @file compiled_hoeffding_tree.hpp
+ *
+ * Definition of the CompiledHoeffdingTree class, which holds a trained
+ * HoeffdingTree in a flat, contiguous layout that is fast to classify with.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_COMPILED_HOEFFDING_TREE_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_COMPILED_HOEFFDING_TREE_HPP
+
+#include <mlpack/core.hpp>
+#include "numeric_split_info.hpp"
+#include "binary_numeric_split_info.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A read-only version of a trained HoeffdingTree that is optimized for
+ * classification.  A HoeffdingTree stores each node as a separate heap-allocated
+ * object which also holds all of the statistics needed for training, so
+ * classifying a point means chasing pointers through large objects scattered
+ * around memory.  This class instead "compiles" the tree into a single
+ * contiguous array of small nodes, laid out in breadth-first order so that the
+ * children of each node are adjacent.  Each node holds only its split
+ * dimension, the offset of its first child, and the offset of its split points
+ * in a shared array of thresholds.  The direction of a point at a numeric node
+ * is found by counting the thresholds it passes (instead of searching for its
+ * bin), and the direction at a categorical node is the category itself.
+ *
+ * The compiled tree does not change when the original tree is trained further,
+ * so it must be compiled again after any training.  The predictions of the
+ * compiled tree are identical to the predictions of the original tree.
+ *
+ * Numeric splits are supported for HoeffdingNumericSplit and
+ * BinaryNumericSplit (that is, for the NumericSplitInfo and
+ * BinaryNumericSplitInfo split information classes); other numeric split
+ * types can be supported by adding an overload of AddThresholds().
+ *
+ * @code
+ * extern HoeffdingTree<> tree;
+ * extern arma::mat testData;
+ *
+ * CompiledHoeffdingTree compiledTree(tree);
+ * arma::Row<size_t> predictions;
+ * compiledTree.Classify(testData, predictions);
+ * @endcode
+ */
+class CompiledHoeffdingTree
+{
+ public:
+  /**
+   * Create an empty compiled tree.  Compile() must be called before it can be
+   * used for classification.
+   */
+  CompiledHoeffdingTree() { /* Nothing to do. */ }
+
+  /**
+   * Compile the given trained tree.
+   *
+   * @param tree Trained HoeffdingTree to compile.
+   */
+  template<typename TreeType>
+  CompiledHoeffdingTree(const TreeType& tree);
+
+  /**
+   * Compile the given trained tree, replacing anything that was previously
+   * compiled.
+   *
+   * @param tree Trained HoeffdingTree to compile.
+   */
+  template<typename TreeType>
+  void Compile(const TreeType& tree);
+
+  /**
+   * Classify the given point.  The predicted label is returned.
+   *
+   * @param point Point to classify.
+   * @return Predicted label of point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const
+  {
+    return majorityClasses[Leaf(point)];
+  }
+
+  /**
+   * Classify the given point and also return an estimate of the probability
+   * that the prediction is correct, like HoeffdingTree::Classify().
+   *
+   * @param point Point to classify.
+   * @param prediction Predicted label of point.
+   * @param probability An estimate of the probability that the prediction is
+   *      correct.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point, size_t& prediction, double& probability)
+      const
+  {
+    const size_t leaf = Leaf(point);
+    prediction = majorityClasses[leaf];
+    probability = majorityProbabilities[leaf];
+  }
+
+  /**
+   * Classify the given points.  If OpenMP is available, the points are
+   * classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, and also return an estimate of the probability
+   * that the prediction is correct for each point.  If OpenMP is available,
+   * the points are classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   * @param probabilities Probability estimates for each predicted label.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::rowvec& probabilities) const;
+
+  //! Get the number of nodes in the compiled tree.
+  size_t NumNodes() const { return nodes.size(); }
+
+ private:
+  //! The type of split that a node performs.
+  enum SplitType
+  {
+    //! The node is a leaf.
+    LEAF,
+    //! The direction is the number of thresholds the value is greater than.
+    NUMERIC,
+    //! The direction is the number of thresholds the value is not less than.
+    NUMERIC_INCLUSIVE,
+    //! The direction is the category of the value.
+    CATEGORICAL
+  };
+
+  //! A node of the compiled tree.  This is kept as small as possible.
+  struct Node
+  {
+    //! The dimension that this node splits on.
+    size_t splitDimension;
+    //! The index of the first child; the children are stored contiguously.
+    size_t firstChild;
+    //! The index of the first threshold of this node in the thresholds array.
+    size_t firstThreshold;
+    //! The number of thresholds of this node.
+    size_t numThresholds;
+    //! The type of split.
+    SplitType type;
+  };
+
+  //! Return the index of the leaf that the given point falls into.
+  template<typename VecType>
+  size_t Leaf(const VecType& point) const;
+
+  //! Append the split points of a HoeffdingNumericSplit to the thresholds, and
+  //! return the type of the split.
+  template<typename ObservationType>
+  SplitType AddThresholds(const NumericSplitInfo<ObservationType>& splitInfo);
+
+  //! Append the split point of a BinaryNumericSplit to the thresholds, and
+  //! return the type of the split.
+  template<typename ObservationType>
+  SplitType AddThresholds(
+      const BinaryNumericSplitInfo<ObservationType>& splitInfo);
+
+  //! The nodes of the tree, in breadth-first order.
+  std::vector<Node> nodes;
+  //! The split points of all numeric nodes.
+  std::vector<double> thresholds;
+  //! The majority class of each node.
+  arma::Col<size_t> majorityClasses;
+  //! The probability of the majority class of each node.
+  arma::vec majorityProbabilities;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "compiled_hoeffding_tree_impl.hpp"
+
+#endif
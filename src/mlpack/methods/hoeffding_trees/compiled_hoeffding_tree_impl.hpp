@@ -0,0 +1,163 @@
+/**
+ * @file compiled_hoeffding_tree_impl.hpp
+ *
+ * Implementation of the CompiledHoeffdingTree class.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_COMPILED_HOEFFDING_TREE_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_COMPILED_HOEFFDING_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compiled_hoeffding_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+CompiledHoeffdingTree::CompiledHoeffdingTree(const TreeType& tree)
+{
+  Compile(tree);
+}
+
+template<typename TreeType>
+void CompiledHoeffdingTree::Compile(const TreeType& tree)
+{
+  nodes.clear();
+  thresholds.clear();
+
+  // Walk the tree in breadth-first order.  Each node is appended to the queue
+  // when its parent is visited, so the index of a node in the queue is its
+  // index in the compiled tree, and the children of each node are adjacent.
+  std::vector<const TreeType*> queue;
+  queue.push_back(&tree);
+  for (size_t i = 0; i < queue.size(); ++i)
+  {
+    const TreeType& treeNode = *queue[i];
+
+    Node node;
+    node.splitDimension = treeNode.SplitDimension();
+    node.firstChild = queue.size();
+    node.firstThreshold = thresholds.size();
+
+    if (treeNode.NumChildren() == 0)
+    {
+      // The tree may have a split dimension but no children if it was modified
+      // by hand; either way, HoeffdingTree::Classify() treats it as a leaf.
+      node.type = LEAF;
+      node.splitDimension = 0;
+    }
+    else if (treeNode.SplitIsCategorical())
+    {
+      node.type = CATEGORICAL;
+    }
+    else
+    {
+      node.type = AddThresholds(treeNode.NumericSplitInformation());
+    }
+    node.numThresholds = thresholds.size() - node.firstThreshold;
+    nodes.push_back(node);
+
+    for (size_t c = 0; c < treeNode.NumChildren(); ++c)
+      queue.push_back(&treeNode.Child(c));
+  }
+
+  majorityClasses.set_size(nodes.size());
+  majorityProbabilities.set_size(nodes.size());
+  for (size_t i = 0; i < queue.size(); ++i)
+  {
+    majorityClasses[i] = queue[i]->MajorityClass();
+    majorityProbabilities[i] = queue[i]->MajorityProbability();
+  }
+}
+
+template<typename MatType>
+void CompiledHoeffdingTree::Classify(const MatType& data,
+                                     arma::Row<size_t>& predictions) const
+{
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+    predictions[i] = majorityClasses[Leaf(data.col(i))];
+}
+
+template<typename MatType>
+void CompiledHoeffdingTree::Classify(const MatType& data,
+                                     arma::Row<size_t>& predictions,
+                                     arma::rowvec& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+  {
+    const size_t leaf = Leaf(data.col(i));
+    predictions[i] = majorityClasses[leaf];
+    probabilities[i] = majorityProbabilities[leaf];
+  }
+}
+
+template<typename VecType>
+size_t CompiledHoeffdingTree::Leaf(const VecType& point) const
+{
+  size_t index = 0;
+  while (nodes[index].type != LEAF)
+  {
+    const Node& node = nodes[index];
+    const double value = point[node.splitDimension];
+
+    // The thresholds of a node are sorted, so counting the thresholds that the
+    // value passes gives the same bin as searching for it, but without a
+    // data-dependent branch for each threshold.
+    const double* nodeThresholds = thresholds.data() + node.firstThreshold;
+    size_t direction = 0;
+    if (node.type == NUMERIC)
+    {
+      for (size_t k = 0; k < node.numThresholds; ++k)
+        direction += (value > nodeThresholds[k]);
+    }
+    else if (node.type == NUMERIC_INCLUSIVE)
+    {
+      for (size_t k = 0; k < node.numThresholds; ++k)
+        direction += !(value < nodeThresholds[k]);
+    }
+    else
+    {
+      // Like CategoricalSplitInfo, assume the category is in range.
+      direction = size_t(value);
+    }
+
+    index = node.firstChild + direction;
+  }
+
+  return index;
+}
+
+template<typename ObservationType>
+CompiledHoeffdingTree::SplitType CompiledHoeffdingTree::AddThresholds(
+    const NumericSplitInfo<ObservationType>& splitInfo)
+{
+  // NumericSplitInfo::CalculateDirection() returns the number of split points
+  // that the value is greater than.
+  const arma::Col<ObservationType>& splitPoints = splitInfo.SplitPoints();
+  for (size_t i = 0; i < splitPoints.n_elem; ++i)
+    thresholds.push_back(double(splitPoints[i]));
+
+  return NUMERIC;
+}
+
+template<typename ObservationType>
+CompiledHoeffdingTree::SplitType CompiledHoeffdingTree::AddThresholds(
+    const BinaryNumericSplitInfo<ObservationType>& splitInfo)
+{
+  // BinaryNumericSplitInfo::CalculateDirection() returns 1 if the value is not
+  // less than the split point.
+  thresholds.push_back(double(splitInfo.SplitPoint()));
+
+  return NUMERIC_INCLUSIVE;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
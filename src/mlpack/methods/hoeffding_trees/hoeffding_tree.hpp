@@ -164,6 +164,23 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a mini-batch of points in streaming mode, with the given labels.
+   * Instead of passing each point through the tree separately, the whole batch
+   * is routed to the leaves at once, and the split statistics of each leaf are
+   * updated one dimension at a time (in parallel across dimensions, if OpenMP
+   * is available).  Each leaf checks for a split at most once per batch, after
+   * all of its points have been seen; so, unlike calling Train() on each point,
+   * points later in the batch are not passed to children created during the
+   * batch.  With small batches, the resulting tree is very similar to the tree
+   * built by point-by-point training.
+   *
+   * @param data Mini-batch of points to train on.
+   * @param labels Labels of points in the mini-batch.
+   */
+  template<typename MatType>
+  void TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -174,6 +191,23 @@ class HoeffdingTree
   //! Get the splitting dimension (size_t(-1) if no split).
   size_t SplitDimension() const { return splitDimension; }
 
+  //! Return whether or not the splitting dimension is categorical (false if
+  //! no split).
+  bool SplitIsCategorical() const
+  {
+    return (splitDimension != size_t(-1)) &&
+        (datasetInfo->Type(splitDimension) == data::Datatype::categorical);
+  }
+
+  //! Get the information on the split, if the splitting dimension is numeric.
+  const typename NumericSplitType<FitnessFunction>::SplitInfo&
+  NumericSplitInformation() const { return numericSplit; }
+
+  //! Get the information on the split, if the splitting dimension is
+  //! categorical.
+  const typename CategoricalSplitType<FitnessFunction>::SplitInfo&
+  CategoricalSplitInformation() const { return categoricalSplit; }
+
   //! Get the majority class.
   size_t MajorityClass() const { return majorityClass; }
   //! Modify the majority class.
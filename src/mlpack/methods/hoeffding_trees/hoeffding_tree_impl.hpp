@@ -322,6 +322,112 @@ void HoeffdingTree<
   }
 }
 
+//! Train on a mini-batch of points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels)
+{
+  if (data.n_cols == 0)
+    return;
+
+  if (splitDimension == size_t(-1))
+  {
+    const size_t oldNumSamples = numSamples;
+    numSamples += data.n_cols;
+
+    // Find the split object that each dimension belongs to, so that the
+    // dimensions can be handled independently.
+    std::vector<size_t> splitIndices(data.n_rows);
+    size_t numericIndex = 0;
+    size_t categoricalIndex = 0;
+    for (size_t i = 0; i < data.n_rows; ++i)
+    {
+      if (datasetInfo->Type(i) == data::Datatype::categorical)
+        splitIndices[i] = categoricalIndex++;
+      else
+        splitIndices[i] = numericIndex++;
+    }
+
+    // Each dimension has its own split object, so the statistics of different
+    // dimensions can be updated in parallel.  Within each dimension, the points
+    // are still seen in order.
+    #pragma omp parallel for schedule(dynamic) \
+        if (data.n_rows > 1 && data.n_cols >= 64)
+    for (intmax_t d = 0; d < (intmax_t) data.n_rows; ++d)
+    {
+      const size_t i = (size_t) d;
+      if (datasetInfo->Type(i) == data::Datatype::categorical)
+      {
+        CategoricalSplitType<FitnessFunction>& split =
+            categoricalSplits[splitIndices[i]];
+        for (size_t j = 0; j < data.n_cols; ++j)
+          split.Train(data(i, j), labels[j]);
+      }
+      else
+      {
+        NumericSplitType<FitnessFunction>& split =
+            numericSplits[splitIndices[i]];
+        for (size_t j = 0; j < data.n_cols; ++j)
+          split.Train(data(i, j), labels[j]);
+      }
+    }
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split once, if we passed a multiple of the check interval
+    // during this batch.
+    if (numSamples / checkInterval > oldNumSamples / checkInterval)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        children.clear();
+        CreateChildren();
+      }
+    }
+  }
+  else
+  {
+    // Already split.  Find out which points go to which child, like in batch
+    // training, and pass each child its part of the batch.
+    std::vector<arma::uvec> indices(children.size(), arma::uvec(data.n_cols));
+    arma::Col<size_t> counts = arma::zeros<arma::Col<size_t>>(children.size());
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t direction = CalculateDirection(data.col(i));
+      indices[direction][counts[direction]++] = i;
+    }
+
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+      if (counts[i] == 0)
+        continue;
+
+      arma::Row<size_t> childLabels = labels.cols(
+          indices[i].subvec(0, counts[i] - 1));
+      MatType childData = data.cols(indices[i].subvec(0, counts[i] - 1));
+      children[i]->TrainMiniBatch(childData, childLabels);
+    }
+  }
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
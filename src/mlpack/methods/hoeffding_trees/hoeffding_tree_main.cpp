@@ -6,9 +6,9 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
+#include <mlpack/methods/hoeffding_trees/compiled_hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/information_gain.hpp>
-#include <queue>
 
 using namespace std;
 using namespace mlpack;
@@ -69,6 +69,10 @@ PARAM_FLAG("batch_mode", "If true, samples will be considered in batch instead "
 PARAM_FLAG("info_gain", "If set, information gain is used instead of Gini "
     "impurity for calculating Hoeffding bounds.", "i");
 PARAM_INT_IN("passes", "Number of passes to take over the dataset.", "s", 1);
+PARAM_INT_IN("mini_batch_size", "If nonzero, streaming training is performed "
+    "on mini-batches of this many points at a time, which is faster than "
+    "training on one point at a time but checks for splits only once per "
+    "mini-batch.", "S", 0);
 
 PARAM_INT_IN("bins", "If the 'domingos' split strategy is used, this specifies "
     "the number of bins for each numeric split.", "B", 10);
@@ -118,6 +122,15 @@ int main(int argc, char** argv)
     Log::Warn << "--batch_mode (-b) ignored because --passes was specified."
         << endl;
 
+  if (CLI::HasParam("mini_batch_size") && CLI::HasParam("batch_mode"))
+    Log::Warn << "--batch_mode (-b) ignored because --mini_batch_size was "
+        << "specified." << endl;
+
+  if (CLI::GetParam<int>("mini_batch_size") < 0)
+    Log::Fatal << "Invalid mini-batch size (" <<
+        CLI::GetParam<int>("mini_batch_size") << ")!  Must be 0 or greater."
+        << endl;
+
   if (CLI::HasParam("info_gain"))
   {
     if (numericSplitStrategy == "domingos")
@@ -168,6 +181,23 @@ int main(int argc, char** argv)
   }
 }
 
+// Train the tree with one pass over the dataset in mini-batches.
+template<typename TreeType>
+void TrainMiniBatches(TreeType& tree,
+                      const arma::mat& trainingSet,
+                      const arma::Row<size_t>& labels,
+                      const size_t miniBatchSize)
+{
+  for (size_t begin = 0; begin < trainingSet.n_cols; begin += miniBatchSize)
+  {
+    const size_t end = min(begin + miniBatchSize, (size_t) trainingSet.n_cols)
+        - 1;
+    const arma::mat batch = trainingSet.cols(begin, end);
+    const arma::Row<size_t> batchLabels = labels.subvec(begin, end);
+    tree.TrainMiniBatch(batch, batchLabels);
+  }
+}
+
 template<typename TreeType>
 void PerformActions(const typename TreeType::NumericSplit& numericSplit)
 {
@@ -186,7 +216,9 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
       CLI::GetParam<string>("probabilities_file");
   bool batchTraining = CLI::HasParam("batch_mode");
   const size_t passes = (size_t) CLI::GetParam<int>("passes");
-  if (passes > 1)
+  const size_t miniBatchSize =
+      (size_t) CLI::GetParam<int>("mini_batch_size");
+  if (passes > 1 || miniBatchSize > 0)
     batchTraining = false; // We already warned about this earlier.
 
   TreeType* tree = NULL;
@@ -208,12 +240,24 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
     if (passes > 1)
       Log::Info << "Taking " << passes << " passes over the dataset." << endl;
 
-    tree = new TreeType(trainingSet, datasetInfo, labels, max(labels) + 1,
-        batchTraining, confidence, maxSamples, 100, minSamples,
-        typename TreeType::CategoricalSplit(0, 0), numericSplit);
+    if (miniBatchSize > 0)
+    {
+      tree = new TreeType(datasetInfo, max(labels) + 1, confidence,
+          maxSamples, 100, minSamples,
+          typename TreeType::CategoricalSplit(0, 0), numericSplit);
+
+      for (size_t i = 0; i < passes; ++i)
+        TrainMiniBatches(*tree, trainingSet, labels, miniBatchSize);
+    }
+    else
+    {
+      tree = new TreeType(trainingSet, datasetInfo, labels, max(labels) + 1,
+          batchTraining, confidence, maxSamples, 100, minSamples,
+          typename TreeType::CategoricalSplit(0, 0), numericSplit);
 
-    for (size_t i = 1; i < passes; ++i)
-      tree->Train(trainingSet, labels, false);
+      for (size_t i = 1; i < passes; ++i)
+        tree->Train(trainingSet, labels, false);
+    }
     Timer::Stop("tree_training");
   }
   else
@@ -235,7 +279,12 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
 
       // Now create the decision tree.
       Timer::Start("tree_training");
-      if (passes > 1)
+      if (miniBatchSize > 0)
+      {
+        for (size_t i = 0; i < passes; ++i)
+          TrainMiniBatches(*tree, trainingSet, labels, miniBatchSize);
+      }
+      else if (passes > 1)
       {
         Log::Info << "Taking " << passes << " passes over the dataset." << endl;
         for (size_t i = 0; i < passes; ++i)
@@ -249,13 +298,18 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
     }
   }
 
+  // Flatten the tree so that classification is faster.
+  Timer::Start("tree_compilation");
+  CompiledHoeffdingTree compiledTree(*tree);
+  Timer::Stop("tree_compilation");
+
   if (CLI::HasParam("training_file"))
   {
     // Get training error.
     arma::mat trainingSet;
     data::Load(trainingFile, trainingSet, datasetInfo, true);
     arma::Row<size_t> predictions;
-    tree->Classify(trainingSet, predictions);
+    compiledTree.Classify(trainingSet, predictions);
 
     arma::Col<size_t> labelsIn;
     data::Load(labelsFile, labelsIn, true, false);
@@ -271,20 +325,7 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
         100.0 << ")." << endl;
   }
 
-  // Get the number of nods in the tree.
-  std::queue<TreeType*> queue;
-  queue.push(tree);
-  size_t nodes = 0;
-  while (!queue.empty())
-  {
-    TreeType* node = queue.front();
-    queue.pop();
-    ++nodes;
-
-    for (size_t i = 0; i < node->NumChildren(); ++i)
-      queue.push(&node->Child(i));
-  }
-  Log::Info << nodes << " nodes in the tree." << endl;
+  Log::Info << compiledTree.NumNodes() << " nodes in the tree." << endl;
 
   // The tree is trained or loaded.  Now do any testing if we need.
   if (CLI::HasParam("test_file"))
@@ -296,7 +337,7 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
     arma::rowvec probabilities;
 
     Timer::Start("tree_testing");
-    tree->Classify(testSet, predictions, probabilities);
+    compiledTree.Classify(testSet, predictions, probabilities);
     Timer::Stop("tree_testing");
 
     if (CLI::HasParam("test_labels_file"))
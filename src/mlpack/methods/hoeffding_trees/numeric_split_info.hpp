@@ -31,6 +31,9 @@ class NumericSplitInfo
     return bin;
   }
 
+  //! Get the split points (sorted in ascending order).
+  const arma::Col<ObservationType>& SplitPoints() const { return splitPoints; }
+
   //! Serialize the split (save/load the split points).
   template<typename Archive>
   void Serialize(Archive& ar, const unsigned int /* version */)
@@ -99,6 +99,27 @@ class LogisticRegressionFunction
                 const size_t i,
                 arma::mat& gradient) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with respect to only one point in the dataset, as a sparse vector.  Only
+   * the intercept and the dimensions in which the point is nonzero have a
+   * nonzero gradient, so for sparse data this takes time proportional to the
+   * number of nonzeros of the point instead of the dimensionality.  This is
+   * used by optimizers such as Hogwild, which apply sparse updates.
+   *
+   * To keep the gradient sparse, the L2-regularization of each dimension is
+   * only applied by the points that are nonzero in that dimension, and it is
+   * scaled by the number of those points, so that the sum of the gradients of
+   * all points is still the full gradient.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param i Index of points to use for objective function gradient evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::sp_mat& gradient) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
@@ -114,6 +135,13 @@ class LogisticRegressionFunction
   const arma::Row<size_t>& responses;
   //! The regularization parameter for L2-regularization.
   double lambda;
+  //! The number of points that are nonzero in each dimension.
+  arma::vec nonzeroCounts;
+
+  //! Count the points that are nonzero in each dimension of dense predictors.
+  void CountNonzeros(const arma::mat& predictors);
+  //! Count the points that are nonzero in each dimension of sparse predictors.
+  void CountNonzeros(const arma::sp_mat& predictors);
 };
 
 } // namespace regression
@@ -23,6 +23,7 @@ LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
     lambda(lambda)
 {
   initialPoint = arma::zeros<arma::mat>(predictors.n_rows + 1, 1);
+  CountNonzeros(predictors);
 
   // Sanity check.
   if (responses.n_elem != predictors.n_cols)
@@ -47,6 +48,8 @@ LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
   if (initialPoint.n_rows != (predictors.n_rows + 1) ||
       initialPoint.n_cols != 1)
     this->initialPoint = arma::zeros<arma::mat>(predictors.n_rows + 1, 1);
+
+  CountNonzeros(predictors);
 }
 
 /**
@@ -165,6 +168,68 @@ void LogisticRegressionFunction<MatType>::Gradient(
       * (responses[i] - sigmoid) + regularization;
 }
 
+/**
+ * Evaluate the gradient of the logistic regression objective function with
+ * respect to an individual point, as a sparse vector.  This is useful for
+ * optimizers that apply sparse updates, such as Hogwild.
+ */
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t i,
+    arma::sp_mat& gradient) const
+{
+  const arma::sp_vec point(predictors.col(i));
+
+  double exponent = parameters(0, 0);
+  for (arma::sp_vec::const_iterator it = point.begin(); it != point.end(); ++it)
+    exponent += (*it) * parameters(it.row() + 1, 0);
+
+  const double error = responses[i] - 1.0 / (1.0 + std::exp(-exponent));
+
+  // The intercept comes first, then the nonzero dimensions of the point (which
+  // are shifted by one because of the intercept), so the locations are sorted.
+  arma::umat locations(2, point.n_nonzero + 1);
+  arma::vec values(point.n_nonzero + 1);
+  locations(0, 0) = 0;
+  locations(1, 0) = 0;
+  values[0] = -error;
+
+  size_t j = 1;
+  for (arma::sp_vec::const_iterator it = point.begin(); it != point.end();
+      ++it, ++j)
+  {
+    const size_t row = it.row() + 1;
+    locations(0, j) = row;
+    locations(1, j) = 0;
+    values[j] = -(*it) * error + lambda * parameters(row, 0) /
+        nonzeroCounts[it.row()];
+  }
+
+  gradient = arma::sp_mat(locations, values, parameters.n_elem, 1, false);
+}
+
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::CountNonzeros(
+    const arma::mat& predictors)
+{
+  nonzeroCounts.zeros(predictors.n_rows);
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    for (size_t d = 0; d < predictors.n_rows; ++d)
+      if (predictors(d, i) != 0)
+        ++nonzeroCounts[d];
+}
+
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::CountNonzeros(
+    const arma::sp_mat& predictors)
+{
+  nonzeroCounts.zeros(predictors.n_rows);
+  for (arma::sp_mat::const_iterator it = predictors.begin();
+      it != predictors.end(); ++it)
+    ++nonzeroCounts[it.row()];
+}
+
 } // namespace regression
 } // namespace mlpack
 
@@ -16,7 +16,7 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::vec& values,
                                    const size_t r) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
+    sdp(0, 0, arma::randu<arma::mat>(m + n, r))
 {
   CheckValues();
   InitSDP();
@@ -28,7 +28,7 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::vec& values,
                                    const arma::mat& initialPoint) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, initialPoint)
+    sdp(0, 0, initialPoint)
 {
   CheckValues();
   InitSDP();
@@ -39,7 +39,7 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::umat& indices,
                                    const arma::vec& values) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0,
+    sdp(0, 0,
         arma::randu<arma::mat>(m + n, DefaultRank(m, n, indices.n_cols)))
 {
   CheckValues();
@@ -70,21 +70,29 @@ void MatrixCompletion::InitSDP()
 {
   sdp.SDP().C().eye(m + n, m + n);
   sdp.SDP().SparseB() = 2. * values;
+
+  // Each constraint only has two entries, so we give the entries directly
+  // instead of storing one (m + n) x (m + n) sparse matrix per constraint.
   const size_t p = indices.n_cols;
+  arma::umat locations(3, 2 * p);
   for (size_t i = 0; i < p; i++)
   {
-    sdp.SDP().SparseA()[i].zeros(m + n, m + n);
-    sdp.SDP().SparseA()[i](indices(0, i), m + indices(1, i)) = 1.;
-    sdp.SDP().SparseA()[i](m + indices(1, i), indices(0, i)) = 1.;
+    locations(0, 2 * i) = i;
+    locations(1, 2 * i) = indices(0, i);
+    locations(2, 2 * i) = m + indices(1, i);
+    locations(0, 2 * i + 1) = i;
+    locations(1, 2 * i + 1) = m + indices(1, i);
+    locations(2, 2 * i + 1) = indices(0, i);
   }
+  sdp.Function().SparseConstraints(locations, arma::ones<arma::vec>(2 * p));
 }
 
 void MatrixCompletion::Recover(arma::mat& recovered)
 {
   recovered = sdp.Function().GetInitialPoint();
   sdp.Optimize(recovered);
-  recovered = recovered * trans(recovered);
-  recovered = recovered(arma::span(0, m - 1), arma::span(m, m + n - 1));
+  // Only the upper right block of R R^T is needed.
+  recovered = recovered.rows(0, m - 1) * trans(recovered.rows(m, m + n - 1));
 }
 
 size_t MatrixCompletion::DefaultRank(const size_t m,
@@ -79,6 +79,12 @@ class NaiveBayesClassifier
    * algorithm is used, the current model is used as a starting point (this is
    * the default).  If the incremental algorithm is not used, then the current
    * model is ignored and the new model will be trained only on the given data.
+   *
+   * With the incremental algorithm, the count, mean, and sum of squared
+   * deviations of each class are computed for the new data (in parallel, if
+   * OpenMP is available), and these statistics are then merged into the
+   * current model.  This gives the same model as calling Train() on each
+   * point individually, but is much faster.
    * Note that even if the incremental algorithm is not used, the data must have
    * the same dimensionality and number of classes that the model was
    * initialized with.  If you want to change the dimensionality or number of
@@ -115,10 +121,31 @@ class NaiveBayesClassifier
    * nbc.Classify(test_data, &results);
    * @endcode
    *
+   * The log-likelihoods are computed for blocks of points at once: for each
+   * class, the block is centered on the class mean, and the squared deviations
+   * are weighted by the inverse variances with one matrix-vector product.  The
+   * inverse variances and normalizing constants are computed once per call.
+   * If OpenMP is available, blocks are classified in parallel.
+   *
    * @param data List of data points.
    * @param results Vector that class predictions will be placed into.
    */
-  void Classify(const MatType& data, arma::Row<size_t>& results);
+  void Classify(const MatType& data, arma::Row<size_t>& results) const;
+
+  /**
+   * Given a bunch of data points, this function evaluates the class of each of
+   * those data points, and puts it in the vector 'predictions'.  The posterior
+   * probability of each class for each point is stored in 'probabilities';
+   * column i holds the probabilities for point i, and row j corresponds to
+   * class j.
+   *
+   * @param data List of data points.
+   * @param predictions Vector that class predictions will be placed into.
+   * @param probabilities Matrix that class probabilities will be placed into.
+   */
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
 
   //! Get the sample means for each class.
   const MatType& Means() const { return means; }
@@ -140,6 +167,26 @@ class NaiveBayesClassifier
   void Serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Classify the given points, storing the posterior probabilities of each
+   * class in the given matrix, if it is not NULL.
+   */
+  void ClassifyInternal(const MatType& data,
+                        arma::Row<size_t>& predictions,
+                        arma::mat* predictionProbabilities) const;
+
+  /**
+   * Merge the sufficient statistics of a second set of points into the given
+   * statistics: the number of points in each class, their mean, and the sum of
+   * their squared deviations from the mean.
+   */
+  static void MergeStatistics(arma::vec& counts,
+                              MatType& sampleMeans,
+                              MatType& squaredDeviations,
+                              const arma::vec& otherCounts,
+                              const MatType& otherMeans,
+                              const MatType& otherSquaredDeviations);
+
   //! Sample mean for each class.
   MatType means;
   //! Sample variances for each class.
@@ -67,25 +67,67 @@ void NaiveBayesClassifier<MatType>::Train(const MatType& data,
   // for each of the features with respect to each of the labels.
   if (incremental)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
-
-    for (size_t j = 0; j < data.n_cols; ++j)
+    // Use incremental algorithm.  First, compute the sufficient statistics of
+    // each class for the new data with Welford's algorithm; each thread handles
+    // a part of the data, and the results are merged afterwards.
+    const size_t dimensionality = data.n_rows;
+    const size_t classes = means.n_cols;
+    arma::vec newCounts(classes, arma::fill::zeros);
+    MatType newMeans(dimensionality, classes, arma::fill::zeros);
+    MatType newSquaredDeviations(dimensionality, classes, arma::fill::zeros);
+
+    #pragma omp parallel
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
+      arma::vec localCounts(classes, arma::fill::zeros);
+      MatType localMeans(dimensionality, classes, arma::fill::zeros);
+      MatType localSquaredDeviations(dimensionality, classes,
+          arma::fill::zeros);
+
+      #pragma omp for schedule(static)
+      for (intmax_t j = 0; j < (intmax_t) data.n_cols; ++j)
+      {
+        const size_t label = labels[j];
+        const double count = ++localCounts[label];
+        for (size_t i = 0; i < dimensionality; ++i)
+        {
+          const double delta = data(i, j) - localMeans(i, label);
+          localMeans(i, label) += delta / count;
+          localSquaredDeviations(i, label) += delta * (data(i, j) -
+              localMeans(i, label));
+        }
+      }
+
+      #pragma omp critical
+      {
+        MergeStatistics(newCounts, newMeans, newSquaredDeviations, localCounts,
+            localMeans, localSquaredDeviations);
+      }
+    }
 
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+    // Now, de-normalize the current model, and merge the new statistics into
+    // it.
+    arma::vec counts = probabilities * trainingPoints;
+    MatType squaredDeviations = variances;
+    for (size_t i = 0; i < classes; ++i)
+    {
+      if (counts[i] > 1)
+        squaredDeviations.col(i) *= (counts[i] - 1);
+      else
+        squaredDeviations.col(i).zeros();
     }
 
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
+    MergeStatistics(counts, means, squaredDeviations, newCounts, newMeans,
+        newSquaredDeviations);
+
+    variances = squaredDeviations;
+    for (size_t i = 0; i < classes; ++i)
     {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      if (counts[i] > 1)
+        variances.col(i) /= (counts[i] - 1);
     }
+
+    probabilities = counts;
+    trainingPoints += data.n_cols;
   }
   else
   {
@@ -124,6 +166,8 @@ void NaiveBayesClassifier<MatType>::Train(const MatType& data,
     for (size_t i = 0; i < probabilities.n_elem; ++i)
       if (probabilities[i] > 1)
         variances.col(i) /= (probabilities[i] - 1);
+
+    trainingPoints = data.n_cols;
   }
 
   // Ensure that the variances are invertible.
@@ -131,8 +175,7 @@ void NaiveBayesClassifier<MatType>::Train(const MatType& data,
     if (variances[i] == 0.0)
       variances[i] = 1e-50;
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+  probabilities /= trainingPoints;
 }
 
 template<typename MatType>
@@ -158,54 +201,135 @@ void NaiveBayesClassifier<MatType>::Train(const VecType& point,
 
 template<typename MatType>
 void NaiveBayesClassifier<MatType>::Classify(const MatType& data,
-                                             arma::Row<size_t>& results)
+                                             arma::Row<size_t>& results) const
+{
+  ClassifyInternal(data, results, NULL);
+}
+
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& predictionProbabilities) const
+{
+  ClassifyInternal(data, predictions, &predictionProbabilities);
+}
+
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::ClassifyInternal(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat* predictionProbabilities) const
 {
   // Check that the number of features in the test data is same as in the
   // training data.
   Log::Assert(data.n_rows == means.n_rows);
 
-  arma::vec probs = arma::log(probabilities);
-  arma::mat invVar = 1.0 / variances;
-
-  arma::mat testProbs = arma::repmat(probs.t(), data.n_cols, 1);
-
-  results.set_size(data.n_cols); // No need to fill with anything yet.
-
   Log::Info << "Running Naive Bayes classifier on " << data.n_cols
       << " data points with " << data.n_rows << " features each." << std::endl;
 
-  // Calculate the joint probability for each of the data points for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  // Number of points classified at once.  This is large enough that the
+  // products below work on many points at once, but small enough that the
+  // temporaries stay in cache.
+  const size_t blockSize = 1024;
+  const size_t blocks = (data.n_cols + blockSize - 1) / blockSize;
+  const size_t classes = means.n_cols;
+
+  // For each class, the log-likelihood of a point x is (with the variances on
+  // the diagonal of a covariance matrix)
+  //   log P(Y = y) - (d / 2) log(2 pi) - (1 / 2) sum_i log(var_i)
+  //       - (1 / 2) sum_i (x_i - mu_i)^2 / var_i.
+  // Everything that does not depend on x is computed once here.  The last
+  // term is computed in this centered form: expanding it into products of x
+  // and mu would lose all precision when a variance is tiny (zero variances
+  // are replaced by 1e-50), while the centered form is exactly zero when
+  // x_i == mu_i.
+  const arma::mat invVar = 1.0 / variances;
+  const arma::vec logConstants = arma::log(probabilities) -
+      0.5 * data.n_rows * std::log(2 * M_PI) -
+      0.5 * arma::trans(arma::sum(arma::log(variances), 0));
+
+  predictions.set_size(data.n_cols); // No need to fill with anything yet.
+  if (predictionProbabilities != NULL)
+    predictionProbabilities->set_size(classes, data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t block = 0; block < (intmax_t) blocks; ++block)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    arma::mat diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    arma::mat rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::vec exponents(diffs.n_cols);
-    for (size_t j = 0; j < diffs.n_cols; ++j) // log(exp(value)) == value
-      exponents(j) = arma::accu(diffs.col(j) % rhs.unsafe_col(j));
-
-    // Calculate probability as sum of logarithm to decrease floating point
-    // errors.
-    testProbs.col(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
+    const size_t begin = block * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+
+    const arma::mat points = data.cols(begin, end);
+    arma::mat logLikelihoods(classes, points.n_cols);
+    arma::mat centeredPoints;
+    for (size_t c = 0; c < classes; ++c)
+    {
+      centeredPoints = points;
+      centeredPoints.each_col() -= means.col(c);
+      logLikelihoods.row(c) = logConstants[c] - 0.5 *
+          (arma::trans(invVar.col(c)) * arma::square(centeredPoints));
+    }
+
+    for (size_t i = 0; i < logLikelihoods.n_cols; ++i)
+    {
+      // Find the index of the class with maximum probability for this point.
+      const double* col = logLikelihoods.colptr(i);
+      size_t maxIndex = 0;
+      for (size_t j = 1; j < classes; ++j)
+        if (col[j] > col[maxIndex])
+          maxIndex = j;
+
+      predictions[begin + i] = maxIndex;
+
+      if (predictionProbabilities != NULL)
+      {
+        // Normalize with the log-sum-exp trick to get the posterior
+        // probabilities.
+        double* probs = predictionProbabilities->colptr(begin + i);
+        double sum = 0.0;
+        for (size_t j = 0; j < classes; ++j)
+        {
+          probs[j] = std::exp(col[j] - col[maxIndex]);
+          sum += probs[j];
+        }
+
+        for (size_t j = 0; j < classes; ++j)
+          probs[j] /= sum;
+      }
+    }
   }
+}
 
-  // Now calculate the label.
-  for (size_t i = 0; i < data.n_cols; ++i)
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::MergeStatistics(
+    arma::vec& counts,
+    MatType& sampleMeans,
+    MatType& squaredDeviations,
+    const arma::vec& otherCounts,
+    const MatType& otherMeans,
+    const MatType& otherSquaredDeviations)
+{
+  // This is the pairwise update of Chan, Golub, and LeVeque.
+  for (size_t i = 0; i < counts.n_elem; ++i)
   {
-    // Find the index of the class with maximum probability for this point.
-    arma::uword maxIndex = 0;
-    arma::vec pointProbs = testProbs.row(i).t();
-    pointProbs.max(maxIndex);
+    if (otherCounts[i] == 0)
+      continue;
 
-    results[i] = maxIndex;
-  }
+    if (counts[i] == 0)
+    {
+      counts[i] = otherCounts[i];
+      sampleMeans.col(i) = otherMeans.col(i);
+      squaredDeviations.col(i) = otherSquaredDeviations.col(i);
+      continue;
+    }
 
-  return;
+    const double total = counts[i] + otherCounts[i];
+    const arma::vec delta = otherMeans.col(i) - sampleMeans.col(i);
+    sampleMeans.col(i) += (otherCounts[i] / total) * delta;
+    squaredDeviations.col(i) += otherSquaredDeviations.col(i) +
+        (counts[i] * otherCounts[i] / total) * arma::square(delta);
+    counts[i] = total;
+  }
 }
 
 template<typename MatType>
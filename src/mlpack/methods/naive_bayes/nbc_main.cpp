@@ -27,9 +27,12 @@ PROGRAM_INFO("Parametric Naive Bayes Classifier",
     "\n\n"
     "If classifying a test set is desired, the test set should be in the file "
     "specified with the --test_file (-T) option, and the classifications will "
-    "be saved to the file specified with the --output_file (-o) option.  If "
-    "saving a trained model is desired, the --output_model_file (-M) option "
-    "should be given.");
+    "be saved to the file specified with the --output_file (-o) option.  The "
+    "posterior probabilities of each class for each test point can be saved "
+    "with the --output_probs_file (-p) option; row i of that file corresponds "
+    "to the i'th class, in sorted order of the training labels.  If saving a "
+    "trained model is desired, the --output_model_file (-M) option should be "
+    "given.");
 
 // Model loading/saving.
 PARAM_STRING_IN("input_model_file", "File containing input Naive Bayes model.",
@@ -49,6 +52,8 @@ PARAM_FLAG("incremental_variance", "The variance of each class will be "
 PARAM_STRING_IN("test_file", "A file containing the test set.", "T", "");
 PARAM_STRING_OUT("output_file", "The file in which the predicted labels for the"
     " test set will be written.", "o");
+PARAM_STRING_OUT("output_probs_file", "The file in which the predicted "
+    "probabilities of each class for the test set will be written.", "p");
 
 using namespace mlpack;
 using namespace mlpack::naive_bayes;
@@ -92,17 +97,25 @@ int main(int argc, char* argv[])
     Log::Warn << "--incremental_variance (-I) ignored because --training_file "
         << "(-t) is not specified." << endl;
 
-  if (!CLI::HasParam("output_file") && !CLI::HasParam("output_model_file"))
-    Log::Warn << "Neither --output_file (-o) nor --output_model_file (-M) "
-        << "specified; no output will be saved!" << endl;
+  if (!CLI::HasParam("output_file") && !CLI::HasParam("output_model_file") &&
+      !CLI::HasParam("output_probs_file"))
+    Log::Warn << "Neither --output_file (-o), --output_probs_file (-p), nor "
+        << "--output_model_file (-M) specified; no output will be saved!"
+        << endl;
 
   if (CLI::HasParam("output_file") && !CLI::HasParam("test_file"))
     Log::Warn << "--output_file (-o) ignored because no test file specified "
         << "with --test_file (-T)." << endl;
 
-  if (!CLI::HasParam("output_file") && CLI::HasParam("test_file"))
+  if (CLI::HasParam("output_probs_file") && !CLI::HasParam("test_file"))
+    Log::Warn << "--output_probs_file (-p) ignored because no test file "
+        << "specified with --test_file (-T)." << endl;
+
+  if (!CLI::HasParam("output_file") && !CLI::HasParam("output_probs_file") &&
+      CLI::HasParam("test_file"))
     Log::Warn << "--test_file (-T) specified, but classification results will "
-        << "not be saved because --output_file (-o) is not specified." << endl;
+        << "not be saved because neither --output_file (-o) nor "
+        << "--output_probs_file (-p) is specified." << endl;
 
   // Either we have to train a model, or load a model.
   NBCModel model;
@@ -166,8 +179,12 @@ int main(int argc, char* argv[])
 
     // Time the running of the Naive Bayes Classifier.
     Row<size_t> results;
+    mat probabilities;
     Timer::Start("nbc_testing");
-    model.nbc.Classify(testingData, results);
+    if (CLI::HasParam("output_probs_file"))
+      model.nbc.Classify(testingData, results, probabilities);
+    else
+      model.nbc.Classify(testingData, results);
     Timer::Stop("nbc_testing");
 
     if (CLI::HasParam("output_file"))
@@ -180,6 +197,19 @@ int main(int argc, char* argv[])
       const string outputFilename = CLI::GetParam<string>("output_file");
       data::Save(outputFilename, rawResults, true);
     }
+
+    if (CLI::HasParam("output_probs_file"))
+    {
+      // The classes are numbered in the order in which their labels first
+      // appeared in the training set, so sort the rows by label.
+      const uvec order = sort_index(model.mappings);
+      mat sortedProbabilities(probabilities.n_rows, probabilities.n_cols);
+      for (size_t i = 0; i < order.n_elem; ++i)
+        sortedProbabilities.row(i) = probabilities.row(order[i]);
+
+      data::Save(CLI::GetParam<string>("output_probs_file"),
+          sortedProbabilities, true);
+    }
   }
 
   if (CLI::HasParam("output_model_file"))
@@ -119,7 +119,8 @@ class SoftmaxErrorFunction
 
   //! Last coordinates.  Used for the non-separable Evaluate() and Gradient().
   arma::mat lastCoordinates;
-  //! Stretched dataset.  Kept internal to avoid memory reallocations.
+  //! Stretched dataset, for the non-separable Evaluate() and Gradient().  Kept
+  //! internal to avoid memory reallocations.
   arma::mat stretchedDataset;
   //! Holds calculated p_i, for the non-separable Evaluate() and Gradient().
   arma::vec p;
@@ -46,8 +46,10 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
   double denominator = 0;
   double numerator = 0;
 
-  // It's quicker to do this now than one point at a time later.
-  stretchedDataset = coordinates * dataset;
+  // It's quicker to do this now than one point at a time later.  The stretched
+  // dataset is kept local so that the separable functions can be evaluated by
+  // several threads at once.
+  const arma::mat stretchedDataset = coordinates * dataset;
 
   for (size_t k = 0; k < dataset.n_cols; ++k)
   {
@@ -145,8 +147,8 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
   secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
 
-  // Compute the stretched dataset.
-  stretchedDataset = coordinates * dataset;
+  // Compute the stretched dataset (locally, as in the separable Evaluate()).
+  const arma::mat stretchedDataset = coordinates * dataset;
 
   for (size_t k = 0; k < dataset.n_cols; ++k)
   {
@@ -0,0 +1,307 @@
+/**
+ * @file incremental_svd_method.hpp
+ *
+ * Implementation of the incremental svd method for use in the Principal
+ * Components Analysis method.  The data is processed block by block, so it
+ * does not have to fit in memory.
+ */
+
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental SVD policy.  The mean of the data and a
+ * (possibly truncated) SVD of the centered data are updated with each new block
+ * of points, as in Brand's incremental SVD extended with a mean update:
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title={Incremental learning for robust visual tracking},
+ *   author={Ross, David A. and Lim, Jongwoo and Lin, Ruei-Sung and Yang,
+ *       Ming-Hsuan},
+ *   journal={International Journal of Computer Vision},
+ *   volume={77},
+ *   number={1--3},
+ *   pages={125--141},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each update only needs the current components and the new block, so its
+ * memory use is independent of the number of points seen so far.  If no rank
+ * is given, nothing is truncated and the result equals the exact SVD.
+ *
+ * Besides being used by PCAType, the policy can be fit on a stream of blocks
+ * with Update(); Apply() then projects new points onto the principal
+ * components without recomputing them:
+ *
+ * @code
+ * IncrementalSVDPolicy decomposition(10); // Keep 10 components.
+ * arma::mat block;
+ * while (... next block ...)
+ *   decomposition.Update(block);
+ *
+ * arma::mat transformed;
+ * decomposition.Apply(newPoints, transformed);
+ * @endcode
+ */
+class IncrementalSVDPolicy
+{
+  public:
+  /**
+   * Use the incremental SVD method to perform the principal components
+   * analysis (PCA).
+   *
+   * @param rank Number of components to keep after each update; 0 keeps all
+   *        of them.
+   * @param blockSize Number of points to process at once when the policy is
+   *        used with PCAType.
+   */
+  IncrementalSVDPolicy(const size_t rank = 0,
+                       const size_t blockSize = 1000) :
+      rank(rank),
+      blockSize(blockSize),
+      numPoints(0),
+      scatter(0)
+  {
+    if (blockSize == 0)
+    {
+      Log::Fatal << "IncrementalSVDPolicy::IncrementalSVDPolicy(): block size "
+          << "must be greater than 0!" << std::endl;
+    }
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * incremental SVD.  The centered data is processed in blocks of BlockSize()
+   * points; any previous state of the policy is discarded.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition (unused; see Rank()).
+   */
+  void Apply(const arma::mat& /* data */,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t /* rank */)
+  {
+    Reset();
+    for (size_t begin = 0; begin < centeredData.n_cols; begin += blockSize)
+    {
+      const size_t points = std::min(blockSize,
+          (size_t) centeredData.n_cols - begin);
+      const arma::mat block(const_cast<double*>(centeredData.colptr(begin)),
+          centeredData.n_rows, points, false, true);
+      Update(block);
+    }
+
+    eigvec = components;
+    eigVal = EigenValues();
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Project the given points onto the principal components that have been
+   * computed so far, after subtracting the mean of the data seen so far.
+   *
+   * @param data Points to transform.
+   * @param transformedData Matrix to store the transformed points in.
+   */
+  void Apply(const arma::mat& data, arma::mat& transformedData) const
+  {
+    if (data.n_rows != mean.n_elem)
+    {
+      Log::Fatal << "IncrementalSVDPolicy::Apply(): data has " << data.n_rows
+          << " dimensions, but the decomposition has " << mean.n_elem << "!"
+          << std::endl;
+    }
+
+    transformedData = arma::trans(components) * data;
+    transformedData.each_col() -= arma::trans(components) * mean;
+  }
+
+  /**
+   * Update the mean and the decomposition with a new block of points.
+   *
+   * @param block Points to add to the decomposition.
+   */
+  void Update(const arma::mat& block)
+  {
+    if (block.n_cols == 0)
+      return;
+
+    if (numPoints > 0 && block.n_rows != mean.n_elem)
+    {
+      Log::Fatal << "IncrementalSVDPolicy::Update(): block has " << block.n_rows
+          << " dimensions, but the previous points had " << mean.n_elem << "!"
+          << std::endl;
+    }
+
+    const arma::vec blockMean = arma::mean(block, 1);
+    arma::mat centeredBlock = block;
+    centeredBlock.each_col() -= blockMean;
+
+    if (numPoints == 0)
+    {
+      arma::mat v;
+      arma::svd_econ(components, singularValues, v, centeredBlock, 'l');
+
+      mean = blockMean;
+      numPoints = block.n_cols;
+      scatter = arma::accu(arma::square(centeredBlock));
+      Truncate();
+      return;
+    }
+
+    // The shift of the mean is added to the block as an extra point, which
+    // accounts for the change of the mean of the old points.
+    const double n = numPoints;
+    const double m = block.n_cols;
+    centeredBlock.insert_cols(block.n_cols,
+        std::sqrt(n * m / (n + m)) * (blockMean - mean));
+
+    mean += (m / (n + m)) * (blockMean - mean);
+    numPoints += block.n_cols;
+    scatter += arma::accu(arma::square(centeredBlock));
+
+    // Split the block into its projection onto the current components and the
+    // orthogonal residual R = Q * T.  Then
+    //
+    //   [U * diag(S), block] = [U, Q] * [diag(S), U^T * block]
+    //                                   [   0,         T     ]
+    //
+    // and we only need the SVD of the small matrix on the right.
+    const size_t k = singularValues.n_elem;
+    const arma::mat projection = arma::trans(components) * centeredBlock;
+
+    arma::mat middle;
+    arma::mat basis;
+    if (k < components.n_rows)
+    {
+      // Project twice, so that the residual is orthogonal to the components
+      // to machine precision.
+      arma::mat residual = centeredBlock - components * projection;
+      residual -= components * (arma::trans(components) * residual);
+
+      arma::mat q, t;
+      arma::qr_econ(q, t, residual);
+
+      middle.zeros(k + q.n_cols, k + centeredBlock.n_cols);
+      middle.submat(k, k, middle.n_rows - 1, middle.n_cols - 1) = t;
+      basis = arma::join_rows(components, q);
+    }
+    else
+    {
+      // The components already span the whole space.
+      middle.zeros(k, k + centeredBlock.n_cols);
+      basis = components;
+    }
+
+    middle.submat(0, 0, k - 1, k - 1) = arma::diagmat(singularValues);
+    middle.submat(0, k, k - 1, middle.n_cols - 1) = projection;
+
+    arma::mat u, v;
+    arma::svd_econ(u, singularValues, v, middle, 'l');
+    components = basis * u;
+    Truncate();
+  }
+
+  //! Discard all points that have been seen so far.
+  void Reset()
+  {
+    components.reset();
+    singularValues.reset();
+    mean.reset();
+    numPoints = 0;
+    scatter = 0;
+  }
+
+  //! Get the eigenvalues of the covariance matrix (the variance along each
+  //! principal component).  These are zero if at most one point was seen.
+  arma::vec EigenValues() const
+  {
+    if (numPoints <= 1)
+      return arma::zeros<arma::vec>(singularValues.n_elem);
+
+    return arma::square(singularValues) / (numPoints - 1);
+  }
+
+  //! Get the total variance of the points seen so far, including the variance
+  //! along components that were truncated.  This is zero if at most one point
+  //! was seen.
+  double TotalVariance() const
+  {
+    return (numPoints <= 1) ? 0.0 : scatter / (numPoints - 1);
+  }
+
+  //! Get the principal components (one per column).
+  const arma::mat& Components() const { return components; }
+  //! Get the singular values of the centered data.
+  const arma::vec& SingularValues() const { return singularValues; }
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the number of components to keep (0 keeps all).
+  size_t Rank() const { return rank; }
+  //! Modify the number of components to keep (0 keeps all).
+  size_t& Rank() { return rank; }
+
+  //! Get the number of points processed at once by PCAType.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points processed at once by PCAType.
+  size_t& BlockSize() { return blockSize; }
+
+  private:
+    //! Drop the components with the smallest singular values.
+    void Truncate()
+    {
+      size_t keep = std::min(singularValues.n_elem, components.n_rows);
+      if (rank != 0)
+        keep = std::min(keep, rank);
+
+      if (keep < components.n_cols)
+        components.shed_cols(keep, components.n_cols - 1);
+      if (keep < singularValues.n_elem)
+        singularValues.shed_rows(keep, singularValues.n_elem - 1);
+    }
+
+    //! Locally stored number of components to keep.
+    size_t rank;
+
+    //! Locally stored number of points to process at once.
+    size_t blockSize;
+
+    //! The principal components.
+    arma::mat components;
+
+    //! The singular values of the centered data.
+    arma::vec singularValues;
+
+    //! The mean of the points seen so far.
+    arma::vec mean;
+
+    //! The number of points seen so far.
+    size_t numPoints;
+
+    //! The sum of the squared distances of the points to their mean.
+    double scatter;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -7,8 +7,12 @@
  */
 #include <mlpack/core.hpp>
 
+#include <fstream>
+#include <sstream>
+
 #include "pca.hpp"
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 
@@ -18,10 +22,14 @@ using namespace std;
 
 // Document program.
 PROGRAM_INFO("Principal Components Analysis", "This program performs principal "
-    "components analysis on the given dataset using the exact, randomized or "
-    "QUIC SVD method. It will transform the data onto its principal components,"
-    " optionally performing dimensionality reduction by ignoring the principal "
-    "components with the smallest eigenvalues.");
+    "components analysis on the given dataset using the exact, randomized, "
+    "QUIC or incremental SVD method. It will transform the data onto its "
+    "principal components, optionally performing dimensionality reduction by "
+    "ignoring the principal components with the smallest eigenvalues."
+    "\n\n"
+    "The incremental method does not load the dataset into memory; instead, the "
+    "input file (a text file with one point per line) is streamed in blocks of "
+    "--block_size points, and the output file is written block by block.");
 
 // Parameters for program.
 PARAM_STRING_IN_REQ("input_file", "Input dataset to perform PCA on.", "i");
@@ -35,7 +43,10 @@ PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
     "that the variance of each feature is 1.", "s");
 
 PARAM_STRING_IN("decomposition_method", "Method used for the principal"
-    "components analysis: 'exact', 'randomized', 'quic'.", "c", "exact");
+    "components analysis: 'exact', 'randomized', 'quic', 'incremental'.", "c",
+    "exact");
+PARAM_INT_IN("block_size", "Number of points to read and process at once with "
+    "the 'incremental' decomposition method.", "b", 1000);
 
 
 //! Run RunPCA on the specified dataset with the given decomposition method.
@@ -68,21 +79,240 @@ void RunPCA(arma::mat& dataset,
 
 }
 
+/**
+ * Read the next block of at most blockSize points from the given text file,
+ * which holds one point per line.  Returns false if there are no points left.
+ */
+bool LoadBlock(ifstream& stream, const size_t blockSize, arma::mat& block)
+{
+  vector<double> values;
+  size_t dimensionality = 0;
+  size_t points = 0;
+  string line;
+  while (points < blockSize && getline(stream, line))
+  {
+    replace(line.begin(), line.end(), ',', ' ');
+    replace(line.begin(), line.end(), '\t', ' ');
+
+    istringstream lineStream(line);
+    const size_t oldSize = values.size();
+    double value;
+    while (lineStream >> value)
+      values.push_back(value);
+
+    // Skip empty lines (and headers).
+    if (values.size() == oldSize)
+      continue;
+
+    if (points == 0)
+    {
+      dimensionality = values.size();
+    }
+    else if (values.size() - oldSize != dimensionality)
+    {
+      Log::Fatal << "Point has " << (values.size() - oldSize) << " dimensions, "
+          << "but the previous points had " << dimensionality << "!" << endl;
+    }
+
+    ++points;
+  }
+
+  if (points == 0)
+    return false;
+
+  block = arma::mat(values.data(), dimensionality, points);
+  return true;
+}
+
+//! Open the given file for streaming, or fail.
+void OpenStream(const string& inputFile, ifstream& stream)
+{
+  stream.open(inputFile.c_str());
+  if (!stream.is_open())
+    Log::Fatal << "Cannot open input file '" << inputFile << "'!" << endl;
+}
+
+//! Run PCA with the incremental SVD method, streaming the input file from disk
+//! instead of loading it.
+void RunStreamingPCA(const string& inputFile,
+                     const string& outputFile,
+                     const size_t blockSize,
+                     const size_t newDimension,
+                     const bool scale,
+                     const double varToRetain)
+{
+  ifstream stream;
+  arma::mat block;
+
+  // Scaling needs the standard deviation of each dimension, which we compute
+  // in an extra pass with the pairwise update of Chan et al.
+  arma::vec stdDev;
+  if (scale)
+  {
+    arma::vec mean, squaredDeviations;
+    size_t numPoints = 0;
+
+    OpenStream(inputFile, stream);
+    while (LoadBlock(stream, blockSize, block))
+    {
+      const double n = numPoints;
+      const double m = block.n_cols;
+      const arma::vec blockMean = arma::mean(block, 1);
+      arma::mat centeredBlock = block;
+      centeredBlock.each_col() -= blockMean;
+
+      if (numPoints == 0)
+      {
+        mean = blockMean;
+        squaredDeviations = arma::sum(arma::square(centeredBlock), 1);
+      }
+      else
+      {
+        const arma::vec delta = blockMean - mean;
+        squaredDeviations += arma::sum(arma::square(centeredBlock), 1) +
+            (n * m / (n + m)) * arma::square(delta);
+        mean += (m / (n + m)) * delta;
+      }
+      numPoints += block.n_cols;
+    }
+    stream.close();
+
+    stdDev = arma::sqrt(squaredDeviations / (numPoints - 1));
+
+    // If there are any zeroes, make them very small.
+    for (size_t i = 0; i < stdDev.n_elem; ++i)
+      if (stdDev[i] == 0)
+        stdDev[i] = 1e-50;
+  }
+
+  // If we retain a certain amount of variance, all components are needed.
+  IncrementalSVDPolicy decomposition((varToRetain != 0) ? 0 : newDimension,
+      blockSize);
+
+  Log::Info << "Performing PCA on dataset..." << endl;
+  Timer::Start("pca");
+
+  OpenStream(inputFile, stream);
+  while (LoadBlock(stream, blockSize, block))
+  {
+    if (scale)
+      block.each_col() /= stdDev;
+    decomposition.Update(block);
+  }
+  stream.close();
+
+  if (decomposition.NumPoints() == 0)
+    Log::Fatal << "Input file '" << inputFile << "' contains no points!"
+        << endl;
+
+  if (newDimension > decomposition.Mean().n_elem)
+  {
+    Log::Fatal << "New dimensionality (" << newDimension
+        << ") cannot be greater than existing dimensionality ("
+        << decomposition.Mean().n_elem << ")!" << endl;
+  }
+
+  // Find the dimension we should keep.
+  const arma::vec eigVal = decomposition.EigenValues();
+  size_t dimension = (newDimension == 0) ? eigVal.n_elem :
+      std::min(newDimension, (size_t) eigVal.n_elem);
+  double varSum = arma::sum(eigVal.subvec(0, dimension - 1));
+  if (varToRetain != 0)
+  {
+    if (newDimension != 0)
+      Log::Warn << "New dimensionality (-d) ignored because --var_to_retain "
+          << "(-r) was specified." << endl;
+
+    // At least one dimension is kept, even if there is no variance at all.
+    dimension = 0;
+    varSum = 0.0;
+    while ((dimension == 0 ||
+        varSum < varToRetain * decomposition.TotalVariance()) &&
+        (dimension < eigVal.n_elem))
+    {
+      varSum += eigVal[dimension];
+      ++dimension;
+    }
+  }
+
+  Timer::Stop("pca");
+
+  // Without any variance (for instance with a single point), everything is
+  // retained.
+  const double totalVariance = decomposition.TotalVariance();
+  Log::Info << ((totalVariance > 0) ? varSum / totalVariance * 100 : 100.0)
+      << "% of variance retained (" << dimension << " dimensions)." << endl;
+
+  if (outputFile == "")
+    return;
+
+  // Now transform the points block by block and write them out.
+  ofstream output(outputFile.c_str());
+  if (!output.is_open())
+    Log::Fatal << "Cannot open output file '" << outputFile << "'!" << endl;
+
+  const char separator = (data::Extension(outputFile) == "csv") ? ',' : ' ';
+  output.precision(16);
+
+  arma::mat transformed;
+  OpenStream(inputFile, stream);
+  while (LoadBlock(stream, blockSize, block))
+  {
+    if (scale)
+      block.each_col() /= stdDev;
+    decomposition.Apply(block, transformed);
+
+    for (size_t i = 0; i < transformed.n_cols; ++i)
+    {
+      for (size_t j = 0; j < dimension; ++j)
+      {
+        if (j > 0)
+          output << separator;
+        output << transformed(j, i);
+      }
+      output << "\n";
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
   // Parse commandline.
   CLI::ParseCommandLine(argc, argv);
 
-  // Load input dataset.
-  string inputFile = CLI::GetParam<string>("input_file");
-  arma::mat dataset;
-  data::Load(inputFile, dataset);
-
   // Issue a warning if the user did not specify an output file.
   if (!CLI::HasParam("output_file"))
     Log::Warn << "--output_file is not specified; no output will be "
         << "saved." << endl;
 
+  // Get the options for running PCA.
+  const size_t scale = CLI::HasParam("scale");
+  const double varToRetain = CLI::GetParam<double>("var_to_retain");
+  const string decompositionMethod = CLI::GetParam<string>(
+      "decomposition_method");
+
+  // The incremental method streams the input file instead of loading it.
+  string inputFile = CLI::GetParam<string>("input_file");
+  if (decompositionMethod == "incremental")
+  {
+    if (CLI::GetParam<int>("block_size") <= 0)
+      Log::Fatal << "Block size (" << CLI::GetParam<int>("block_size")
+          << ") must be greater than 0!" << endl;
+    if (CLI::GetParam<int>("new_dimensionality") < 0)
+      Log::Fatal << "New dimensionality ("
+          << CLI::GetParam<int>("new_dimensionality") << ") cannot be "
+          << "negative!" << endl;
+
+    RunStreamingPCA(inputFile, CLI::GetParam<string>("output_file"),
+        (size_t) CLI::GetParam<int>("block_size"),
+        (size_t) CLI::GetParam<int>("new_dimensionality"), scale, varToRetain);
+    return 0;
+  }
+
+  // Load input dataset.
+  arma::mat dataset;
+  data::Load(inputFile, dataset);
+
   // Find out what dimension we want.
   size_t newDimension = dataset.n_rows; // No reduction, by default.
   if (CLI::GetParam<int>("new_dimensionality") != 0)
@@ -97,12 +327,6 @@ int main(int argc, char** argv)
     }
   }
 
-  // Get the options for running PCA.
-  const size_t scale = CLI::HasParam("scale");
-  const double varToRetain = CLI::GetParam<double>("var_to_retain");
-  const string decompositionMethod = CLI::GetParam<string>(
-      "decomposition_method");
-
   // Perform PCA.
   if (decompositionMethod == "exact")
   {
@@ -120,7 +344,8 @@ int main(int argc, char** argv)
   {
     // Invalid decomposition method.
     Log::Fatal << "Invalid decomposition method ('" << decompositionMethod
-        << "'); valid choices are 'exact', 'randomized', 'quic'." << endl;
+        << "'); valid choices are 'exact', 'randomized', 'quic', "
+        << "'incremental'." << endl;
   }
 
   // Now save the results.
@@ -0,0 +1,230 @@
+/**
+ * @file decision_tree.hpp
+ *
+ * Definition of the DecisionTree class, a full-depth classification tree with
+ * binary numeric splits, used as the base learner of RandomForest.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_DECISION_TREE_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_DECISION_TREE_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hoeffding_trees/gini_impurity.hpp>
+#include <mlpack/methods/hoeffding_trees/information_gain.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A classification tree that is grown until its leaves are pure (or hold
+ * fewer than a minimum number of points).  Every split is a binary split on a
+ * numeric dimension: points with values less than or equal to the split value
+ * go to the left child.  The quality of a split is measured with a fitness
+ * function, such as GiniImpurity or InformationGain; these are the same
+ * fitness functions that HoeffdingTree uses.
+ *
+ * Each training point may be given an integer weight, which is treated as the
+ * number of copies of the point in the training set; this is how bootstrap
+ * samples are represented without copying the data.  Only a random subset of
+ * the dimensions may be considered for each split.  Points with weight zero
+ * are "out of bag": they are routed through the tree while it is grown, so the
+ * class probabilities of the leaf each one lands in can be collected without
+ * classifying them afterwards.
+ *
+ * The tree is stored as a single array of nodes, where the children of each
+ * node are adjacent.
+ *
+ * @tparam FitnessFunction Fitness function to use to evaluate splits.
+ */
+template<typename FitnessFunction = GiniImpurity>
+class DecisionTree
+{
+ public:
+  /**
+   * Construct the tree and train it on the given labeled data, considering
+   * every dimension for each split.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   */
+  DecisionTree(const arma::mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 1);
+
+  /**
+   * Construct an empty tree, which classifies every point as class 0.
+   */
+  DecisionTree();
+
+  /**
+   * Train the tree on the given labeled data, considering every dimension for
+   * each split.  Anything the tree previously learned is discarded.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   */
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t minimumLeafSize = 1);
+
+  /**
+   * Train the tree on the given weighted data, considering only numFeatures
+   * randomly chosen dimensions for each split (more are tried if none of them
+   * can split the node).  Anything the tree previously learned is discarded.
+   *
+   * If oobProbabilities is not NULL, it must be a numClasses x data.n_cols
+   * matrix, and the class probabilities of the leaf that each point with
+   * weight zero falls into are added to that point's column.  The additions
+   * are atomic, so many trees may be trained at once with the same matrix.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Number of times each point appears in the training set.
+   * @param minimumLeafSize Minimum total weight of the points in each leaf.
+   * @param numFeatures Number of dimensions to consider for each split.
+   * @param rng Random number generator used to choose the dimensions.
+   * @param oobProbabilities Matrix to add out-of-bag class probabilities to.
+   */
+  template<typename RNGType>
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const arma::Row<size_t>& weights,
+             const size_t minimumLeafSize,
+             const size_t numFeatures,
+             RNGType& rng,
+             arma::mat* oobProbabilities = NULL);
+
+  /**
+   * Classify the given point.
+   *
+   * @param point Point to classify.
+   * @return Predicted class of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const
+  {
+    return majorityClasses[Leaf(point)];
+  }
+
+  /**
+   * Classify the given point, and also return the class probabilities of the
+   * leaf it falls into.
+   *
+   * @param point Point to classify.
+   * @param prediction Will be set to the predicted class of the point.
+   * @param probabilities Will be set to the class probabilities of the point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points.  If OpenMP is available, the points are
+   * classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Vector to store the predicted classes in.
+   */
+  void Classify(const arma::mat& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Return a pointer to the class probabilities (NumClasses() values) of the
+   * leaf that the given point falls into.  The pointer is valid until the tree
+   * is trained again.
+   *
+   * @param point Point to find the class probabilities of.
+   */
+  template<typename VecType>
+  const double* ClassProbabilities(const VecType& point) const
+  {
+    return probabilities.colptr(Leaf(point));
+  }
+
+  //! Get the number of classes the tree was trained with.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of nodes in the tree.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of leaves in the tree.
+  size_t NumLeaves() const { return probabilities.n_cols; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * A node of the tree.  A node is a leaf if firstChild is 0 (the root is never
+   * a child).  Points with values in dimension splitDimension less than or
+   * equal to splitValue go to firstChild; other points go to firstChild + 1.
+   */
+  struct Node
+  {
+    Node() : splitDimension(0), firstChild(0), splitValue(0.0), leaf(0) { }
+
+    //! The dimension this node splits on.
+    size_t splitDimension;
+    //! The index of the left child, or 0 if this node is a leaf.
+    size_t firstChild;
+    //! The split value of this node.
+    double splitValue;
+    //! For a leaf, the column of its class probabilities.
+    size_t leaf;
+  };
+
+  //! Return the index of the leaf the given point falls into.
+  template<typename VecType>
+  size_t Leaf(const VecType& point) const
+  {
+    size_t index = 0;
+    while (nodes[index].firstChild != 0)
+    {
+      const Node& node = nodes[index];
+      index = node.firstChild + (point[node.splitDimension] > node.splitValue);
+    }
+
+    return nodes[index].leaf;
+  }
+
+  /**
+   * Find the best split of the points indices[begin, end) in the given
+   * dimension.  The best gain is returned, or -DBL_MAX if the dimension cannot
+   * split the node; in that case splitValue is not modified.
+   */
+  double FindSplit(const arma::mat& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::Row<size_t>& weights,
+                   const std::vector<size_t>& indices,
+                   const size_t begin,
+                   const size_t end,
+                   const arma::Col<size_t>& classCounts,
+                   const size_t dimension,
+                   const size_t minimumLeafSize,
+                   std::vector<std::pair<double, size_t>>& sorted,
+                   arma::Mat<size_t>& splitCounts,
+                   double& splitValue) const;
+
+  //! The nodes of the tree; the root is the first node.
+  std::vector<Node> nodes;
+  //! The class probabilities of each leaf (one column per leaf).
+  arma::mat probabilities;
+  //! The most probable class of each leaf.
+  std::vector<size_t> majorityClasses;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "decision_tree_impl.hpp"
+
+#endif
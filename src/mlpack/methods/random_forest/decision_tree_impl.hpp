@@ -0,0 +1,349 @@
+/**
+ * @file decision_tree_impl.hpp
+ *
+ * Implementation of the DecisionTree class.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_DECISION_TREE_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_DECISION_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "decision_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+DecisionTree<FitnessFunction>::DecisionTree(const arma::mat& data,
+                                            const arma::Row<size_t>& labels,
+                                            const size_t numClasses,
+                                            const size_t minimumLeafSize)
+{
+  Train(data, labels, numClasses, minimumLeafSize);
+}
+
+template<typename FitnessFunction>
+DecisionTree<FitnessFunction>::DecisionTree() :
+    nodes(1),
+    probabilities(arma::ones<arma::mat>(1, 1)),
+    majorityClasses(1, 0),
+    numClasses(1)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction>
+void DecisionTree<FitnessFunction>::Train(const arma::mat& data,
+                                          const arma::Row<size_t>& labels,
+                                          const size_t numClasses,
+                                          const size_t minimumLeafSize)
+{
+  const arma::Row<size_t> weights = arma::ones<arma::Row<size_t>>(data.n_cols);
+  Train(data, labels, numClasses, weights, minimumLeafSize, data.n_rows,
+      math::randGen);
+}
+
+template<typename FitnessFunction>
+template<typename RNGType>
+void DecisionTree<FitnessFunction>::Train(const arma::mat& data,
+                                          const arma::Row<size_t>& labels,
+                                          const size_t numClasses,
+                                          const arma::Row<size_t>& weights,
+                                          const size_t minimumLeafSize,
+                                          const size_t numFeatures,
+                                          RNGType& rng,
+                                          arma::mat* oobProbabilities)
+{
+  if (labels.n_elem != data.n_cols || weights.n_elem != data.n_cols)
+    Log::Fatal << "DecisionTree::Train(): number of labels (" << labels.n_elem
+        << ") and weights (" << weights.n_elem << ") must match number of "
+        << "points (" << data.n_cols << ")!" << std::endl;
+
+  if (numFeatures == 0 || numFeatures > data.n_rows)
+    Log::Fatal << "DecisionTree::Train(): number of features to consider ("
+        << numFeatures << ") must be between 1 and the dimensionality of the "
+        << "data (" << data.n_rows << ")!" << std::endl;
+
+  this->numClasses = numClasses;
+  nodes.clear();
+  majorityClasses.clear();
+  std::vector<double> leafProbabilities;
+
+  // Split the points into the points in the bag and the points out of it.
+  std::vector<size_t> indices, oobIndices;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (weights[i] > 0)
+      indices.push_back(i);
+    else if (oobProbabilities)
+      oobIndices.push_back(i);
+  }
+
+  if (indices.empty())
+    Log::Fatal << "DecisionTree::Train(): no points with nonzero weight!"
+        << std::endl;
+
+  if (arma::max(labels) >= numClasses)
+    Log::Fatal << "DecisionTree::Train(): labels must be less than the number "
+        << "of classes (" << numClasses << ")!" << std::endl;
+
+  // A node that is waiting to be split, with its points in indices[begin, end)
+  // and its out-of-bag points in oobIndices[oobBegin, oobEnd).
+  struct Range
+  {
+    size_t node;
+    size_t begin;
+    size_t end;
+    size_t oobBegin;
+    size_t oobEnd;
+  };
+
+  // Memory that is reused at every node.
+  std::vector<size_t> dimensions(data.n_rows);
+  for (size_t d = 0; d < data.n_rows; ++d)
+    dimensions[d] = d;
+  std::vector<std::pair<double, size_t>> sorted;
+  sorted.reserve(indices.size());
+  arma::Mat<size_t> splitCounts(numClasses, 2);
+  arma::Col<size_t> classCounts(numClasses);
+
+  // The tree can be very deep, so it is grown with an explicit stack instead
+  // of recursion.
+  nodes.push_back(Node());
+  std::vector<Range> stack;
+  stack.push_back(Range { 0, 0, indices.size(), 0, oobIndices.size() });
+  while (!stack.empty())
+  {
+    const Range range = stack.back();
+    stack.pop_back();
+
+    classCounts.zeros();
+    for (size_t k = range.begin; k < range.end; ++k)
+      classCounts[labels[indices[k]]] += weights[indices[k]];
+    const size_t totalWeight = arma::accu(classCounts);
+
+    // Pure nodes and nodes too small to split are leaves.  Otherwise, look for
+    // the best split in numFeatures random dimensions (chosen with a partial
+    // Fisher-Yates shuffle), and keep looking in other dimensions if none of
+    // those can split the node.
+    double bestGain = -DBL_MAX;
+    size_t bestDimension = 0;
+    double bestValue = 0.0;
+    if (arma::max(classCounts) < totalWeight &&
+        totalWeight >= 2 * minimumLeafSize)
+    {
+      for (size_t j = 0; j < data.n_rows; ++j)
+      {
+        if (j >= numFeatures && bestGain != -DBL_MAX)
+          break;
+
+        std::uniform_int_distribution<size_t> dist(j, data.n_rows - 1);
+        std::swap(dimensions[j], dimensions[dist(rng)]);
+
+        double value;
+        const double gain = FindSplit(data, labels, weights, indices,
+            range.begin, range.end, classCounts, dimensions[j],
+            minimumLeafSize, sorted, splitCounts, value);
+        if (gain > bestGain)
+        {
+          bestGain = gain;
+          bestDimension = dimensions[j];
+          bestValue = value;
+        }
+      }
+    }
+
+    if (bestGain == -DBL_MAX)
+    {
+      // Make this node a leaf.
+      const size_t leaf = majorityClasses.size();
+      nodes[range.node].leaf = leaf;
+
+      size_t majorityClass = 0;
+      for (size_t c = 0; c < numClasses; ++c)
+      {
+        leafProbabilities.push_back(double(classCounts[c]) /
+            double(totalWeight));
+        if (classCounts[c] > classCounts[majorityClass])
+          majorityClass = c;
+      }
+      majorityClasses.push_back(majorityClass);
+
+      // Give the out-of-bag points in this leaf its class probabilities.
+      const double* leafProbs = &leafProbabilities[leaf * numClasses];
+      for (size_t k = range.oobBegin; k < range.oobEnd; ++k)
+      {
+        double* oobColumn = oobProbabilities->colptr(oobIndices[k]);
+        for (size_t c = 0; c < numClasses; ++c)
+        {
+          #pragma omp atomic
+          oobColumn[c] += leafProbs[c];
+        }
+      }
+
+      continue;
+    }
+
+    // Split the points (and the out-of-bag points) between the children.
+    const size_t middle = std::partition(indices.begin() + range.begin,
+        indices.begin() + range.end, [&](const size_t i)
+        { return data(bestDimension, i) <= bestValue; }) - indices.begin();
+    const size_t oobMiddle = std::partition(oobIndices.begin() + range.oobBegin,
+        oobIndices.begin() + range.oobEnd, [&](const size_t i)
+        { return data(bestDimension, i) <= bestValue; }) - oobIndices.begin();
+
+    // The children must be adjacent, so they are created together.  (Note that
+    // nodes may be reallocated here.)
+    const size_t firstChild = nodes.size();
+    nodes.resize(nodes.size() + 2);
+    nodes[range.node].splitDimension = bestDimension;
+    nodes[range.node].firstChild = firstChild;
+    nodes[range.node].splitValue = bestValue;
+
+    stack.push_back(Range { firstChild + 1, middle, range.end, oobMiddle,
+        range.oobEnd });
+    stack.push_back(Range { firstChild, range.begin, middle, range.oobBegin,
+        oobMiddle });
+  }
+
+  probabilities = arma::mat(leafProbabilities.data(), numClasses,
+      majorityClasses.size());
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void DecisionTree<FitnessFunction>::Classify(const VecType& point,
+                                             size_t& prediction,
+                                             arma::vec& probabilities) const
+{
+  const size_t leaf = Leaf(point);
+  prediction = majorityClasses[leaf];
+  probabilities = this->probabilities.col(leaf);
+}
+
+template<typename FitnessFunction>
+void DecisionTree<FitnessFunction>::Classify(const arma::mat& data,
+                                             arma::Row<size_t>& predictions)
+    const
+{
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t i = 0; i < (intmax_t) data.n_cols; ++i)
+    predictions[i] = Classify(data.unsafe_col(i));
+}
+
+template<typename FitnessFunction>
+double DecisionTree<FitnessFunction>::FindSplit(
+    const arma::mat& data,
+    const arma::Row<size_t>& labels,
+    const arma::Row<size_t>& weights,
+    const std::vector<size_t>& indices,
+    const size_t begin,
+    const size_t end,
+    const arma::Col<size_t>& classCounts,
+    const size_t dimension,
+    const size_t minimumLeafSize,
+    std::vector<std::pair<double, size_t>>& sorted,
+    arma::Mat<size_t>& splitCounts,
+    double& splitValue) const
+{
+  sorted.clear();
+  for (size_t k = begin; k < end; ++k)
+    sorted.push_back(std::make_pair(data(dimension, indices[k]), indices[k]));
+  std::sort(sorted.begin(), sorted.end());
+
+  if (sorted.front().first == sorted.back().first)
+    return -DBL_MAX; // Nothing to split on.
+
+  // Move the points from the right child to the left child in sorted order,
+  // and evaluate every split between two distinct values.
+  splitCounts.col(0).zeros();
+  splitCounts.col(1) = classCounts;
+  const size_t totalWeight = arma::accu(classCounts);
+  size_t leftWeight = 0;
+
+  double bestGain = -DBL_MAX;
+  double low = 0.0, high = 0.0;
+  for (size_t k = 0; k + 1 < sorted.size(); ++k)
+  {
+    const size_t i = sorted[k].second;
+    splitCounts(labels[i], 0) += weights[i];
+    splitCounts(labels[i], 1) -= weights[i];
+    leftWeight += weights[i];
+
+    if (sorted[k].first == sorted[k + 1].first)
+      continue;
+    if (leftWeight < minimumLeafSize)
+      continue;
+    if (totalWeight - leftWeight < minimumLeafSize)
+      break; // The right child only gets smaller from here.
+
+    const double gain = FitnessFunction::Evaluate(splitCounts);
+    if (gain > bestGain)
+    {
+      bestGain = gain;
+      low = sorted[k].first;
+      high = sorted[k + 1].first;
+    }
+  }
+
+  if (bestGain != -DBL_MAX)
+  {
+    // Split halfway between the two values, unless rounding would put the
+    // split value on the right side.
+    splitValue = low + (high - low) / 2.0;
+    if (splitValue >= high)
+      splitValue = low;
+  }
+
+  return bestGain;
+}
+
+template<typename FitnessFunction>
+template<typename Archive>
+void DecisionTree<FitnessFunction>::Serialize(Archive& ar,
+                                              const unsigned int /* version */)
+{
+  using data::CreateNVP;
+
+  ar & CreateNVP(numClasses, "numClasses");
+  ar & CreateNVP(probabilities, "probabilities");
+  ar & CreateNVP(majorityClasses, "majorityClasses");
+
+  // The nodes are saved as one matrix of indices and one vector of split
+  // values.
+  arma::Mat<size_t> nodeIndices;
+  arma::vec splitValues;
+  if (!Archive::is_loading::value)
+  {
+    nodeIndices.set_size(3, nodes.size());
+    splitValues.set_size(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodeIndices(0, i) = nodes[i].splitDimension;
+      nodeIndices(1, i) = nodes[i].firstChild;
+      nodeIndices(2, i) = nodes[i].leaf;
+      splitValues[i] = nodes[i].splitValue;
+    }
+  }
+
+  ar & CreateNVP(nodeIndices, "nodeIndices");
+  ar & CreateNVP(splitValues, "splitValues");
+
+  if (Archive::is_loading::value)
+  {
+    nodes.resize(splitValues.n_elem);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodes[i].splitDimension = nodeIndices(0, i);
+      nodes[i].firstChild = nodeIndices(1, i);
+      nodes[i].leaf = nodeIndices(2, i);
+      nodes[i].splitValue = splitValues[i];
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file random_forest.hpp
+ *
+ * Definition of the RandomForest class, an ensemble of decision trees trained
+ * on bootstrap samples of the data.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
+
+#include <mlpack/core.hpp>
+#include "decision_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * An implementation of random forests for classification.  Each tree of the
+ * forest is a full-depth DecisionTree trained on a bootstrap sample of the
+ * data, and only a random subset of the dimensions is considered for each
+ * split.  The prediction of the forest is the class with the highest average
+ * probability over the trees.  For more information, see the following paper:
+ *
+ * @code
+ * @article{breiman2001random,
+ *   title={Random forests},
+ *   author={Breiman, Leo},
+ *   journal={Machine Learning},
+ *   volume={45},
+ *   number={1},
+ *   pages={5--32},
+ *   year={2001}
+ * }
+ * @endcode
+ *
+ * A bootstrap sample is represented by the number of times each point was
+ * drawn, so the data is never copied.  If OpenMP is available, the trees are
+ * trained in parallel; each tree has its own random number generator, seeded
+ * from mlpack's random number generator before training starts, so the forest
+ * does not depend on the number of threads.
+ *
+ * The out-of-bag error (the error of each point when classified by the trees
+ * whose bootstrap sample does not contain it) is computed while the trees are
+ * grown, by routing each tree's out-of-bag points along with its training
+ * points; no extra pass over the data or the forest is needed.
+ *
+ * @code
+ * extern arma::mat data, testData;
+ * extern arma::Row<size_t> labels;
+ *
+ * RandomForest<> forest(data, labels, 3, 500);
+ * Log::Info << "Out-of-bag error: " << forest.OOBError() << std::endl;
+ *
+ * arma::Row<size_t> predictions;
+ * forest.Classify(testData, predictions);
+ * @endcode
+ *
+ * @tparam FitnessFunction Fitness function to use to evaluate splits
+ *     (GiniImpurity or InformationGain).
+ */
+template<typename FitnessFunction = GiniImpurity>
+class RandomForest
+{
+ public:
+  //! The type of tree in the forest.
+  typedef DecisionTree<FitnessFunction> TreeType;
+
+  /**
+   * Train a random forest on the given labeled data.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param numFeatures Number of dimensions to consider for each split; if 0,
+   *     the square root of the dimensionality is used.
+   */
+  RandomForest(const arma::mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numTrees = 100,
+               const size_t minimumLeafSize = 1,
+               const size_t numFeatures = 0);
+
+  /**
+   * Create an empty random forest, which classifies every point as class 0.
+   */
+  RandomForest();
+
+  /**
+   * Train the random forest on the given labeled data.  Any previously trained
+   * trees are discarded.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param numFeatures Number of dimensions to consider for each split; if 0,
+   *     the square root of the dimensionality is used.
+   */
+  void Train(const arma::mat& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t numTrees = 100,
+             const size_t minimumLeafSize = 1,
+             const size_t numFeatures = 0);
+
+  /**
+   * Classify the given point.
+   *
+   * @param point Point to classify.
+   * @return Predicted class of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point, and also return the average class probabilities
+   * of the trees.
+   *
+   * @param point Point to classify.
+   * @param prediction Will be set to the predicted class of the point.
+   * @param probabilities Will be set to the class probabilities of the point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points.  If OpenMP is available, blocks of points are
+   * classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Vector to store the predicted classes in.
+   */
+  void Classify(const arma::mat& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, and also return the average class
+   * probabilities of the trees for each point (one column per point).  If
+   * OpenMP is available, blocks of points are classified in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Vector to store the predicted classes in.
+   * @param probabilities Matrix to store the class probabilities in.
+   */
+  void Classify(const arma::mat& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get a tree of the forest.
+  const TreeType& Tree(const size_t i) const { return trees[i]; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  /**
+   * Get the out-of-bag error of the forest from training: the fraction of
+   * training points that are misclassified by the trees that were not trained
+   * on them.  Points that were in the bootstrap sample of every tree are not
+   * counted.
+   */
+  double OOBError() const { return oobError; }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The trees of the forest.
+  std::vector<TreeType> trees;
+  //! The number of classes.
+  size_t numClasses;
+  //! The out-of-bag error from training.
+  double oobError;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "random_forest_impl.hpp"
+
+#endif
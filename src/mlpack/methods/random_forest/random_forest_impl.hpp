@@ -0,0 +1,241 @@
+/**
+ * @file random_forest_impl.hpp
+ *
+ * Implementation of the RandomForest class.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+RandomForest<FitnessFunction>::RandomForest(const arma::mat& data,
+                                            const arma::Row<size_t>& labels,
+                                            const size_t numClasses,
+                                            const size_t numTrees,
+                                            const size_t minimumLeafSize,
+                                            const size_t numFeatures)
+{
+  Train(data, labels, numClasses, numTrees, minimumLeafSize, numFeatures);
+}
+
+template<typename FitnessFunction>
+RandomForest<FitnessFunction>::RandomForest() :
+    numClasses(1),
+    oobError(0.0)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction>
+void RandomForest<FitnessFunction>::Train(const arma::mat& data,
+                                          const arma::Row<size_t>& labels,
+                                          const size_t numClasses,
+                                          const size_t numTrees,
+                                          const size_t minimumLeafSize,
+                                          const size_t numFeatures)
+{
+  if (labels.n_elem != data.n_cols)
+    Log::Fatal << "RandomForest::Train(): number of labels (" << labels.n_elem
+        << ") does not match number of points (" << data.n_cols << ")!"
+        << std::endl;
+
+  if (data.n_cols == 0 || data.n_rows == 0)
+    Log::Fatal << "RandomForest::Train(): cannot train on an empty dataset!"
+        << std::endl;
+
+  // The trees are trained in parallel, and an error can't be raised from
+  // there, so the input is checked here.
+  if (arma::max(labels) >= numClasses)
+    Log::Fatal << "RandomForest::Train(): labels must be less than the number "
+        << "of classes (" << numClasses << ")!" << std::endl;
+
+  if (numFeatures > data.n_rows)
+    Log::Fatal << "RandomForest::Train(): number of features to consider ("
+        << numFeatures << ") must not be greater than the dimensionality of "
+        << "the data (" << data.n_rows << ")!" << std::endl;
+
+  const size_t features = (numFeatures == 0) ?
+      std::max((size_t) std::sqrt((double) data.n_rows), (size_t) 1) :
+      numFeatures;
+
+  this->numClasses = numClasses;
+  trees.clear();
+  trees.resize(numTrees);
+
+  // Draw the seeds of the trees up front, so that the forest doesn't depend on
+  // which thread trains which tree.
+  std::vector<uint32_t> seeds(numTrees);
+  for (size_t t = 0; t < numTrees; ++t)
+    seeds[t] = (uint32_t) math::randGen();
+
+  arma::mat oobProbabilities(numClasses, data.n_cols);
+  oobProbabilities.zeros();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t t = 0; t < (intmax_t) numTrees; ++t)
+  {
+    std::mt19937 rng(seeds[t]);
+
+    // Draw the bootstrap sample.
+    std::uniform_int_distribution<size_t> dist(0, data.n_cols - 1);
+    arma::Row<size_t> weights(data.n_cols);
+    weights.zeros();
+    for (size_t i = 0; i < data.n_cols; ++i)
+      ++weights[dist(rng)];
+
+    trees[t].Train(data, labels, numClasses, weights, minimumLeafSize,
+        features, rng, &oobProbabilities);
+  }
+
+  // Every point that was out of bag for at least one tree has some nonzero
+  // probability.
+  size_t oobPoints = 0, oobMistakes = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const double* column = oobProbabilities.colptr(i);
+    size_t prediction = 0;
+    double total = column[0];
+    for (size_t c = 1; c < numClasses; ++c)
+    {
+      total += column[c];
+      if (column[c] > column[prediction])
+        prediction = c;
+    }
+
+    if (total > 0.0)
+    {
+      ++oobPoints;
+      if (prediction != labels[i])
+        ++oobMistakes;
+    }
+  }
+
+  oobError = (oobPoints == 0) ? 0.0 : double(oobMistakes) / double(oobPoints);
+  Log::Info << "RandomForest::Train(): trained " << numTrees << " trees; "
+      << "out-of-bag error " << oobError << " (" << oobPoints << " points)."
+      << std::endl;
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+size_t RandomForest<FitnessFunction>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+  return prediction;
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void RandomForest<FitnessFunction>::Classify(const VecType& point,
+                                             size_t& prediction,
+                                             arma::vec& probabilities) const
+{
+  probabilities.zeros(numClasses);
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    const double* treeProbabilities = trees[t].ClassProbabilities(point);
+    for (size_t c = 0; c < numClasses; ++c)
+      probabilities[c] += treeProbabilities[c];
+  }
+
+  if (!trees.empty())
+    probabilities /= trees.size();
+
+  prediction = 0;
+  for (size_t c = 1; c < numClasses; ++c)
+    if (probabilities[c] > probabilities[prediction])
+      prediction = c;
+}
+
+template<typename FitnessFunction>
+void RandomForest<FitnessFunction>::Classify(const arma::mat& data,
+                                             arma::Row<size_t>& predictions)
+    const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename FitnessFunction>
+void RandomForest<FitnessFunction>::Classify(const arma::mat& data,
+                                             arma::Row<size_t>& predictions,
+                                             arma::mat& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  // Each block of points is run through one tree at a time, so that the tree
+  // stays in cache while the block is classified.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (intmax_t b = 0; b < (intmax_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    for (size_t t = 0; t < trees.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double* treeProbabilities =
+            trees[t].ClassProbabilities(data.colptr(i));
+        double* column = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          column[c] += treeProbabilities[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      double* column = probabilities.colptr(i);
+      size_t prediction = 0;
+      for (size_t c = 0; c < numClasses; ++c)
+      {
+        if (!trees.empty())
+          column[c] /= trees.size();
+        if (column[c] > column[prediction])
+          prediction = c;
+      }
+
+      predictions[i] = prediction;
+    }
+  }
+}
+
+template<typename FitnessFunction>
+template<typename Archive>
+void RandomForest<FitnessFunction>::Serialize(Archive& ar,
+                                              const unsigned int /* version */)
+{
+  size_t numTrees = trees.size();
+  ar & data::CreateNVP(numClasses, "numClasses");
+  ar & data::CreateNVP(oobError, "oobError");
+  ar & data::CreateNVP(numTrees, "numTrees");
+
+  // Now serialize each tree.
+  if (Archive::is_loading::value)
+  {
+    trees.clear();
+    trees.resize(numTrees);
+  }
+  for (size_t i = 0; i < trees.size(); ++i)
+  {
+    std::ostringstream oss;
+    oss << "tree" << i;
+    ar & data::CreateNVP(trees[i], oss.str());
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file random_forest_main.cpp
+ *
+ * A command-line program to train and apply random forests.
+ */
+#include <mlpack/core.hpp>
+#include "random_forest.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::data;
+
+PROGRAM_INFO("Random forests",
+    "This program implements random forests, an ensemble of decision trees "
+    "that are each trained on a bootstrap sample of the data, considering only"
+    " a random subset of the dimensions for each split.  The trees are trained"
+    " in parallel if OpenMP is available.  Given a labeled dataset, this "
+    "program can train a forest and save it to a file, and a trained forest "
+    "can be used to predict the classes of a test set."
+    "\n\n"
+    "The training file and associated labels are specified with the "
+    "--training_file (-t) and --labels_file (-l) options, respectively.  The "
+    "number of trees is given with --num_trees (-N), the minimum number of "
+    "points in each leaf with --minimum_leaf_size (-n), and the number of "
+    "dimensions to consider for each split with --num_features (-f); if that "
+    "is 0, the square root of the dimensionality is used.  The out-of-bag "
+    "error of the forest is printed after training.  Splits are chosen by Gini"
+    " impurity, or by information gain if --info_gain (-i) is given."
+    "\n\n"
+    "When a model is trained, it may be saved to a file with the "
+    "--output_model_file (-M) option.  A model may be loaded from file with the"
+    " --input_model_file (-m) option; --info_gain must be given if and only if "
+    "it was given when the model was trained."
+    "\n\n"
+    "A test file may be specified with the --test_file (-T) option, and if "
+    "performance numbers are desired for that test set, labels may be specified"
+    " with the --test_labels_file (-L) option.  Predictions for each test point"
+    " will be stored in the file specified by --predictions_file (-p) and "
+    "class probabilities for each test point will be stored in the file "
+    "specified by the --probabilities_file (-P) option.");
+
+PARAM_STRING_IN("training_file", "Training dataset file.", "t", "");
+PARAM_STRING_IN("labels_file", "Labels for training dataset.", "l", "");
+
+PARAM_INT_IN("num_trees", "Number of trees in the forest.", "N", 100);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf.",
+    "n", 1);
+PARAM_INT_IN("num_features", "Number of dimensions to consider for each split "
+    "(0 means the square root of the dimensionality).", "f", 0);
+PARAM_FLAG("info_gain", "If set, information gain is used instead of Gini "
+    "impurity for calculating split quality.", "i");
+
+PARAM_STRING_IN("input_model_file", "File to load trained forest from.", "m",
+    "");
+PARAM_STRING_OUT("output_model_file", "File to save trained forest to.", "M");
+
+PARAM_STRING_IN("test_file", "File of testing data.", "T", "");
+PARAM_STRING_IN("test_labels_file", "Labels of test data.", "L", "");
+PARAM_STRING_OUT("predictions_file", "File to output label predictions for "
+    "test data into.", "p");
+PARAM_STRING_OUT("probabilities_file", "In addition to predicting labels, "
+    "provide class probabilities in this file.", "P");
+
+// Helper function for once we have chosen a forest type.
+template<typename ForestType>
+void PerformActions();
+
+int main(int argc, char** argv)
+{
+  CLI::ParseCommandLine(argc, argv);
+
+  // Check input parameters for validity.
+  if ((CLI::HasParam("predictions_file") ||
+       CLI::HasParam("probabilities_file")) &&
+       !CLI::HasParam("test_file"))
+    Log::Fatal << "--test_file must be specified if --predictions_file or "
+        << "--probabilities_file is specified." << endl;
+
+  if (CLI::HasParam("training_file") && CLI::HasParam("input_model_file"))
+    Log::Fatal << "Only one of --training_file or --input_model_file may be "
+        << "specified!" << endl;
+
+  if (!CLI::HasParam("training_file") && !CLI::HasParam("input_model_file"))
+    Log::Fatal << "One of --training_file or --input_model_file must be "
+        << "specified!" << endl;
+
+  if (CLI::HasParam("training_file") && !CLI::HasParam("labels_file"))
+    Log::Fatal << "If --training_file is specified, --labels_file must be "
+        << "specified too!" << endl;
+
+  if (CLI::GetParam<int>("num_trees") <= 0)
+    Log::Fatal << "Invalid number of trees (" << CLI::GetParam<int>("num_trees")
+        << ")!  Must be 1 or greater." << endl;
+
+  if (CLI::GetParam<int>("minimum_leaf_size") <= 0)
+    Log::Fatal << "Invalid minimum leaf size ("
+        << CLI::GetParam<int>("minimum_leaf_size") << ")!  Must be 1 or "
+        << "greater." << endl;
+
+  if (CLI::GetParam<int>("num_features") < 0)
+    Log::Fatal << "Invalid number of features ("
+        << CLI::GetParam<int>("num_features") << ")!  Must be 0 or greater."
+        << endl;
+
+  if (!CLI::HasParam("output_model_file") &&
+      !CLI::HasParam("predictions_file") &&
+      !CLI::HasParam("probabilities_file"))
+    Log::Warn << "None of --output_model_file, --predictions_file, or "
+        << "--probabilities_file are specified; no results will be saved."
+        << endl;
+
+  if (CLI::HasParam("info_gain"))
+    PerformActions<RandomForest<InformationGain>>();
+  else
+    PerformActions<RandomForest<GiniImpurity>>();
+}
+
+template<typename ForestType>
+void PerformActions()
+{
+  ForestType forest;
+
+  if (CLI::HasParam("training_file"))
+  {
+    arma::mat trainingSet;
+    data::Load(CLI::GetParam<string>("training_file"), trainingSet, true);
+
+    arma::Col<size_t> labelsIn;
+    data::Load(CLI::GetParam<string>("labels_file"), labelsIn, true, false);
+    const arma::Row<size_t> labels = labelsIn.t();
+
+    if (labels.n_elem != trainingSet.n_cols)
+      Log::Fatal << "The number of labels (" << labels.n_elem << ") must match"
+          << " the number of training points (" << trainingSet.n_cols << ")!"
+          << endl;
+
+    const size_t numFeatures = (size_t) CLI::GetParam<int>("num_features");
+    if (numFeatures > trainingSet.n_rows)
+      Log::Fatal << "--num_features (" << numFeatures << ") must not be "
+          << "greater than the dimensionality of the training set ("
+          << trainingSet.n_rows << ")!" << endl;
+
+    Timer::Start("forest_training");
+    forest.Train(trainingSet, labels, max(labels) + 1,
+        (size_t) CLI::GetParam<int>("num_trees"),
+        (size_t) CLI::GetParam<int>("minimum_leaf_size"), numFeatures);
+    Timer::Stop("forest_training");
+
+    Log::Info << "Out-of-bag error: " << forest.OOBError() * 100.0 << "%."
+        << endl;
+  }
+  else
+  {
+    data::Load(CLI::GetParam<string>("input_model_file"), "randomForest",
+        forest, true);
+  }
+
+  if (CLI::HasParam("test_file"))
+  {
+    arma::mat testSet;
+    data::Load(CLI::GetParam<string>("test_file"), testSet, true);
+
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+
+    Timer::Start("forest_testing");
+    forest.Classify(testSet, predictions, probabilities);
+    Timer::Stop("forest_testing");
+
+    if (CLI::HasParam("test_labels_file"))
+    {
+      arma::Col<size_t> testLabelsIn;
+      data::Load(CLI::GetParam<string>("test_labels_file"), testLabelsIn, true,
+          false);
+      const arma::Row<size_t> testLabels = testLabelsIn.t();
+
+      size_t correct = 0;
+      for (size_t i = 0; i < testLabels.n_elem; ++i)
+      {
+        if (predictions[i] == testLabels[i])
+          ++correct;
+      }
+      Log::Info << correct << " out of " << testLabels.n_elem << " correct "
+          << "on test set (" << double(correct) / double(testLabels.n_elem) *
+          100.0 << ")." << endl;
+    }
+
+    if (CLI::HasParam("predictions_file"))
+      data::Save(CLI::GetParam<string>("predictions_file"), predictions);
+
+    if (CLI::HasParam("probabilities_file"))
+      data::Save(CLI::GetParam<string>("probabilities_file"), probabilities);
+  }
+
+  if (CLI::HasParam("output_model_file"))
+    data::Save(CLI::GetParam<string>("output_model_file"), "randomForest",
+        forest, true);
+}
@@ -10,15 +10,119 @@
 namespace mlpack {
 namespace svd {
 
+//! Compute the mean of each row of the dense data.
+static arma::vec RowMean(const arma::mat& data)
+{
+  return arma::sum(data, 1) / data.n_cols;
+}
+
+//! Compute the mean of each row of the sparse data.
+static arma::vec RowMean(const arma::sp_mat& data)
+{
+  arma::vec rowMean(data.n_rows, arma::fill::zeros);
+  for (arma::sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+    rowMean[it.row()] += (*it);
+
+  return rowMean / data.n_cols;
+}
+
+//! The dense data doesn't need a transposed copy.
+static arma::mat Transpose(const arma::mat& /* data */)
+{
+  return arma::mat();
+}
+
+//! Transpose the sparse data once, so that the products with the data can be
+//! split over its rows.
+static arma::sp_mat Transpose(const arma::sp_mat& data)
+{
+  return arma::trans(data);
+}
+
+//! Compute data * x for dense data.
+static arma::mat Multiply(const arma::mat& data,
+                          const arma::mat& /* dataT */,
+                          const arma::mat& x)
+{
+  return data * x;
+}
+
+//! Compute data^T * x for dense data.
+static arma::mat MultiplyTransposed(const arma::mat& data, const arma::mat& x)
+{
+  return arma::trans(data) * x;
+}
+
+//! Compute data^T * x for sparse data.  Each thread computes the rows of the
+//! result for its own columns of the data, so the work is split by the nonzero
+//! entries and not by the few columns of x.
+static arma::mat MultiplyTransposed(const arma::sp_mat& data,
+                                    const arma::mat& x)
+{
+  // The rows of x are the columns of x^T, which are contiguous in memory.
+  const arma::mat xt = arma::trans(x);
+  arma::mat resultT(x.n_cols, data.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(static)
+  for (intmax_t j = 0; j < (intmax_t) data.n_cols; ++j)
+  {
+    double* resultCol = resultT.colptr(j);
+    for (size_t k = data.col_ptrs[j]; k < data.col_ptrs[j + 1]; ++k)
+    {
+      const double value = data.values[k];
+      const double* xtCol = xt.colptr(data.row_indices[k]);
+      for (size_t i = 0; i < xt.n_rows; ++i)
+        resultCol[i] += value * xtCol[i];
+    }
+  }
+
+  return arma::trans(resultT);
+}
+
+//! Compute data * x for sparse data.  This is a transposed product with the
+//! transposed data, so it is split over the rows of the data.
+static arma::mat Multiply(const arma::sp_mat& /* data */,
+                          const arma::sp_mat& dataT,
+                          const arma::mat& x)
+{
+  return MultiplyTransposed(dataT, x);
+}
+
+//! Compute (data - rowMean * 1^T) * x; the data is centered implicitly, so
+//! that sparse data stays sparse.
+template<typename MatType>
+static arma::mat CenteredMultiply(const MatType& data,
+                                  const MatType& dataT,
+                                  const arma::vec& rowMean,
+                                  const arma::mat& x)
+{
+  arma::mat result = Multiply(data, dataT, x);
+  result -= rowMean * arma::sum(x, 0);
+  return result;
+}
+
+//! Compute (data - rowMean * 1^T)^T * x.
+template<typename MatType>
+static arma::mat CenteredMultiplyTransposed(const MatType& data,
+                                            const arma::vec& rowMean,
+                                            const arma::mat& x)
+{
+  arma::mat result = MultiplyTransposed(data, x);
+  result.each_row() -= rowMean.t() * x;
+  return result;
+}
+
 RandomizedSVD::RandomizedSVD(const arma::mat& data,
                              arma::mat& u,
                              arma::vec& s,
                              arma::mat& v,
                              const size_t iteratedPower,
                              const size_t maxIterations,
-                             const size_t rank) :
+                             const size_t rank,
+                             const bool center) :
     iteratedPower(iteratedPower),
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    center(center)
 {
   if (rank == 0)
   {
@@ -31,9 +135,11 @@ RandomizedSVD::RandomizedSVD(const arma::mat& data,
 }
 
 RandomizedSVD::RandomizedSVD(const size_t iteratedPower,
-                             const size_t maxIterations) :
+                             const size_t maxIterations,
+                             const bool center) :
     iteratedPower(iteratedPower),
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    center(center)
 {
   /* Nothing to do here */
 }
@@ -44,67 +150,71 @@ void RandomizedSVD::Apply(const arma::mat& data,
                           arma::mat& v,
                           const size_t rank)
 {
-  if (iteratedPower == 0)
-    iteratedPower = rank + 2;
+  ApplyImpl(data, u, s, v, rank);
+}
 
-  // Center the data into a temporary matrix.
-  arma::vec rowMean = arma::sum(data, 1) / data.n_cols;
+void RandomizedSVD::Apply(const arma::sp_mat& data,
+                          arma::mat& u,
+                          arma::vec& s,
+                          arma::mat& v,
+                          const size_t rank)
+{
+  ApplyImpl(data, u, s, v, rank);
+}
+
+template<typename MatType>
+void RandomizedSVD::ApplyImpl(const MatType& data,
+                              arma::mat& u,
+                              arma::vec& s,
+                              arma::mat& v,
+                              const size_t rank)
+{
+  const size_t blockSize = (iteratedPower == 0) ? rank + 2 : iteratedPower;
+
+  // The data is centered implicitly: instead of forming data - rowMean * 1^T,
+  // which would be dense, each product with the data is corrected.
+  const arma::vec rowMean = center ? RowMean(data) :
+      arma::vec(data.n_rows, arma::fill::zeros);
+  const MatType dataT = Transpose(data);
 
-  arma::mat R, Q, Qdata;
+  arma::mat R, Q;
   ann::RandomInitialization randomInit;
 
   // Apply the centered data matrix to a random matrix, obtaining Q.
   if (data.n_cols >= data.n_rows)
   {
-    randomInit.Initialize(R, data.n_rows, iteratedPower);
-    Q = (data.t() * R) - arma::repmat(arma::trans(R.t() * rowMean),
-        data.n_cols, 1);
+    randomInit.Initialize(R, data.n_rows, blockSize);
+    Q = CenteredMultiplyTransposed(data, rowMean, R);
   }
   else
   {
-    randomInit.Initialize(R, data.n_cols, iteratedPower);
-    Q = (data * R) - (rowMean * (arma::ones(1, data.n_cols) * R));
+    randomInit.Initialize(R, data.n_cols, blockSize);
+    Q = CenteredMultiply(data, dataT, rowMean, R);
   }
 
-  // Form a matrix Q whose columns constitute a
-  // well-conditioned basis for the columns of the earlier Q.
-  if (maxIterations == 0)
-  {
-    arma::qr_econ(Q, v, Q);
-  }
-  else
-  {
-    arma::lu(Q, v, Q);
-  }
+  // Form a matrix Q whose columns constitute a well-conditioned basis for the
+  // columns of the earlier Q.
+  arma::qr_econ(Q, R, Q);
 
-  // Perform normalized power iterations.
+  // Perform block power iterations.  Q is re-orthonormalized after each
+  // product, so that the columns don't all converge to the dominant singular
+  // vector and the small singular values are not lost to rounding.
   for (size_t i = 0; i < maxIterations; ++i)
   {
     if (data.n_cols >= data.n_rows)
     {
-      Q = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
-      arma::lu(Q, v, Q);
-      Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
+      Q = CenteredMultiply(data, dataT, rowMean, Q);
+      arma::qr_econ(Q, R, Q);
+      Q = CenteredMultiplyTransposed(data, rowMean, Q);
     }
     else
     {
-      Q = (data.t() * Q) - arma::repmat(rowMean.t() * Q, data.n_cols, 1);
-      arma::lu(Q, v, Q);
-      Q = (data * Q) - (rowMean * (arma::ones(1, data.n_cols) * Q));
+      Q = CenteredMultiplyTransposed(data, rowMean, Q);
+      arma::qr_econ(Q, R, Q);
+      Q = CenteredMultiply(data, dataT, rowMean, Q);
     }
 
-    // Computing the LU decomposition is more efficient than computing the QR
-    // decomposition, so we only use in the last iteration, a pivoted QR
-    // decomposition which renormalizes Q, ensuring that the columns of Q are
-    // orthonormal.
-    if (i < (maxIterations - 1))
-    {
-      arma::lu(Q, v, Q);
-    }
-    else
-    {
-      arma::qr_econ(Q, v, Q);
-    }
+    arma::qr_econ(Q, R, Q);
   }
 
   // Do economical singular value decomposition and compute only the
@@ -112,13 +222,14 @@ void RandomizedSVD::Apply(const arma::mat& data,
   // applied to Q.
   if (data.n_cols >= data.n_rows)
   {
-    Qdata = (data * Q) - rowMean * (arma::ones(1, data.n_cols) * Q);
+    const arma::mat Qdata = CenteredMultiply(data, dataT, rowMean, Q);
     arma::svd_econ(u, s, v, Qdata);
     v = Q * v;
   }
   else
   {
-    Qdata = (Q.t() * data) - arma::repmat(Q.t() * rowMean, 1,  data.n_cols);
+    const arma::mat Qdata = arma::trans(
+        CenteredMultiplyTransposed(data, rowMean, Q));
     arma::svd_econ(u, s, v, Qdata);
     u = Q * u;
   }
@@ -43,6 +43,14 @@ namespace svd {
  * }
  * @endcode
  *
+ * The data may be given as an arma::mat or as an arma::sp_mat.  Sparse data is
+ * never densified: the data is centered implicitly, and the products of the
+ * sparse data with the dense blocks of the range finder and the power
+ * iterations are split over the rows or columns of the data between multiple
+ * threads if OpenMP is available.  For this, a transposed copy of the sparse
+ * data is kept while the decomposition is computed.  After each product the
+ * block is re-orthonormalized, which keeps the power iterations stable.
+ *
  * An example of how to use the interface is shown below:
  *
  * @code
@@ -74,6 +82,7 @@ class RandomizedSVD
    * @param maxIterations Number of iterations for the power method
    *        (Default: 2).
    * @param rank Rank of the approximation (Default: number of rows.)
+   * @param center Whether to decompose the centered data (Default: true).
    */
   RandomizedSVD(const arma::mat& data,
                 arma::mat& u,
@@ -81,7 +90,8 @@ class RandomizedSVD
                 arma::mat& v,
                 const size_t iteratedPower = 0,
                 const size_t maxIterations = 2,
-                const size_t rank = 0);
+                const size_t rank = 0,
+                const bool center = true);
 
   /**
    * Create object for the randomized SVD method.
@@ -90,8 +100,11 @@ class RandomizedSVD
    *        (Default: rank + 2).
    * @param maxIterations Number of iterations for the power method
    *        (Default: 2).
+   * @param center Whether to decompose the centered data (Default: true).
    */
-  RandomizedSVD(const size_t iteratedPower = 0, const size_t maxIterations = 2);
+  RandomizedSVD(const size_t iteratedPower = 0,
+                const size_t maxIterations = 2,
+                const bool center = true);
 
   /**
    * Apply Principal Component Analysis to the provided data set using the
@@ -109,6 +122,22 @@ class RandomizedSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized SVD.  The data is not densified.
+   *
+   * @param data Sparse data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param sigma Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -119,12 +148,28 @@ class RandomizedSVD
   //! Modify the number of iterations for the power method.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get whether the centered data is decomposed.
+  bool Center() const { return center; }
+  //! Modify whether the centered data is decomposed.
+  bool& Center() { return center; }
+
   private:
+    //! Run the randomized SVD on dense or sparse data.
+    template<typename MatType>
+    void ApplyImpl(const MatType& data,
+                   arma::mat& u,
+                   arma::vec& s,
+                   arma::mat& v,
+                   const size_t rank);
+
     //! Locally stored size of the normalized power iterations.
     size_t iteratedPower;
 
     //! Locally stored number of iterations for the power method.
     size_t maxIterations;
+
+    //! Whether the centered data is decomposed.
+    bool center;
 };
 
 } // namespace svd
@@ -123,6 +123,7 @@ void RegularizedSVDFunction::Gradient(const arma::mat& parameters,
 namespace mlpack {
 namespace optimization {
 
+template<>
 template<>
 double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(arma::mat& parameters)
 {
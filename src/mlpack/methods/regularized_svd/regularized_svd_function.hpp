@@ -106,6 +106,7 @@ namespace optimization {
    * abstraction does not work as fast as we might like it to.
    */
   template<>
+  template<>
   double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(
       arma::mat& parameters);
 
@@ -42,8 +42,8 @@ namespace regression {
  * const size_t numIterations = 100; // Maximum number of iterations.
  *
  * // Use an instantiated optimizer for the training.
- * SoftmaxRegressionFunction srf(train_data, labels, inputSize, numClasses);
- * L_BFGS<SoftmaxRegressionFunction> optimizer(srf, numBasis, numIterations);
+ * SoftmaxRegressionFunction<> srf(train_data, labels, inputSize, numClasses);
+ * L_BFGS<SoftmaxRegressionFunction<>> optimizer(srf, numBasis, numIterations);
  * SoftmaxRegression<L_BFGS> regressor2(optimizer);
  *
  * arma::mat test_data; // Test data matrix.
@@ -101,7 +101,7 @@ class SoftmaxRegression
    *
    * @param optimizer Instantiated optimizer with instantiated error function.
    */
-  SoftmaxRegression(OptimizerType<SoftmaxRegressionFunction>& optimizer);
+  SoftmaxRegression(OptimizerType<SoftmaxRegressionFunction<>>& optimizer);
 
   /**
    * Predict the class labels for the provided feature points. The function
@@ -132,7 +132,7 @@ class SoftmaxRegression
    * @param optimizer Instantiated optimizer with instantiated error function.
    * @return Objective value of the final point.
    */
-  double Train(OptimizerType<SoftmaxRegressionFunction>& optimizer);
+  double Train(OptimizerType<SoftmaxRegressionFunction<>>& optimizer);
 
   /**
    * Train the softmax regression with the given training data.
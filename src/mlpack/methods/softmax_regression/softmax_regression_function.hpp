@@ -13,6 +13,19 @@
 namespace mlpack {
 namespace regression {
 
+/**
+ * The objective function of softmax regression.  The data may be given as a
+ * dense or as a sparse matrix (MatType = arma::sp_mat).
+ *
+ * Besides the full objective and gradient used by optimizers such as L_BFGS,
+ * the objective can be evaluated separately for each point, so SGD-type
+ * optimizers can be used as well.  The gradient of a single point is also
+ * available as a sparse matrix for optimizers such as Hogwild; it is only
+ * nonzero in the columns of the dimensions in which the point is nonzero.
+ *
+ * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
@@ -27,7 +40,7 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
@@ -106,6 +119,53 @@ class SoftmaxRegressionFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluate the objective function of the softmax regression model for only
+   * one point of the training data, so that the sum over all points is the
+   * result of Evaluate(parameters).  This is useful for optimizers such as
+   * SGD, which require a separable objective function.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param i Index of the point to use for the objective function evaluation.
+   */
+  double Evaluate(const arma::mat& parameters, const size_t i) const;
+
+  /**
+   * Evaluate the gradient of the objective function with respect to only one
+   * point of the training data.  This is useful for optimizers such as SGD,
+   * which require a separable objective function.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param i Index of the point to use for the gradient evaluation.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::mat& gradient) const;
+
+  /**
+   * Evaluate the gradient of the objective function with respect to only one
+   * point of the training data, as a sparse matrix.  Only the columns of the
+   * intercept and of the dimensions in which the point is nonzero are filled,
+   * so for sparse data this takes time proportional to the number of nonzeros
+   * of the point (times the number of classes) instead of the dimensionality.
+   *
+   * To keep the gradient sparse, the L2-regularization of each column is only
+   * applied by the points that are nonzero in that dimension, and it is scaled
+   * by the number of those points, so that the sum of the gradients of all
+   * points is still the full gradient.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param i Index of the point to use for the gradient evaluation.
+   * @param gradient Sparse matrix where gradient values will be stored.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t i,
+                arma::sp_mat& gradient) const;
+
+  //! Return the number of separable functions (the number of points).
+  size_t NumFunctions() const { return data.n_cols; }
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
@@ -129,7 +189,7 @@ class SoftmaxRegressionFunction
 
  private:
   //! Training data matrix.
-  const arma::mat& data;
+  const MatType& data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -140,9 +200,30 @@ class SoftmaxRegressionFunction
   double lambda;
   //! Intercept term flag.
   bool fitIntercept;
+  //! The number of points that are nonzero in each dimension.
+  arma::vec nonzeroCounts;
+
+  /**
+   * Compute the class probabilities of a single point.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param point The point, as a sparse vector.
+   * @param probabilities Vector to store the probabilities in.
+   */
+  void PointProbabilities(const arma::mat& parameters,
+                          const arma::sp_vec& point,
+                          arma::vec& probabilities) const;
+
+  //! Count the points that are nonzero in each dimension of dense data.
+  void CountNonzeros(const arma::mat& data);
+  //! Count the points that are nonzero in each dimension of sparse data.
+  void CountNonzeros(const arma::sp_mat& data);
 };
 
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
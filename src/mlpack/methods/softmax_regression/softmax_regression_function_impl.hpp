@@ -1,16 +1,21 @@
 /**
- * @file softmax_regression_function.cpp
+ * @file softmax_regression_function_impl.hpp
  * @author Siddharth Agrawal
  *
  * Implementation of function to be optimized for softmax regression.
  */
- #include "softmax_regression_function.hpp"
+#ifndef MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
 
-using namespace mlpack;
-using namespace mlpack::regression;
+// In case it hasn't been included yet.
+#include "softmax_regression_function.hpp"
 
-SoftmaxRegressionFunction::SoftmaxRegressionFunction(
-    const arma::mat& data,
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+SoftmaxRegressionFunction<MatType>::SoftmaxRegressionFunction(
+    const MatType& data,
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const double lambda,
@@ -25,6 +30,8 @@ SoftmaxRegressionFunction::SoftmaxRegressionFunction(
 
   // Calculate the label matrix.
   GetGroundTruthMatrix(labels, groundTruth);
+
+  CountNonzeros(data);
 }
 
 /**
@@ -32,12 +39,14 @@ SoftmaxRegressionFunction::SoftmaxRegressionFunction(
  * normal distribution. The weights cannot be initialized to zero, as that will
  * lead to each class output being the same.
  */
-const arma::mat SoftmaxRegressionFunction::InitializeWeights()
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights()
 {
   return InitializeWeights(data.n_rows, numClasses, fitIntercept);
 }
 
-const arma::mat SoftmaxRegressionFunction::InitializeWeights(
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights(
     const size_t featureSize,
     const size_t numClasses,
     const bool fitIntercept)
@@ -47,7 +56,8 @@ const arma::mat SoftmaxRegressionFunction::InitializeWeights(
     return parameters;
 }
 
-void SoftmaxRegressionFunction::InitializeWeights(
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::InitializeWeights(
     arma::mat &weights,
     const size_t featureSize,
     const size_t numClasses,
@@ -68,8 +78,10 @@ void SoftmaxRegressionFunction::InitializeWeights(
  * labels. The output is in the form of a matrix, which leads to simpler
  * calculations in the Evaluate() and Gradient() methods.
  */
-void SoftmaxRegressionFunction::GetGroundTruthMatrix(const arma::Row<size_t>& labels,
-                                                     arma::sp_mat& groundTruth)
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetGroundTruthMatrix(
+    const arma::Row<size_t>& labels,
+    arma::sp_mat& groundTruth)
 {
   // Calculate the ground truth matrix according to the labels passed. The
   // ground truth matrix is a matrix of dimensions 'numClasses * numExamples',
@@ -101,7 +113,8 @@ void SoftmaxRegressionFunction::GetGroundTruthMatrix(const arma::Row<size_t>& la
  * Evaluate the probabilities matrix. If fitIntercept flag is true,
  * it should consider the parameters.cols(0) intercept term.
  */
-void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetProbabilitiesMatrix(
     const arma::mat& parameters,
     arma::mat& probabilities) const
 {
@@ -130,7 +143,9 @@ void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
 /**
  * Evaluates the objective function given the parameters.
  */
-double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
 {
   // The objective function is the negative log likelihood of the model
   // calculated over all the training examples. Mathematically it is as follows:
@@ -168,8 +183,9 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
 /**
  * Calculates and stores the gradient values given a set of parameters.
  */
-void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  arma::mat& gradient) const
 {
   // Calculate the class probabilities for each training example. The
   // probabilities for each of the classes are given by:
@@ -200,3 +216,143 @@ void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
                lambda * parameters;
   }
 }
+
+/**
+ * Evaluates the objective function with respect to a single point.  The log
+ * likelihood and the regularization are both divided by the number of points,
+ * so the sum over all points is the full objective.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t i) const
+{
+  arma::vec probabilities;
+  PointProbabilities(parameters, arma::sp_vec(data.col(i)), probabilities);
+
+  // The label of the point is the row of the only entry in column i of the
+  // ground truth matrix.
+  const size_t label = groundTruth.row_indices[groundTruth.col_ptrs[i]];
+
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters %
+      parameters);
+
+  return (-std::log(probabilities[label]) + weightDecay) / data.n_cols;
+}
+
+/**
+ * Calculates the gradient with respect to a single point.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  const size_t i,
+                                                  arma::mat& gradient) const
+{
+  const arma::sp_vec point(data.col(i));
+  arma::vec inner;
+  PointProbabilities(parameters, point, inner);
+  inner[groundTruth.row_indices[groundTruth.col_ptrs[i]]] -= 1.0;
+
+  gradient = lambda * parameters;
+  const size_t offset = fitIntercept ? 1 : 0;
+  if (fitIntercept)
+    gradient.col(0) += inner;
+
+  for (arma::sp_vec::const_iterator it = point.begin(); it != point.end(); ++it)
+    gradient.col(it.row() + offset) += (*it) * inner;
+
+  gradient /= data.n_cols;
+}
+
+/**
+ * Calculates the gradient with respect to a single point, as a sparse matrix.
+ * The regularization of a dimension is spread over the points that are nonzero
+ * in it, so it is only applied when the corresponding column is touched.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  const size_t i,
+                                                  arma::sp_mat& gradient) const
+{
+  const arma::sp_vec point(data.col(i));
+  arma::vec inner;
+  PointProbabilities(parameters, point, inner);
+  inner[groundTruth.row_indices[groundTruth.col_ptrs[i]]] -= 1.0;
+
+  // Every point touches the intercept, so it is regularized as in the dense
+  // gradient.  The columns are visited in order, so the locations are sorted.
+  const size_t offset = fitIntercept ? 1 : 0;
+  const size_t numColumns = point.n_nonzero + offset;
+  arma::umat locations(2, numColumns * numClasses);
+  arma::vec values(numColumns * numClasses);
+
+  size_t j = 0;
+  if (fitIntercept)
+  {
+    for (size_t c = 0; c < numClasses; ++c, ++j)
+    {
+      locations(0, j) = c;
+      locations(1, j) = 0;
+      values[j] = (inner[c] + lambda * parameters(c, 0)) / data.n_cols;
+    }
+  }
+
+  for (arma::sp_vec::const_iterator it = point.begin(); it != point.end(); ++it)
+  {
+    const size_t column = it.row() + offset;
+    for (size_t c = 0; c < numClasses; ++c, ++j)
+    {
+      locations(0, j) = c;
+      locations(1, j) = column;
+      values[j] = (*it) * inner[c] / data.n_cols + lambda *
+          parameters(c, column) / nonzeroCounts[it.row()];
+    }
+  }
+
+  gradient = arma::sp_mat(locations, values, parameters.n_rows,
+      parameters.n_cols, false);
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::PointProbabilities(
+    const arma::mat& parameters,
+    const arma::sp_vec& point,
+    arma::vec& probabilities) const
+{
+  // Only the columns of the nonzero dimensions contribute to the scores.
+  const size_t offset = fitIntercept ? 1 : 0;
+  if (fitIntercept)
+    probabilities = parameters.col(0);
+  else
+    probabilities.zeros(numClasses);
+
+  for (arma::sp_vec::const_iterator it = point.begin(); it != point.end(); ++it)
+    probabilities += (*it) * parameters.col(it.row() + offset);
+
+  // Subtract the maximum score for numerical stability.
+  probabilities = arma::exp(probabilities - probabilities.max());
+  probabilities /= arma::accu(probabilities);
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::CountNonzeros(const arma::mat& data)
+{
+  nonzeroCounts.zeros(data.n_rows);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    for (size_t d = 0; d < data.n_rows; ++d)
+      if (data(d, i) != 0)
+        ++nonzeroCounts[d];
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::CountNonzeros(const arma::sp_mat& data)
+{
+  nonzeroCounts.zeros(data.n_rows);
+  for (arma::sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+    ++nonzeroCounts[it.row()];
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
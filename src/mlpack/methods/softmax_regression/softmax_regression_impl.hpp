@@ -22,7 +22,7 @@ SoftmaxRegression(const size_t inputSize,
     lambda(0.0001),
     fitIntercept(fitIntercept)
 {
-   SoftmaxRegressionFunction::InitializeWeights(parameters,
+   SoftmaxRegressionFunction<>::InitializeWeights(parameters,
                                                 inputSize, numClasses,
                                                 fitIntercept);
 }
@@ -37,9 +37,9 @@ SoftmaxRegression<OptimizerType>::SoftmaxRegression(const arma::mat& data,
     lambda(lambda),
     fitIntercept(fitIntercept)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses,
+  SoftmaxRegressionFunction<> regressor(data, labels, numClasses,
                                       lambda, fitIntercept);
-  OptimizerType<SoftmaxRegressionFunction> optimizer(regressor);
+  OptimizerType<SoftmaxRegressionFunction<>> optimizer(regressor);
 
   parameters = regressor.GetInitialPoint();
   Train(optimizer);
@@ -47,7 +47,7 @@ SoftmaxRegression<OptimizerType>::SoftmaxRegression(const arma::mat& data,
 
 template<template<typename> class OptimizerType>
 SoftmaxRegression<OptimizerType>::SoftmaxRegression(
-    OptimizerType<SoftmaxRegressionFunction>& optimizer) :
+    OptimizerType<SoftmaxRegressionFunction<>>& optimizer) :
     parameters(optimizer.Function().GetInitialPoint()),
     numClasses(optimizer.Function().NumClasses()),
     lambda(optimizer.Function().Lambda()),
@@ -136,7 +136,7 @@ double SoftmaxRegression<OptimizerType>::ComputeAccuracy(
 
 template<template<typename> class OptimizerType>
 double SoftmaxRegression<OptimizerType>::Train(
-    OptimizerType<SoftmaxRegressionFunction>& optimizer)
+    OptimizerType<SoftmaxRegressionFunction<>>& optimizer)
 {
   // Train the model.
   Timer::Start("softmax_regression_optimization");
@@ -154,9 +154,9 @@ double SoftmaxRegression<OptimizerType>::Train(const arma::mat& data,
                                                const arma::Row<size_t>& labels,
                                                const size_t numClasses)
 {
-  SoftmaxRegressionFunction regressor(data, labels, numClasses,
+  SoftmaxRegressionFunction<> regressor(data, labels, numClasses,
                                       lambda, fitIntercept);
-  OptimizerType<SoftmaxRegressionFunction> optimizer(regressor);
+  OptimizerType<SoftmaxRegressionFunction<>> optimizer(regressor);
 
   return Train(optimizer);
 }
@@ -240,7 +240,7 @@ unique_ptr<Model> TrainSoftmax(const string& trainingFile,
 {
   using namespace mlpack;
 
-  using SRF = regression::SoftmaxRegressionFunction;
+  using SRF = regression::SoftmaxRegressionFunction<>;
 
   unique_ptr<Model> sm;
   if (!inputModelFile.empty())
@@ -11,6 +11,8 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/layer/conv_layer.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -144,6 +146,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input,
+      filter, output);
 }
 
 /**
@@ -181,6 +187,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   // speeded up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -226,6 +236,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -275,6 +289,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution3DTest)
   // speeded up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -317,6 +335,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolutionBatchTest)
   // speeded up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -363,6 +385,114 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
   // speeded up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution through im2col and a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+}
+
+/*
+ * Check that two 3rd order tensors have the same size and (almost) the same
+ * elements.
+ */
+void CheckCubes(const arma::cube& a, const arma::cube& b)
+{
+  BOOST_REQUIRE_EQUAL(a.n_rows, b.n_rows);
+  BOOST_REQUIRE_EQUAL(a.n_cols, b.n_cols);
+  BOOST_REQUIRE_EQUAL(a.n_slices, b.n_slices);
+
+  for (size_t i = 0; i < a.n_elem; i++)
+    BOOST_REQUIRE_SMALL(a[i] - b[i], 1e-8);
+}
+
+/**
+ * A ConvLayer that convolves all maps at once through im2col should compute the
+ * same forward pass, backward pass and gradient as one that convolves each pair
+ * of maps separately.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvLayerTest)
+{
+  ConvLayer<> naiveLayer(3, 4, 5, 3);
+  ConvLayer<Im2ColConvolution<ValidConvolution>,
+            Im2ColConvolution<FullConvolution>,
+            Im2ColConvolution<ValidConvolution> > im2colLayer(3, 4, 5, 3);
+
+  naiveLayer.Weights().randn();
+  im2colLayer.Weights() = naiveLayer.Weights();
+
+  arma::cube input = arma::randn<arma::cube>(12, 10, 3);
+  naiveLayer.InputParameter() = input;
+  im2colLayer.InputParameter() = input;
+
+  arma::cube naiveOutput, im2colOutput;
+  naiveLayer.Forward(input, naiveOutput);
+  im2colLayer.Forward(input, im2colOutput);
+  BOOST_REQUIRE_EQUAL(im2colOutput.n_rows, 8);
+  BOOST_REQUIRE_EQUAL(im2colOutput.n_cols, 8);
+  BOOST_REQUIRE_EQUAL(im2colOutput.n_slices, 4);
+  CheckCubes(naiveOutput, im2colOutput);
+
+  arma::cube error = arma::randn<arma::cube>(8, 8, 4);
+  arma::cube naiveDelta, im2colDelta;
+  naiveLayer.Backward(naiveOutput, error, naiveDelta);
+  im2colLayer.Backward(im2colOutput, error, im2colDelta);
+  CheckCubes(naiveDelta, im2colDelta);
+
+  arma::cube naiveGradient, im2colGradient;
+  naiveLayer.Gradient(input, error, naiveGradient);
+  im2colLayer.Gradient(input, error, im2colGradient);
+  CheckCubes(naiveGradient, im2colGradient);
+}
+
+/**
+ * Make sure that the im2col layer-wise convolution handles stride and padding
+ * correctly.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColStridePaddingTest)
+{
+  arma::cube input(5, 5, 1), weights(3, 3, 1);
+  input.slice(0) = arma::reshape(arma::linspace<arma::vec>(1, 25, 25), 5, 5);
+  weights.ones();
+
+  // With a stride of 2 and a padding of 1, each output is the sum of a 3x3
+  // window (clipped at the borders) centered on every other input position.
+  arma::cube output;
+  Im2ColConvolution<ValidConvolution>::Forward(input, weights, 1, 2, 2, 1, 1,
+      output);
+  BOOST_REQUIRE_EQUAL(output.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 3);
+  for (size_t j = 0; j < 3; ++j)
+  {
+    for (size_t i = 0; i < 3; ++i)
+    {
+      const size_t rowBegin = (2 * i == 0) ? 0 : 2 * i - 1;
+      const size_t colBegin = (2 * j == 0) ? 0 : 2 * j - 1;
+      const double sum = arma::accu(input.slice(0).submat(rowBegin, colBegin,
+          std::min(2 * i + 1, (size_t) 4), std::min(2 * j + 1, (size_t) 4)));
+      BOOST_REQUIRE_CLOSE(output(i, j, 0), sum, 1e-5);
+    }
+  }
+
+  // The backward pass is the adjoint of the forward pass:
+  // <Forward(x), e> = <x, Backward(e)>.
+  arma::cube error = arma::randu<arma::cube>(3, 3, 1);
+  arma::cube delta;
+  Im2ColConvolution<FullConvolution>::Backward(error, weights, 5, 5, 2, 2, 1,
+      1, delta);
+  BOOST_REQUIRE_EQUAL(delta.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(delta.n_cols, 5);
+  BOOST_REQUIRE_CLOSE(arma::accu(output % error), arma::accu(input % delta),
+      1e-5);
+
+  // The gradient with respect to the weights, again via the inner product:
+  // <Forward(x; w), e> = <w, Gradient(x, e)> since the convolution is linear in
+  // the weights.
+  arma::cube gradient;
+  Im2ColConvolution<ValidConvolution>::Gradient(input, error, 3, 3, 2, 2, 1, 1,
+      gradient);
+  BOOST_REQUIRE_EQUAL(gradient.n_slices, 1);
+  BOOST_REQUIRE_CLOSE(arma::accu(output % error),
+      arma::accu(weights % gradient), 1e-5);
 }
 
 BOOST_AUTO_TEST_SUITE_END();
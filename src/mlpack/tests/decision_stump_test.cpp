@@ -353,4 +353,42 @@ BOOST_AUTO_TEST_CASE(EmptyConstructorTest)
   BOOST_CHECK_EQUAL(predictedLabels(0, 7), 2);
 }
 
+/**
+ * Ensure that training with presorted data gives exactly the same stump as
+ * training without it, even when there are many duplicate values.
+ */
+BOOST_AUTO_TEST_CASE(PresortedTrainingTest)
+{
+  // Round the data so that there are lots of ties.
+  arma::mat data = arma::floor(10.0 * arma::randu<arma::mat>(5, 500));
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    labels[i] = (data(2, i) > 4.0) ? 1 : 0;
+    if (mlpack::math::Random() < 0.2)
+      labels[i] = mlpack::math::RandInt(3);
+  }
+  arma::rowvec weights = arma::randu<arma::rowvec>(500);
+  weights /= arma::accu(weights);
+
+  DecisionStump<> other(data, labels, 3, 6);
+
+  arma::umat sortedIndices;
+  DecisionStump<>::Presort(data, sortedIndices);
+  BOOST_REQUIRE_EQUAL(sortedIndices.n_rows, 500);
+  BOOST_REQUIRE_EQUAL(sortedIndices.n_cols, 5);
+
+  DecisionStump<> ds(other, data, labels, weights);
+  DecisionStump<> presortedDs(other, data, labels, weights, sortedIndices);
+
+  BOOST_REQUIRE_EQUAL(ds.SplitDimension(), presortedDs.SplitDimension());
+  BOOST_REQUIRE_EQUAL(ds.Split().n_elem, presortedDs.Split().n_elem);
+  BOOST_REQUIRE_EQUAL(ds.BinLabels().n_elem, presortedDs.BinLabels().n_elem);
+  for (size_t i = 0; i < ds.Split().n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(ds.Split()[i], presortedDs.Split()[i]);
+    BOOST_REQUIRE_EQUAL(ds.BinLabels()[i], presortedDs.BinLabels()[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -212,6 +212,71 @@ BOOST_AUTO_TEST_CASE(TestGrow)
   BOOST_REQUIRE_CLOSE(alpha, min(rootAlpha, rAlpha), 1e-10);
 }
 
+// Check that two trees have the same structure, splits, and errors.
+void CheckSameTree(const DTree* a, const DTree* b)
+{
+  BOOST_REQUIRE_EQUAL(a->Start(), b->Start());
+  BOOST_REQUIRE_EQUAL(a->End(), b->End());
+  BOOST_REQUIRE_EQUAL(a->SubtreeLeaves(), b->SubtreeLeaves());
+  BOOST_REQUIRE_CLOSE(a->LogNegError(), b->LogNegError(), 1e-10);
+  BOOST_REQUIRE_CLOSE(a->Ratio(), b->Ratio(), 1e-10);
+
+  BOOST_REQUIRE_EQUAL((a->Left() == NULL), (b->Left() == NULL));
+  if (a->Left() != NULL)
+  {
+    BOOST_REQUIRE_EQUAL(a->SplitDim(), b->SplitDim());
+    BOOST_REQUIRE_EQUAL(a->SplitValue(), b->SplitValue());
+    BOOST_REQUIRE_CLOSE(a->AlphaUpper(), b->AlphaUpper(), 1e-10);
+
+    CheckSameTree(a->Left(), b->Left());
+    CheckSameTree(a->Right(), b->Right());
+  }
+}
+
+/**
+ * GrowPresorted() should build the same tree as Grow(), and should keep the
+ * points of each node contiguous.
+ */
+BOOST_AUTO_TEST_CASE(TestGrowPresorted)
+{
+  // Round some values so that there are duplicates.
+  arma::mat data = arma::randu<arma::mat>(4, 3000);
+  data.row(1) = arma::round(10 * data.row(1));
+
+  arma::mat data1(data), data2(data);
+  arma::Col<size_t> oldFromNew1(data.n_cols), oldFromNew2(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    oldFromNew1[i] = i;
+    oldFromNew2[i] = i;
+  }
+
+  DTree tree1(data1), tree2(data2);
+  const double alpha1 = tree1.Grow(data1, oldFromNew1, false, 10, 5);
+  const double alpha2 = tree2.GrowPresorted(data2, oldFromNew2, false, 10, 5);
+
+  BOOST_REQUIRE_GT(tree1.SubtreeLeaves(), 1);
+  BOOST_REQUIRE_CLOSE(alpha1, alpha2, 1e-10);
+  CheckSameTree(&tree1, &tree2);
+
+  // The reordered data must match the mappings, and every point must lie in
+  // the leaf that holds its index.
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+      BOOST_REQUIRE_EQUAL(data2(d, i), data(d, oldFromNew2[i]));
+
+    const DTree* node = &tree2;
+    while (node->Left() != NULL)
+    {
+      node = (data2(node->SplitDim(), i) <= node->SplitValue()) ? node->Left()
+          : node->Right();
+    }
+    BOOST_REQUIRE_GE(i, node->Start());
+    BOOST_REQUIRE_LT(i, node->End());
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestPruneAndUpdate)
 {
   arma::mat testData(3, 5);
@@ -277,6 +342,45 @@ BOOST_AUTO_TEST_CASE(TestComputeValue)
   BOOST_REQUIRE_CLOSE(0.0, testDTree.ComputeValue(q4), 1e-10);
 }
 
+/**
+ * The batch ComputeValue() should give the same results as computing the value
+ * of each point separately, including for points outside of the tree.
+ */
+BOOST_AUTO_TEST_CASE(TestComputeValueBatch)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 2000);
+  arma::Col<size_t> oldFromNew(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    oldFromNew[i] = i;
+
+  DTree tree(data);
+  double alpha = tree.Grow(data, oldFromNew, false, 10, 5);
+  BOOST_REQUIRE_GT(tree.SubtreeLeaves(), 1);
+
+  // Some of the queries will be outside the bounding box of the data.
+  arma::mat queries = 1.2 * arma::randu<arma::mat>(3, 3000) - 0.1;
+
+  arma::rowvec densities;
+  tree.ComputeValue(queries, densities);
+  BOOST_REQUIRE_EQUAL(densities.n_elem, queries.n_cols);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.col(i);
+    BOOST_REQUIRE_EQUAL(densities[i], tree.ComputeValue(query));
+  }
+
+  // Prune a few times and check again.
+  for (size_t i = 0; i < 3 && tree.SubtreeLeaves() > 1; ++i)
+    alpha = tree.PruneAndUpdate(alpha, data.n_cols, false);
+
+  tree.ComputeValue(queries, densities);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.col(i);
+    BOOST_REQUIRE_EQUAL(densities[i], tree.ComputeValue(query));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestVariableImportance)
 {
   arma::mat testData(3, 5);
@@ -373,4 +373,68 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionTrainTest)
       BOOST_REQUIRE_SMALL(d.Covariance()(i, j) - actualCov(i, j), 1e-5);
 }
 
+/**
+ * Make sure the batch log-probability of a discrete distribution matches the
+ * log-probability of each individual observation.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteDistributionBatchLogProbabilityTest)
+{
+  DiscreteDistribution d("0.2 0.4 0.1 0.1 0.2");
+
+  arma::mat obs("0 1 2 3 4 1 1 0");
+  arma::vec logProbabilities, probabilities;
+  d.LogProbability(obs, logProbabilities);
+  d.Probability(obs, probabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, obs.n_cols);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, obs.n_cols);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    const arma::vec o = obs.col(i);
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], d.LogProbability(o), 1e-5);
+    BOOST_REQUIRE_CLOSE(probabilities[i], d.Probability(o), 1e-5);
+  }
+}
+
+/**
+ * Make sure the batch log-probability of a Gaussian matches the log-probability
+ * of each individual observation.
+ */
+BOOST_AUTO_TEST_CASE(GaussianDistributionBatchLogProbabilityTest)
+{
+  GaussianDistribution g("1.0 -2.0 0.5", "3.0 0.5 0.1; 0.5 2.0 0.3; "
+      "0.1 0.3 1.5");
+
+  arma::mat obs = 3.0 * arma::randn<arma::mat>(3, 500);
+  arma::vec logProbabilities;
+  g.LogProbability(obs, logProbabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, obs.n_cols);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], g.LogProbability(obs.col(i)),
+        1e-5);
+}
+
+/**
+ * Make sure the batch log-probability of a Laplace distribution matches the
+ * log-probability of each individual observation.
+ */
+BOOST_AUTO_TEST_CASE(LaplaceDistributionBatchLogProbabilityTest)
+{
+  LaplaceDistribution l(arma::vec("1.0 -1.0 0.0 2.0"), 1.5);
+
+  arma::mat obs = arma::randn<arma::mat>(4, 500);
+  arma::vec logProbabilities, probabilities;
+  l.LogProbability(obs, logProbabilities);
+  l.Probability(obs, probabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, obs.n_cols);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], l.LogProbability(obs.col(i)),
+        1e-5);
+    BOOST_REQUIRE_CLOSE(probabilities[i], l.Probability(obs.col(i)), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
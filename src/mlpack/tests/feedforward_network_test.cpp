@@ -18,13 +18,17 @@
 #include <mlpack/methods/ann/layer/dropout_layer.hpp>
 #include <mlpack/methods/ann/layer/binary_classification_layer.hpp>
 #include <mlpack/methods/ann/layer/dropconnect_layer.hpp>
+#include <mlpack/methods/ann/layer/softmax_layer.hpp>
+#include <mlpack/methods/ann/layer/multiclass_classification_layer.hpp>
 
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/performance_functions/mse_function.hpp>
 #include <mlpack/core/optimizers/rmsprop/rmsprop.hpp>
+#include <mlpack/core/optimizers/minibatch_sgd/minibatch_sgd.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -501,4 +505,270 @@ BOOST_AUTO_TEST_CASE(DropConnectNetworkTest)
       (dataset, labels, dataset, labels, 8, 30, 0.4);
 }
 
+/**
+ * Propagating a batch of points through the network at once should give the
+ * same objective and gradient as summing over the points one at a time.
+ */
+BOOST_AUTO_TEST_CASE(BatchGradientTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 20);
+  arma::mat responses = arma::randu<arma::mat>(2, 20);
+
+  LinearLayer<> inputLayer(4, 6);
+  BiasLayer<> inputBiasLayer(6);
+  BaseLayer<LogisticFunction> inputBaseLayer;
+
+  LinearLayer<> hiddenLayer1(6, 2);
+  BiasLayer<> hiddenBiasLayer1(2);
+  BaseLayer<LogisticFunction> outputLayer;
+
+  BinaryClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(inputLayer, inputBiasLayer, inputBaseLayer,
+                          hiddenLayer1, hiddenBiasLayer1, outputLayer);
+
+  FFN<decltype(modules), decltype(classOutputLayer), RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  // A single iteration doesn't change the parameters; this only sets the
+  // dataset.
+  MiniBatchSGD<decltype(net)> opt(net, 5, 0.01, 1);
+  net.Train(data, responses, opt);
+
+  arma::mat batchGradient;
+  net.GradientBatch(net.Parameters(), 5, batchGradient, 10);
+  const double batchObjective = net.EvaluateBatch(net.Parameters(), 5, 10);
+
+  arma::mat gradient = arma::zeros<arma::mat>(net.Parameters().n_rows,
+      net.Parameters().n_cols);
+  double objective = 0;
+  for (size_t i = 5; i < 15; ++i)
+  {
+    arma::mat pointGradient;
+    net.Gradient(net.Parameters(), i, pointGradient);
+    gradient += pointGradient;
+    objective += net.Evaluate(net.Parameters(), i);
+  }
+
+  BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+  BOOST_REQUIRE_EQUAL(batchGradient.n_elem, gradient.n_elem);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(batchGradient[i] - gradient[i], 1e-10);
+}
+
+/**
+ * The layer buffers are reused between passes with different numbers of points
+ * and between training and testing passes; make sure that consecutive passes
+ * use the same memory, and that this doesn't change the results.
+ */
+BOOST_AUTO_TEST_CASE(BufferReuseTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 20);
+  arma::mat responses = arma::randu<arma::mat>(2, 20);
+
+  LinearLayer<> inputLayer(4, 6);
+  BiasLayer<> inputBiasLayer(6);
+  BaseLayer<LogisticFunction> inputBaseLayer;
+
+  LinearLayer<> hiddenLayer1(6, 2);
+  BiasLayer<> hiddenBiasLayer1(2);
+  BaseLayer<LogisticFunction> outputLayer;
+
+  BinaryClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(inputLayer, inputBiasLayer, inputBaseLayer,
+                          hiddenLayer1, hiddenBiasLayer1, outputLayer);
+
+  FFN<decltype(modules), decltype(classOutputLayer), RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  MiniBatchSGD<decltype(net)> opt(net, 5, 0.01, 1);
+  net.Train(data, responses, opt);
+
+  arma::mat gradient;
+  net.GradientBatch(net.Parameters(), 0, gradient, 5);
+
+  // Predict all points at once, then one at a time.
+  arma::mat prediction;
+  net.Predict(data, prediction);
+
+  // The smaller passes fit into the memory of the first one.
+  const double* inputOutput = inputLayer.OutputParameter().memptr();
+  const double* hiddenOutput = hiddenLayer1.OutputParameter().memptr();
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::mat point = data.col(i);
+    arma::mat pointPrediction;
+    net.Predict(point, pointPrediction);
+
+    BOOST_REQUIRE_EQUAL(inputLayer.OutputParameter().memptr(), inputOutput);
+    BOOST_REQUIRE_EQUAL(hiddenLayer1.OutputParameter().memptr(), hiddenOutput);
+
+    BOOST_REQUIRE_EQUAL(pointPrediction.n_elem, prediction.n_rows);
+    for (size_t j = 0; j < pointPrediction.n_elem; ++j)
+      BOOST_REQUIRE_SMALL(pointPrediction[j] - prediction(j, i), 1e-10);
+  }
+
+  // The gradient doesn't change after the testing passes.
+  arma::mat newGradient;
+  net.GradientBatch(net.Parameters(), 0, newGradient, 5);
+
+  BOOST_REQUIRE_EQUAL(newGradient.n_elem, gradient.n_elem);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(newGradient[i] - gradient[i], 1e-10);
+
+  // Consecutive training passes use the same memory too.
+  hiddenOutput = hiddenLayer1.OutputParameter().memptr();
+  const double* hiddenDelta = hiddenLayer1.Delta().memptr();
+  net.GradientBatch(net.Parameters(), 5, newGradient, 5);
+
+  BOOST_REQUIRE_EQUAL(hiddenLayer1.OutputParameter().memptr(), hiddenOutput);
+  BOOST_REQUIRE_EQUAL(hiddenLayer1.Delta().memptr(), hiddenDelta);
+}
+
+/**
+ * The compiled inference network has to predict the same responses as the
+ * original network, in double and in single precision.
+ */
+BOOST_AUTO_TEST_CASE(InferenceNetworkTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 10);
+
+  LinearLayer<> inputLayer(4, 8);
+  BiasLayer<> inputBiasLayer(8);
+  BaseLayer<LogisticFunction> inputBaseLayer;
+  DropoutLayer<> dropoutLayer(0.2);
+
+  LinearLayer<> hiddenLayer1(8, 3);
+  BiasLayer<> hiddenBiasLayer1(3);
+  SoftmaxLayer<> softmaxLayer;
+
+  MulticlassClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(inputLayer, inputBiasLayer, inputBaseLayer,
+      dropoutLayer, hiddenLayer1, hiddenBiasLayer1, softmaxLayer);
+
+  FFN<decltype(modules), decltype(classOutputLayer), RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  arma::mat prediction;
+  net.Predict(data, prediction);
+
+  // The bias and activation layers are fused with the linear layers and the
+  // dropout layer is folded into the weights of the next linear layer.
+  InferenceNetwork<MulticlassClassificationLayer> inference = net.Freeze(4);
+  BOOST_REQUIRE_EQUAL(inference.NumStages(), 3);
+
+  arma::mat inferencePrediction;
+  inference.Predict(data, inferencePrediction);
+
+  BOOST_REQUIRE_EQUAL(inferencePrediction.n_rows, prediction.n_rows);
+  BOOST_REQUIRE_EQUAL(inferencePrediction.n_cols, prediction.n_cols);
+  for (size_t i = 0; i < prediction.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(inferencePrediction[i] - prediction[i], 1e-10);
+
+  InferenceNetwork<MulticlassClassificationLayer, float> floatInference =
+      net.Freeze<float>(4);
+
+  arma::fmat floatPrediction;
+  floatInference.Predict(arma::conv_to<arma::fmat>::from(data),
+      floatPrediction);
+
+  BOOST_REQUIRE_EQUAL(floatPrediction.n_elem, prediction.n_elem);
+  for (size_t i = 0; i < prediction.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(floatPrediction[i] - prediction[i], 1e-4);
+}
+
+/**
+ * A network with single precision layers has to follow the same network in
+ * double precision during training, up to the precision of float, and it has
+ * to survive serialization.
+ */
+BOOST_AUTO_TEST_CASE(FloatNetworkTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 10);
+  arma::mat responses = arma::randu<arma::mat>(2, 10);
+
+  LinearLayer<> inputLayer(4, 6);
+  BiasLayer<> inputBiasLayer(6);
+  BaseLayer<LogisticFunction> inputBaseLayer;
+  LinearLayer<> hiddenLayer1(6, 2);
+  BiasLayer<> hiddenBiasLayer1(2);
+  BaseLayer<LogisticFunction> outputLayer;
+
+  MulticlassClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(inputLayer, inputBiasLayer, inputBaseLayer,
+                          hiddenLayer1, hiddenBiasLayer1, outputLayer);
+
+  FFN<decltype(modules), decltype(classOutputLayer), RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  LinearLayer<arma::fmat, arma::fmat> floatInputLayer(4, 6);
+  BiasLayer<arma::fmat, arma::fmat> floatInputBiasLayer(6);
+  BaseLayer<LogisticFunction, arma::fmat, arma::fmat> floatInputBaseLayer;
+  LinearLayer<arma::fmat, arma::fmat> floatHiddenLayer1(6, 2);
+  BiasLayer<arma::fmat, arma::fmat> floatHiddenBiasLayer1(2);
+  BaseLayer<LogisticFunction, arma::fmat, arma::fmat> floatOutputLayer;
+
+  auto floatModules = std::tie(floatInputLayer, floatInputBiasLayer,
+      floatInputBaseLayer, floatHiddenLayer1, floatHiddenBiasLayer1,
+      floatOutputLayer);
+
+  FFN<decltype(floatModules), decltype(classOutputLayer), RandomInitialization,
+      MeanSquaredErrorFunction, arma::fmat> floatNet(floatModules,
+      classOutputLayer);
+
+  // Start from the same point. The layers point into the parameters, so the
+  // parameters are copied in place.
+  BOOST_REQUIRE_EQUAL(floatNet.Parameters().n_elem, net.Parameters().n_elem);
+  for (size_t i = 0; i < net.Parameters().n_elem; ++i)
+    floatNet.Parameters()[i] = float(net.Parameters()[i]);
+
+  RMSprop<decltype(net)> opt(net, 0.01, 0.88, 1e-8, 20, -1, false);
+  net.Train(data, responses, opt);
+
+  const arma::fmat floatData = arma::conv_to<arma::fmat>::from(data);
+  RMSprop<decltype(floatNet)> floatOpt(floatNet, 0.01, 0.88, 1e-8, 20, -1,
+      false);
+  floatNet.Train(floatData, arma::conv_to<arma::fmat>::from(responses),
+      floatOpt);
+
+  arma::mat prediction;
+  net.Predict(data, prediction);
+
+  arma::fmat predictors = floatData;
+  arma::fmat floatPrediction;
+  floatNet.Predict(predictors, floatPrediction);
+
+  BOOST_REQUIRE_EQUAL(floatPrediction.n_elem, prediction.n_elem);
+  for (size_t i = 0; i < prediction.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(floatPrediction[i] - prediction[i], 1e-3);
+
+  // Load the trained parameters into another network.
+  LinearLayer<arma::fmat, arma::fmat> newInputLayer(4, 6);
+  BiasLayer<arma::fmat, arma::fmat> newInputBiasLayer(6);
+  BaseLayer<LogisticFunction, arma::fmat, arma::fmat> newInputBaseLayer;
+  LinearLayer<arma::fmat, arma::fmat> newHiddenLayer1(6, 2);
+  BiasLayer<arma::fmat, arma::fmat> newHiddenBiasLayer1(2);
+  BaseLayer<LogisticFunction, arma::fmat, arma::fmat> newOutputLayer;
+
+  auto newModules = std::tie(newInputLayer, newInputBiasLayer,
+      newInputBaseLayer, newHiddenLayer1, newHiddenBiasLayer1, newOutputLayer);
+
+  FFN<decltype(newModules), decltype(classOutputLayer), RandomInitialization,
+      MeanSquaredErrorFunction, arma::fmat> newNet(newModules,
+      classOutputLayer);
+
+  SerializeObject<decltype(floatNet), boost::archive::binary_iarchive,
+      boost::archive::binary_oarchive>(floatNet, newNet);
+
+  arma::fmat newPrediction;
+  newNet.Predict(predictors, newPrediction);
+
+  BOOST_REQUIRE_EQUAL(newPrediction.n_elem, floatPrediction.n_elem);
+  for (size_t i = 0; i < floatPrediction.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(newPrediction[i] - floatPrediction[i], 1e-6f);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
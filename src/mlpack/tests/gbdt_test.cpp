@@ -0,0 +1,190 @@
+/**
+ * @file gbdt_test.cpp
+ *
+ * Tests for gradient boosted decision trees and the QuantileBinner.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gbdt/gbdt.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::gbdt;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(GBDTTest);
+
+/**
+ * Generate a regression dataset with two numeric features and one categorical
+ * feature (with three categories).
+ */
+void CreateRegressionDataset(const size_t points,
+                             arma::mat& data,
+                             DatasetInfo& info,
+                             arma::rowvec& responses)
+{
+  info = DatasetInfo(3);
+  info.MapString("a", 2);
+  info.MapString("b", 2);
+  info.MapString("c", 2);
+
+  const double categoryEffects[] = { -1.0, 0.0, 2.0 };
+
+  data.set_size(3, points);
+  responses.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    data(0, i) = math::Random();
+    data(1, i) = math::Random(); // Irrelevant.
+    data(2, i) = math::RandInt(3);
+
+    responses[i] = 2.0 * data(0, i) + categoryEffects[size_t(data(2, i))] +
+        0.05 * math::RandNormal();
+  }
+}
+
+/**
+ * Make sure that numeric features with few distinct values get one bin per
+ * value, and that other numeric features get bins of roughly equal size.
+ */
+BOOST_AUTO_TEST_CASE(QuantileBinnerTest)
+{
+  arma::mat data(3, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    data(0, i) = i % 5;
+    data(1, i) = math::Random();
+    data(2, i) = i % 3;
+  }
+
+  DatasetInfo info(3);
+  info.MapString("x", 2);
+  info.MapString("y", 2);
+  info.MapString("z", 2);
+
+  QuantileBinner binner(10);
+  binner.Fit(data, info);
+
+  BOOST_REQUIRE_EQUAL(binner.NumBins(0), 5);
+  BOOST_REQUIRE_EQUAL(binner.NumBins(1), 10);
+  BOOST_REQUIRE_EQUAL(binner.NumBins(2), 3);
+  BOOST_REQUIRE(!binner.IsCategorical(0));
+  BOOST_REQUIRE(!binner.IsCategorical(1));
+  BOOST_REQUIRE(binner.IsCategorical(2));
+
+  arma::Mat<unsigned char> bins;
+  binner.Transform(data, bins);
+  BOOST_REQUIRE_EQUAL(bins.n_rows, 1000);
+  BOOST_REQUIRE_EQUAL(bins.n_cols, 3);
+
+  arma::Col<size_t> counts = arma::zeros<arma::Col<size_t>>(10);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL((size_t) bins(i, 0), i % 5);
+    BOOST_REQUIRE_EQUAL((size_t) bins(i, 2), i % 3);
+    ++counts[bins(i, 1)];
+  }
+
+  // Each quantile bin should hold about 100 points.
+  for (size_t b = 0; b < 10; ++b)
+  {
+    BOOST_REQUIRE_GT(counts[b], 90);
+    BOOST_REQUIRE_LT(counts[b], 110);
+  }
+}
+
+/**
+ * Make sure that GBDT with the squared error loss can fit a function of a
+ * numeric and a categorical feature.
+ */
+BOOST_AUTO_TEST_CASE(SquaredErrorRegressionTest)
+{
+  arma::mat data, testData;
+  DatasetInfo info, testInfo;
+  arma::rowvec responses, testResponses;
+  CreateRegressionDataset(3000, data, info, responses);
+  CreateRegressionDataset(1000, testData, testInfo, testResponses);
+
+  GBDT<SquaredErrorLoss> model(data, info, responses, 200, 0.1, 4, 10);
+
+  BOOST_REQUIRE_EQUAL(model.NumTrainedTrees(), 200);
+  BOOST_REQUIRE_GT(model.NumNodes(), 200);
+
+  arma::rowvec predictions;
+  model.Predict(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 1000);
+
+  // The responses have a variance of about 2, so this is a good fit.
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  BOOST_REQUIRE_LT(mse, 0.05);
+
+  // Single-point prediction should give the same results.
+  for (size_t i = 0; i < 1000; ++i)
+    BOOST_REQUIRE_CLOSE(model.Predict(testData.col(i)), predictions[i], 1e-8);
+}
+
+/**
+ * Make sure that GBDT with the logistic loss can separate two classes.
+ */
+BOOST_AUTO_TEST_CASE(LogisticClassificationTest)
+{
+  arma::mat data(4, 2000);
+  arma::rowvec responses(2000);
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    responses[i] = i % 2;
+    data.col(i) = arma::randn<arma::vec>(4);
+    data(0, i) += (i % 2 == 0) ? -2.0 : 2.0;
+  }
+  DatasetInfo info(4);
+
+  GBDT<LogisticLoss> model(data, info, responses, 50);
+
+  arma::rowvec predictions;
+  model.Predict(data, predictions);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    BOOST_REQUIRE_GE(predictions[i], 0.0);
+    BOOST_REQUIRE_LE(predictions[i], 1.0);
+    if ((predictions[i] >= 0.5) == (responses[i] == 1.0))
+      ++correct;
+  }
+
+  BOOST_REQUIRE_GT(correct, 1900);
+}
+
+/**
+ * Make sure that a serialized model makes the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(GBDTSerializationTest)
+{
+  arma::mat data;
+  DatasetInfo info;
+  arma::rowvec responses;
+  CreateRegressionDataset(500, data, info, responses);
+
+  GBDT<SquaredErrorLoss> model(data, info, responses, 20);
+  GBDT<SquaredErrorLoss> xmlModel, textModel, binaryModel(5, 0.5);
+
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  BOOST_REQUIRE_EQUAL(xmlModel.NumNodes(), model.NumNodes());
+  BOOST_REQUIRE_EQUAL(textModel.NumNodes(), model.NumNodes());
+  BOOST_REQUIRE_EQUAL(binaryModel.NumNodes(), model.NumNodes());
+  BOOST_REQUIRE_EQUAL(binaryModel.NumTrees(), 20);
+
+  arma::rowvec predictions, xmlPredictions, textPredictions, binaryPredictions;
+  model.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -8,6 +8,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/kd_tree_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -772,4 +773,172 @@ BOOST_AUTO_TEST_CASE(UseExistingModelTest)
 }
 
 
+/**
+ * Make sure that one iteration of the blocked EM algorithm gives the same
+ * parameters as the textbook EM update.  We use enough points that the data is
+ * split into several blocks, the last of which is not full.
+ */
+BOOST_AUTO_TEST_CASE(EMFitSingleIterationTest)
+{
+  arma::mat data(3, 2500);
+  data.cols(0, 1199) = arma::randn<arma::mat>(3, 1200);
+  data.cols(1200, 2499) = 2.0 * arma::randn<arma::mat>(3, 1300) + 3.0;
+
+  std::vector<distribution::GaussianDistribution> dists(2);
+  dists[0] = distribution::GaussianDistribution("0.5 0.0 -0.5",
+      "1.5 0.1 0.0; 0.1 1.0 0.2; 0.0 0.2 2.0");
+  dists[1] = distribution::GaussianDistribution("2.0 2.5 3.0",
+      "3.0 0.0 0.5; 0.0 2.0 0.0; 0.5 0.0 4.0");
+  arma::vec weights("0.3 0.7");
+
+  // Calculate the textbook update.
+  arma::mat condProb(data.n_cols, 2);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    arma::vec probs;
+    dists[i].Probability(data, probs);
+    condProb.col(i) = weights[i] * probs;
+  }
+  for (size_t j = 0; j < data.n_cols; ++j)
+    condProb.row(j) /= arma::accu(condProb.row(j));
+
+  std::vector<arma::vec> means(2);
+  std::vector<arma::mat> covs(2);
+  arma::vec newWeights(2);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const double sum = arma::accu(condProb.col(i));
+    means[i] = data * condProb.col(i) / sum;
+    arma::mat centered = data;
+    centered.each_col() -= means[i];
+    arma::mat weighted = centered;
+    weighted.each_row() %= condProb.col(i).t();
+    covs[i] = weighted * centered.t() / sum;
+    newWeights[i] = sum / data.n_cols;
+  }
+
+  // Now run one iteration of EM, starting from the given model.
+  EMFit<kmeans::KMeans<>, NoConstraint> fitter(2);
+  fitter.Estimate(data, dists, weights, true);
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(weights[i], newWeights[i], 1e-5);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(dists[i].Mean()[j], means[i][j], 1e-5);
+      for (size_t k = 0; k < 3; ++k)
+        BOOST_REQUIRE_CLOSE(dists[i].Covariance()(j, k), covs[i](j, k), 1e-4);
+    }
+  }
+}
+
+/**
+ * With an approximation tolerance of 0, KDTreeEMFit should never prune, and
+ * should give the same results as EMFit.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeEMFitExactTest)
+{
+  arma::mat data(2, 1000);
+  data.cols(0, 399) = arma::randn<arma::mat>(2, 400);
+  data.cols(400, 999) = 1.5 * arma::randn<arma::mat>(2, 600) + 2.0;
+
+  std::vector<distribution::GaussianDistribution> dists(2);
+  dists[0] = distribution::GaussianDistribution("0.5 0.0", "1.5 0.1; 0.1 1.0");
+  dists[1] = distribution::GaussianDistribution("2.0 2.5", "3.0 0.5; 0.5 2.0");
+  arma::vec weights("0.3 0.7");
+
+  std::vector<distribution::GaussianDistribution> kdDists(dists);
+  arma::vec kdWeights(weights);
+
+  EMFit<> fitter(5);
+  fitter.Estimate(data, dists, weights, true);
+
+  KDTreeEMFit<> kdFitter(5, 1e-10, 0.0, 10);
+  kdFitter.Estimate(data, kdDists, kdWeights, true);
+
+  BOOST_REQUIRE_EQUAL(kdFitter.NumPrunes(), 0);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(kdWeights[i], weights[i], 1e-5);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(kdDists[i].Mean()[j], dists[i].Mean()[j], 1e-5);
+      for (size_t k = 0; k < 2; ++k)
+        BOOST_REQUIRE_CLOSE(kdDists[i].Covariance()(j, k),
+            dists[i].Covariance()(j, k), 1e-4);
+    }
+  }
+}
+
+/**
+ * Make sure that KDTreeEMFit prunes on well-separated Gaussians and still
+ * recovers them.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeEMFitSeparatedGaussiansTest)
+{
+  arma::mat data(2, 10000);
+  data.cols(0, 2999) = arma::randn<arma::mat>(2, 3000);
+  data.cols(3000, 9999) = 0.5 * arma::randn<arma::mat>(2, 7000);
+  data.cols(3000, 9999).each_col() += arma::vec("20.0 -10.0");
+
+  // Start from a rough guess.
+  std::vector<distribution::GaussianDistribution> dists(2);
+  dists[0] = distribution::GaussianDistribution("1.0 1.0", "2.0 0.0; 0.0 2.0");
+  dists[1] = distribution::GaussianDistribution("18.0 -9.0",
+      "2.0 0.0; 0.0 2.0");
+  arma::vec weights("0.5 0.5");
+
+  KDTreeEMFit<> fitter(300, 1e-5, 1e-3, 20);
+  fitter.Estimate(data, dists, weights, true);
+
+  BOOST_REQUIRE_GT(fitter.NumPrunes(), 0);
+
+  const arma::vec mean0 = arma::mean(data.cols(0, 2999), 1);
+  const arma::vec mean1 = arma::mean(data.cols(3000, 9999), 1);
+  BOOST_REQUIRE_CLOSE(weights[0], 0.3, 0.1);
+  BOOST_REQUIRE_CLOSE(weights[1], 0.7, 0.1);
+  for (size_t j = 0; j < 2; ++j)
+  {
+    BOOST_REQUIRE_SMALL(dists[0].Mean()[j] - mean0[j], 1e-2);
+    BOOST_REQUIRE_SMALL(dists[1].Mean()[j] - mean1[j], 1e-2);
+  }
+}
+
+/**
+ * Make sure the batch log-probability of a GMM matches the probability of each
+ * individual observation, and that Classify() picks the most likely component.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchLogProbabilityTest)
+{
+  std::vector<distribution::GaussianDistribution> dists(3);
+  dists[0] = distribution::GaussianDistribution("0.0 0.0", "1.0 0.2; 0.2 1.0");
+  dists[1] = distribution::GaussianDistribution("3.0 1.0", "2.0 0.0; 0.0 0.5");
+  dists[2] = distribution::GaussianDistribution("-2.0 4.0",
+      "1.5 -0.3; -0.3 1.0");
+  GMM gmm(dists, "0.5 0.3 0.2");
+
+  arma::mat obs = 3.0 * arma::randn<arma::mat>(2, 500);
+  arma::vec logProbabilities, probabilities;
+  gmm.LogProbability(obs, logProbabilities);
+  gmm.Probability(obs, probabilities);
+
+  arma::Row<size_t> labels;
+  gmm.Classify(obs, labels);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, obs.n_cols);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, obs.n_cols);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    const arma::vec o = obs.col(i);
+    BOOST_REQUIRE_CLOSE(probabilities[i], gmm.Probability(o), 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], std::log(gmm.Probability(o)),
+        1e-5);
+    BOOST_REQUIRE_CLOSE(gmm.LogProbability(o), logProbabilities[i], 1e-5);
+
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_GE(gmm.Probability(o, labels[i]), gmm.Probability(o, j));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -5,6 +5,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/online_viterbi.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -1164,5 +1165,156 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLoadSaveTest)
           hmm2.Emission()[j].Probabilities()[i], 1e-3);
 }
 
+/**
+ * Make sure that online Viterbi decoding gives the same state sequence and
+ * log-likelihood as HMM::Predict(), no matter how the sequence is split into
+ * chunks.
+ */
+BOOST_AUTO_TEST_CASE(OnlineViterbiPredictTest)
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.8 0.1 0.2; 0.1 0.8 0.1; 0.1 0.1 0.7");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("2.0 2.0", "1.0 0.5; 0.5 1.2");
+  hmm.Emission()[2] = GaussianDistribution("-2.0 1.0", "2.0 0.1; 0.1 1.0");
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(3000, observations, states);
+
+  arma::Row<size_t> predictedStates;
+  const double logLikelihood = hmm.Predict(observations, predictedStates);
+
+  const size_t chunkSizes[] = { 1, 7, 100, 3000 };
+  for (size_t c = 0; c < 4; ++c)
+  {
+    OnlineViterbi<HMM<GaussianDistribution>> viterbi(hmm, 3000);
+
+    arma::Row<size_t> onlineStates;
+    arma::Row<size_t> decoded;
+    for (size_t start = 0; start < observations.n_cols; start += chunkSizes[c])
+    {
+      const size_t end = std::min(start + chunkSizes[c],
+          (size_t) observations.n_cols) - 1;
+      viterbi.Process(observations.cols(start, end), decoded);
+      onlineStates = arma::join_rows(onlineStates, decoded);
+
+      // The number of undecided observations should be small.
+      BOOST_REQUIRE_EQUAL(onlineStates.n_elem + viterbi.Pending(), end + 1);
+    }
+
+    // Finish() resets the decoder, so check this before calling it.
+    BOOST_REQUIRE_EQUAL(viterbi.ForcedDecisions(), 0);
+
+    const double onlineLogLikelihood = viterbi.Finish(decoded);
+    onlineStates = arma::join_rows(onlineStates, decoded);
+
+    BOOST_REQUIRE_EQUAL(onlineStates.n_elem, predictedStates.n_elem);
+    for (size_t i = 0; i < predictedStates.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(onlineStates[i], predictedStates[i]);
+    BOOST_REQUIRE_CLOSE(onlineLogLikelihood, logLikelihood, 1e-5);
+  }
+}
+
+/**
+ * With a maximum lag much smaller than the sequence, make sure that online
+ * Viterbi decoding keeps at most that many observations undecided, and that it
+ * gives the same states as HMM::Predict() for every observation that was
+ * decided before the first forced decision.
+ */
+BOOST_AUTO_TEST_CASE(OnlineViterbiSmallLagTest)
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.8 0.1 0.2; 0.1 0.8 0.1; 0.1 0.1 0.7");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("2.0 2.0", "1.0 0.5; 0.5 1.2");
+  hmm.Emission()[2] = GaussianDistribution("-2.0 1.0", "2.0 0.1; 0.1 1.0");
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(3000, observations, states);
+
+  arma::Row<size_t> predictedStates;
+  hmm.Predict(observations, predictedStates);
+
+  OnlineViterbi<HMM<GaussianDistribution>> viterbi(hmm, 20);
+
+  size_t decodedCount = 0;
+  size_t matches = 0;
+  arma::Row<size_t> decoded;
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    viterbi.Process(observations.col(i), decoded);
+    BOOST_REQUIRE_LT(viterbi.Pending(), 20);
+    BOOST_REQUIRE_EQUAL(decodedCount + decoded.n_elem + viterbi.Pending(),
+        i + 1);
+
+    // Until a decision is forced, every decided state is on the Viterbi path.
+    for (size_t j = 0; j < decoded.n_elem; ++j, ++decodedCount)
+    {
+      if (viterbi.ForcedDecisions() == 0)
+        BOOST_REQUIRE_EQUAL(decoded[j], predictedStates[decodedCount]);
+      if (decoded[j] == predictedStates[decodedCount])
+        ++matches;
+    }
+  }
+
+  viterbi.Finish(decoded);
+  for (size_t j = 0; j < decoded.n_elem; ++j, ++decodedCount)
+    if (decoded[j] == predictedStates[decodedCount])
+      ++matches;
+
+  // Forced decisions follow the most probable path at the time, so they should
+  // rarely disagree with the Viterbi path.
+  BOOST_REQUIRE_EQUAL(decodedCount, 3000);
+  BOOST_REQUIRE_GT(matches, 2900);
+}
+
+/**
+ * Make sure that online Viterbi decoding never keeps more undecided
+ * observations than the maximum lag, and that it still decodes every
+ * observation when decisions must be forced.
+ */
+BOOST_AUTO_TEST_CASE(OnlineViterbiMaxLagTest)
+{
+  // With these transition and emission probabilities, the survivor paths take
+  // a long time to converge.
+  arma::vec initial("0.5 0.5");
+  arma::mat transition("0.999 0.001; 0.001 0.999");
+  std::vector<DiscreteDistribution> emission(2);
+  emission[0] = DiscreteDistribution("0.51 0.49");
+  emission[1] = DiscreteDistribution("0.49 0.51");
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(1000, observations, states);
+
+  OnlineViterbi<HMM<DiscreteDistribution>> viterbi(hmm, 10);
+
+  size_t decodedCount = 0;
+  arma::Row<size_t> decoded;
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    decodedCount += viterbi.Process(observations.col(i), decoded);
+    BOOST_REQUIRE_LT(viterbi.Pending(), 10);
+
+    for (size_t j = 0; j < decoded.n_elem; ++j)
+      BOOST_REQUIRE_LT(decoded[j], 2);
+  }
+
+  // The paths cannot all converge within the maximum lag, so some decisions
+  // must have been forced.  Finish() resets this count.
+  BOOST_REQUIRE_GT(viterbi.ForcedDecisions(), 0);
+
+  viterbi.Finish(decoded);
+  decodedCount += decoded.n_elem;
+
+  BOOST_REQUIRE_EQUAL(decodedCount, 1000);
+  BOOST_REQUIRE_EQUAL(viterbi.Pending(), 0);
+  BOOST_REQUIRE_EQUAL(viterbi.Processed(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
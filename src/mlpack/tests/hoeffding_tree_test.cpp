@@ -10,6 +10,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
+#include <mlpack/methods/hoeffding_trees/compiled_hoeffding_tree.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1140,4 +1141,148 @@ BOOST_AUTO_TEST_CASE(MultipleSerializationTest)
   }
 }
 
+/**
+ * Train a tree of the given type in batch mode on a dataset with numeric and
+ * categorical features, compile it, and make sure that the compiled tree gives
+ * exactly the same predictions and probabilities as the original tree.
+ */
+template<typename TreeType>
+void CheckCompiledTree()
+{
+  // Generate data.  The label depends on both a numeric and a categorical
+  // feature, with some noise, so that batch training builds a deep tree.
+  arma::mat dataset(4, 3000);
+  arma::Row<size_t> labels(3000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString("a", 3);
+  info.MapString("b", 3);
+  info.MapString("c", 3);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = mlpack::math::RandInt(3);
+
+    labels[i] = (size_t(dataset(3, i)) + ((dataset(0, i) > 0.5) ? 1 : 0)) % 3;
+    if (mlpack::math::Random() < 0.1)
+      labels[i] = mlpack::math::RandInt(3);
+  }
+
+  TreeType tree(dataset, info, labels, 3, true);
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+
+  CompiledHoeffdingTree compiledTree(tree);
+
+  // Count the nodes in the original tree.
+  std::stack<const TreeType*> stack;
+  stack.push(&tree);
+  size_t nodes = 0;
+  while (!stack.empty())
+  {
+    const TreeType* node = stack.top();
+    stack.pop();
+    ++nodes;
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push(&node->Child(i));
+  }
+  BOOST_REQUIRE_EQUAL(compiledTree.NumNodes(), nodes);
+
+  // Classify some new points with both trees.
+  arma::mat testData(4, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    testData(0, i) = mlpack::math::Random();
+    testData(1, i) = mlpack::math::Random();
+    testData(2, i) = mlpack::math::Random();
+    testData(3, i) = mlpack::math::RandInt(3);
+  }
+
+  arma::Row<size_t> predictions, compiledPredictions;
+  arma::rowvec probabilities, compiledProbabilities;
+  tree.Classify(testData, predictions, probabilities);
+  compiledTree.Classify(testData, compiledPredictions, compiledProbabilities);
+
+  arma::Row<size_t> compiledPredictionsOnly;
+  compiledTree.Classify(testData, compiledPredictionsOnly);
+
+  BOOST_REQUIRE_EQUAL(compiledPredictions.n_elem, 1000);
+  BOOST_REQUIRE_EQUAL(compiledProbabilities.n_elem, 1000);
+  BOOST_REQUIRE_EQUAL(compiledPredictionsOnly.n_elem, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], compiledPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], compiledPredictionsOnly[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], compiledTree.Classify(testData.col(i)));
+    BOOST_REQUIRE_CLOSE(probabilities[i], compiledProbabilities[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure compiled trees classify exactly like the trees they were compiled
+ * from, for both types of numeric splits.
+ */
+BOOST_AUTO_TEST_CASE(CompiledHoeffdingTreeTest)
+{
+  CheckCompiledTree<HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit>>();
+  CheckCompiledTree<HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit>>();
+}
+
+/**
+ * Make sure that mini-batch training on a dataset with numeric and categorical
+ * features gives a tree that splits on the right dimension and classifies well.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchHoeffdingTreeTest)
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString("0", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 0.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+
+  // Train a tree on mini-batches of 300 points.
+  HoeffdingTree<GiniImpurity, BinaryDoubleNumericSplit> tree(info, 3);
+  for (size_t i = 0; i < 9000; i += 300)
+  {
+    arma::mat batch = dataset.cols(i, i + 299);
+    arma::Row<size_t> batchLabels = labels.subvec(i, i + 299);
+    tree.TrainMiniBatch(batch, batchLabels);
+  }
+
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 1);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < 9000; ++i)
+    if (labels[i] == predictions[i])
+      ++correct;
+
+  // 66% accuracy shouldn't be too much to ask...
+  BOOST_REQUIRE_GT(correct, 6000);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,108 @@
+/**
+ * @file hogwild_test.cpp
+ *
+ * Test file for the Hogwild! optimizer and the sparse gradients it uses.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/hogwild/hogwild.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace arma;
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+
+BOOST_AUTO_TEST_SUITE(HogwildTest);
+
+/**
+ * Make sure that the sparse gradients of the logistic regression function
+ * match the dense gradients: without regularization each point must have the
+ * same gradient, and with regularization the gradients must still sum to the
+ * full gradient.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionSparseGradientTest)
+{
+  // Create a random dataset.
+  arma::sp_mat dataset;
+  dataset.sprandu(10, 200, 0.3);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  const arma::mat parameters = arma::randu<arma::mat>(11, 1);
+
+  LogisticRegressionFunction<arma::sp_mat> lrf(dataset, labels);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    arma::mat gradient;
+    arma::sp_mat sparseGradient;
+    lrf.Gradient(parameters, i, gradient);
+    lrf.Gradient(parameters, i, sparseGradient);
+
+    // Only the intercept and the nonzero dimensions may have a gradient.
+    BOOST_REQUIRE_LE(sparseGradient.n_nonzero, dataset.col(i).n_nonzero + 1);
+    for (size_t j = 0; j < gradient.n_elem; ++j)
+      BOOST_REQUIRE_SMALL(gradient[j] - sparseGradient[j], 1e-10);
+  }
+
+  LogisticRegressionFunction<arma::sp_mat> lrfRegularized(dataset, labels,
+      0.7);
+  arma::mat gradient;
+  lrfRegularized.Gradient(parameters, gradient);
+
+  arma::sp_mat sum(parameters.n_rows, 1);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    arma::sp_mat sparseGradient;
+    lrfRegularized.Gradient(parameters, i, sparseGradient);
+    sum += sparseGradient;
+  }
+
+  for (size_t j = 0; j < gradient.n_elem; ++j)
+    BOOST_REQUIRE_CLOSE(gradient[j], sum(j, 0), 1e-5);
+}
+
+/**
+ * Train logistic regression on a sparse, separable dataset with Hogwild! and
+ * make sure every point is classified correctly.
+ */
+BOOST_AUTO_TEST_CASE(HogwildLogisticRegressionTest)
+{
+  // The first class only has nonzeros in the first ten dimensions, and the
+  // second class only in the last ten dimensions.  Each point has at least one
+  // nonzero.
+  arma::sp_mat first, second;
+  first.sprandu(10, 500, 0.2);
+  second.sprandu(10, 500, 0.2);
+
+  arma::mat denseData(20, 1000, arma::fill::zeros);
+  denseData.submat(0, 0, 9, 499) = arma::mat(first);
+  denseData.submat(10, 500, 19, 999) = arma::mat(second);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    denseData(i % 10, i) += 1.0;
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    denseData(10 + i % 10, i) += 1.0;
+    responses[i] = 1;
+  }
+
+  const arma::sp_mat data(denseData);
+
+  LogisticRegression<arma::sp_mat> lr(data.n_rows, 0.001);
+  LogisticRegressionFunction<arma::sp_mat> lrf(data, responses, 0.001);
+  Hogwild<LogisticRegressionFunction<arma::sp_mat>> hogwild(lrf, 0.1, 50000,
+      1e-5);
+  lr.Train(hogwild);
+
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 1e-5);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -8,12 +8,17 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/lbfgs/lbfgs.hpp>
 #include <mlpack/core/optimizers/lbfgs/test_functions.hpp>
+#include <mlpack/core/optimizers/parallel_separable_function/parallel_separable_function.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression_function.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
+using namespace mlpack;
 using namespace mlpack::optimization;
 using namespace mlpack::optimization::test;
+using namespace mlpack::distribution;
+using namespace mlpack::regression;
 
 BOOST_AUTO_TEST_SUITE(LBFGSTest);
 
@@ -112,4 +117,108 @@ BOOST_AUTO_TEST_CASE(RosenbrockWoodFunctionTest)
   }
 }
 
+/**
+ * The squared distance to a fixed point c, f(x) = 0.5 |x - c|^2.  With an L1
+ * penalty of weight lambda, the minimum is the soft-thresholded c.
+ */
+class ShiftedSquareFunction
+{
+ public:
+  ShiftedSquareFunction(const arma::vec& c) : c(c) { }
+
+  double Evaluate(const arma::mat& coordinates)
+  {
+    return 0.5 * arma::accu(arma::square(coordinates - c));
+  }
+
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient)
+  {
+    gradient = coordinates - c;
+  }
+
+  const arma::mat GetInitialPoint() const
+  {
+    return arma::ones<arma::mat>(c.n_elem, 1);
+  }
+
+ private:
+  arma::vec c;
+};
+
+/**
+ * Make sure that OWL-QN finds the sparse minimum of an L1-penalized function.
+ */
+BOOST_AUTO_TEST_CASE(OrthantWiseL1Test)
+{
+  ShiftedSquareFunction f(arma::vec("3.0 -0.5 0.2 -4.0 0.9 1.5"));
+  L_BFGS<ShiftedSquareFunction> lbfgs(f);
+  lbfgs.L1Penalty() = 1.0;
+
+  arma::mat coords = f.GetInitialPoint();
+  const double objective = lbfgs.Optimize(coords);
+
+  // The soft-thresholded point.
+  const arma::vec expected("2.0 0.0 0.0 -3.0 0.0 0.5");
+  for (size_t i = 0; i < expected.n_elem; ++i)
+  {
+    if (expected[i] == 0.0)
+      BOOST_REQUIRE_SMALL(coords[i], 1e-6);
+    else
+      BOOST_REQUIRE_CLOSE(coords[i], expected[i], 1e-3);
+  }
+
+  // The returned objective includes the penalty.
+  BOOST_REQUIRE_CLOSE(objective, f.Evaluate(coords) +
+      arma::accu(arma::abs(coords)), 1e-5);
+}
+
+/**
+ * Make sure that evaluating a separable function with multiple threads gives
+ * the same L-BFGS result as the full function.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSeparableFunctionTest)
+{
+  // Generate a two-Gaussian dataset that isn't perfectly separable.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("3.0 3.0 3.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = g2.Random();
+    responses[i] = 1;
+  }
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+  ParallelSeparableFunction<LogisticRegressionFunction<>> plrf(lrf);
+
+  // The objective and the gradient must match the full ones.
+  const arma::mat point = arma::randu<arma::mat>(4, 1);
+  BOOST_REQUIRE_CLOSE(plrf.Evaluate(point), lrf.Evaluate(point), 1e-5);
+
+  arma::mat gradient, parallelGradient;
+  lrf.Gradient(point, gradient);
+  plrf.Gradient(point, parallelGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(parallelGradient[i], gradient[i], 1e-5);
+
+  L_BFGS<LogisticRegressionFunction<>> lbfgs(lrf);
+  L_BFGS<ParallelSeparableFunction<LogisticRegressionFunction<>>>
+      parallelLbfgs(plrf);
+
+  arma::mat coords = lrf.GetInitialPoint();
+  arma::mat parallelCoords = plrf.GetInitialPoint();
+  lbfgs.Optimize(coords);
+  parallelLbfgs.Optimize(parallelCoords);
+
+  for (size_t i = 0; i < coords.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(parallelCoords[i] - coords[i], 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -271,6 +271,137 @@ BOOST_AUTO_TEST_CASE(GaussianMatrixSensingSDP)
   BOOST_REQUIRE_SMALL(err, 1e-3);
 }
 
+/**
+ * Make sure that the augmented Lagrangian of an LRSDP and its gradient, which
+ * are computed without forming R R^T, match the straightforward computation
+ * with R R^T, and that giving the sparse constraints as a list of entries
+ * gives the same result as giving them as sparse matrices.
+ */
+BOOST_AUTO_TEST_CASE(SparseConstraintBatchTest)
+{
+  const size_t n = 20;
+  const size_t rank = 4;
+  const size_t numSparse = 30;
+  const size_t numDense = 2;
+  const arma::mat coordinates = arma::randu<arma::mat>(n, rank);
+
+  LRSDPFunction<SDP<arma::sp_mat>> function(numSparse, numDense, coordinates);
+  LRSDPFunction<SDP<arma::sp_mat>> batchFunction(0, numDense, coordinates);
+
+  arma::sp_mat c = arma::sprandu<arma::sp_mat>(n, n, 0.2);
+  function.SDP().C() = c + trans(c);
+  batchFunction.SDP().C() = function.SDP().C();
+
+  // Each sparse constraint gets a few symmetric entries.  The entry list may
+  // contain duplicates, which are summed.
+  arma::umat locations(3, 6 * numSparse);
+  arma::vec values(6 * numSparse);
+  size_t numEntries = 0;
+  for (size_t i = 0; i < numSparse; ++i)
+  {
+    function.SDP().SparseA()[i].zeros(n, n);
+    for (size_t e = 0; e < 3; ++e)
+    {
+      const size_t j = math::RandInt(n);
+      const size_t k = math::RandInt(n);
+      const double value = math::Random();
+      function.SDP().SparseA()[i](j, k) += value;
+      locations(0, numEntries) = i;
+      locations(1, numEntries) = j;
+      locations(2, numEntries) = k;
+      values[numEntries++] = value;
+
+      if (j != k)
+      {
+        function.SDP().SparseA()[i](k, j) += value;
+        locations(0, numEntries) = i;
+        locations(1, numEntries) = k;
+        locations(2, numEntries) = j;
+        values[numEntries++] = value;
+      }
+    }
+  }
+  function.SDP().SparseB().randu();
+  batchFunction.SDP().SparseB() = function.SDP().SparseB();
+  batchFunction.SparseConstraints(locations.cols(0, numEntries - 1),
+      values.subvec(0, numEntries - 1));
+
+  for (size_t i = 0; i < numDense; ++i)
+  {
+    arma::mat a = arma::randu<arma::mat>(n, n);
+    function.SDP().DenseA()[i] = a + trans(a);
+    batchFunction.SDP().DenseA()[i] = function.SDP().DenseA()[i];
+  }
+  function.SDP().DenseB().randu();
+  batchFunction.SDP().DenseB() = function.SDP().DenseB();
+
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> augfunc(function);
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>>
+      batchAugfunc(batchFunction);
+  augfunc.Lambda().randu(numSparse + numDense);
+  augfunc.Sigma() = 3.0;
+  batchAugfunc.Lambda() = augfunc.Lambda();
+  batchAugfunc.Sigma() = augfunc.Sigma();
+
+  // Compute the augmented Lagrangian and its gradient the simple way.
+  const arma::mat rrt = coordinates * trans(coordinates);
+  double objective = accu(arma::mat(function.SDP().C()) % rrt);
+  arma::mat s(function.SDP().C());
+  for (size_t i = 0; i < numSparse + numDense; ++i)
+  {
+    const arma::mat a = (i < numSparse) ?
+        arma::mat(function.SDP().SparseA()[i]) :
+        function.SDP().DenseA()[i - numSparse];
+    const double b = (i < numSparse) ? function.SDP().SparseB()[i] :
+        function.SDP().DenseB()[i - numSparse];
+    const double constraint = accu(a % rrt) - b;
+
+    BOOST_REQUIRE_SMALL(function.EvaluateConstraint(i, coordinates) -
+        constraint, 1e-8);
+    BOOST_REQUIRE_SMALL(batchFunction.EvaluateConstraint(i, coordinates) -
+        constraint, 1e-8);
+
+    objective -= augfunc.Lambda()[i] * constraint;
+    objective += (augfunc.Sigma() / 2.) * constraint * constraint;
+    s -= (augfunc.Lambda()[i] - augfunc.Sigma() * constraint) * a;
+  }
+  const arma::mat gradient = 2 * s * coordinates;
+
+  BOOST_REQUIRE_CLOSE(augfunc.Evaluate(coordinates), objective, 1e-5);
+  BOOST_REQUIRE_CLOSE(batchAugfunc.Evaluate(coordinates), objective, 1e-5);
+
+  arma::mat augGradient, batchGradient;
+  augfunc.Gradient(coordinates, augGradient);
+  batchAugfunc.Gradient(coordinates, batchGradient);
+  BOOST_REQUIRE_SMALL(arma::norm(augGradient - gradient, "fro") /
+      arma::norm(gradient, "fro"), 1e-10);
+  BOOST_REQUIRE_SMALL(arma::norm(batchGradient - gradient, "fro") /
+      arma::norm(gradient, "fro"), 1e-10);
+}
+
+/**
+ * Make sure that an LRSDP with only dense constraints can be optimized.  With
+ * the single constraint Tr(X) = 1, the minimum of Tr(C X) over the positive
+ * semidefinite matrices X is the smallest eigenvalue of C.
+ */
+BOOST_AUTO_TEST_CASE(DenseConstraintOnlySDP)
+{
+  const size_t n = 5;
+  arma::mat coordinates = arma::randu<arma::mat>(n, 2);
+
+  LRSDP<SDP<arma::sp_mat>> sdp(0, 1, coordinates);
+  arma::vec diagonal("3.0 1.0 4.0 2.0 5.0");
+  sdp.SDP().C() = arma::sp_mat(arma::mat(arma::diagmat(diagonal)));
+  sdp.SDP().DenseA()[0].eye(n, n);
+  sdp.SDP().DenseB()[0] = 1.0;
+
+  const double finalValue = sdp.Optimize(coordinates);
+  BOOST_REQUIRE_CLOSE(finalValue, 1.0, 1e-1);
+
+  const arma::mat rrt = coordinates * trans(coordinates);
+  BOOST_REQUIRE_CLOSE(arma::trace(rrt), 1.0, 1e-1);
+}
+
 /**
  * keller4.co test case for Lovasz-Theta LRSDP.
  * This is commented out because it takes a long time to run.
@@ -154,4 +154,44 @@ BOOST_AUTO_TEST_CASE(ZeroBatchSizeTest)
   BOOST_REQUIRE_EQUAL(finite, true);
 }
 
+/**
+ * Make sure that splitting each mini-batch across threads gives the same
+ * result as the serial computation of the gradients.
+ */
+BOOST_AUTO_TEST_CASE(ParallelLogisticRegressionTest)
+{
+  // Generate a two-Gaussian dataset.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = g2.Random();
+    responses[i] = 1;
+  }
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+  MiniBatchSGD<LogisticRegressionFunction<>> serial(lrf, 37, 0.01, 500, 1e-5,
+      false);
+  MiniBatchSGD<LogisticRegressionFunction<>> parallel(lrf, 37, 0.01, 500,
+      1e-5, false, true);
+
+  arma::mat serialCoordinates = lrf.GetInitialPoint();
+  arma::mat parallelCoordinates = lrf.GetInitialPoint();
+  const double serialObjective = serial.Optimize(serialCoordinates);
+  const double parallelObjective = parallel.Optimize(parallelCoordinates);
+
+  // The gradients are only summed in a different order.
+  BOOST_REQUIRE_CLOSE(parallelObjective, serialObjective, 1e-5);
+  for (size_t i = 0; i < serialCoordinates.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(parallelCoordinates[i] - serialCoordinates[i], 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -285,4 +285,131 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Train incrementally on two halves of the dataset, and make sure the model is
+ * the same as the model trained on the whole dataset at once.
+ */
+BOOST_AUTO_TEST_CASE(SeparateTrainBatchIncrementalTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData;
+  data::Load(trainFilename, trainData, true);
+
+  // Get the labels out.
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  NaiveBayesClassifier<> nbc(trainData, labels, classes, false);
+  NaiveBayesClassifier<> nbcTrain(trainData.n_rows, classes);
+
+  const size_t half = trainData.n_cols / 2;
+  nbcTrain.Train(trainData.cols(0, half - 1), labels.subvec(0, half - 1));
+  nbcTrain.Train(trainData.cols(half, trainData.n_cols - 1),
+      labels.subvec(half, trainData.n_cols - 1));
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    if (std::abs(nbc.Means()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Means()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Means()[i], nbcTrain.Means()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Variances().n_elem; ++i)
+  {
+    if (std::abs(nbc.Variances()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Variances()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Variances()[i], nbcTrain.Variances()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+  {
+    if (std::abs(nbc.Probabilities()[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(nbcTrain.Probabilities()[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i], nbcTrain.Probabilities()[i],
+          1e-5);
+  }
+}
+
+/**
+ * Make sure that the probabilities given by Classify() are normalized and
+ * consistent with the predictions.
+ */
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierProbabilitiesTest)
+{
+  const char* trainFilename = "trainSet.csv";
+  const char* testFilename = "testSet.csv";
+  size_t classes = 2;
+
+  arma::mat trainData, testData;
+  data::Load(trainFilename, trainData, true);
+  data::Load(testFilename, testData, true);
+
+  // Get the labels out.
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  NaiveBayesClassifier<> nbc(trainData, labels, classes);
+
+  arma::Row<size_t> predictions, probPredictions;
+  arma::mat probabilities;
+  nbc.Classify(testData, predictions);
+  nbc.Classify(testData, probPredictions, probabilities);
+
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, classes);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, testData.n_cols);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], probPredictions[i]);
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+
+    arma::uword maxIndex;
+    probabilities.col(i).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictions[i], (size_t) maxIndex);
+  }
+}
+
+/**
+ * Make sure that a feature that is constant within each class (and so has zero
+ * variance) is handled correctly: points that match the constant value of a
+ * class must be assigned to that class, whatever the other features are.
+ */
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierZeroVarianceTest)
+{
+  const size_t classes = 3;
+  const size_t pointsPerClass = 100;
+
+  // The first feature is 10 * (class + 1) for every point of a class; the
+  // second feature is noise that is the same for all classes.
+  arma::mat data(2, classes * pointsPerClass);
+  arma::Row<size_t> labels(classes * pointsPerClass);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = i / pointsPerClass;
+    data(0, i) = 10.0 * (labels[i] + 1);
+    data(1, i) = 1000.0 * math::RandNormal();
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, classes);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  nbc.Classify(data, predictions, probabilities);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], labels[i]);
+    BOOST_REQUIRE_CLOSE(probabilities(labels[i], i), 1.0, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
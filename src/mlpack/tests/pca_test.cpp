@@ -8,6 +8,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 
@@ -189,6 +190,41 @@ BOOST_AUTO_TEST_CASE(RandomizedPCADimensionalityReductionTest)
   PCADimensionalityReduction<RandomizedSVDPolicy>();
 }
 
+/**
+ * Make sure that randomized-svd PCA on a sparse matrix gives the same result as
+ * randomized-svd PCA on the same matrix stored densely.  The data has rank 3,
+ * so both find the exact decomposition.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedPCASparseTest)
+{
+  const arma::sp_mat data = arma::sprandu<arma::sp_mat>(200, 3, 0.3) *
+      arma::sprandu<arma::sp_mat>(3, 500, 0.3);
+  const arma::mat denseData(data);
+  arma::mat centeredData = denseData;
+  centeredData.each_col() -= arma::mean(denseData, 1);
+
+  arma::mat denseTransformed, denseEigvec;
+  arma::vec denseEigval;
+  RandomizedSVDPolicy denseDecomposition;
+  denseDecomposition.Apply(denseData, centeredData, denseTransformed,
+      denseEigval, denseEigvec, 3);
+
+  arma::mat transformed, eigvec;
+  arma::vec eigval;
+  RandomizedSVDPolicy decomposition;
+  decomposition.Apply(data, transformed, eigval, eigvec, 3);
+
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(eigval[i], denseEigval[i], 1e-5);
+
+  // The components may point in opposite directions.
+  BOOST_REQUIRE_EQUAL(transformed.n_rows, denseTransformed.n_rows);
+  BOOST_REQUIRE_EQUAL(transformed.n_cols, denseTransformed.n_cols);
+  for (size_t i = 0; i < transformed.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(std::abs(transformed[i]) -
+        std::abs(denseTransformed[i]), 1e-5);
+}
+
 /**
  * Test that dimensionality reduction with QUIC-SVD PCA works the same way
  * as the Exact-SVD PCA method.
@@ -220,6 +256,114 @@ BOOST_AUTO_TEST_CASE(ExactPCAVarianceRetainedTest)
   PCAVarianceRetained<ExactSVDPolicy>();
 }
 
+/**
+ * Test that dimensionality reduction with incremental-svd PCA works the same
+ * way MATLAB does (which should be correct!).
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCADimensionalityReductionTest)
+{
+  PCADimensionalityReduction<IncrementalSVDPolicy>();
+}
+
+/**
+ * Test that setting the variance retained parameter to perform dimensionality
+ * reduction works using the incremental svd PCA method.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAVarianceRetainedTest)
+{
+  PCAVarianceRetained<IncrementalSVDPolicy>();
+}
+
+/**
+ * Make sure that incremental-svd PCA over many small blocks gives the same
+ * result as exact-svd PCA.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCABlockTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 1000);
+  data.row(1) += 2 * data.row(0);
+  data.row(3) -= data.row(2);
+
+  arma::mat exactTransformed, exactEigvec;
+  arma::vec exactEigval;
+  PCAType<ExactSVDPolicy> exactPCA;
+  exactPCA.Apply(data, exactTransformed, exactEigval, exactEigvec);
+
+  arma::mat transformed, eigvec;
+  arma::vec eigval;
+  PCAType<IncrementalSVDPolicy> incrementalPCA(false,
+      IncrementalSVDPolicy(0, 3));
+  incrementalPCA.Apply(data, transformed, eigval, eigvec);
+
+  BOOST_REQUIRE_EQUAL(eigval.n_elem, exactEigval.n_elem);
+  for (size_t i = 0; i < eigval.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(eigval[i], exactEigval[i], 1e-5);
+
+  // The components may point in opposite directions.
+  BOOST_REQUIRE_EQUAL(transformed.n_rows, exactTransformed.n_rows);
+  for (size_t i = 0; i < transformed.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(std::abs(transformed[i]) -
+        std::abs(exactTransformed[i]), 1e-5);
+}
+
+/**
+ * Fit a truncated incremental decomposition block by block on data that lies
+ * in a two-dimensional subspace, and make sure that new points are projected
+ * like with exact-svd PCA.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAStreamingTest)
+{
+  const arma::mat basis = arma::randu<arma::mat>(10, 2);
+  arma::mat data = basis * arma::randn<arma::mat>(2, 600);
+  data.each_col() += arma::randu<arma::vec>(10);
+
+  IncrementalSVDPolicy decomposition(2);
+  for (size_t i = 0; i < 12; ++i)
+    decomposition.Update(data.cols(50 * i, 50 * i + 49));
+
+  BOOST_REQUIRE_EQUAL(decomposition.NumPoints(), 600);
+  BOOST_REQUIRE_EQUAL(decomposition.Components().n_cols, 2);
+
+  arma::mat exactTransformed, exactEigvec;
+  arma::vec exactEigval;
+  PCAType<ExactSVDPolicy> exactPCA;
+  exactPCA.Apply(data, exactTransformed, exactEigval, exactEigvec);
+
+  const arma::vec eigval = decomposition.EigenValues();
+  BOOST_REQUIRE_CLOSE(eigval[0], exactEigval[0], 1e-5);
+  BOOST_REQUIRE_CLOSE(eigval[1], exactEigval[1], 1e-5);
+  BOOST_REQUIRE_CLOSE(decomposition.TotalVariance(), arma::sum(exactEigval),
+      1e-5);
+
+  // Project new points without refitting.
+  arma::mat points = basis * arma::randn<arma::mat>(2, 20);
+  arma::mat transformed;
+  decomposition.Apply(points, transformed);
+
+  points.each_col() -= arma::mean(data, 1);
+  const arma::mat exactPoints = arma::trans(exactEigvec.cols(0, 1)) * points;
+  for (size_t i = 0; i < transformed.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(std::abs(transformed[i]) - std::abs(exactPoints[i]),
+        1e-5);
+}
+
+/**
+ * After a single point, the incremental decomposition has no variance; make
+ * sure it reports zeros instead of dividing by zero.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCASinglePointTest)
+{
+  IncrementalSVDPolicy decomposition;
+  decomposition.Update(arma::randu<arma::mat>(4, 1));
+
+  BOOST_REQUIRE_EQUAL(decomposition.NumPoints(), 1);
+  BOOST_REQUIRE_EQUAL(decomposition.TotalVariance(), 0.0);
+
+  const arma::vec eigval = decomposition.EigenValues();
+  for (size_t i = 0; i < eigval.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(eigval[i], 0.0);
+}
+
 /**
  * Test that scaling PCA works.
  */
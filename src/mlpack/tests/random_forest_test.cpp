@@ -0,0 +1,215 @@
+/**
+ * @file random_forest_test.cpp
+ *
+ * Tests for the DecisionTree and RandomForest classes.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(RandomForestTest);
+
+/**
+ * Generate points from three Gaussians in five dimensions; the class of each
+ * point is the Gaussian it came from.
+ */
+void CreateGaussianDataset(const size_t points,
+                           arma::mat& data,
+                           arma::Row<size_t>& labels)
+{
+  data.randn(5, points);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % 3;
+    data(labels[i], i) += 4.0;
+  }
+}
+
+/**
+ * A full-depth tree should classify its (distinct) training points perfectly.
+ */
+BOOST_AUTO_TEST_CASE(DecisionTreeTrainingAccuracyTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  CreateGaussianDataset(500, data, labels);
+
+  DecisionTree<> tree(data, labels, 3);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(data, predictions);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], labels[i]);
+    BOOST_REQUIRE_EQUAL(tree.Classify(data.col(i)), labels[i]);
+  }
+
+  BOOST_REQUIRE_EQUAL(tree.NumNodes(), 2 * tree.NumLeaves() - 1);
+}
+
+/**
+ * Make sure that the minimum leaf size is respected.
+ */
+BOOST_AUTO_TEST_CASE(DecisionTreeMinimumLeafSizeTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  CreateGaussianDataset(500, data, labels);
+
+  DecisionTree<InformationGain> tree(data, labels, 3, 50);
+
+  // Every leaf holds at least 50 points, so there are at most 10 leaves.
+  BOOST_REQUIRE_LE(tree.NumLeaves(), 10);
+  BOOST_REQUIRE_GT(tree.NumLeaves(), 1);
+}
+
+/**
+ * Make sure that a random forest classifies well, and that its out-of-bag
+ * error is a reasonable estimate of its test error.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestAccuracyTest)
+{
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  CreateGaussianDataset(1500, data, labels);
+  CreateGaussianDataset(1500, testData, testLabels);
+
+  RandomForest<> forest(data, labels, 3, 50);
+  BOOST_REQUIRE_EQUAL(forest.NumTrees(), 50);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  forest.Classify(testData, predictions, probabilities);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    if (predictions[i] == testLabels[i])
+      ++correct;
+
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+
+    size_t prediction;
+    arma::vec pointProbabilities;
+    forest.Classify(testData.col(i), prediction, pointProbabilities);
+    BOOST_REQUIRE_EQUAL(prediction, predictions[i]);
+    for (size_t c = 0; c < 3; ++c)
+      BOOST_REQUIRE_SMALL(pointProbabilities[c] - probabilities(c, i), 1e-10);
+  }
+
+  const double testError = 1.0 - double(correct) / testData.n_cols;
+  BOOST_REQUIRE_LT(testError, 0.05);
+  BOOST_REQUIRE_LT(forest.OOBError(), 0.05);
+  BOOST_REQUIRE_SMALL(forest.OOBError() - testError, 0.03);
+}
+
+/**
+ * The forest should only depend on the random seed, not on how many threads
+ * train the trees or on how the trees are distributed among them.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestDeterministicTest)
+{
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  CreateGaussianDataset(600, data, labels);
+  CreateGaussianDataset(300, testData, testLabels);
+
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  math::RandomSeed(17);
+  RandomForest<InformationGain> forest1(data, labels, 3, 20, 2, 3);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  math::RandomSeed(17);
+  RandomForest<InformationGain> forest2(data, labels, 3, 20, 2, 3);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  for (size_t t = 0; t < 20; ++t)
+    BOOST_REQUIRE_EQUAL(forest1.Tree(t).NumNodes(), forest2.Tree(t).NumNodes());
+
+  arma::Row<size_t> predictions1, predictions2;
+  arma::mat probabilities1, probabilities2;
+  forest1.Classify(testData, predictions1, probabilities1);
+  forest2.Classify(testData, predictions2, probabilities2);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions1[i], predictions2[i]);
+    for (size_t c = 0; c < 3; ++c)
+      BOOST_REQUIRE_SMALL(probabilities1(c, i) - probabilities2(c, i), 1e-10);
+  }
+
+  // The out-of-bag votes are summed in the order the trees finish, so a tie
+  // may be broken differently for a single point.
+  BOOST_REQUIRE_SMALL(forest1.OOBError() - forest2.OOBError(), 0.01);
+
+  math::RandomSeed(std::time(NULL));
+}
+
+/**
+ * Invalid labels or numbers of features must raise an error instead of
+ * terminating the program from inside the threads that train the trees.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestInvalidInputTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  CreateGaussianDataset(100, data, labels);
+
+  RandomForest<> forest;
+  BOOST_REQUIRE_THROW(forest.Train(data, labels, 2, 10), std::runtime_error);
+  BOOST_REQUIRE_THROW(forest.Train(data, labels, 3, 10, 1, 6),
+      std::runtime_error);
+}
+
+/**
+ * Make sure that a serialized forest makes the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(RandomForestSerializationTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  CreateGaussianDataset(300, data, labels);
+
+  RandomForest<> forest(data, labels, 3, 10);
+  RandomForest<> xmlForest, textForest;
+  RandomForest<> binaryForest(data, labels, 3, 3);
+
+  SerializeObjectAll(forest, xmlForest, textForest, binaryForest);
+
+  BOOST_REQUIRE_EQUAL(xmlForest.NumTrees(), 10);
+  BOOST_REQUIRE_EQUAL(textForest.NumTrees(), 10);
+  BOOST_REQUIRE_EQUAL(binaryForest.NumTrees(), 10);
+
+  arma::mat probabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities;
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  forest.Classify(data, predictions, probabilities);
+  xmlForest.Classify(data, xmlPredictions, xmlProbabilities);
+  textForest.Classify(data, textPredictions, textProbabilities);
+  binaryForest.Classify(data, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(probabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -7,6 +7,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/randomized_svd/randomized_svd.hpp>
+#include <mlpack/methods/cf/svd_wrapper.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -59,4 +60,63 @@ BOOST_AUTO_TEST_CASE(RandomizedSVDReconstructionError)
   BOOST_REQUIRE_SMALL(error, 1e-5);
 }
 
+/**
+ * The randomized SVD of sparse low-rank data should match the exact SVD of the
+ * centered dense data.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDSparseTest)
+{
+  // A sparse matrix of rank 3; the centered matrix has rank 3 too.
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(200, 3, 0.1) *
+      arma::sprandu<arma::sp_mat>(3, 500, 0.3);
+
+  arma::mat centeredData;
+  math::Center(arma::mat(data), centeredData);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  svd::RandomizedSVD rSVD(0, 4);
+  rSVD.Apply(data, U2, s2, V2, 3);
+
+  // The sigular value error should be small.
+  double error = arma::norm(s2.subvec(0, 2) - s1.subvec(0, 2), "frob") /
+      arma::norm(s1.subvec(0, 2), "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+
+  // The relative reconstruction error should be small.
+  error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+}
+
+/**
+ * A low-rank factorization of sparse data with SVDWrapper and the randomized
+ * SVD should have small reconstruction error.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDWrapperSparseTest)
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(500, 3, 0.1) *
+      arma::sprandu<arma::sp_mat>(3, 200, 0.3);
+
+  cf::SVDWrapper<svd::RandomizedSVD> factorizer;
+  arma::mat W, H;
+  const double error = factorizer.Apply(data, 3, W, H);
+
+  BOOST_REQUIRE_EQUAL(W.n_rows, 500);
+  BOOST_REQUIRE_EQUAL(W.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(H.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(H.n_cols, 200);
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  // The error must match the error of the dense reconstruction.
+  const double denseError = arma::norm(arma::mat(data) - W * H, "fro") /
+      arma::norm(arma::mat(data), "fro");
+  BOOST_REQUIRE_SMALL(error - denseError, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,7 @@
 #include <mlpack/methods/ann/rnn.hpp>
 #include <mlpack/methods/ann/performance_functions/mse_function.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/minibatch_sgd/minibatch_sgd.hpp>
 #include <mlpack/methods/ann/activation_functions/logistic_function.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
  #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
@@ -596,4 +597,63 @@ BOOST_AUTO_TEST_CASE(DistractedSequenceRecallTest)
   DistractedSequenceRecallTestNetwork(hiddenLayerLSTMPeephole);
 }
 
+/**
+ * The recurrent state is carried over between the windows of the truncated
+ * backward pass, so the window size must not change the forward pass.
+ * Propagating a batch of sequences at once should give the same objective and
+ * gradient as summing over the sequences one at a time.
+ */
+BOOST_AUTO_TEST_CASE(TruncatedBatchGradientTest)
+{
+  arma::mat input, labels;
+  GenerateNoisySines(input, labels, 10, 3);
+
+  LinearLayer<> linearLayer0(1, 16);
+  RecurrentLayer<> recurrentLayer0(4, 16);
+  LSTMLayer<> hiddenLayer0(4);
+
+  LinearLayer<> hiddenLayer(4, 2);
+  BaseLayer<LogisticFunction> hiddenBaseLayer;
+
+  BinaryClassificationLayer classOutputLayer;
+
+  auto modules = std::tie(linearLayer0, recurrentLayer0, hiddenLayer0,
+                          hiddenLayer, hiddenBaseLayer);
+
+  RNN<decltype(modules), BinaryClassificationLayer, RandomInitialization,
+      MeanSquaredErrorFunction> net(modules, classOutputLayer);
+
+  // A single iteration doesn't change the parameters; this only sets the
+  // dataset.
+  MiniBatchSGD<decltype(net)> opt(net, 2, 0.01, 1);
+  net.Train(input, labels, opt);
+
+  const double objective = net.EvaluateBatch(net.Parameters(), 0,
+      input.n_cols);
+
+  net.Rho() = 3;
+  const double truncatedObjective = net.EvaluateBatch(net.Parameters(), 0,
+      input.n_cols);
+  BOOST_REQUIRE_CLOSE(truncatedObjective, objective, 1e-5);
+
+  arma::mat batchGradient;
+  net.GradientBatch(net.Parameters(), 0, batchGradient, input.n_cols);
+
+  arma::mat gradient = arma::zeros<arma::mat>(net.Parameters().n_rows,
+      net.Parameters().n_cols);
+  double sequenceObjective = 0;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    arma::mat sequenceGradient;
+    net.Gradient(net.Parameters(), i, sequenceGradient);
+    gradient += sequenceGradient;
+    sequenceObjective += net.Evaluate(net.Parameters(), i);
+  }
+
+  BOOST_REQUIRE_CLOSE(sequenceObjective, objective, 1e-5);
+  BOOST_REQUIRE_EQUAL(batchGradient.n_elem, gradient.n_elem);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(batchGradient[i] - gradient[i], 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
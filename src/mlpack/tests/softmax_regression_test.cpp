@@ -34,7 +34,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for(size_t i = 0; i < trials; i++)
@@ -79,9 +79,9 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionRegularizationEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -121,8 +121,8 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -357,8 +357,8 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionTrainTest)
 
   // This should be the same as the default parameters given by
   // SoftmaxRegression.
-  SoftmaxRegressionFunction srf(dataset, labels, 2, 0.0001, false);
-  L_BFGS<SoftmaxRegressionFunction> lbfgs(srf);
+  SoftmaxRegressionFunction<> srf(dataset, labels, 2, 0.0001, false);
+  L_BFGS<SoftmaxRegressionFunction<>> lbfgs(srf);
   SoftmaxRegression<> sr(lbfgs);
 
   SoftmaxRegression<> sr2(dataset.n_rows, 2);
@@ -387,12 +387,12 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionOptimizerTrainTest)
   for (size_t i = 500; i < 1000; ++i)
     labels[i] = size_t(1.0);
 
-  SoftmaxRegressionFunction srf(dataset, labels, 2, 0.01, true);
-  L_BFGS<SoftmaxRegressionFunction> lbfgs(srf);
+  SoftmaxRegressionFunction<> srf(dataset, labels, 2, 0.01, true);
+  L_BFGS<SoftmaxRegressionFunction<>> lbfgs(srf);
   SoftmaxRegression<> sr(lbfgs);
 
   SoftmaxRegression<> sr2(dataset.n_rows, 2, true);
-  L_BFGS<SoftmaxRegressionFunction> lbfgs2(srf);
+  L_BFGS<SoftmaxRegressionFunction<>> lbfgs2(srf);
   sr2.Parameters() = srf.GetInitialPoint();
   sr2.Train(lbfgs2);
 
@@ -408,4 +408,66 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionOptimizerTrainTest)
   }
 }
 
+/**
+ * Make sure that the separable objective and the dense and sparse per-point
+ * gradients sum to the full objective and gradient, on dense and on sparse
+ * data.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSeparableTest)
+{
+  const size_t points = 200;
+  const size_t inputSize = 10;
+  const size_t numClasses = 4;
+
+  arma::sp_mat sparseData;
+  sparseData.sprandu(inputSize, points, 0.3);
+  const arma::mat data(sparseData);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0.5, true);
+  SoftmaxRegressionFunction<arma::sp_mat> srfSparse(sparseData, labels,
+      numClasses, 0.5, true);
+  BOOST_REQUIRE_EQUAL(srf.NumFunctions(), points);
+
+  arma::mat parameters;
+  parameters.randu(numClasses, inputSize + 1);
+
+  const double objective = srf.Evaluate(parameters);
+  BOOST_REQUIRE_CLOSE(srfSparse.Evaluate(parameters), objective, 1e-5);
+
+  arma::mat gradient, sparseDataGradient;
+  srf.Gradient(parameters, gradient);
+  srfSparse.Gradient(parameters, sparseDataGradient);
+
+  double sumObjective = 0;
+  arma::mat sumGradient(numClasses, inputSize + 1, arma::fill::zeros);
+  arma::sp_mat sumSparseGradient(numClasses, inputSize + 1);
+  for (size_t i = 0; i < points; ++i)
+  {
+    sumObjective += srfSparse.Evaluate(parameters, i);
+
+    arma::mat pointGradient;
+    arma::sp_mat sparseGradient;
+    srf.Gradient(parameters, i, pointGradient);
+    srfSparse.Gradient(parameters, i, sparseGradient);
+    sumGradient += pointGradient;
+    sumSparseGradient += sparseGradient;
+
+    // Only the intercept and the nonzero dimensions may have a gradient.
+    BOOST_REQUIRE_LE(sparseGradient.n_nonzero,
+        (sparseData.col(i).n_nonzero + 1) * numClasses);
+  }
+
+  BOOST_REQUIRE_CLOSE(sumObjective, objective, 1e-5);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(sparseDataGradient[i], gradient[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(sumGradient[i], gradient[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(sumSparseGradient[i], gradient[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();